@@ -0,0 +1,61 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of Nanvix.
+ * 
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PCI_H_
+#define PCI_H_
+
+	#include <stdint.h>
+
+	/**
+	 * @name PCI configuration space registers
+	 */
+	/**@{*/
+	#define PCI_VENDOR    0x00 /**< Vendor ID.           */
+	#define PCI_DEVICE    0x02 /**< Device ID.           */
+	#define PCI_COMMAND   0x04 /**< Command.             */
+	#define PCI_BAR0      0x10 /**< Base address 0.      */
+	#define PCI_SUBSYSTEM 0x2e /**< Subsystem ID.        */
+	#define PCI_IRQ_LINE  0x3c /**< Interrupt line.      */
+	/**@}*/
+
+	/**
+	 * @name PCI command register bits
+	 */
+	/**@{*/
+	#define PCI_COMMAND_IO     (1 << 0) /**< I/O space enable.    */
+	#define PCI_COMMAND_MEMORY (1 << 1) /**< Memory space enable. */
+	#define PCI_COMMAND_MASTER (1 << 2) /**< Bus mastering.       */
+	/**@}*/
+
+	/**
+	 * @brief Address of a PCI function.
+	 */
+	#define PCI_ADDR(bus, dev, fn) (((bus) << 16) | ((dev) << 11) | ((fn) << 8))
+
+	/**
+	 * @brief No such PCI function.
+	 */
+	#define PCI_NONE 0xffffffff
+
+	/* Forward definitions. */
+	extern uint32_t pci_read(uint32_t, unsigned);
+	extern void pci_write(uint32_t, unsigned, uint32_t);
+	extern uint32_t pci_find(uint16_t, uint16_t, unsigned);
+
+#endif /* PCI_H_ */
@@ -61,6 +61,16 @@
  	 */
  	#define SUPER_MAGIC 0x137f
  	
+	/**
+	 * @name Superblock Features
+	 * 
+	 * @details Optional features of a file system.
+	 */
+	/**@{*/
+	#define MINIX_FEATURE_INLINE (1 << 0)               /**< Inline data?    */
+	#define MINIX_FEATURES       (MINIX_FEATURE_INLINE) /**< Known features. */
+	/**@}*/
+ 	
 	/**
 	 * @brief In-disk superblock.
 	 */
@@ -71,7 +81,7 @@
 		uint16_t s_imap_nblocks;     /**< Number of inode map blocks. */
 		uint16_t s_bmap_nblocks;     /**< Number of block map blocks. */
 		uint16_t s_first_data_block; /**< Unused.                     */
-		uint16_t unused1;            /**< Unused.                     */
+		uint16_t s_features;         /**< Feature flags.              */
 		uint32_t s_max_size;         /**< Maximum file size.          */
 		uint16_t s_magic;            /**< Magic number.               */
 	} __attribute__((packed));
@@ -144,6 +154,15 @@
 		uint8_t i_nlinks;           /**< Number of links to the file.         */
 		uint16_t i_zones[NR_ZONES]; /**< Zone numbers.                        */
 	} __attribute__((packed));
+	
+	/**
+	 * @brief Maximum size of inline data (in bytes).
+	 * 
+	 * @details If #MINIX_FEATURE_INLINE is enabled, the contents of regular
+	 *          files that are no larger than this are stored in the zone area
+	 *          of the disk inode, instead of in data blocks.
+	 */
+	#define MINIX_INLINE_MAX (NR_ZONES*sizeof(uint16_t))
 
 /*============================================================================*
  *                         Directory Entry Information                        *
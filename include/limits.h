@@ -59,6 +59,21 @@
 	/* Files that one process can have open simultaneously. */
 	#define OPEN_MAX 20
 	
+	/**
+	 * @brief Message queues that one process can have open simultaneously.
+	 */
+	#define MQ_OPEN_MAX 8
+	
+	/**
+	 * @brief Number of message priorities.
+	 */
+	#define MQ_PRIO_MAX 32
+	
+	/**
+	 * @brief Maximum number of I/O vectors in a single call.
+	 */
+	#define IOV_MAX 16
+	
 	/* Length of argument to the execve(). */
 	#define ARG_MAX 2048
 	
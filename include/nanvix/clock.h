@@ -21,17 +21,45 @@
 #define TIMER_H_
 
 	#include <nanvix/const.h>
+	#include <stdint.h>
 	
 	/* Clock frequency (in hertz). */
 	#define CLOCK_FREQ 100
 	
 	/* Current time. */
 	#define CURRENT_TIME (startup_time + ticks/CLOCK_FREQ)
+	
+	/* Shared time page. */
+	#define TIMEPG_ADDR  0x00400000 /* Address in user space.        */
+	#define TIMEPG_SHIFT         24 /* Fixed point scale of tsc_mult. */
+	
+	/*
+	 * Shared time page.
+	 * 
+	 * The kernel updates this page on every clock tick, and user processes
+	 * read it at TIMEPG_ADDR without entering the kernel. The sequence
+	 * counter is odd while an update is in progress, so readers retry
+	 * until they see the same even value before and after reading.
+	 */
+	struct timepg
+	{
+		volatile unsigned seq;          /* Sequence counter.                */
+		volatile unsigned freq;         /* Clock frequency (in hertz).      */
+		volatile unsigned ticks;        /* Ticks since initialization.      */
+		volatile unsigned startup_time; /* Time at system startup.          */
+		volatile uint64_t tsc;          /* Time stamp counter at last tick. */
+		volatile unsigned tsc_mult;     /* Nanoseconds per cycle, scaled.   */
+	};
 
 	/*
 	 * Initializes the timer interrupt.
 	 */
 	EXTERN void clock_init(unsigned freq);
+	
+	/*
+	 * Converts time stamp counter cycles to nanoseconds.
+	 */
+	EXTERN unsigned clock_nsec(unsigned cycles);
 
 	/* Ticks since system initialization. */
 	EXTERN unsigned ticks;
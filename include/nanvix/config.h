@@ -26,6 +26,7 @@
 	#define MEMORY_SIZE   0x1000000 /* Memory size (in bytes).    */
 	#define HDD_SIZE      0x2000000 /* Hard disk size (in bytes). */
 	#define SWP_SIZE      0x1000000 /* Swap disk size (in bytes). */
+	#define SWP_MAX       0x2000000 /* Maximum swap size.         */
 	#define KEYBOARD_US           1 /* US International keyboard. */
 	
 	/* Kernel configuration. */
@@ -34,13 +35,28 @@
 	#define PROC_MAX              64 /* Maximum number of process.      */
 	#define PROC_SIZE_MAX  0x4000000 /* Maximum process size.           */
 	#define RAMDISK_SIZE    0x400000 /* RAM disks size.                 */
-	#define INITRD_SIZE      0x80000 /* Init RAM disk size.             */
+	#define INITRD_SIZE     0x100000 /* Init RAM disk size.             */
 	#define NR_INODES           1024 /* Number of in-core inodes.       */
 	#define NR_SUPERBLOCKS         4 /* Number of in-core super blocks. */
 	#define ROOT_DEV          0x0101 /* Root device number.             */
 	#define SWAP_DEV          0x0101 /* Swap device number.             */
+	#define NR_SWAPS               4 /* Number of swap areas.           */
 	#define NR_FILES             256 /* Number of opened files.         */
 	#define NR_REGIONS           128 /* Number of memory regions.       */
 	#define NR_BUFFERS           256 /* Number of block buffers.        */
+	#define NR_RECLAIMS           32 /* Number of pending reclaims.     */
+	#define NR_MQUEUES             8 /* Number of message queues.       */
+	#define NR_MESSAGES          128 /* Number of queued messages.      */
+	#define NR_SOCKETS            32 /* Number of sockets.              */
+	#define NR_NETBUFS            32 /* Number of network buffers.      */
+	#define NR_ARPS               16 /* Number of ARP table entries.    */
+	#define MLOCK_MAX       0x100000 /* Maximum locked memory.          */
+	#define KLOG_LEVEL             3 /* Kernel log level.               */
+	#define IRQTRACE               0 /* Trace interrupts-off sections?  */
+	
+	/* Network configuration (host byte order). */
+	#define NET_ADDR      0x0a00020f /* Internet address (10.0.2.15).  */
+	#define NET_NETMASK   0xffffff00 /* Network mask (255.255.255.0).  */
+	#define NET_GATEWAY   0x0a000202 /* Default gateway (10.0.2.2).    */
 	
 #endif /* CONFIG_H_ */
@@ -131,6 +131,7 @@
 		ssize_t (*write)(dev_t, const char *, size_t, off_t); /* Write.       */
 		int (*readblk)(unsigned, struct buffer *);            /* Read block.  */
 		int (*writeblk)(unsigned, struct buffer *);           /* Write block. */
+		ssize_t (*size)(unsigned);                            /* Size.        */
 	};
 	
 	/*
@@ -182,6 +183,11 @@
 	 */
 	EXTERN ssize_t bdev_read(dev_t dev, char *buf, size_t n, off_t off);
 	
+	/*
+	 * Gets the size of a block device.
+	 */
+	EXTERN ssize_t bdev_size(dev_t dev);
+	
 	/*
 	 * Writes a block to a block device.
 	 */
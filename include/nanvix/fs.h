@@ -39,8 +39,12 @@
 	#include <nanvix/config.h>
 	#include <nanvix/const.h>
 	#include <nanvix/pm.h>
+	#include <netinet/in.h>
+	#include <sys/socket.h>
 	#include <sys/stat.h>
+	#include <sys/un.h>
 	#include <sys/types.h>
+	#include <sys/uio.h>
 	#include <stdint.h>
 	#include <ustat.h>
 
@@ -63,6 +67,20 @@
 	 */
 	typedef const struct buffer * const_buffer_t;
 	
+	/**
+	 * @brief Block buffer cache statistics.
+	 */
+	struct bcache_stat
+	{
+		unsigned nbuffers; /**< Number of buffers. */
+		unsigned nvalid;   /**< Valid buffers.     */
+		unsigned ndirty;   /**< Dirty buffers.     */
+		unsigned nbusy;    /**< Buffers in use.    */
+		unsigned nlocked;  /**< Locked buffers.    */
+		unsigned hits;     /**< Cache hits.        */
+		unsigned misses;   /**< Cache misses.      */
+	};
+	
 	/* Forward definitions. */
 	EXTERN void bsync(void);
 	EXTERN void blklock(buffer_t);
@@ -75,6 +93,7 @@
 	EXTERN dev_t buffer_dev(const_buffer_t);
 	EXTERN block_t buffer_num(const_buffer_t);
 	EXTERN int buffer_is_sync(const_buffer_t);
+	EXTERN void buffer_stat(struct bcache_stat *);
 	
 	/**@}*/
 	
@@ -92,13 +111,20 @@
 	 */
 	enum inode_flags
 	{
-		INODE_LOCKED = (1 << 0), /**< Locked?      */
-		INODE_DIRTY  = (1 << 1), /**< Dirty?       */
-		INODE_MOUNT  = (1 << 2), /**< Mount point? */
-		INODE_VALID  = (1 << 3), /**< Valid inode? */
-		INODE_PIPE   = (1 << 4)  /**< Pipe inode?  */
+		INODE_LOCKED = (1 << 0), /**< Locked?             */
+		INODE_DIRTY  = (1 << 1), /**< Dirty?              */
+		INODE_MOUNT  = (1 << 2), /**< Mount point?        */
+		INODE_VALID  = (1 << 3), /**< Valid inode?        */
+		INODE_PIPE   = (1 << 4), /**< Pipe inode?         */
+		INODE_DSYNC  = (1 << 5), /**< Size/zones changed? */
+		INODE_INLINE = (1 << 6), /**< Inline data?        */
+		INODE_SOCKET = (1 << 7), /**< Socket inode?       */
+		INODE_PROC   = (1 << 8)  /**< Process file?       */
 	};
 	 
+	/* Forward definitions. */
+	struct socket;
+	
 	/**
 	 * @brief In-core inode.
 	 */
@@ -119,10 +145,26 @@
 		char *pipe;               /**< Pipe page.                            */
 		off_t head;               /**< Pipe head.                            */
 		off_t tail;               /**< Pipe tail.                            */
+		struct socket *sock;      /**< Socket.                               */
+		dev_t mdev;               /**< Device mounted here.                  */
+		ino_t mroot;              /**< Root inode of the mounted device.     */
 		struct inode *free_next;  /**< Next inode in the free list.          */
 		struct inode *hash_next;  /**< Next inode in the hash table.         */
 		struct inode *hash_prev;  /**< Previous inode in the hash table.     */
 		struct process *chain;    /**< Sleeping chain.                       */
+		struct buffer *dirty;     /**< Dirty buffers.                        */
+	};
+	
+	/**
+	 * @brief Inode cache statistics.
+	 */
+	struct icache_stat
+	{
+		unsigned ninodes; /**< Number of in-core inodes. */
+		unsigned nvalid;  /**< Inodes in use.            */
+		unsigned ndirty;  /**< Dirty inodes.             */
+		unsigned hits;    /**< Cache hits.               */
+		unsigned misses;  /**< Cache misses.             */
 	};
 	
 	/**@}*/
@@ -133,12 +175,15 @@
 	EXTERN void inode_unlock(struct inode *i);
 	EXTERN void inode_sync(void);
 	EXTERN void inode_truncate(struct inode *i);
+	EXTERN void inode_fsync(struct inode *i, int datasync);
 	EXTERN struct inode *inode_alloc(struct superblock *sb);
 	EXTERN struct inode *inode_get(dev_t dev, ino_t num);
 	EXTERN void inode_put(struct inode *i);
 	EXTERN struct inode *inode_dname(const char *path, const char **name);
 	EXTERN struct inode *inode_name(const char *pathname);
 	EXTERN struct inode *inode_pipe(void);
+	EXTERN struct inode *inode_socket(struct socket *sock);
+	EXTERN void inode_stat(struct icache_stat *st);
 
 /*============================================================================*
  *                            Super Block Library                             *
@@ -167,6 +212,8 @@
 	EXTERN void superblock_sync(void);
 	EXTERN block_t block_map(struct inode *, off_t, int);
 	EXTERN void block_free(struct superblock *, block_t, int);
+	EXTERN void reclaim_flush(void);
+	EXTERN void reclaimd(void);
 	
 	
 /*============================================================================*
@@ -209,6 +256,11 @@
 	 */
 	EXTERN void putname(char *name);
 	
+	/*
+	 * Resolves a path name lexically.
+	 */
+	EXTERN int path_canon(char *buf, const char *path, struct process *proc);
+	
 	/*
 	 * Gets an empty file descriptor table entry.
 	 */
@@ -224,17 +276,51 @@
 	 */
 	EXTERN void do_close(int fd);
 	
+	/*
+	 * Reads from a file.
+	 */
+	EXTERN ssize_t do_read
+	(struct file *f, const struct iovec *iov, int iovcnt, off_t *off);
+	
+	/*
+	 * Writes to a file.
+	 */
+	EXTERN ssize_t do_write
+	(struct file *f, const struct iovec *iov, int iovcnt, off_t *off);
+	
+	/*
+	 * Gets I/O vectors from user space.
+	 */
+	EXTERN int getiov
+	(struct iovec *kiov, const struct iovec *iov, int iovcnt, mode_t mask);
+	
+	/*
+	 * Free directory entry that expands the directory.
+	 */
+	#define DIRENT_APPEND (-1)
+	
 	/*
 	 * Adds an entry to a directory.
 	 */
 	EXTERN int dir_add
 	(struct inode *dinode, struct inode *inode, const char *name);
 	
+	/*
+	 * Adds an entry to a directory at a known position.
+	 */
+	EXTERN int dir_add_slot
+	(struct inode *dinode, struct inode *inode, const char *name, int slot);
+	
 	/*
 	 * Searchs for a file in a directory.
 	 */
 	EXTERN ino_t dir_search(struct inode *i, const char *filename);
 	
+	/*
+	 * Searchs for a file in a directory, or for room to create it.
+	 */
+	EXTERN ino_t dir_lookup(struct inode *i, const char *filename, int *slot);
+	
 	/*
 	 * Removes an entry from a directory.
 	 */
@@ -250,6 +336,18 @@
 	 */
 	EXTERN ssize_t file_write(struct inode *i, const void *buf, size_t n, off_t off);
 	
+	/*
+	 * Reads from a regular file into many buffers.
+	 */
+	EXTERN ssize_t file_readv
+	(struct inode *i, const struct iovec *iov, int iovcnt, off_t off);
+	
+	/*
+	 * Writes to a regular file from many buffers.
+	 */
+	EXTERN ssize_t file_writev
+	(struct inode *i, const struct iovec *iov, int iovcnt, off_t off);
+	
 	/*
 	 * Reads data from a pipe.
 	 */
@@ -260,6 +358,95 @@
 	 */
 	EXTERN ssize_t pipe_write(struct inode *inode, const char *buf, size_t n);
 	
+/*============================================================================*
+ *                                  Sockets                                   *
+ *============================================================================*/
+
+	/**
+	 * @brief Maximum number of file descriptors passed in a message.
+	 */
+	#define SCM_MAX_FD 4
+	
+	/**
+	 * @brief Socket name.
+	 * 
+	 * @details Holds a socket address of any supported family, once it has
+	 *          been brought into kernel space.
+	 */
+	struct sockname
+	{
+		sa_family_t family;           /**< Address family.             */
+		char path[UNIX_PATH_MAX + 1]; /**< Pathname (AF_UNIX).         */
+		struct sockaddr_in in;        /**< Internet address (AF_INET). */
+	};
+	
+	/**
+	 * @brief Socket message.
+	 */
+	struct sockmsg
+	{
+		const struct iovec *iov; /**< Data buffers (in user space).    */
+		int iovcnt;              /**< Number of data buffers.          */
+		struct sockname *name;   /**< Peer name (in kernel space).     */
+		int nfds;                /**< Number of passed descriptors.    */
+		int fds[SCM_MAX_FD];     /**< Passed file descriptors.         */
+		int flags;               /**< Message flags.                   */
+	};
+	
+	/* Forward definitions. */
+	EXTERN int socket_getaddr
+	(const struct sockaddr *, socklen_t, struct sockname *);
+	EXTERN int socket_putaddr
+	(const struct sockname *, struct sockaddr *, socklen_t *);
+	EXTERN struct socket *socket_alloc(int domain, int type);
+	EXTERN void socket_close(struct socket *sock);
+	EXTERN int socket_open(struct socket *sock);
+	EXTERN int socket_get(int fd, struct socket **sock);
+	EXTERN int socket_bind(struct socket *sock, const struct sockname *name);
+	EXTERN int socket_listen(struct socket *sock, int backlog);
+	EXTERN int socket_accept
+	(struct socket *sock, struct socket **new, struct sockname *name,
+	 int nonblock);
+	EXTERN int socket_connect
+	(struct socket *sock, const struct sockname *name, int nonblock);
+	EXTERN ssize_t socket_send(struct socket *sock, struct sockmsg *msg);
+	EXTERN ssize_t socket_recv(struct socket *sock, struct sockmsg *msg);
+	EXTERN ssize_t socket_read
+	(struct socket *sock, const struct iovec *iov, int iovcnt, int oflag);
+	EXTERN ssize_t socket_write
+	(struct socket *sock, const struct iovec *iov, int iovcnt, int oflag);
+	EXTERN int socket_ioctl(struct socket *sock, unsigned cmd, unsigned arg);
+	EXTERN int socket_udp_input
+	(const struct sockaddr_in *, const struct sockaddr_in *, const void *,
+	 size_t);
+	
+/*============================================================================*
+ *                            Process File System                             *
+ *============================================================================*/
+
+	/**
+	 * @brief Device number of the process file system.
+	 */
+	#define PROC_DEV 0xff00
+	
+	/**
+	 * @brief Root inode of the process file system.
+	 */
+	#define PROC_ROOT INODE_ROOT
+	
+	/* Forward definitions. */
+	EXTERN int procfs_inode(struct inode *ip);
+	EXTERN void procfs_put(struct inode *ip);
+	EXTERN ino_t procfs_lookup(struct inode *dip, const char *name);
+	EXTERN ssize_t procfs_read(struct inode *ip, void *buf, size_t n, off_t off);
+	EXTERN int procfs_mount(struct inode *mp);
+	EXTERN int procfs_umount(struct inode *ip);
+	
+	/*
+	 * Mount point of the process file system.
+	 */
+	EXTERN struct inode *procfs_mp;
+	
 	/*
 	 * Root device.
 	 */
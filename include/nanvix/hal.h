@@ -65,6 +65,7 @@
 	EXTERN void user_mode(addr_t, addr_t);
 	EXTERN void switch_to(struct process *);
 	EXTERN unsigned irq_lvl(unsigned);
+	EXTERN uint64_t read_tsc(void);
 	/**@}*/	
 	
 	/**
@@ -74,8 +75,12 @@
 	EXTERN void iowait(void);
 	EXTERN void outputb(word_t, byte_t);
 	EXTERN void outputw(word_t, word_t);
+	EXTERN void outputl(word_t, dword_t);
 	EXTERN byte_t inputb(word_t);
 	EXTERN word_t inputw(word_t);
+	EXTERN dword_t inputl(word_t);
+	EXTERN void inputsw(word_t, void *, size_t);
+	EXTERN void outputsw(word_t, const void *, size_t);
 	/**@}*/	
 
 	/**
@@ -84,6 +89,38 @@
 	/**@{*/
 	EXTERN void physcpy(addr_t, addr_t, size_t);
 	/**@}*/	
+	
+	/**
+	 * @name Hibernation Functions
+	 */
+	/**@{*/
+	#define CONTEXT_SIZE 7 /**< Saved context size (in double words). */
+	EXTERN int context_save(dword_t *);
+	EXTERN void context_resume(addr_t, dword_t *);
+	/**@}*/
+	
+	/**
+	 * @name Interrupts-Off Tracer
+	 */
+	/**@{*/
+	#define NR_IRQTRACES 16 /**< Number of worst sections recorded. */
+	
+	/**
+	 * @brief Interrupts-off section.
+	 */
+	struct irqtrace
+	{
+		addr_t off;     /**< Call site that disabled interrupts. */
+		addr_t on;      /**< Call site that enabled interrupts.  */
+		unsigned count; /**< Number of times seen.               */
+		unsigned max;   /**< Longest duration (in cycles).       */
+	};
+	
+	EXTERN void irqtrace_off(addr_t, dword_t);
+	EXTERN void irqtrace_on(addr_t, dword_t);
+	EXTERN void irqtrace_reset(void);
+	EXTERN int irqtrace_stat(unsigned, struct irqtrace *);
+	/**@}*/
 
 #endif /* _ASM_FILE_ */
 
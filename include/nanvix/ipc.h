@@ -0,0 +1,60 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of Nanvix.
+ * 
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file nanvix/ipc.h
+ * 
+ * @brief Interprocess communication
+ */
+
+#ifndef NANVIX_IPC_H_
+#define NANVIX_IPC_H_
+
+	#include <nanvix/const.h>
+	#include <nanvix/hal.h>
+	#include <nanvix/pm.h>
+	#include <sys/types.h>
+	#include <mqueue.h>
+	
+	/**
+	 * @name Message queue limits
+	 */
+	/**@{*/
+	#define MQ_MAXMSG_DEF                     8 /**< Default number of messages. */
+	#define MQ_MAXMSG_MAX                    16 /**< Maximum number of messages. */
+	#define MQ_MSGSIZE_DEF                 1024 /**< Default message size.       */
+	#define MQ_PAGES                         16 /**< Maximum pages in a message. */
+	#define MQ_MSGSIZE_MAX (MQ_PAGES*PAGE_SIZE) /**< Maximum message size.       */
+	/**@}*/
+	
+	/* Forward definitions. */
+	struct mqueue;
+	
+	/* Forward definitions. */
+	EXTERN struct mqueue *mqueue_open
+	(const char *, int, mode_t, const struct mq_attr *);
+	EXTERN int mqueue_unlink(const char *);
+	EXTERN int mqueue_send(struct mqueue *, const char *, size_t, unsigned, int);
+	EXTERN ssize_t mqueue_receive
+	(struct mqueue *, char *, size_t, unsigned *, int);
+	EXTERN void mqueue_attr(struct mqueue *, struct mq_attr *);
+	EXTERN void mqueue_dup(struct mqueue *);
+	EXTERN void mqueue_put(struct mqueue *);
+
+#endif /* NANVIX_IPC_H_ */
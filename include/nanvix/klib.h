@@ -220,6 +220,30 @@
 	 *                            formatted output                            *
 	 *========================================================================*/
 
+	/**
+	 * @name Log Levels
+	 * 
+	 * @details A log level may prefix the format string of kprintf(). Messages
+	 *          with no log level are informational, and messages above
+	 *          KLOG_LEVEL are discarded.
+	 */
+	/**@{*/
+	#define KERN_ERR   "<1>" /**< Error conditions.       */
+	#define KERN_WARN  "<2>" /**< Warning conditions.     */
+	#define KERN_INFO  "<3>" /**< Informational messages. */
+	#define KERN_DEBUG "<4>" /**< Debug messages.         */
+	/**@}*/
+	
+	/**
+	 * @brief Rate limit state.
+	 */
+	struct ratelimit
+	{
+		unsigned begin;   /**< Start of the current interval.  */
+		unsigned printed; /**< Messages printed in interval.   */
+		unsigned missed;  /**< Messages suppressed in interval. */
+	};
+
 	/* Forward definitions. */
 	EXTERN dev_t kout;
 
@@ -230,7 +254,35 @@
 	EXTERN int kvsprintf(char *, const char *, va_list);
 	EXTERN void chkout(dev_t);
 	EXTERN void kprintf(const char *, ...);
+	EXTERN int kratelimit(struct ratelimit *);
+	EXTERN void kflush(void);
+	EXTERN void klogd(void);
 	/**@}*/
+	
+	/**
+	 * @brief Writes a rate limited message to the kernel log.
+	 * 
+	 * @details Each call site is limited on its own, so that a flood of
+	 *          messages from one place does not hide the others.
+	 */
+	#define kprintf_ratelimited(...)                        \
+	do                                                      \
+	{                                                       \
+		PRIVATE struct ratelimit ratelimit__ = { 0, 0, 0 }; \
+		if (kratelimit(&ratelimit__))                       \
+			kprintf(__VA_ARGS__);                           \
+	} while (0)
+	
+	/**
+	 * @brief Writes a debug message to the kernel log.
+	 * 
+	 * @details Debug messages are compiled out unless KLOG_LEVEL enables them.
+	 */
+	#if (KLOG_LEVEL >= 4)
+		#define kdebug(...) kprintf(KERN_DEBUG __VA_ARGS__)
+	#else
+		#define kdebug(...) ((void)0)
+	#endif
 
 	/*========================================================================*
 	 *                           logging and debugging                        *
@@ -249,6 +301,7 @@
 	/**@{*/
 	EXTERN ssize_t klog_read(unsigned, char *, size_t);
 	EXTERN ssize_t klog_write(unsigned, const char *, size_t);
+	EXTERN ssize_t klog_drain(char *, size_t);
 	EXTERN void kpanic(const char *, ...);
 	EXTERN void kmemdump(const void *s, size_t n);
 	/**@}*/
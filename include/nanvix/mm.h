@@ -42,8 +42,9 @@
 	#define UBASE_PHYS   0x00800000 /* User base.        */
 	
 	/* User memory layout. */
-	#define USTACK_ADDR 0xc0000000 /* User stack. */
-	#define UHEAP_ADDR  0xa0000000 /* User heap.  */
+	#define USTACK_ADDR  0xc0000000 /* User stack.          */
+	#define UHEAP_ADDR   0xa0000000 /* User heap.           */
+	#define USHARED_ADDR 0x00400000 /* Shared kernel pages. */
 
 	/* Kernel memory size: 4 MB. */
 	#define KMEM_SIZE 0x00400000
@@ -57,15 +58,60 @@
 #ifndef _ASM_FILE_
 	
 	/* Forward definitions. */
+	struct inode;
+	
+	/**
+	 * @brief Memory statistics.
+	 */
+	struct mem_stat
+	{
+		unsigned nframes;   /**< Number of page frames.     */
+		unsigned nfree;     /**< Free page frames.          */
+		unsigned nshared;   /**< Shared page frames.        */
+		unsigned nlocked;   /**< Locked page frames.        */
+		unsigned nkpages;   /**< Number of kernel pages.    */
+		unsigned nkfree;    /**< Free kernel pages.         */
+		unsigned faults;    /**< Validity page faults.      */
+		unsigned cows;      /**< Copy-on-write page faults. */
+		unsigned evictions; /**< Evicted pages.             */
+		unsigned swapins;   /**< Pages swapped in.          */
+		unsigned swapouts;  /**< Pages swapped out.         */
+	};
+	
+	/**
+	 * @brief Swap statistics.
+	 */
+	struct swap_stat
+	{
+		unsigned nareas; /**< Active swap areas. */
+		unsigned nslots; /**< Number of slots.   */
+		unsigned nused;  /**< Used slots.        */
+	};
+	
+	/* Forward definitions. */
+	EXTERN int advisepg(addr_t, size_t, int);
 	EXTERN int chkmem(const void *, size_t, mode_t);
 	EXTERN int fubyte(const void *);
 	EXTERN int fudword(const void *);
+	EXTERN int getupg(addr_t, struct pte *);
+	EXTERN int hibernate_enter(void);
 	EXTERN int crtpgdir(struct process *);
+	EXTERN int lockpg(addr_t, size_t);
+	EXTERN int mapupg(addr_t, struct pte *);
 	EXTERN int pfault(addr_t);
+	EXTERN int swap_off(struct inode *);
+	EXTERN int swap_on(struct inode *, int);
+	EXTERN int unlockpg(addr_t, size_t);
 	EXTERN int vfault(addr_t);
 	EXTERN void dstrypgdir(struct process *);
+	EXTERN void hibernate_resume(void);
 	EXTERN void putkpg(void *);
+	EXTERN void putupg(struct pte *);
+	EXTERN void sharekpg(addr_t, void *);
 	EXTERN void mm_init(void);
+	EXTERN void mm_stat(struct mem_stat *);
+	EXTERN void swap_stat(struct swap_stat *);
+	EXTERN void swap_init(void);
 	EXTERN void *getkpg(int);
 
 #endif /* _ASM_FILE_ */
@@ -0,0 +1,94 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of Nanvix.
+ * 
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ * 
+ * @brief Public network interface.
+ */
+
+#ifndef NANVIX_NET_H_
+#define NANVIX_NET_H_
+
+	#include <nanvix/const.h>
+	#include <net/if.h>
+	#include <netinet/in.h>
+	#include <sys/types.h>
+	#include <sys/uio.h>
+	#include <stdint.h>
+
+	/**
+	 * @brief Length of a hardware address.
+	 */
+	#define ETH_ALEN 6
+
+	/**
+	 * @brief Largest UDP payload that fits in a single frame.
+	 * 
+	 * @details Fragmentation is not supported, so this is the maximum
+	 *          datagram size on Internet sockets.
+	 */
+	#define UDP_PAYLOAD_MAX 1472
+
+	/**
+	 * @brief Network device.
+	 * 
+	 * @details The send() operation transmits a whole frame, waiting for room
+	 *          in the transmit ring if needed. The recv() operation copies the
+	 *          next received frame, if any, and returns its length.
+	 */
+	struct netdev
+	{
+		unsigned char mac[ETH_ALEN];       /**< Hardware address. */
+		int (*send)(const void *, size_t); /**< Send a frame.     */
+		ssize_t (*recv)(void *, size_t);   /**< Receive a frame.  */
+		void (*resume)(void);              /**< Resume device.    */
+	};
+
+	/**
+	 * @brief Network statistics.
+	 */
+	struct netstat
+	{
+		unsigned rxpackets; /**< Frames received.                */
+		unsigned rxbytes;   /**< Bytes received.                 */
+		unsigned rxdropped; /**< Frames dropped on input.        */
+		unsigned txpackets; /**< Frames sent.                    */
+		unsigned txbytes;   /**< Bytes sent.                     */
+		unsigned txdropped; /**< Frames dropped on output.       */
+		unsigned loopback;  /**< Packets looped back.            */
+		unsigned arpmisses; /**< Packets held for ARP.           */
+		unsigned noport;    /**< Datagrams to unbound ports.     */
+		unsigned nobufs;    /**< Datagrams to full sockets.      */
+	};
+
+	/* Forward definitions. */
+	EXTERN int netdev_register(const struct netdev *);
+	EXTERN void net_wakeup(void);
+	EXTERN void net_resume(void);
+	EXTERN void net_init(void);
+	EXTERN void netd(void);
+	EXTERN int net_ioctl(unsigned, unsigned);
+	EXTERN void net_stat(struct netstat *, struct netconf *);
+	EXTERN int net_local(in_addr_t);
+	EXTERN ssize_t udp_output
+	(const struct sockaddr_in *, const struct sockaddr_in *,
+	 const struct iovec *, int, size_t);
+
+#endif /* NANVIX_NET_H_ */
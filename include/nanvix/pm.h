@@ -118,10 +118,34 @@
 	#define PROC_HANDLERS 28 /**< Signal handlers offset.        */
 	#define PROC_IRQLVL 120  /**< IRQ Level offset.              */
 	#define PROC_FSS    124  /**< FPU Saved Status offset.       */
+	#define PROC_NSYSCALLS 232 /**< System calls offset.         */
 	/**@}*/
 
 #ifndef _ASM_FILE_
+	
+	/* Forward definitions. */
+	struct mqueue;
 
+	/**
+	 * @name Scheduling latency histograms
+	 * 
+	 * @details Bucket zero counts values below one microsecond, bucket i
+	 *          counts values in [2^(i-1), 2^i) microseconds, and the last
+	 *          bucket also counts anything longer.
+	 */
+	/**@{*/
+	#define NR_SCHEDHIST 20 /**< Number of histogram buckets. */
+	/**@}*/
+	
+	/**
+	 * @brief Scheduling latency histograms.
+	 */
+	struct sched_hist
+	{
+		unsigned delay[NR_SCHEDHIST]; /**< Time ready before running. */
+		unsigned slice[NR_SCHEDHIST]; /**< Time run in a time slice.  */
+	};
+	
 	/**
 	 * @brief Process.
 	 */
@@ -141,6 +165,7 @@
 		sighandler_t handlers[NR_SIGNALS]; /**< Signal handlers.        */
 		unsigned irqlvl;                   /**< Current IRQ level.      */
     	struct fpu fss;                    /**< FPU Saved Status.       */
+		unsigned nsyscalls;                /**< System calls issued.    */
 		/**@}*/
 
     	/**
@@ -150,6 +175,7 @@
 		struct pde *pgdir;                 /**< Page directory.         */
 		struct pregion pregs[NR_PREGIONS]; /**< Process memory regions. */
 		size_t size;                       /**< Process size.           */
+		unsigned faults;                   /**< Page faults.            */
 		/**@}*/
 
 		/**
@@ -158,12 +184,22 @@
 		/**@{*/
 		struct inode *pwd;             /**< Working directory.         */
 		struct inode *root;            /**< Root directory.            */
+		char pwdpath[PATH_MAX];        /**< Working directory path.    */
+		char rootpath[PATH_MAX];       /**< Root directory path.       */
 		struct file *ofiles[OPEN_MAX]; /**< Opened files.              */
 		int close;                     /**< Close on exec()?           */
 		mode_t umask;                  /**< User file's creation mask. */
 		dev_t tty;                     /**< Associated tty device.     */
 		/**@}*/
 		
+		/**
+		 * @name Message queue information
+		 */
+		/**@{*/
+		struct mqueue *mqdes[MQ_OPEN_MAX]; /**< Message queue descriptors. */
+		int mqflags[MQ_OPEN_MAX];          /**< Descriptor flags.          */
+		/**@}*/
+		
 		/**
 		 * @name General information
 		 */
@@ -205,6 +241,58 @@
 		struct process *next;    /**< Next process in a list. */
 		struct process **chain;  /**< Sleeping chain.         */
 		/**@}*/
+		
+		/**
+		 * @name Scheduling latency
+		 */
+		/**@{*/
+		uint64_t readytsc;       /**< Time when made ready.   */
+		uint64_t runtsc;         /**< Time when last run.     */
+		struct sched_hist hist;  /**< Latency histograms.     */
+		/**@}*/
+	};
+	
+	/**
+	 * @brief Scheduler statistics.
+	 */
+	struct sched_stat
+	{
+		unsigned nprocs;    /**< Number of processes.           */
+		unsigned nready;    /**< Running or ready processes.    */
+		unsigned nwaiting;  /**< Waiting or sleeping processes. */
+		unsigned nstopped;  /**< Stopped processes.             */
+		unsigned nswitches; /**< Context switches.              */
+	};
+	
+	/**
+	 * @name Sleeping chain statistics
+	 */
+	/**@{*/
+	#define NR_CHAINSTATS 64 /**< Number of tracked sleeping chains.   */
+	#define NR_CALLSITES   4 /**< Call sites tracked for each chain.   */
+	/**@}*/
+	
+	/**
+	 * @brief Sleeping chain statistics.
+	 */
+	struct chain_stat
+	{
+		struct process **chain; /**< Sleeping chain.          */
+		unsigned nsleeps;       /**< Number of sleeps.        */
+		unsigned nwakeups;      /**< Number of wakeups.       */
+		unsigned nempty;        /**< Wakeups with no sleeper. */
+		unsigned total;         /**< Total blocked ticks.     */
+		unsigned max;           /**< Maximum blocked ticks.   */
+		unsigned last;          /**< Time of last sleep.      */
+		
+		/**
+		 * @brief Call sites that have slept in the chain.
+		 */
+		struct
+		{
+			addr_t addr;    /**< Return address.   */
+			unsigned count; /**< Number of sleeps. */
+		} sites[NR_CALLSITES];
 	};
 	
 	/* Forward definitions. */
@@ -213,6 +301,10 @@
 	EXTERN int issig(void);
 	EXTERN void pm_init(void);
 	EXTERN void sched(struct process *);
+	EXTERN void sched_stat(struct sched_stat *);
+	EXTERN void sched_hist(struct sched_hist *, unsigned *);
+	EXTERN int chain_stat(unsigned, struct chain_stat *);
+	EXTERN unsigned chain_evicted(void);
 	EXTERN void sleep(struct process **, int);
 	EXTERN void sndsig(struct process *, int);
 	EXTERN void wakeup(struct process **);
@@ -274,6 +366,7 @@
 	
 	/* Forward definitions. */
 	EXTERN int shutting_down;
+	EXTERN struct process *freezer;
 	EXTERN struct process proctab[PROC_MAX];
 	EXTERN struct process *curr_proc;
 	EXTERN struct process *last_proc;
@@ -50,6 +50,7 @@
 		struct pte *pgtab[REGION_PGTABS]; /* Underlying page table.      */
 		struct process *chain;            /* Sleeping chain.             */
 		struct pregion *preg;             /* Process region attached to. */
+		int advice;                       /* Access pattern advice.      */
 		
 		/* File information. */
 		struct
@@ -22,6 +22,7 @@
 #define NANVIX_SYSCALL_H_
 
 	#include <nanvix/const.h>
+	#include <sys/socket.h>
 	#include <sys/stat.h>
 	#include <sys/times.h>
 	#include <sys/types.h>
@@ -31,7 +32,7 @@
 	#include <utime.h>
 	
 	/* Number of system calls. */
-	#define NR_SYSCALLS 48
+	#define NR_SYSCALLS 80
 	
 	/* System call numbers. */
 	#define NR_alarm     0
@@ -85,8 +86,42 @@
  	#define NR_semget   48
  	#define NR_semctl   49
  	#define NR_semop    50
+ 	#define NR_fsync    51
+ 	#define NR_fdatasync 52
+ 	#define NR_madvise  53
+ 	#define NR_mlock    54
+ 	#define NR_munlock  55
+ 	#define NR_swapon   56
+ 	#define NR_swapoff  57
+ 	#define NR_mq_open  58
+ 	#define NR_mq_close 59
+ 	#define NR_mq_unlink 60
+ 	#define NR_mq_send  61
+ 	#define NR_mq_receive 62
+ 	#define NR_mq_getattr 63
+ 	#define NR_socket   64
+ 	#define NR_bind     65
+ 	#define NR_listen   66
+ 	#define NR_accept   67
+ 	#define NR_connect  68
+ 	#define NR_sendmsg  69
+ 	#define NR_recvmsg  70
+ 	#define NR_hibernate 71
+ 	#define NR_mount     72
+ 	#define NR_umount    73
+ 	#define NR_pstat     74
+ 	#define NR_getcwd    75
+ 	#define NR_readv     76
+ 	#define NR_writev    77
+ 	#define NR_pread     78
+ 	#define NR_pwrite    79
 
 #ifndef _ASM_FILE_
+	
+	/* Forward definitions. */
+	struct iovec;
+	struct mq_attr;
+	struct pstat;
 
 	/* System calls prototypes. */
 	EXTERN unsigned sys_alarm(unsigned seconds);
@@ -264,6 +299,158 @@
 	 */
 	EXTERN int sys_gticks(void);
 
+	/*
+	 * Reserved system call.
+	 */
+	EXTERN int sys_nosys(void);
+
+	/*
+	 * Synchronizes changes to a file.
+	 */
+	EXTERN int sys_fsync(int fd);
+
+	/*
+	 * Synchronizes data of a file.
+	 */
+	EXTERN int sys_fdatasync(int fd);
+
+	/*
+	 * Advises the system about the use of memory.
+	 */
+	EXTERN int sys_madvise(void *addr, size_t len, int advice);
+
+	/*
+	 * Locks a range of memory.
+	 */
+	EXTERN int sys_mlock(const void *addr, size_t len);
+
+	/*
+	 * Unlocks a range of memory.
+	 */
+	EXTERN int sys_munlock(const void *addr, size_t len);
+
+	/*
+	 * Enables swapping to a file or block device.
+	 */
+	EXTERN int sys_swapon(const char *path, int prio);
+
+	/*
+	 * Disables swapping to a file or block device.
+	 */
+	EXTERN int sys_swapoff(const char *path);
+
+	/*
+	 * Opens a message queue.
+	 */
+	EXTERN int sys_mq_open
+	(const char *name, int oflag, mode_t mode, const struct mq_attr *attr);
+
+	/*
+	 * Closes a message queue.
+	 */
+	EXTERN int sys_mq_close(int mqd);
+
+	/*
+	 * Removes a message queue.
+	 */
+	EXTERN int sys_mq_unlink(const char *name);
+
+	/*
+	 * Sends a message to a message queue.
+	 */
+	EXTERN int sys_mq_send(int mqd, const char *msg, size_t len, unsigned prio);
+
+	/*
+	 * Receives a message from a message queue.
+	 */
+	EXTERN ssize_t sys_mq_receive
+	(int mqd, char *msg, size_t len, unsigned *prio);
+
+	/*
+	 * Gets the attributes of a message queue.
+	 */
+	EXTERN int sys_mq_getattr(int mqd, struct mq_attr *attr);
+
+	/*
+	 * Creates a socket.
+	 */
+	EXTERN int sys_socket(int domain, int type, int protocol);
+
+	/*
+	 * Binds a name to a socket.
+	 */
+	EXTERN int sys_bind(int fd, const struct sockaddr *addr, socklen_t len);
+
+	/*
+	 * Listens for socket connections.
+	 */
+	EXTERN int sys_listen(int fd, int backlog);
+
+	/*
+	 * Accepts a connection on a socket.
+	 */
+	EXTERN int sys_accept(int fd, struct sockaddr *addr, socklen_t *len);
+
+	/*
+	 * Connects a socket.
+	 */
+	EXTERN int sys_connect(int fd, const struct sockaddr *addr, socklen_t len);
+
+	/*
+	 * Sends a message on a socket.
+	 */
+	EXTERN ssize_t sys_sendmsg(int fd, const struct msghdr *msg, int flags);
+
+	/*
+	 * Receives a message from a socket.
+	 */
+	EXTERN ssize_t sys_recvmsg(int fd, struct msghdr *msg, int flags);
+
+	/*
+	 * Hibernates the system.
+	 */
+	EXTERN int sys_hibernate(void);
+
+	/*
+	 * Mounts a file system.
+	 */
+	EXTERN int sys_mount(const char *source, const char *target, const char *type);
+
+	/*
+	 * Unmounts a file system.
+	 */
+	EXTERN int sys_umount(const char *target);
+
+	/*
+	 * Takes a snapshot of all processes.
+	 */
+	EXTERN int sys_pstat(struct pstat *buf, int n);
+
+	/*
+	 * Gets the path name of the working directory.
+	 */
+	EXTERN int sys_getcwd(char *buf, size_t size);
+
+	/*
+	 * Reads from a file into many buffers.
+	 */
+	EXTERN ssize_t sys_readv(int fd, const struct iovec *iov, int iovcnt);
+
+	/*
+	 * Writes to a file from many buffers.
+	 */
+	EXTERN ssize_t sys_writev(int fd, const struct iovec *iov, int iovcnt);
+
+	/*
+	 * Reads from a file at a given offset.
+	 */
+	EXTERN ssize_t sys_pread(int fd, void *buf, size_t n, off_t off);
+
+	/*
+	 * Writes to a file at a given offset.
+	 */
+	EXTERN ssize_t sys_pwrite(int fd, const void *buf, size_t n, off_t off);
+
 #endif /* _ASM_FILE_ */
 
 #endif /* NANVIX_SYSCALL_H_ */
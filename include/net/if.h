@@ -0,0 +1,59 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of Nanvix.
+ * 
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NET_IF_H_
+#define NET_IF_H_
+
+	#include <netinet/in.h>
+
+	/**
+	 * @name Socket I/O control commands
+	 */
+	/**@{*/
+	#define SIOCGNETCONF 0x7301 /**< Get network interface configuration. */
+	#define SIOCSNETCONF 0x7302 /**< Set network interface configuration. */
+	/**@}*/
+
+	/**
+	 * @name Network interface flags
+	 */
+	/**@{*/
+	#define IFF_UP 1 /**< Network interface present? */
+	/**@}*/
+
+#ifndef _ASM_FILE_
+
+	/**
+	 * @brief Network interface configuration.
+	 * 
+	 * @details Addresses are in network byte order. When setting the
+	 *          configuration, the hardware address and flags are ignored.
+	 */
+	struct netconf
+	{
+		unsigned char mac[6]; /**< Hardware address. */
+		in_addr_t addr;       /**< Internet address. */
+		in_addr_t netmask;    /**< Network mask.     */
+		in_addr_t gateway;    /**< Default gateway.  */
+		unsigned flags;       /**< Flags.            */
+	};
+
+#endif /* _ASM_FILE_ */
+
+#endif /* NET_IF_H_ */
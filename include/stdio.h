@@ -123,6 +123,12 @@
 	 */
 	extern int fputs(const char *str, FILE *stream);
 	
+	/*
+	 * Writes items to a file.
+	 */
+	extern size_t fwrite
+	(const void *ptr, size_t size, size_t nitems, FILE *stream);
+	
 	/* Forward definitions. */
 	extern FILE *fopen(const char *, const char *);
 	extern FILE *freopen(const char *filename, const char *mode, FILE *stream);
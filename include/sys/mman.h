@@ -0,0 +1,41 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of Nanvix.
+ * 
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MMAN_H_
+#define MMAN_H_
+
+	#include <sys/types.h>
+
+	/**
+	 * @brief Memory advice values.
+	 */
+	/**@{*/
+	#define MADV_NORMAL     0 /**< No special treatment.              */
+	#define MADV_RANDOM     1 /**< Expect random page references.     */
+	#define MADV_SEQUENTIAL 2 /**< Expect sequential page references. */
+	#define MADV_WILLNEED   3 /**< Pages will be needed soon.         */
+	#define MADV_DONTNEED   4 /**< Pages will not be needed soon.     */
+	/**@}*/
+
+	/* Forward definitions. */
+	extern int madvise(void *, size_t, int);
+	extern int mlock(const void *, size_t);
+	extern int munlock(const void *, size_t);
+
+#endif /* MMAN_H_ */
@@ -0,0 +1,49 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of Nanvix.
+ * 
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SYS_PSTAT_H_
+#define SYS_PSTAT_H_
+#ifndef _ASM_FILE_
+
+	#include <sys/types.h>
+	#include <limits.h>
+
+	/**
+	 * @brief Process status snapshot.
+	 */
+	struct pstat
+	{
+		pid_t pid;               /**< Process ID.              */
+		pid_t ppid;              /**< Father process ID.       */
+		uid_t uid;               /**< User ID.                 */
+		int priority;            /**< Priority.                */
+		int nice;                /**< Nice value.              */
+		unsigned state;          /**< Current state.           */
+		unsigned utime;          /**< User CPU time (ticks).   */
+		unsigned ktime;          /**< Kernel CPU time (ticks). */
+		size_t size;             /**< Memory size (bytes).     */
+		unsigned faults;         /**< Page faults.             */
+		unsigned nsyscalls;      /**< System calls issued.     */
+		char name[NAME_MAX + 1]; /**< Process name.            */
+	};
+	
+	extern int pstat(struct pstat *buf, int n);
+
+#endif /* _ASM_FILE_ */
+#endif /* SYS_PSTAT_H_ */
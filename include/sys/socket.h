@@ -0,0 +1,153 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of Nanvix.
+ * 
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SOCKET_H_
+#define SOCKET_H_
+
+	#include <sys/types.h>
+
+	/**
+	 * @name Socket types
+	 */
+	/**@{*/
+	#define SOCK_STREAM 1 /**< Byte stream socket. */
+	#define SOCK_DGRAM  2 /**< Datagram socket.    */
+	/**@}*/
+
+	/**
+	 * @name Address families
+	 */
+	/**@{*/
+	#define AF_UNSPEC 0 /**< Unspecified.         */
+	#define AF_UNIX   1 /**< UNIX domain sockets. */
+	#define AF_INET   2 /**< Internet sockets.    */
+	/**@}*/
+
+	/**
+	 * @name Message flags
+	 */
+	/**@{*/
+	#define MSG_CTRUNC   0x08 /**< Control data truncated. */
+	#define MSG_TRUNC    0x20 /**< Normal data truncated.  */
+	#define MSG_DONTWAIT 0x40 /**< Non-blocking operation. */
+	/**@}*/
+
+	/**
+	 * @brief Socket level for control messages.
+	 */
+	#define SOL_SOCKET 1
+
+	/**
+	 * @brief Control message that carries file descriptors.
+	 */
+	#define SCM_RIGHTS 1
+
+	/**
+	 * @brief Maximum backlog of pending connections.
+	 */
+	#define SOMAXCONN 8
+
+#ifndef _ASM_FILE_
+
+	#include <sys/uio.h>
+
+	/**
+	 * @brief Length of a socket address.
+	 */
+	typedef unsigned socklen_t;
+
+	/**
+	 * @brief Address family.
+	 */
+	typedef unsigned short sa_family_t;
+
+	/**
+	 * @brief Socket address.
+	 */
+	struct sockaddr
+	{
+		sa_family_t sa_family; /**< Address family.  */
+		char sa_data[14];      /**< Socket address. */
+	};
+
+	/**
+	 * @brief Message header.
+	 */
+	struct msghdr
+	{
+		void *msg_name;           /**< Optional address.           */
+		socklen_t msg_namelen;    /**< Size of address.            */
+		struct iovec *msg_iov;    /**< Scatter/gather array.       */
+		int msg_iovlen;           /**< Number of buffers in array. */
+		void *msg_control;        /**< Ancillary data.             */
+		socklen_t msg_controllen; /**< Ancillary data length.      */
+		int msg_flags;            /**< Flags on received message.  */
+	};
+
+	/**
+	 * @brief Control message header.
+	 */
+	struct cmsghdr
+	{
+		socklen_t cmsg_len; /**< Data byte count, including header. */
+		int cmsg_level;     /**< Originating protocol.              */
+		int cmsg_type;      /**< Protocol-specific type.            */
+	};
+
+	/**
+	 * @name Control message macros
+	 */
+	/**@{*/
+	#define CMSG_ALIGN(len) \
+		(((len) + sizeof(int) - 1) & ~(sizeof(int) - 1))
+	#define CMSG_DATA(cmsg) \
+		((unsigned char *)((struct cmsghdr *)(cmsg) + 1))
+	#define CMSG_LEN(len) \
+		(sizeof(struct cmsghdr) + (len))
+	#define CMSG_SPACE(len) \
+		(sizeof(struct cmsghdr) + CMSG_ALIGN(len))
+	#define CMSG_FIRSTHDR(mhdr)                                \
+		(((mhdr)->msg_controllen >= sizeof(struct cmsghdr)) ? \
+		(struct cmsghdr *)(mhdr)->msg_control : (struct cmsghdr *)0)
+	#define CMSG_NXTHDR(mhdr, cmsg)                                           \
+		((((unsigned char *)(cmsg) + CMSG_ALIGN((cmsg)->cmsg_len) +          \
+		sizeof(struct cmsghdr)) >                                            \
+		((unsigned char *)(mhdr)->msg_control + (mhdr)->msg_controllen)) ?  \
+		(struct cmsghdr *)0 :                                                \
+		(struct cmsghdr *)((unsigned char *)(cmsg) + CMSG_ALIGN((cmsg)->cmsg_len)))
+	/**@}*/
+
+	/* Forward definitions. */
+	extern int socket(int, int, int);
+	extern int bind(int, const struct sockaddr *, socklen_t);
+	extern int listen(int, int);
+	extern int accept(int, struct sockaddr *, socklen_t *);
+	extern int connect(int, const struct sockaddr *, socklen_t);
+	extern ssize_t send(int, const void *, size_t, int);
+	extern ssize_t sendto
+	(int, const void *, size_t, int, const struct sockaddr *, socklen_t);
+	extern ssize_t sendmsg(int, const struct msghdr *, int);
+	extern ssize_t recv(int, void *, size_t, int);
+	extern ssize_t recvfrom
+	(int, void *, size_t, int, struct sockaddr *, socklen_t *);
+	extern ssize_t recvmsg(int, struct msghdr *, int);
+
+#endif /* _ASM_FILE_ */
+
+#endif /* SOCKET_H_ */
@@ -24,6 +24,7 @@
 	
 	/* File types. */
 	#define S_IFMT  00170000
+	#define S_IFSOCK 0140000
 	#define S_IFREG  0100000
 	#define S_IFBLK  0060000
 	#define S_IFDIR  0040000
@@ -35,6 +36,7 @@
 	#define S_ISCHR(m)	(((m) & S_IFMT) == S_IFCHR) /* Char. special file? */
 	#define S_ISBLK(m)	(((m) & S_IFMT) == S_IFBLK) /* Block special file? */
 	#define S_ISFIFO(m)	(((m) & S_IFMT) == S_IFIFO) /* FIFO special file?  */
+	#define S_ISSOCK(m)	(((m) & S_IFMT) == S_IFSOCK) /* Socket?            */
 
 	/* Mode bits. */
 	#define S_IRWXU  0700 /* Read, write, execute/search by owner.     */
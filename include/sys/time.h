@@ -0,0 +1,41 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of Nanvix.
+ * 
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SYS_TIME_H_
+#define SYS_TIME_H_
+#ifndef _ASM_FILE_
+
+	#include <sys/types.h>
+
+	/*
+	 * Time value in seconds and microseconds.
+	 */
+	struct timeval
+	{
+		time_t tv_sec;       /* Seconds.      */
+		suseconds_t tv_usec; /* Microseconds. */
+	};
+	
+	/*
+	 * Get the date and time.
+	 */
+	extern int gettimeofday(struct timeval *tp, void *tzp);
+
+#endif /* _ASM_FILE_ */
+#endif /* SYS_TIME_H_ */
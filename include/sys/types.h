@@ -27,6 +27,9 @@
 	/* Used for system times in clock ticks. */
 	typedef int clock_t;
 
+	/* Used for clock ID type in the clock and timer functions. */
+	typedef int clockid_t;
+
 	/* Used for device IDs. */
 	typedef unsigned dev_t;
 	
@@ -63,6 +66,9 @@
 	/* Used for a count of bytes or an error indication. */
 	typedef signed ssize_t;
 	
+	/* Used for time in microseconds. */
+	typedef signed suseconds_t;
+	
 	/* Used for user IDs. */
 	typedef int uid_t;
 	
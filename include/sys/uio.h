@@ -0,0 +1,44 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of Nanvix.
+ * 
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UIO_H_
+#define UIO_H_
+
+	#include <sys/types.h>
+
+	/**
+	 * @brief I/O vector.
+	 */
+	struct iovec
+	{
+		void *iov_base; /**< Base address of a memory region. */
+		size_t iov_len; /**< Size of the memory region.       */
+	};
+
+	/*
+	 * Reads from a file into many buffers.
+	 */
+	extern ssize_t readv(int fd, const struct iovec *iov, int iovcnt);
+	
+	/*
+	 * Writes to a file from many buffers.
+	 */
+	extern ssize_t writev(int fd, const struct iovec *iov, int iovcnt);
+
+#endif /* UIO_H_ */
@@ -0,0 +1,47 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of Nanvix.
+ * 
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TIME_H_
+#define TIME_H_
+#ifndef _ASM_FILE_
+
+	#include <sys/types.h>
+
+	/*
+	 * Clock IDs.
+	 */
+	#define CLOCK_REALTIME  0 /* System-wide realtime clock. */
+	#define CLOCK_MONOTONIC 1 /* Time since system startup.  */
+
+	/*
+	 * Time value in seconds and nanoseconds.
+	 */
+	struct timespec
+	{
+		time_t tv_sec; /* Seconds.     */
+		long tv_nsec;  /* Nanoseconds. */
+	};
+	
+	/*
+	 * Get the time of a clock.
+	 */
+	extern int clock_gettime(clockid_t clock_id, struct timespec *tp);
+
+#endif /* _ASM_FILE_ */
+#endif /* TIME_H_ */
@@ -50,7 +50,7 @@
 	/*
 	 * Changes process' breakpoint value.
 	 */
-	extern void *sbrk(size_t size);
+	extern void *sbrk(ssize_t size);
 	
 	/*
 	 * Changes process' breakpoint value.
@@ -164,6 +164,16 @@
 	 */
 	extern int pipe(int fildes[2]);
 	
+	/*
+	 * Reads from a file at a given offset.
+	 */
+	extern ssize_t pread(int fd, void *buf, size_t n, off_t off);
+	
+	/*
+	 * Writes to a file at a given offset.
+	 */
+	extern ssize_t pwrite(int fd, const void *buf, size_t n, off_t off);
+	
 	/*
 	 * Reads from a file.
 	 */
@@ -196,17 +206,52 @@
 	 */
 	extern void sync(void);
 	
+	/*
+	 * Synchronizes changes to a file.
+	 */
+	extern int fsync(int fd);
+	
+	/*
+	 * Synchronizes data of a file.
+	 */
+	extern int fdatasync(int fd);
+	
 	/*
 	 * Removes a directory entry.
 	 */
 	extern int unlink(const char *path);
 	
+	/*
+	 * Enables swapping to a file or block device.
+	 */
+	extern int swapon(const char *path, int prio);
+	
+	/*
+	 * Disables swapping to a file or block device.
+	 */
+	extern int swapoff(const char *path);
+	
 	/*
 	 * Writes to a file.
 	 */
 	extern ssize_t write(int fd, const void *buf, size_t n);
 	
 	extern int shutdown(void);
+	
+	/*
+	 * Hibernates the system.
+	 */
+	extern int hibernate(void);
+
+	/*
+	 * Mounts a file system.
+	 */
+	extern int mount(const char *source, const char *target, const char *type);
+
+	/*
+	 * Unmounts a file system.
+	 */
+	extern int umount(const char *target);
 
 	/*
 	 * Gets process information
@@ -17,17 +17,108 @@
  * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <nanvix/clock.h>
 #include <nanvix/const.h>
 #include <nanvix/hal.h>
 #include <nanvix/klib.h>
+#include <nanvix/mm.h>
 #include <nanvix/pm.h>
 
+/*
+ * Bad TIMEPG_ADDR ?
+ */
+#if (TIMEPG_ADDR != USHARED_ADDR)
+	#error "bad TIMEPG_ADDR"
+#endif
+
+/* Nanoseconds per second. */
+#define NSEC_PER_SEC 1000000000ULL
+
 /* Clock ticks since system initialization. */
 PUBLIC unsigned ticks = 0;
 
 /* Time at system startup. */
 PUBLIC unsigned startup_time = 0;
 
+/* Shared time page. */
+PRIVATE struct timepg *timepg = NULL;
+
+/* Time stamp counter at last calibration. */
+PRIVATE uint64_t calibration = 0;
+
+/*
+ * Computes the scaled nanoseconds per cycle for a given cycle rate.
+ * 
+ * The division is done bit by bit, since 64-bit division is not
+ * available in the kernel. Zero is returned if the result does not fit.
+ */
+PRIVATE unsigned tsc_mult(uint64_t cycles)
+{
+	uint64_t n;    /* Dividend.               */
+	uint64_t q, r; /* Quotient and remainder. */
+	
+	/* Time stamp counter not running. */
+	if (cycles == 0)
+		return (0);
+	
+	n = NSEC_PER_SEC << TIMEPG_SHIFT;
+	q = r = 0;
+	
+	for (int i = 63; i >= 0; i--)
+	{
+		r = (r << 1) | ((n >> i) & 1);
+		
+		if (r >= cycles)
+		{
+			r -= cycles;
+			q |= 1ULL << i;
+		}
+	}
+	
+	return ((q >> 32) ? 0 : (unsigned) q);
+}
+
+/*
+ * Updates the shared time page.
+ */
+PRIVATE void timepg_update(void)
+{
+	uint64_t tsc; /* Time stamp counter. */
+	
+	tsc = read_tsc();
+	
+	timepg->seq++;
+	
+	timepg->ticks = ticks;
+	timepg->startup_time = startup_time;
+	timepg->tsc = tsc;
+	
+	/* Recalibrate time stamp counter once a second. */
+	if ((ticks % CLOCK_FREQ) == 0)
+	{
+		timepg->tsc_mult = tsc_mult(tsc - calibration);
+		calibration = tsc;
+	}
+	
+	timepg->seq++;
+}
+
+/*
+ * Converts time stamp counter cycles to nanoseconds.
+ */
+PUBLIC unsigned clock_nsec(unsigned cycles)
+{
+	uint64_t ns; /* Nanoseconds. */
+	
+	/* Time stamp counter not calibrated. */
+	if (timepg == NULL)
+		return (0);
+	
+	ns = ((uint64_t)cycles*timepg->tsc_mult) >> TIMEPG_SHIFT;
+	
+	return ((ns >> 32) ? 0xffffffff : (unsigned)ns);
+}
+
 /*
  * Handles a timer interrupt.
  */
@@ -35,6 +126,8 @@ PRIVATE void do_clock()
 {
 	ticks++;
 	
+	timepg_update();
+	
 	if (KERNEL_RUNNING(curr_proc))
 	{
 		curr_proc->ktime++;
@@ -57,6 +150,13 @@ PUBLIC void clock_init(unsigned freq)
 	
 	kprintf("dev: initializing clock device driver");
 	
+	/* Share time page with user processes. */
+	if ((timepg = getkpg(1)) == NULL)
+		kpanic("dev: cannot allocate time page");
+	timepg->freq = freq;
+	calibration = read_tsc();
+	sharekpg(TIMEPG_ADDR, timepg);
+	
 	set_hwint(INT_CLOCK, &do_clock);
 	
 	freq_divisor = PIT_FREQUENCY/freq;
@@ -0,0 +1,167 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of Nanvix.
+ * 
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nanvix/const.h>
+#include <nanvix/hal.h>
+#include <nanvix/klib.h>
+
+/**
+ * @file
+ * 
+ * @brief Interrupts-off latency tracer.
+ * 
+ * @details When IRQTRACE is enabled, disable_interrupts() and
+ *          enable_interrupts() call into this module with their call site
+ *          and the processor flags before the change. A section starts when
+ *          interrupts go from enabled to disabled, and ends at the next
+ *          enable_interrupts() call that finds them disabled. Sections are
+ *          timed with the time stamp counter and grouped by the call site that
+ *          started them. Only the longest ones are kept.
+ * 
+ *          Interrupts disabled by the processor on interrupt entry and
+ *          enabled by iret are not traced. Neither is a section that spans a
+ *          context switch or the idle loop, since the time is then spent in
+ *          another process, or with the processor halted. Such sections are
+ *          dropped with irqtrace_reset().
+ */
+
+/**
+ * @brief Interrupt enable flag.
+ */
+#define EFLAGS_IF (1 << 9)
+
+/**
+ * @brief Worst interrupts-off sections.
+ */
+PRIVATE struct irqtrace traces[NR_IRQTRACES];
+
+/**
+ * @brief Time stamp counter at the start of the current section.
+ */
+PRIVATE uint64_t start = 0;
+
+/**
+ * @brief Call site that has started the current section.
+ */
+PRIVATE addr_t site = 0;
+
+/**
+ * @brief Records that interrupts were disabled.
+ * 
+ * @param addr   Call site of disable_interrupts().
+ * @param eflags Processor flags before interrupts were disabled.
+ * 
+ * @note Interrupts must be disabled.
+ */
+PUBLIC void irqtrace_off(addr_t addr, dword_t eflags)
+{
+	/* Nested section. */
+	if (!(eflags & EFLAGS_IF))
+		return;
+	
+	site = addr;
+	start = read_tsc();
+}
+
+/**
+ * @brief Records that interrupts are about to be enabled.
+ * 
+ * @param addr   Call site of enable_interrupts().
+ * @param eflags Processor flags before interrupts are enabled.
+ * 
+ * @note Interrupts are disabled if the section is still open.
+ */
+PUBLIC void irqtrace_on(addr_t addr, dword_t eflags)
+{
+	uint64_t delta;       /* Elapsed cycles.         */
+	unsigned cycles;      /* Section length.         */
+	struct irqtrace *min; /* Shortest worst section. */
+	
+	/* No open section. */
+	if ((start == 0) || (eflags & EFLAGS_IF))
+	{
+		start = 0;
+		return;
+	}
+	
+	delta = read_tsc() - start;
+	cycles = (delta >> 32) ? 0xffffffff : (unsigned)delta;
+	start = 0;
+	
+	min = &traces[0];
+	for (unsigned i = 0; i < NR_IRQTRACES; i++)
+	{
+		/* Known call site. */
+		if (traces[i].off == site)
+		{
+			traces[i].count++;
+			if (cycles > traces[i].max)
+			{
+				traces[i].max = cycles;
+				traces[i].on = addr;
+			}
+			return;
+		}
+		
+		if (traces[i].max < min->max)
+			min = &traces[i];
+	}
+	
+	/* Not among the worst sections. */
+	if (cycles <= min->max)
+		return;
+	
+	min->off = site;
+	min->on = addr;
+	min->count = 1;
+	min->max = cycles;
+}
+
+/**
+ * @brief Drops the current section, if any.
+ * 
+ * @details Called right before a context switch and before the idle process
+ *          halts the processor, so that the next process does not close a
+ *          section that it has not started.
+ */
+PUBLIC void irqtrace_reset(void)
+{
+	start = 0;
+}
+
+/**
+ * @brief Gets an interrupts-off section record.
+ * 
+ * @param i  Record index.
+ * @param tr Store location for the record.
+ * 
+ * @returns Zero if the @p i th record is in use, and non-zero otherwise.
+ */
+PUBLIC int irqtrace_stat(unsigned i, struct irqtrace *tr)
+{
+	/* Record not in use. */
+	if ((i >= NR_IRQTRACES) || (traces[i].count == 0))
+		return (-1);
+	
+	disable_interrupts();
+	kmemcpy(tr, &traces[i], sizeof(struct irqtrace));
+	enable_interrupts();
+	
+	return (0);
+}
@@ -72,6 +72,9 @@
 #define ATA_CMD_READ_SECTORS_EXT	0x24 /* Read sectors using LBA 48-bit.  */
 #define ATA_CMD_WRITE_SECTORS		0x30 /* Write sectors using LBA 28-bit. */
 #define ATA_CMD_WRITE_SECTORS_EXT	0x34 /* Write sectors using LBA 48-bit. */
+#define ATA_CMD_READ_MULTIPLE_EXT	0x29 /* Read multiple using LBA 48-bit. */
+#define ATA_CMD_WRITE_MULTIPLE_EXT	0x39 /* Write multiple using LBA 48-bit.*/
+#define ATA_CMD_SET_MULTIPLE		0xc6 /* Set multiple mode.              */
 #define ATA_CMD_FLUSH_CACHE			0xe7 /* Flush cache using LBA 28-bit.   */
 #define ATA_CMD_FLUSH_CACHE_EXT		0xeA /* Flush cache using LBA 48-bit.   */
 	
@@ -163,6 +166,7 @@ struct ata_info
 {
 	unsigned flags;                   /* ATA device flags (see above).*/
 	unsigned nsectors;                /* Number of sectors.           */
+	unsigned multsect;                /* Sectors per DRQ block.       */
 	unsigned type;                    /* Device type (see above).     */
 	uint16_t rawinfo[ATA_INFO_WORDS]; /* Raw, non parsed information. */
 };
@@ -297,6 +301,115 @@ PRIVATE void ata_bus_wait(int bus)
 		/* noop*/ ;
 }
 
+/*
+ * Waits ATA device to request data.
+ */
+PRIVATE int ata_drq_wait(int bus)
+{
+	byte_t status; /* Status register. */
+	
+	while (1)
+	{
+		status = inputb(pio_ports[bus][ATA_REG_ASTATUS]);
+		
+		/* Device busy. */
+		if (status & ATA_BUSY)
+			continue;
+		
+		/* Device error. */
+		if (status & (ATA_ERR | ATA_DF))
+			return (-1);
+		
+		/* Data request. */
+		if (status & ATA_DRQ)
+			return (0);
+	}
+}
+
+/*
+ * Transfers data to/from ATA device in DRQ blocks.
+ */
+PRIVATE void ata_pio
+(unsigned atadevid, unsigned char *buf, size_t size, int wr)
+{
+	int bus;      /* Bus number.          */
+	size_t chunk; /* DRQ block size.      */
+	size_t blksz; /* Bytes per DRQ block. */
+	
+	bus = ata_bus(atadevid);
+	blksz = ata_devices[atadevid].info.multsect << ATA_SECTOR_SIZE_LOG2;
+	
+	for (size_t i = 0; i < size; i += chunk)
+	{
+		chunk = ((size - i) < blksz) ? (size - i) : blksz;
+		
+		/* Device error. */
+		if (ata_drq_wait(bus))
+		{
+			kprintf_ratelimited(KERN_ERR "ATA: device error");
+			return;
+		}
+		
+		if (wr)
+			outputsw(pio_ports[bus][ATA_REG_DATA], buf + i, chunk >> 1);
+		else
+			inputsw(pio_ports[bus][ATA_REG_DATA], buf + i, chunk >> 1);
+		
+		/* Let the device update its status. */
+		ata_delay();
+	}
+}
+
+/*
+ * Enables multiple mode on ATA device.
+ */
+PRIVATE void ata_set_multiple(int atadevid)
+{
+	int bus;                  /* Bus number.             */
+	unsigned max;             /* Maximum multiple count. */
+	unsigned count;           /* Multiple count.         */
+	byte_t status;            /* Status register.        */
+	struct ata_info *devinfo; /* ATA device information. */
+	
+	bus = ata_bus(atadevid);
+	devinfo = &ata_devices[atadevid].info;
+	devinfo->multsect = 1;
+	
+	max = devinfo->rawinfo[ATA_INFO_MAX_MULTSECT] & 0xff;
+	
+	/*
+	 * Largest power of two that does not exceed the
+	 * maximum, nor the largest request we issue.
+	 */
+	for (count = 1; (count << 1) <= max; count <<= 1)
+	{
+		if ((count << 1) > (PAGE_SIZE >> ATA_SECTOR_SIZE_LOG2))
+			break;
+	}
+	
+	/* Multiple mode not supported. */
+	if (count < 2)
+		return;
+	
+	ata_device_select(atadevid);
+	outputb(pio_ports[bus][ATA_REG_NSECT], count);
+	outputb(pio_ports[bus][ATA_REG_CMD], ATA_CMD_SET_MULTIPLE);
+	ata_delay();
+	
+	do
+		status = inputb(pio_ports[bus][ATA_REG_ASTATUS]);
+	while (status & ATA_BUSY);
+	
+	/* Acknowledge IRQ. */
+	inputb(pio_ports[bus][ATA_REG_STATUS]);
+	
+	/* Command aborted. */
+	if (status & (ATA_ERR | ATA_DF))
+		return;
+	
+	devinfo->multsect = count;
+}
+
 /*
  * Sets up PATA device.
  */
@@ -462,13 +575,17 @@ PRIVATE void ata_read_op(unsigned atadevid, struct request *req)
 	outputb(pio_ports[bus][ATA_REG_LBAM], (addr >> 0x08) & 0xff);
 	outputb(pio_ports[bus][ATA_REG_LBAH], (addr >> 0x10) & 0xff);
 
-	outputb(pio_ports[bus][ATA_REG_CMD], ATA_CMD_READ_SECTORS_EXT);
+	/* Transfer many sectors per interrupt. */
+	if (ata_devices[atadevid].info.multsect > 1)
+		outputb(pio_ports[bus][ATA_REG_CMD], ATA_CMD_READ_MULTIPLE_EXT);
+	else
+		outputb(pio_ports[bus][ATA_REG_CMD], ATA_CMD_READ_SECTORS_EXT);
 	ata_bus_wait(bus);
 
 	/* Query return value. */
 	byte = inputb(pio_ports[bus][ATA_REG_ASTATUS]);
 	if (byte & ATA_DF)
-		kprintf("ATA: device error");
+		kprintf_ratelimited(KERN_ERR "ATA: device error");
 }
 
 /*
@@ -477,11 +594,9 @@ PRIVATE void ata_read_op(unsigned atadevid, struct request *req)
 PRIVATE void ata_write_op(unsigned atadevid, struct request *req)
 {
 	int bus;            /* Bus number.         */
-	size_t i;           /* Loop index.         */
 	size_t size;        /* Write size.         */
 	byte_t byte;        /* Byte used for I/O.  */
 	uint64_t addr;      /* LBA 48-bit address. */
-	word_t word;        /* Word used for I/O.  */
 	unsigned char *buf; /* Buffer to use.      */
 	
 	ata_device_select(atadevid);
@@ -522,26 +637,27 @@ PRIVATE void ata_write_op(unsigned atadevid, struct request *req)
 	outputb(pio_ports[bus][ATA_REG_LBAM], (addr >> 0x08) & 0xff);
 	outputb(pio_ports[bus][ATA_REG_LBAH], (addr >> 0x10) & 0xff);
 
-	outputb(pio_ports[bus][ATA_REG_CMD], ATA_CMD_WRITE_SECTORS_EXT);
+	/* Transfer many sectors per interrupt. */
+	if (ata_devices[atadevid].info.multsect > 1)
+		outputb(pio_ports[bus][ATA_REG_CMD], ATA_CMD_WRITE_MULTIPLE_EXT);
+	else
+		outputb(pio_ports[bus][ATA_REG_CMD], ATA_CMD_WRITE_SECTORS_EXT);
 	ata_bus_wait(bus);
 
 	/* Query return value. */
 	byte = inputb(pio_ports[bus][ATA_REG_ASTATUS]);
 	if (byte & ATA_DF)
 	{
-		kprintf("ATA: device error");
+		kprintf_ratelimited(KERN_ERR "ATA: device error");
 		return;
 	}			
 		
 	/* Write block. */
-	for (i = 0; i < size; i += 2)
-	{
-		ata_bus_wait(bus);
-		word = buf[i];
-		word |= buf[i + 1] << 8;
-		outputw(pio_ports[bus][ATA_REG_DATA], word);
-		iowait();
-	}
+	ata_pio(atadevid, buf, size, 1);
+	
+	/* Wait last DRQ block to be written. */
+	while (inputb(pio_ports[bus][ATA_REG_ASTATUS]) & ATA_BUSY)
+		/* noop */ ;
 	
 	/*
 	 * Flushes ATA cache. Note that this will
@@ -839,14 +955,35 @@ PRIVATE ssize_t ata_write(unsigned minor, const char *buf, size_t n, off_t off)
 	return ((ssize_t)i);
 }
 
+/*
+ * Gets the size of a ATA device.
+ */
+PRIVATE ssize_t ata_size(unsigned minor)
+{
+	struct atadev *dev; /* ATA device. */
+	
+	/* Invalid minor device. */
+	if (minor >= 4)
+		return (-EINVAL);
+	
+	dev = &ata_devices[minor];
+	
+	/* Device not valid. */
+	if (!(dev->flags & ATADEV_VALID))
+		return (-EINVAL);
+	
+	return ((ssize_t)(dev->info.nsectors << ATA_SECTOR_SIZE_LOG2));
+}
+
 /*
  * ATA device operations.
  */
 PRIVATE const struct bdev ata_ops = {
-	&ata_read,    /* read()     */
-	&ata_write,   /* write()    */
-	&ata_readblk, /* readblk()  */
-	&ata_writeblk /* writeblk() */
+	&ata_read,     /* read()     */
+	&ata_write,    /* write()    */
+	&ata_readblk,  /* readblk()  */
+	&ata_writeblk, /* writeblk() */
+	&ata_size      /* size()     */
 };
 
 /*
@@ -855,10 +992,8 @@ PRIVATE const struct bdev ata_ops = {
 PRIVATE void ata_handler(int atadevid)
 {
 	int bus;             /* Bus number.    */
-	size_t i;            /* Loop index.    */
 	struct atadev *dev;  /* ATA device.    */
 	struct request *req; /* Request.       */
-	word_t word;         /* Working word.  */
 	size_t size;         /* Write size.    */
 	unsigned char *buf;  /* Buffer to use. */
 	
@@ -930,13 +1065,7 @@ PRIVATE void ata_handler(int atadevid)
 	else
 	{			
 		/* Read block. */
-		for (i = 0; i < size; i += 2)
-		{
-			ata_bus_wait(bus);
-			word = inputw(pio_ports[bus][ATA_REG_DATA]);
-			buf[i] = word & 0xff;
-			buf[i + 1] = (word >> 8) & 0xff;
-		}
+		ata_pio(atadevid, buf, size, 0);
 	}
 	
 	/* Process next operation. */
@@ -979,8 +1108,6 @@ PRIVATE void ata2_handler(void)
 
 /**
  * @brief Initializes the generic ATA device driver.
- * 
- * @todo Check for multiple read/write sectors capability.
  */
 PUBLIC void ata_init(void)
 {
@@ -1018,9 +1145,12 @@ PUBLIC void ata_init(void)
 					kprintf("hd%c: device not found.", dvrl);
 				else
 				{
+					ata_set_multiple(i);
 					kprintf("hd%c: PATA HDD detected.", dvrl);
 					kprintf("hd%c: %d sectors.", dvrl, 
 												ata_devices[i].info.nsectors);
+					kprintf("hd%c: %d sectors per interrupt.", dvrl,
+												ata_devices[i].info.multsect);
 				}
 				break;
 
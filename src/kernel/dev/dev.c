@@ -22,6 +22,7 @@
 #include <dev/klog.h>
 #include <dev/tty.h>
 #include <dev/ramdisk.h>
+#include <dev/virtio.h>
 #include <nanvix/const.h>
 #include <nanvix/dev.h>
 #include <nanvix/klib.h>
@@ -248,6 +249,22 @@ PUBLIC ssize_t bdev_read(dev_t dev, char *buf, size_t n, off_t off)
 	return (bdevsw[MAJOR(dev)]->read(MINOR(dev), buf, n, off));
 }
 
+/*
+ * Gets the size of a block device.
+ */
+PUBLIC ssize_t bdev_size(dev_t dev)
+{
+	/* Invalid device. */
+	if (bdevsw[MAJOR(dev)] == NULL)
+		return (-EINVAL);
+	
+	/* Operation not supported. */
+	if (bdevsw[MAJOR(dev)]->size == NULL)
+		return (-ENOTSUP);
+	
+	return (bdevsw[MAJOR(dev)]->size(MINOR(dev)));
+}
+
 /*
  * Writes a block to a block device.
  */
@@ -311,4 +328,5 @@ PUBLIC void dev_init(void)
 	fpu_init();
 	tty_init();
 	ramdisk_init();
+	virtio_net_init();
 }
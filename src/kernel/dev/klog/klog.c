@@ -35,8 +35,9 @@ PRIVATE struct
 {
 	int head;               /**< First element in the buffer.  */
 	int tail;               /**< Next free slot in the buffer. */
+	int cons;               /**< Next element to be drained.   */
 	char buffer[KLOG_SIZE]; /**< Ring buffer.                  */
-} klog = { 0, 0, {0, }};
+} klog = { 0, 0, 0, {0, }};
 
 /**
  * @brief Writes to kernel log.
@@ -50,6 +51,7 @@ PUBLIC ssize_t klog_write(unsigned minor, const char *buffer, size_t n)
 {
 	int head;      /* Log head.        */
 	int tail;      /* Log tail.        */
+	int cons;      /* Drain pointer.   */
 	const char *p; /* Writing pointer. */
 	
 	UNUSED(minor);
@@ -59,6 +61,7 @@ PUBLIC ssize_t klog_write(unsigned minor, const char *buffer, size_t n)
 	/* Read pointers. */
 	head = klog.head;
 	tail = klog.tail;
+	cons = klog.cons;
 	
 	/* Copy data to ring buffer. */
 	while (n-- > 0)
@@ -68,12 +71,17 @@ PUBLIC ssize_t klog_write(unsigned minor, const char *buffer, size_t n)
 		tail = (tail + 1)&(KLOG_SIZE - 1);
 		
 		if (tail == head)
-			head++;
+			head = (head + 1)&(KLOG_SIZE - 1);
+		
+		/* Overrun, drop oldest undrained character. */
+		if (tail == cons)
+			cons = (cons + 1)&(KLOG_SIZE - 1);
 	}
 	
 	/* Write back pointers. */
 	klog.head = head;
 	klog.tail = tail;
+	klog.cons = cons;
 	
 	return ((ssize_t)(p - buffer));
 }
@@ -108,6 +116,35 @@ PUBLIC ssize_t klog_read(unsigned minor, char *buffer, size_t n)
 	return ((ssize_t)(p - buffer));
 }
 
+/**
+ * @brief Drains the kernel log.
+ * 
+ * @details Reads characters that have been written to the kernel log since
+ *          the last drain, so that they can be sent to the kernel's output
+ *          device. Characters that have been overwritten before being
+ *          drained are lost.
+ * 
+ * @param buffer Buffer where the kernel log should be read to.
+ * @param n      Number of characters to read.
+ * 
+ * @returns The number of characters actually drained from the kernel log.
+ */
+PUBLIC ssize_t klog_drain(char *buffer, size_t n)
+{
+	char *p; /* Reading pointer. */
+	
+	p = buffer;
+	
+	while ((n-- > 0) && (klog.cons != klog.tail))
+	{
+		*p++ = klog.buffer[klog.cons];
+		
+		klog.cons = (klog.cons + 1)&(KLOG_SIZE - 1);
+	}
+	
+	return ((ssize_t)(p - buffer));
+}
+
 /**
  * @brief Dummy open() operation.
  */
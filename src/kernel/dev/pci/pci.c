@@ -0,0 +1,114 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of Nanvix.
+ * 
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nanvix/const.h>
+#include <nanvix/hal.h>
+#include <dev/pci.h>
+#include <stdint.h>
+
+/**
+ * @file
+ * 
+ * @brief PCI configuration space access.
+ * 
+ * @details The configuration space is accessed through configuration
+ *          mechanism #1, which is the one that emulators and chipsets of
+ *          interest implement.
+ */
+
+/**
+ * @name Configuration mechanism ports
+ */
+/**@{*/
+#define PCI_CONFIG_ADDR 0xcf8 /**< Address register. */
+#define PCI_CONFIG_DATA 0xcfc /**< Data register.    */
+/**@}*/
+
+/**
+ * @brief Enables a configuration cycle.
+ */
+#define PCI_ENABLE 0x80000000
+
+/**
+ * @brief Reads a configuration register.
+ * 
+ * @param addr Address of the PCI function.
+ * @param reg  Register offset.
+ * 
+ * @returns The double word that contains the target register, shifted so that
+ *          the register sits in the lower bits.
+ */
+PUBLIC uint32_t pci_read(uint32_t addr, unsigned reg)
+{
+	outputl(PCI_CONFIG_ADDR, PCI_ENABLE | addr | (reg & 0xfc));
+	
+	return (inputl(PCI_CONFIG_DATA) >> ((reg & 3) << 3));
+}
+
+/**
+ * @brief Writes a configuration register.
+ * 
+ * @param addr Address of the PCI function.
+ * @param reg  Register offset (double word aligned).
+ * @param val  Value to be written.
+ */
+PUBLIC void pci_write(uint32_t addr, unsigned reg, uint32_t val)
+{
+	outputl(PCI_CONFIG_ADDR, PCI_ENABLE | addr | (reg & 0xfc));
+	outputl(PCI_CONFIG_DATA, val);
+}
+
+/**
+ * @brief Searches for a PCI function.
+ * 
+ * @param vendor Vendor ID.
+ * @param device Device ID.
+ * @param subsys Subsystem ID, or zero for any.
+ * 
+ * @returns The address of the first function that matches, or PCI_NONE if
+ *          there is none.
+ */
+PUBLIC uint32_t pci_find(uint16_t vendor, uint16_t device, unsigned subsys)
+{
+	uint32_t addr; /* Function address. */
+	uint32_t id;   /* Vendor/device ID. */
+	
+	for (unsigned bus = 0; bus < 256; bus++)
+	{
+		for (unsigned dev = 0; dev < 32; dev++)
+		{
+			addr = PCI_ADDR(bus, dev, 0);
+			
+			/* Empty slot. */
+			if ((id = pci_read(addr, PCI_VENDOR)) == 0xffffffff)
+				continue;
+			
+			if (((id & 0xffff) != vendor) || ((id >> 16) != device))
+				continue;
+			
+			if ((subsys != 0) &&
+				((pci_read(addr, PCI_SUBSYSTEM) & 0xffff) != subsys))
+				continue;
+			
+			return (addr);
+		}
+	}
+	
+	return (PCI_NONE);
+}
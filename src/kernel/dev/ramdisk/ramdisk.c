@@ -158,6 +158,18 @@ PRIVATE int ramdisk_writeblk(unsigned minor, buffer_t buf)
 	return (0);
 }
 
+/*
+ * Gets the size of a RAM disk device.
+ */
+PRIVATE ssize_t ramdisk_size(unsigned minor)
+{
+	/* Invalid minor device. */
+	if (minor >= NR_RAMDISKS)
+		return (-EINVAL);
+	
+	return ((ssize_t)ramdisks[minor].size);
+}
+
 /*
  * RAM disk device driver interface.
  */
@@ -165,7 +177,8 @@ PRIVATE const struct bdev ramdisk_driver = {
 	&ramdisk_read,     /* read()     */
 	&ramdisk_write,    /* write()    */
 	&ramdisk_readblk,  /* readblk()  */
-	&ramdisk_writeblk  /* writeblk() */
+	&ramdisk_writeblk, /* writeblk() */
+	&ramdisk_size      /* size()     */
 };
 
 /*
@@ -366,7 +366,7 @@ PRIVATE ssize_t tty_read(unsigned minor, char *buf, size_t n)
 				/* Case A: MIN>0, TIME>0 */
 				if (TIME_CHAR(tty.term) > 0)
 				{
-					kprintf("tty: MIN>0, TIME>0");
+					kdebug("tty: MIN>0, TIME>0");
 					goto out;
 				}
 				
@@ -395,7 +395,7 @@ PRIVATE ssize_t tty_read(unsigned minor, char *buf, size_t n)
 				/* Case C: MIN=0, TIME>0 */
 				if (TIME_CHAR(tty.term) > 0)
 				{
-					kprintf("tty: MIN=0, TIME>0");
+					kdebug("tty: MIN=0, TIME>0");
 					goto out;
 				}
 				
@@ -0,0 +1,576 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of Nanvix.
+ * 
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nanvix/const.h>
+#include <nanvix/hal.h>
+#include <nanvix/klib.h>
+#include <nanvix/mm.h>
+#include <nanvix/net.h>
+#include <nanvix/pm.h>
+#include <dev/pci.h>
+#include <dev/virtio.h>
+#include <errno.h>
+#include <stdint.h>
+
+/**
+ * @file
+ * 
+ * @brief Virtio network device driver.
+ * 
+ * @details Drives the legacy (virtio 0.9.5) interface of the PCI network
+ *          device. Each ring holds a fixed set of buffers, described by a
+ *          two-descriptor chain: the virtio header and the frame itself.
+ *          Receive buffers are posted back as soon as their frame has been
+ *          copied out, and transmit buffers are reclaimed lazily, when the
+ *          driver runs out of them. Transmit completion interrupts are
+ *          suppressed unless some process waits for a transmit buffer.
+ * 
+ *          The device is reset when the system resumes from hibernation,
+ *          since the rings restored from the image no longer match the
+ *          state of the device.
+ */
+
+/**
+ * @name PCI identification
+ */
+/**@{*/
+#define VIRTIO_VENDOR     0x1af4 /**< Vendor ID.           */
+#define VIRTIO_NET_DEVICE 0x1000 /**< Device ID (legacy). */
+#define VIRTIO_NET_SUBSYS      1 /**< Network device.      */
+/**@}*/
+
+/**
+ * @name Legacy device registers
+ */
+/**@{*/
+#define VIRTIO_HOST_FEATURES  0x00 /**< Device features.  */
+#define VIRTIO_GUEST_FEATURES 0x04 /**< Driver features.  */
+#define VIRTIO_QUEUE_PFN      0x08 /**< Queue address.    */
+#define VIRTIO_QUEUE_NUM      0x0c /**< Queue size.       */
+#define VIRTIO_QUEUE_SEL      0x0e /**< Queue select.     */
+#define VIRTIO_QUEUE_NOTIFY   0x10 /**< Queue notify.     */
+#define VIRTIO_STATUS         0x12 /**< Device status.    */
+#define VIRTIO_ISR            0x13 /**< Interrupt status. */
+#define VIRTIO_NET_MAC        0x14 /**< MAC address.      */
+/**@}*/
+
+/**
+ * @name Device status
+ */
+/**@{*/
+#define VIRTIO_STATUS_ACK       (1 << 0) /**< Device found.   */
+#define VIRTIO_STATUS_DRIVER    (1 << 1) /**< Driver found.   */
+#define VIRTIO_STATUS_DRIVER_OK (1 << 2) /**< Driver ready.   */
+#define VIRTIO_STATUS_FAILED    (1 << 7) /**< Driver gave up. */
+/**@}*/
+
+/**
+ * @brief Device has a MAC address.
+ */
+#define VIRTIO_NET_F_MAC (1 << 5)
+
+/**
+ * @name Ring flags
+ */
+/**@{*/
+#define VRING_DESC_F_NEXT          1 /**< Chained descriptor.        */
+#define VRING_DESC_F_WRITE         2 /**< Device writes buffer.      */
+#define VRING_AVAIL_F_NO_INTERRUPT 1 /**< Driver needs no interrupt. */
+#define VRING_USED_F_NO_NOTIFY     1 /**< Device needs no notify.    */
+/**@}*/
+
+/**
+ * @name Queues
+ */
+/**@{*/
+#define RXQ 0 /**< Receive queue.  */
+#define TXQ 1 /**< Transmit queue. */
+/**@}*/
+
+/**
+ * @brief Largest supported queue size.
+ */
+#define VIRTQ_MAX 256
+
+/**
+ * @brief Size of a ring with room for VIRTQ_MAX descriptors.
+ */
+#define VIRTQ_MEM \
+	(ALIGN(18*VIRTQ_MAX + 6, PAGE_SIZE) + ALIGN(8*VIRTQ_MAX + 6, PAGE_SIZE))
+
+/**
+ * @name Buffers
+ */
+/**@{*/
+#define NR_RXBUFS        32 /**< Number of receive buffers.  */
+#define NR_TXBUFS        32 /**< Number of transmit buffers. */
+#define VIRTIO_BUFSIZE 2048 /**< Size of a frame buffer.     */
+/**@}*/
+
+/**
+ * @brief Physical address of kernel memory.
+ */
+#define PADDR(x) ((addr_t)(x) - KBASE_VIRT)
+
+/**
+ * @brief Forces the compiler to perform memory accesses in order.
+ */
+#define barrier() __asm__ volatile ("" ::: "memory")
+
+/**
+ * @brief Ring descriptor.
+ */
+struct vring_desc
+{
+	uint64_t addr;  /**< Buffer address.  */
+	uint32_t len;   /**< Buffer length.   */
+	uint16_t flags; /**< Flags.           */
+	uint16_t next;  /**< Next descriptor. */
+};
+
+/**
+ * @brief Available ring.
+ */
+struct vring_avail
+{
+	uint16_t flags;  /**< Flags.             */
+	uint16_t idx;    /**< Next free entry.   */
+	uint16_t ring[]; /**< Descriptor chains. */
+};
+
+/**
+ * @brief Used ring entry.
+ */
+struct vring_used_elem
+{
+	uint32_t id;  /**< Descriptor chain. */
+	uint32_t len; /**< Bytes written.    */
+};
+
+/**
+ * @brief Used ring.
+ */
+struct vring_used
+{
+	uint16_t flags;                /**< Flags.           */
+	uint16_t idx;                  /**< Next free entry. */
+	struct vring_used_elem ring[]; /**< Used chains.     */
+};
+
+/**
+ * @brief Network packet header (legacy, without mergeable buffers).
+ */
+struct virtio_net_hdr
+{
+	uint8_t flags;        /**< Flags.                */
+	uint8_t gso_type;     /**< Segmentation offload. */
+	uint16_t hdr_len;     /**< Header length.        */
+	uint16_t gso_size;    /**< Segment size.         */
+	uint16_t csum_start;  /**< Checksum start.       */
+	uint16_t csum_offset; /**< Checksum offset.      */
+};
+
+/**
+ * @brief Virtqueue.
+ */
+struct virtqueue
+{
+	unsigned num;                       /**< Queue size.           */
+	unsigned nbufs;                     /**< Buffers in the ring.  */
+	volatile struct vring_desc *desc;   /**< Descriptor table.     */
+	volatile struct vring_avail *avail; /**< Available ring.       */
+	volatile struct vring_used *used;   /**< Used ring.            */
+	uint16_t lastused;                  /**< Last used entry seen. */
+};
+
+/**
+ * @name Rings
+ */
+/**@{*/
+PRIVATE char rxring[VIRTQ_MEM] __attribute__((aligned(PAGE_SIZE)));
+PRIVATE char txring[VIRTQ_MEM] __attribute__((aligned(PAGE_SIZE)));
+/**@}*/
+
+/**
+ * @name Buffers
+ */
+/**@{*/
+PRIVATE struct virtio_net_hdr rxhdrs[NR_RXBUFS];
+PRIVATE struct virtio_net_hdr txhdrs[NR_TXBUFS];
+PRIVATE char rxbufs[NR_RXBUFS][VIRTIO_BUFSIZE];
+PRIVATE char txbufs[NR_TXBUFS][VIRTIO_BUFSIZE];
+/**@}*/
+
+/**
+ * @brief Receive queue.
+ */
+PRIVATE struct virtqueue rxq;
+
+/**
+ * @brief Transmit queue.
+ */
+PRIVATE struct virtqueue txq;
+
+/**
+ * @brief Free transmit buffers.
+ */
+PRIVATE unsigned txfree[NR_TXBUFS];
+
+/**
+ * @brief Number of free transmit buffers.
+ */
+PRIVATE unsigned ntxfree = 0;
+
+/**
+ * @brief Processes waiting for a transmit buffer.
+ */
+PRIVATE struct process *txchain = NULL;
+
+/**
+ * @brief Base I/O port.
+ */
+PRIVATE uint16_t iobase;
+
+/*============================================================================*
+ *                                 Virtqueues                                 *
+ *============================================================================*/
+
+/**
+ * @brief Sets up a virtqueue.
+ * 
+ * @param vq    Virtqueue.
+ * @param index Queue index.
+ * @param mem   Ring memory.
+ * @param bufs  Frame buffers.
+ * @param hdrs  Packet headers.
+ * @param nbufs Number of buffers.
+ * @param flags Descriptor flags.
+ * 
+ * @returns Upon successful completion, zero is returned. Upon failure, a
+ *          negative error code is returned instead.
+ */
+PRIVATE int virtq_setup
+(struct virtqueue *vq, unsigned index, char *mem, char (*bufs)[VIRTIO_BUFSIZE],
+ struct virtio_net_hdr *hdrs, unsigned nbufs, uint16_t flags)
+{
+	unsigned num; /* Queue size. */
+	
+	outputw(iobase + VIRTIO_QUEUE_SEL, index);
+	num = inputw(iobase + VIRTIO_QUEUE_NUM);
+	
+	/* Unsupported queue size. */
+	if ((num < 2) || (num > VIRTQ_MAX) || (num & (num - 1)))
+		return (-EINVAL);
+	
+	kmemset(mem, 0, VIRTQ_MEM);
+	vq->num = num;
+	vq->nbufs = (nbufs < num/2) ? nbufs : num/2;
+	vq->desc = (struct vring_desc *)mem;
+	vq->avail = (struct vring_avail *)(mem + 16*num);
+	vq->used = (struct vring_used *)(mem + ALIGN(18*num + 6, PAGE_SIZE));
+	vq->lastused = 0;
+	
+	/* Chain header and frame descriptors. */
+	for (unsigned i = 0; i < vq->nbufs; i++)
+	{
+		vq->desc[2*i].addr = PADDR(&hdrs[i]);
+		vq->desc[2*i].len = sizeof(struct virtio_net_hdr);
+		vq->desc[2*i].flags = flags | VRING_DESC_F_NEXT;
+		vq->desc[2*i].next = 2*i + 1;
+		vq->desc[2*i + 1].addr = PADDR(bufs[i]);
+		vq->desc[2*i + 1].len = VIRTIO_BUFSIZE;
+		vq->desc[2*i + 1].flags = flags;
+	}
+	
+	outputl(iobase + VIRTIO_QUEUE_PFN, PADDR(mem) >> PAGE_SHIFT);
+	
+	return (0);
+}
+
+/**
+ * @brief Makes a buffer available to the device.
+ * 
+ * @param vq Virtqueue.
+ * @param i  Buffer number.
+ */
+PRIVATE void virtq_post(struct virtqueue *vq, unsigned i)
+{
+	vq->avail->ring[vq->avail->idx & (vq->num - 1)] = 2*i;
+	barrier();
+	vq->avail->idx++;
+}
+
+/**
+ * @brief Notifies the device about new available buffers.
+ * 
+ * @param vq    Virtqueue.
+ * @param index Queue index.
+ */
+PRIVATE void virtq_kick(struct virtqueue *vq, unsigned index)
+{
+	barrier();
+	
+	/* Device is polling the ring. */
+	if (vq->used->flags & VRING_USED_F_NO_NOTIFY)
+		return;
+	
+	outputw(iobase + VIRTIO_QUEUE_NOTIFY, index);
+}
+
+/*============================================================================*
+ *                                Network Device                              *
+ *============================================================================*/
+
+/**
+ * @brief Reclaims transmit buffers that the device is done with.
+ */
+PRIVATE void virtio_net_reclaim(void)
+{
+	unsigned id; /* Buffer number. */
+	
+	while (txq.lastused != txq.used->idx)
+	{
+		barrier();
+		id = txq.used->ring[txq.lastused & (txq.num - 1)].id/2;
+		txfree[ntxfree++] = id;
+		txq.lastused++;
+	}
+}
+
+/**
+ * @brief Sends a frame.
+ * 
+ * @param frame Frame.
+ * @param len   Length of the frame.
+ * 
+ * @returns Upon successful completion, zero is returned. Upon failure, a
+ *          negative error code is returned instead.
+ */
+PRIVATE int virtio_net_send(const void *frame, size_t len)
+{
+	unsigned i; /* Buffer number. */
+	
+	/* Frame too large. */
+	if (len > VIRTIO_BUFSIZE)
+		return (-EINVAL);
+	
+	/* Wait for a transmit buffer. */
+	disable_interrupts();
+	virtio_net_reclaim();
+	while (ntxfree == 0)
+	{
+		txq.avail->flags = 0;
+		virtio_net_reclaim();
+		if (ntxfree > 0)
+			break;
+		sleep(&txchain, PRIO_IO);
+		virtio_net_reclaim();
+	}
+	txq.avail->flags = VRING_AVAIL_F_NO_INTERRUPT;
+	enable_interrupts();
+	
+	i = txfree[--ntxfree];
+	kmemcpy(txbufs[i], frame, len);
+	txq.desc[2*i + 1].len = len;
+	
+	virtq_post(&txq, i);
+	virtq_kick(&txq, TXQ);
+	
+	return (0);
+}
+
+/**
+ * @brief Receives a frame.
+ * 
+ * @param frame Where the frame should be stored.
+ * @param n     Size of the buffer.
+ * 
+ * @returns The length of the received frame, or zero if there is none.
+ */
+PRIVATE ssize_t virtio_net_recv(void *frame, size_t n)
+{
+	size_t len;                         /* Frame length.  */
+	unsigned id;                        /* Buffer number. */
+	volatile struct vring_used_elem *e; /* Used entry.    */
+	
+	while (rxq.lastused != rxq.used->idx)
+	{
+		barrier();
+		e = &rxq.used->ring[rxq.lastused & (rxq.num - 1)];
+		id = e->id/2;
+		len = e->len;
+		rxq.lastused++;
+		
+		/* Runt frame, drop it. */
+		if (len <= sizeof(struct virtio_net_hdr))
+		{
+			virtq_post(&rxq, id);
+			virtq_kick(&rxq, RXQ);
+			continue;
+		}
+		
+		len -= sizeof(struct virtio_net_hdr);
+		if (len > n)
+			len = n;
+		kmemcpy(frame, rxbufs[id], len);
+		
+		virtq_post(&rxq, id);
+		virtq_kick(&rxq, RXQ);
+		
+		return (len);
+	}
+	
+	/* No frame. */
+	return (0);
+}
+
+/**
+ * @brief Resets the device and sets up its queues.
+ * 
+ * @returns Upon successful completion, zero is returned. Upon failure, a
+ *          negative error code is returned instead.
+ */
+PRIVATE int virtio_net_reset(void)
+{
+	uint32_t features; /* Device features. */
+	
+	/* Reset and acknowledge device. */
+	outputb(iobase + VIRTIO_STATUS, 0);
+	outputb(iobase + VIRTIO_STATUS, VIRTIO_STATUS_ACK);
+	outputb(iobase + VIRTIO_STATUS, VIRTIO_STATUS_ACK | VIRTIO_STATUS_DRIVER);
+	
+	features = inputl(iobase + VIRTIO_HOST_FEATURES);
+	outputl(iobase + VIRTIO_GUEST_FEATURES, features & VIRTIO_NET_F_MAC);
+	
+	/* Failed to set up queues. */
+	if ((virtq_setup(&rxq, RXQ, rxring, rxbufs, rxhdrs, NR_RXBUFS,
+			VRING_DESC_F_WRITE)) ||
+		(virtq_setup(&txq, TXQ, txring, txbufs, txhdrs, NR_TXBUFS, 0)))
+	{
+		outputb(iobase + VIRTIO_STATUS, VIRTIO_STATUS_FAILED);
+		return (-EINVAL);
+	}
+	
+	/* Fill rings. */
+	for (unsigned i = 0; i < rxq.nbufs; i++)
+		virtq_post(&rxq, i);
+	ntxfree = 0;
+	for (unsigned i = 0; i < txq.nbufs; i++)
+		txfree[ntxfree++] = i;
+	txq.avail->flags = VRING_AVAIL_F_NO_INTERRUPT;
+	
+	outputb(iobase + VIRTIO_STATUS,
+		VIRTIO_STATUS_ACK | VIRTIO_STATUS_DRIVER | VIRTIO_STATUS_DRIVER_OK);
+	virtq_kick(&rxq, RXQ);
+	
+	return (0);
+}
+
+/**
+ * @brief Resumes the device after hibernation.
+ * 
+ * @details Frames that were in flight are lost, and processes waiting for a
+ *          transmit buffer are woken up, since all of them are free again.
+ */
+PRIVATE void virtio_net_resume(void)
+{
+	disable_interrupts();
+	
+	if (virtio_net_reset())
+		kprintf("virtio-net: failed to resume device");
+	
+	enable_interrupts();
+	
+	wakeup(&txchain);
+}
+
+/**
+ * @brief Virtio network device.
+ */
+PRIVATE struct netdev virtio_net = {
+	{ 0x52, 0x54, 0x00, 0x12, 0x34, 0x56 },
+	&virtio_net_send,
+	&virtio_net_recv,
+	&virtio_net_resume
+};
+
+/**
+ * @brief Handles a virtio network device interrupt.
+ */
+PRIVATE void virtio_net_handler(void)
+{
+	/* Reading the ISR acknowledges the interrupt. */
+	if (!(inputb(iobase + VIRTIO_ISR) & 1))
+		return;
+	
+	net_wakeup();
+	wakeup(&txchain);
+}
+
+/**
+ * @brief Initializes the virtio network device driver.
+ */
+PUBLIC void virtio_net_init(void)
+{
+	uint32_t pci; /* PCI function.   */
+	uint32_t bar; /* Base address.   */
+	unsigned irq; /* Interrupt line. */
+	
+	/* Device not found. */
+	if ((pci = pci_find(VIRTIO_VENDOR, VIRTIO_NET_DEVICE, VIRTIO_NET_SUBSYS))
+		== PCI_NONE)
+		return;
+	
+	/* Not an I/O port base address. */
+	if (!((bar = pci_read(pci, PCI_BAR0)) & 1))
+	{
+		kprintf("virtio-net: no I/O ports");
+		return;
+	}
+	
+	iobase = bar & 0xfffc;
+	irq = pci_read(pci, PCI_IRQ_LINE) & 0xff;
+	pci_write(pci, PCI_COMMAND, (pci_read(pci, PCI_COMMAND) & 0xffff) |
+		PCI_COMMAND_IO | PCI_COMMAND_MASTER);
+	
+	/* Failed to register interrupt handler. */
+	if ((irq > 15) || (set_hwint(irq, &virtio_net_handler)))
+		goto error;
+	
+	/* Failed to set up device. */
+	if (virtio_net_reset())
+		goto error;
+	
+	if (inputl(iobase + VIRTIO_HOST_FEATURES) & VIRTIO_NET_F_MAC)
+	{
+		for (unsigned i = 0; i < ETH_ALEN; i++)
+			virtio_net.mac[i] = inputb(iobase + VIRTIO_NET_MAC + i);
+	}
+	
+	netdev_register(&virtio_net);
+	
+	kprintf("virtio-net: irq %d, %d rx and %d tx buffers",
+		irq, rxq.nbufs, txq.nbufs);
+	
+	return;
+
+error:
+	outputb(iobase + VIRTIO_STATUS, VIRTIO_STATUS_FAILED);
+	kprintf("virtio-net: failed to set up device");
+}
@@ -84,7 +84,7 @@ found:
 	sb->flags |= SUPERBLOCK_DIRTY;
 	
 	/* Clean block to avoid security issues. */
-	buf = bread(sb->dev, blk);	
+	buf = bread(sb->dev, num);
 	kmemset(buf->data, 0, BLOCK_SIZE);
 	buf->flags |= BUFFER_DIRTY;
 	brelse(buf);
@@ -92,6 +92,42 @@ found:
 	return (num);
 }
 
+/**
+ * @brief Gets a free disk block.
+ * 
+ * @details Allocates a disk block in the file system that is associated to the
+ *          superblock pointed to by @p sb. If the file system is full but some
+ *          blocks are pending reclaim, the reclaim queue is flushed and the
+ *          allocation is retried.
+ * 
+ * @param sb Superblock in which the disk block should be allocated.
+ * 
+ * @return Upon successful completion, the block number of the allocated block
+ *         is returned. Upon failed, #BLOCK_NULL is returned instead.
+ * 
+ * @note The superblock must not be locked.
+ */
+PRIVATE block_t block_get(struct superblock *sb)
+{
+	block_t num; /* Block number. */
+	
+	superblock_lock(sb);
+	num = block_alloc(sb);
+	superblock_unlock(sb);
+	
+	/* Wait for pending blocks. */
+	if ((num == BLOCK_NULL) && (sb->zpending > 0))
+	{
+		reclaim_flush();
+		
+		superblock_lock(sb);
+		num = block_alloc(sb);
+		superblock_unlock(sb);
+	}
+	
+	return (num);
+}
+
 /**
  * @brief Frees a direct disk block.
  * 
@@ -232,31 +268,167 @@ PUBLIC void block_free(struct superblock *sb, block_t num, int lvl)
 	}
 }
 
+/**
+ * @brief Moves inline data to a disk block.
+ * 
+ * @details Allocates a disk block for the inode pointed to by @p ip, and moves
+ *          the inline data of the inode to it, so that the file can grow past
+ *          #MINIX_INLINE_MAX bytes.
+ * 
+ * @param ip Inode whose inline data shall be moved.
+ * 
+ * @returns Upon successful completion, zero is returned. Upon failure, a
+ *          negative error code is returned instead and the inode is left
+ *          untouched.
+ * 
+ * @note @p ip must be locked.
+ */
+PUBLIC int block_spill(struct inode *ip)
+{
+	block_t phys;       /* Physical block number. */
+	struct buffer *buf; /* Underlying buffer.     */
+	
+	/* Empty file, no data to move. */
+	if (ip->size == 0)
+		goto out;
+	
+	phys = block_get(ip->sb);
+	
+	/* Failed to allocate block. */
+	if (phys == BLOCK_NULL)
+		return (-ENOSPC);
+	
+	buf = bread(ip->dev, phys);
+	kmemcpy(buf->data, ip->blocks, ip->size);
+	bdirty(buf, ip);
+	brelse(buf);
+	
+	for (unsigned i = 0; i < NR_ZONES; i++)
+		ip->blocks[i] = BLOCK_NULL;
+	ip->blocks[0] = phys;
+
+out:
+	ip->flags &= ~INODE_INLINE;
+	ip->flags |= INODE_DSYNC;
+	inode_touch(ip);
+	
+	return (0);
+}
+
+/**
+ * @brief Maps a zone of an inode.
+ * 
+ * @details Gets the disk block number of the zone @p zone of the inode pointed
+ *          to by @p ip. If @p create is not zero and the zone is empty, a new
+ *          disk block is allocated for it.
+ * 
+ * @param ip     File to use.
+ * @param zone   Zone number.
+ * @param create Create zone?
+ * 
+ * @returns The disk block number of the zone, which may be #BLOCK_NULL.
+ * 
+ * @note @p ip must be locked.
+ */
+PRIVATE block_t block_map_zone(struct inode *ip, unsigned zone, int create)
+{
+	block_t phys; /* Physical block number. */
+	
+	/* Create block. */
+	if (ip->blocks[zone] == BLOCK_NULL && create)
+	{
+		phys = block_get(ip->sb);
+		
+		if (phys != BLOCK_NULL)
+		{
+			ip->blocks[zone] = phys;
+			ip->flags |= INODE_DSYNC;
+			inode_touch(ip);
+		}
+	}
+	
+	return (ip->blocks[zone]);
+}
+
+/**
+ * @brief Maps an entry of an indirect disk block.
+ * 
+ * @details Gets the disk block number stored in the entry @p idx of the
+ *          indirect disk block @p num of the inode pointed to by @p ip. If
+ *          @p create is not zero and the entry is empty, a new disk block is
+ *          allocated for it.
+ * 
+ * @param ip     File to use.
+ * @param num    Indirect disk block number.
+ * @param idx    Entry in the indirect disk block.
+ * @param create Create entry?
+ * 
+ * @returns The disk block number stored in the entry, which may be
+ *          #BLOCK_NULL.
+ * 
+ * @note @p ip must be locked.
+ */
+PRIVATE block_t block_map_indirect
+(struct inode *ip, block_t num, unsigned idx, int create)
+{
+	block_t phys;       /* Physical block number. */
+	struct buffer *buf; /* Underlying buffer.     */
+	
+	/* We cannot go any further. */
+	if (num == BLOCK_NULL)
+		return (BLOCK_NULL);
+	
+	buf = bread(ip->dev, num);
+	
+	/* Create block. */
+	if (((block_t *)buf->data)[idx] == BLOCK_NULL && create)
+	{
+		phys = block_get(ip->sb);
+		
+		if (phys != BLOCK_NULL)
+		{
+			((block_t *)buf->data)[idx] = phys;
+			bdirty(buf, ip);
+			inode_touch(ip);
+		}
+	}
+	
+	phys = ((block_t *)buf->data)[idx];
+	brelse(buf);
+	
+	return (phys);
+}
+
 /**
  * @brief Maps a file byte offset in a disk block number.
  * 
  * @details Maps the offset @p off in the file pointed to by @p ip in a disk
- *          block number. If @p create is not zero and such file by offset is
- *          invalid, the file is expanded accordingly to make it valid.
+ *          block number. If @p create is not zero and no disk block backs
+ *          such offset, disk blocks are allocated to make it valid. Otherwise,
+ *          offsets that fall in a hole of the file are not backed by any disk
+ *          block, and these read as zeros.
  * 
  * @param ip     File to use
  * @param off    File byte offset.
  * @param create Create offset?
  * 
  * @returns Upon successful completion, the disk block number that is associated
- *          with the file byte offset is returned. Upon failure, #BLOCK_NULL is
- *          returned instead.
+ *          with the file byte offset is returned. Upon failure, or if the
+ *          offset falls in a hole, #BLOCK_NULL is returned instead.
  * 
  * @note @p ip must be locked.
  */
 PUBLIC block_t block_map(struct inode *ip, off_t off, int create)
 {
-	block_t phys;       /* Physical block number. */
-	block_t logic;      /* Logical block number.  */
-	struct buffer *buf; /* Underlying buffer.     */
+	block_t phys;   /* Physical block number. */
+	unsigned logic; /* Logical block number.  */
 	
 	logic = off/BLOCK_SIZE;
 	
+	/* Inline data has no blocks. */
+	if (ip->flags & INODE_INLINE)
+		return (BLOCK_NULL);
+	
 	/* File offset too big. */
 	if (off >= ip->sb->max_size)
 	{
@@ -264,82 +436,30 @@ PUBLIC block_t block_map(struct inode *ip, off_t off, int create)
 		return (BLOCK_NULL);
 	}
 	
-	/* 
-	 * Create blocks that are
-	 * in a valid offset.
-	 */
-	if (off < ip->size)
-		create = 1;
-	
 	/* Direct block. */
 	if (logic < NR_ZONES_DIRECT)
-	{
-		/* Create direct block. */
-		if (ip->blocks[logic] == BLOCK_NULL && create)
-		{
-			superblock_lock(ip->sb);
-			phys = block_alloc(ip->sb);
-			superblock_unlock(ip->sb);
-			
-			if (phys != BLOCK_NULL)
-			{
-				ip->blocks[logic] = phys;
-				inode_touch(ip);
-			}
-		}
-		
-		return (ip->blocks[logic]);
-	}
+		return (block_map_zone(ip, ZONE_DIRECT + logic, create));
 	
 	logic -= NR_ZONES_DIRECT;
 	
 	/* Single indirect block. */
 	if (logic < NR_SINGLE)
 	{
-		/* Create single indirect block. */
-		if (ip->blocks[ZONE_SINGLE] == BLOCK_NULL && create)
-		{
-			superblock_lock(ip->sb);
-			phys = block_alloc(ip->sb);
-			superblock_unlock(ip->sb);
-			
-			if (phys != BLOCK_NULL)
-			{
-				ip->blocks[ZONE_SINGLE] = phys;
-				inode_touch(ip);
-			}
-		}
-		
-		/* We cannot go any further. */
-		if ((phys = ip->blocks[ZONE_SINGLE]) == BLOCK_NULL)
-			return (BLOCK_NULL);
-	
-		buf = bread(ip->dev, phys);
-		
-		/* Create direct block. */
-		if (((block_t *)buf->data)[logic] == BLOCK_NULL && create)
-		{
-			superblock_lock(ip->sb);
-			phys = block_alloc(ip->sb);
-			superblock_unlock(ip->sb);
-			
-			if (phys != BLOCK_NULL)
-			{
-				((block_t *)buf->data)[logic] = phys;
-				buf->flags |= BUFFER_DIRTY;
-				inode_touch(ip);
-			}
-		}
-		
-		brelse(buf);
-		
-		return (((block_t *)buf->data)[logic]);
+		phys = block_map_zone(ip, ZONE_SINGLE, create);
+		return (block_map_indirect(ip, phys, logic, create));
 	}
 	
 	logic -= NR_SINGLE;
 	
-	/* Double indirect zone. */
-	kpanic("double indirect zones not supported yet");
+	/* Double indirect block. */
+	if (logic < NR_DOUBLE)
+	{
+		phys = block_map_zone(ip, ZONE_DOUBLE, create);
+		phys = block_map_indirect(ip, phys, logic/NR_SINGLE, create);
+		return (block_map_indirect(ip, phys, logic%NR_SINGLE, create));
+	}
+	
+	curr_proc->errno = -EFBIG;
 	
 	return (BLOCK_NULL);
 }
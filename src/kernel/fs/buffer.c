@@ -75,6 +75,15 @@ PRIVATE struct process *chain = NULL;
  */
 PRIVATE struct buffer hashtab[BUFFERS_HASHTAB_SIZE];
 
+/**
+ * @brief Block buffer cache hits.
+ */
+PRIVATE unsigned hits = 0;
+
+/**
+ * @brief Block buffer cache misses.
+ */
+PRIVATE unsigned misses = 0;
 
 /**
  * @brief Hash function for block buffer hash table.
@@ -85,6 +94,27 @@ PRIVATE struct buffer hashtab[BUFFERS_HASHTAB_SIZE];
 #define HASH(dev, block) \
 	(((dev)^(block))%BUFFERS_HASHTAB_SIZE)
 
+/**
+ * @brief Removes a block buffer from the dirty list of its owner.
+ * 
+ * @param buf Block buffer to be removed.
+ * 
+ * @note Interrupts must be disabled.
+ */
+PRIVATE void buffer_unlink(struct buffer *buf)
+{
+	if (buf->dirty_prev != NULL)
+		buf->dirty_prev->dirty_next = buf->dirty_next;
+	else
+		buf->owner->dirty = buf->dirty_next;
+	if (buf->dirty_next != NULL)
+		buf->dirty_next->dirty_prev = buf->dirty_prev;
+	
+	buf->owner = NULL;
+	buf->dirty_next = NULL;
+	buf->dirty_prev = NULL;
+}
+
 /**
  * @brief Gets a block buffer from the block buffer cache.
  * 
@@ -150,7 +180,7 @@ repeat:
 	 */
 	if (&free_buffers == free_buffers.free_next)
 	{
-		kprintf("fs: no free buffers");
+		kprintf_ratelimited(KERN_WARN "fs: no free buffers");
 		sleep(&chain, PRIO_BUFFER);
 		goto repeat;
 	}
@@ -254,6 +284,10 @@ PUBLIC void brelse(struct buffer *buf)
 	if (buf->count == 0)
 		kpanic("freeing buffer twice");
 	
+	/* Buffer has been written back. */
+	if ((buf->owner != NULL) && !(buf->flags & BUFFER_DIRTY))
+		buffer_unlink(buf);
+	
 	/* No more references. */
 	if (--buf->count == 0)
 	{
@@ -311,8 +345,12 @@ PUBLIC struct buffer *bread(dev_t dev, block_t num)
 	
 	/* Valid buffer? */
 	if (buf->flags & BUFFER_VALID)
+	{
+		hits++;
 		return (buf);
+	}
 
+	misses++;
 	bdev_readblk(buf);
 	
 	/* Update buffer flags. */
@@ -391,6 +429,131 @@ PUBLIC void bsync(void)
 	}
 }
 
+/**
+ * @brief Marks a block buffer as dirty on behalf of an inode.
+ * 
+ * @details Sets the dirty flag of the block buffer pointed to by @p buf and
+ *          inserts it in the dirty list of the inode pointed to by @p ip, so
+ *          that it can be written back by bfsync().
+ * 
+ * @param buf Block buffer to be marked as dirty.
+ * @param ip  Inode that owns the block buffer.
+ * 
+ * @note The block buffer must be locked.
+ */
+PUBLIC void bdirty(struct buffer *buf, struct inode *ip)
+{
+	buf->flags |= BUFFER_DIRTY;
+	
+	/* Already in the dirty list. */
+	if (buf->owner == ip)
+		return;
+	
+	disable_interrupts();
+	
+	if (buf->owner != NULL)
+		buffer_unlink(buf);
+	
+	/* Insert buffer in the dirty list. */
+	buf->owner = ip;
+	buf->dirty_prev = NULL;
+	buf->dirty_next = ip->dirty;
+	if (ip->dirty != NULL)
+		ip->dirty->dirty_prev = buf;
+	ip->dirty = buf;
+	
+	enable_interrupts();
+}
+
+/**
+ * @brief Empties the dirty list of an inode.
+ * 
+ * @details Removes all block buffers from the dirty list of the inode pointed
+ *          to by @p ip. The buffers are kept dirty, and they will be written
+ *          back by bsync() or when evicted from the block buffer cache.
+ * 
+ * @param ip Inode whose dirty list shall be emptied.
+ */
+PUBLIC void bdisown(struct inode *ip)
+{
+	disable_interrupts();
+	
+	while (ip->dirty != NULL)
+		buffer_unlink(ip->dirty);
+	
+	enable_interrupts();
+}
+
+/**
+ * @brief Synchronizes the dirty block buffers of an inode.
+ * 
+ * @details Writes back all block buffers in the dirty list of the inode
+ *          pointed to by @p ip, in ascending block number order, and waits
+ *          for the writes to complete.
+ * 
+ * @param ip Inode whose dirty buffers shall be written back.
+ */
+PUBLIC void bfsync(struct inode *ip)
+{
+	unsigned n;           /* Number of buffers. */
+	struct buffer *buf;   /* Working buffer.    */
+	struct buffer **bufs; /* Dirty buffers.     */
+	
+	/* Fall back to a full synchronization. */
+	if ((bufs = getkpg(0)) == NULL)
+	{
+		bsync();
+		return;
+	}
+	
+	/*
+	 * Take two references to each buffer: one is dropped
+	 * by bwrite(), and the other keeps the buffer from being
+	 * evicted until its write has completed.
+	 */
+	n = 0;
+	disable_interrupts();
+	for (buf = ip->dirty; buf != NULL; buf = buf->dirty_next)
+	{
+		if (buf->count == 0)
+		{
+			buf->free_prev->free_next = buf->free_next;
+			buf->free_next->free_prev = buf->free_prev;
+		}
+		buf->count += 2;
+		
+		bufs[n++] = buf;
+	}
+	enable_interrupts();
+	
+	/* Sort buffers by block number. */
+	for (unsigned i = 1; i < n; i++)
+	{
+		unsigned j;
+		
+		buf = bufs[i];
+		for (j = i; (j > 0) && (bufs[j - 1]->num > buf->num); j--)
+			bufs[j] = bufs[j - 1];
+		bufs[j] = buf;
+	}
+	
+	/* Write buffers. */
+	for (unsigned i = 0; i < n; i++)
+	{
+		blklock(bufs[i]);
+		bwrite(bufs[i]);
+	}
+	
+	/* Wait for writes to complete. */
+	for (unsigned i = 0; i < n; i++)
+	{
+		blklock(bufs[i]);
+		brelse(bufs[i]);
+	}
+	
+	putkpg(bufs);
+}
+
 /**
  * @brief Sets/clears buffer's dirty flag.
  * 
@@ -473,6 +636,31 @@ PUBLIC inline int buffer_is_sync(const struct buffer *buf)
 	return (buf->flags & BUFFER_SYNC);
 }
 
+/**
+ * @brief Gets block buffer cache statistics.
+ * 
+ * @param st Store location for statistics.
+ */
+PUBLIC void buffer_stat(struct bcache_stat *st)
+{
+	st->nbuffers = NR_BUFFERS;
+	st->nvalid = st->ndirty = st->nbusy = st->nlocked = 0;
+	st->hits = hits;
+	st->misses = misses;
+	
+	for (struct buffer *buf = &buffers[0]; buf < &buffers[NR_BUFFERS]; buf++)
+	{
+		if (buf->flags & BUFFER_VALID)
+			st->nvalid++;
+		if (buf->flags & BUFFER_DIRTY)
+			st->ndirty++;
+		if (buf->count > 0)
+			st->nbusy++;
+		if (buf->flags & BUFFER_LOCKED)
+			st->nlocked++;
+	}
+}
+
 /**
  * @brief Initializes the bock buffer cache.
  * 
@@ -504,6 +692,9 @@ PUBLIC void binit(void)
 			(i == 0) ? &free_buffers : &buffers[i - 1];
 		buffers[i].hash_next = &buffers[i];
 		buffers[i].hash_prev = &buffers[i];
+		buffers[i].owner = NULL;
+		buffers[i].dirty_next = NULL;
+		buffers[i].dirty_prev = NULL;
 		
 		ptr += BLOCK_SIZE;
 	}
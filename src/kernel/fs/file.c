@@ -30,13 +30,15 @@
  * @brief Searches for a directory entry.
  * 
  * @details Searches for a directory entry named @p filename in the directory
- *          pointed to be @p dip. If @p create is not zero and such file entry
- *          does not exist, the entry is created.
+ *          pointed to be @p dip. While doing so, the index of the first free
+ *          directory entry is remembered, so that a subsequent creation does
+ *          not need to walk the directory again.
  * 
  * @param dip      Directory where the directory entry shall be searched.
  * @param filename Name of the directory entry that shall be searched.
  * @param buf      Buffer where the directory entry is loaded.
- * @param create   Create directory entry?
+ * @param slot     Where to store the index of the first free directory entry,
+ *                 or #DIRENT_APPEND if there is none. May be #NULL.
  * 
  * @returns Upon successful completion, the directory entry is returned. In this
  *          case, @p buf is set to point to the (locked) buffer associated to
@@ -48,7 +50,7 @@
  * @note @p buf must point to a valid location
  */
 PRIVATE struct d_dirent *dirent_search
-(struct inode *dip, const char *filename, struct buffer **buf, int create)
+(struct inode *dip, const char *filename, struct buffer **buf, int *slot)
 {
 	int i;              /* Working directory entry index.       */
 	int entry;          /* Index of first free directory entry. */
@@ -60,7 +62,7 @@ PRIVATE struct d_dirent *dirent_search
 	
 	/* Search from very first block. */
 	i = 0;
-	entry = -1;
+	entry = DIRENT_APPEND;
 	blk = dip->blocks[0];		
 	(*buf) = NULL;
 	d = NULL;
@@ -100,21 +102,11 @@ PRIVATE struct d_dirent *dirent_search
 		{
 			/* Found */
 			if (!kstrncmp(d->d_name, filename, NAME_MAX))
-			{
-				/* Duplicated entry. */
-				if (create)
-				{
-					brelse((*buf));
-					d = NULL;
-					curr_proc->errno = EEXIST;
-				}
-				
 				return (d);
-			}
 		}
 
-		/* Remember entry index. */
-		else
+		/* Remember first free entry. */
+		else if (entry == DIRENT_APPEND)
 			entry = i;
 		
 		d++; i++;	
@@ -127,38 +119,63 @@ PRIVATE struct d_dirent *dirent_search
 		(*buf) = NULL;
 	}
 	
-	/* Create entry. */
-	if (create)
+	if (slot != NULL)
+		*slot = entry;
+	
+	return (NULL);
+}
+
+/**
+ * @brief Gets a free directory entry.
+ * 
+ * @details Gets the free directory entry @p slot of the directory pointed to
+ *          by @p dip, as found by dirent_search(). If @p slot is
+ *          #DIRENT_APPEND, the directory is expanded instead.
+ * 
+ * @param dip  Directory where the directory entry shall be created.
+ * @param slot Index of the free directory entry.
+ * @param buf  Buffer where the directory entry is loaded.
+ * 
+ * @returns Upon successful completion, the directory entry is returned. In this
+ *          case, @p buf is set to point to the (locked) buffer associated to
+ *          the directory entry. However, upon failure, a #NULL pointer is
+ *          returned instead.
+ * 
+ * @note @p dip must be locked, and must not have changed since @p slot was
+ *       found.
+ * @note @p buf must point to a valid location
+ */
+PRIVATE struct d_dirent *dirent_alloc
+(struct inode *dip, int slot, struct buffer **buf)
+{
+	block_t blk; /* Working block number. */
+	
+	/* Expand directory. */
+	if (slot == DIRENT_APPEND)
 	{
-		/* Expand directory. */
-		if (entry < 0)
-		{
-			entry = nentries;
-			
-			blk = block_map(dip, entry*sizeof(struct d_dirent), 1);
-			
-			/* Failed to create entry. */
-			if (blk == BLOCK_NULL)
-			{
-				curr_proc->errno = -ENOSPC;
-				return (NULL);
-			}
-			
-			dip->size += sizeof(struct d_dirent);
-			inode_touch(dip);
-		}
+		slot = dip->size/sizeof(struct d_dirent);
 		
-		else
-			blk = block_map(dip, entry*sizeof(struct d_dirent), 0);
+		blk = block_map(dip, slot*sizeof(struct d_dirent), 1);
 		
-		(*buf) = bread(dip->dev, blk);
-		entry %= (BLOCK_SIZE/sizeof(struct d_dirent));
-		d = &((struct d_dirent *)((*buf)->data))[entry];
+		/* Failed to create entry. */
+		if (blk == BLOCK_NULL)
+		{
+			curr_proc->errno = -ENOSPC;
+			return (NULL);
+		}
 		
-		return (d);
+		dip->size += sizeof(struct d_dirent);
+		dip->flags |= INODE_DSYNC;
+		inode_touch(dip);
 	}
 	
-	return (NULL);
+	else
+		blk = block_map(dip, slot*sizeof(struct d_dirent), 0);
+	
+	(*buf) = bread(dip->dev, blk);
+	slot %= (BLOCK_SIZE/sizeof(struct d_dirent));
+	
+	return (&((struct d_dirent *)((*buf)->data))[slot]);
 }
 
 /**
@@ -178,18 +195,52 @@ PRIVATE struct d_dirent *dirent_search
  * @note @p filename must point to a valid location.
  */
 PUBLIC ino_t dir_search(struct inode *ip, const char *filename)
+{
+	return (dir_lookup(ip, filename, NULL));
+}
+
+/**
+ * @brief Searches for a file in a directory, or for room to create it.
+ * 
+ * @details Searches for a file named @p filename in the directory pointed to
+ *          by @p ip, in a single walk that also finds where such file should
+ *          be added, if it does not exist.
+ * 
+ * @param ip       Inode where the file that shall be searched.
+ * @param filename Name of the file that shall be searched.
+ * @param slot     Where to store the directory entry that dir_add_slot()
+ *                 should use. May be #NULL.
+ * 
+ * @returns If the requested file exists in the directory, than its inode number
+ *          is returned. However, if the file does not exist #INODE_NULL is 
+ *          is returned instead, and @p slot is set.
+ * 
+ * @note @p ip must be locked.
+ * @note @p filename must point to a valid location.
+ */
+PUBLIC ino_t dir_lookup(struct inode *ip, const char *filename, int *slot)
 {
 	struct buffer *buf; /* Block buffer.    */
 	struct d_dirent *d; /* Directory entry. */
+	ino_t num;          /* Inode number.    */
+	
+	/* Process file system. */
+	if (ip->dev == PROC_DEV)
+	{
+		if (slot != NULL)
+			*slot = DIRENT_APPEND;
+		return (procfs_lookup(ip, filename));
+	}
 	
 	/* Search directory entry. */
-	d = dirent_search(ip, filename, &buf, 0);
+	d = dirent_search(ip, filename, &buf, slot);
 	if (d == NULL)
 		return (INODE_NULL);
 	
+	num = d->d_ino;
 	brelse(buf);
 	
-	return (d->d_ino);
+	return (num);
 }
 
 /*
@@ -201,7 +252,11 @@ PUBLIC int dir_remove(struct inode *dinode, const char *filename)
 	struct d_dirent *d; /* Directory entry. */
 	struct inode *file; /* File inode.      */
 	
-	d = dirent_search(dinode, filename, &buf, 0);
+	/* Read-only file system. */
+	if (dinode->dev == PROC_DEV)
+		return (-EROFS);
+	
+	d = dirent_search(dinode, filename, &buf, NULL);
 	
 	/* Not found. */
 	if (d == NULL)
@@ -245,7 +300,7 @@ PUBLIC int dir_remove(struct inode *dinode, const char *filename)
 	
 	/* Remove directory entry. */
 	d->d_ino = INODE_NULL;
-	buf->flags |= BUFFER_DIRTY;
+	bdirty(buf, dinode);
 	inode_touch(dinode);
 	file->nlinks--;
 	inode_touch(file);
@@ -259,83 +314,280 @@ PUBLIC int dir_remove(struct inode *dinode, const char *filename)
  * Adds an entry to a directory.
  */
 PUBLIC int dir_add(struct inode *dinode, struct inode *inode, const char *name)
+{
+	int slot; /* Free directory entry. */
+	
+	/* Duplicated entry. */
+	if (dir_lookup(dinode, name, &slot) != INODE_NULL)
+	{
+		curr_proc->errno = -EEXIST;
+		return (-EEXIST);
+	}
+	
+	return (dir_add_slot(dinode, inode, name, slot));
+}
+
+/**
+ * @brief Adds an entry to a directory at a known position.
+ * 
+ * @details Adds an entry named @p name to the directory pointed to by
+ *          @p dinode, linking it to the inode pointed to by @p inode, in the
+ *          free directory entry @p slot found by dir_lookup(). The directory
+ *          is not searched again.
+ * 
+ * @param dinode Directory where the entry shall be added.
+ * @param inode  Inode to be linked.
+ * @param name   Name of the entry.
+ * @param slot   Free directory entry, as returned by dir_lookup().
+ * 
+ * @returns Upon successful completion, zero is returned. Upon failure, a
+ *          negative error code is returned instead.
+ * 
+ * @note @p dinode must be locked, and must not have changed since @p slot
+ *       was found.
+ */
+PUBLIC int dir_add_slot
+(struct inode *dinode, struct inode *inode, const char *name, int slot)
 {
 	struct buffer *buf; /* Block buffer.         */
 	struct d_dirent *d; /* Disk directory entry. */
 	
-	d = dirent_search(dinode, name, &buf, 1);
+	/* Read-only file system. */
+	if (dinode->dev == PROC_DEV)
+		return (-EROFS);
+	
+	d = dirent_alloc(dinode, slot, &buf);
 	
 	/* Failed to create directory entry. */
 	if (d == NULL)
-		return (-1);
+		return (-ENOSPC);
 	
 	kstrncpy(d->d_name, name, NAME_MAX);
 	d->d_ino = inode->num;
-	buf->flags |= BUFFER_DIRTY;
+	bdirty(buf, dinode);
 	brelse(buf);
 	
 	return (0);
 }
 
-/*
- * Reads from a regular file.
+/**
+ * @brief Asserts if a file may start over with inline data.
+ * 
+ * @param ip File to be inspected.
+ * 
+ * @returns True if the file pointed to by @p ip is an empty regular file that
+ *          has no blocks and inline data is enabled, and false otherwise.
+ * 
+ * @note @p ip must be locked.
  */
-PUBLIC ssize_t file_read(struct inode *i, void *buf, size_t n, off_t off)
+PRIVATE int file_can_inline(struct inode *ip)
+{
+	/* Not empty. */
+	if ((ip->size != 0) || !INODE_CAN_INLINE(ip))
+		return (0);
+	
+	/* Has blocks. */
+	for (unsigned j = 0; j < NR_ZONES; j++)
+	{
+		if (ip->blocks[j] != BLOCK_NULL)
+			return (0);
+	}
+	
+	return (1);
+}
+
+/**
+ * @brief Moves data back inline.
+ * 
+ * @details Moves the data of the file pointed to by @p ip back to the inode
+ *          and frees all its blocks. This is used when a write has moved
+ *          inline data to a disk block but failed to grow the file.
+ * 
+ * @param ip File whose data shall be moved.
+ * 
+ * @note @p ip must be locked.
+ */
+PRIVATE void file_unspill(struct inode *ip)
+{
+	off_t size;                  /* File size.   */
+	struct buffer *buf;          /* Buffer.      */
+	char data[MINIX_INLINE_MAX]; /* Inline data. */
+	
+	size = ip->size;
+	
+	kmemset(data, 0, MINIX_INLINE_MAX);
+	if (ip->blocks[0] != BLOCK_NULL)
+	{
+		buf = bread(ip->dev, ip->blocks[0]);
+		kmemcpy(data, buf->data, size);
+		brelse(buf);
+	}
+	
+	inode_truncate(ip);
+	
+	kmemcpy(ip->blocks, data, size);
+	ip->size = size;
+}
+
+/**
+ * @brief Reads from a regular file.
+ * 
+ * @param i   Target file.
+ * @param buf Target buffer.
+ * @param n   Number of bytes to read.
+ * @param off Read offset.
+ * 
+ * @returns The number of bytes read.
+ * 
+ * @note @p i must be locked.
+ */
+PRIVATE ssize_t do_file_read(struct inode *i, void *buf, size_t n, off_t off)
 {
 	char *p;             /* Writing pointer.      */
 	size_t blkoff;       /* Block offset.         */
 	size_t chunk;        /* Data chunk size.      */
 	block_t blk;         /* Working block number. */
 	struct buffer *bbuf; /* Working block buffer. */
-		
+	
 	p = buf;
 	
-	inode_lock(i);
+	/* End of file reached. */
+	if ((n == 0) || (off >= i->size))
+		return (0);
+	
+	/* Read inline data. */
+	if (i->flags & INODE_INLINE)
+	{
+		chunk = ((off_t)n < i->size - off) ? n : (size_t)(i->size - off);
+		kmemcpy(p, (char *)i->blocks + off, chunk);
+		p += chunk;
+		
+		goto out;
+	}
 	
 	/* Read data. */
 	do
 	{
-		blk = block_map(i, off, 0);
-		
-		/* End of file reached. */
-		if (blk == BLOCK_NULL)
-			goto out;
-		
-		bbuf = bread(i->dev, blk);
-			
 		blkoff = off % BLOCK_SIZE;
 		
 		/* Calculate read chunk size. */
 		chunk = (n < BLOCK_SIZE - blkoff) ? n : BLOCK_SIZE - blkoff;
 		if ((off_t)chunk > i->size - off)
-		{
 			chunk = i->size - off;
-			if (chunk == 0)
-			{
-				brelse(bbuf);
-				goto out;
-			}
-		}
 		
-		kmemcpy(p, (char *)bbuf->data + blkoff, chunk);
-		brelse(bbuf);
+		blk = block_map(i, off, 0);
+		
+		/* Holes read as zeros. */
+		if (blk == BLOCK_NULL)
+			kmemset(p, 0, chunk);
+		
+		else
+		{
+			bbuf = bread(i->dev, blk);
+			kmemcpy(p, (char *)bbuf->data + blkoff, chunk);
+			brelse(bbuf);
+		}
 		
 		n -= chunk;
 		off += chunk;
 		p += chunk;
-	} while (n > 0);
+	} while ((n > 0) && (off < i->size));
 
 out:
-	inode_touch(i);
-	inode_unlock(i);
 	return ((ssize_t)(p - (char *)buf));
 }
 
 /*
- * Writes to a regular file.
+ * Reads from a regular file.
  */
-PUBLIC ssize_t file_write(struct inode *i, const void *buf, size_t n, off_t off)
+PUBLIC ssize_t file_read(struct inode *i, void *buf, size_t n, off_t off)
+{
+	struct iovec iov; /* Target buffer. */
+	
+	iov.iov_base = buf;
+	iov.iov_len = n;
+	
+	return (file_readv(i, &iov, 1, off));
+}
+
+/**
+ * @brief Reads from a regular file into many buffers.
+ * 
+ * @details Reads from the file pointed to by @p i, starting at offset @p off,
+ *          into the @p iovcnt buffers described by @p iov, in order. The
+ *          inode is locked only once for all buffers, and reading stops at
+ *          the end of the file.
+ * 
+ * @param i      Target file.
+ * @param iov    Target buffers.
+ * @param iovcnt Number of target buffers.
+ * @param off    Read offset.
+ * 
+ * @returns Upon successful completion, the number of bytes read is returned.
+ *          Upon failure, a negative error code is returned instead.
+ */
+PUBLIC ssize_t file_readv
+(struct inode *i, const struct iovec *iov, int iovcnt, off_t off)
+{
+	ssize_t n;     /* Bytes read in a buffer. */
+	ssize_t count; /* Bytes read.             */
+	
+	count = 0;
+	
+	/* Process file system. */
+	if (i->dev == PROC_DEV)
+	{
+		for (int k = 0; k < iovcnt; k++)
+		{
+			n = procfs_read(i, iov[k].iov_base, iov[k].iov_len, off + count);
+			
+			/* Failed to read. */
+			if (n < 0)
+				return ((count > 0) ? count : n);
+			
+			count += n;
+			if ((size_t)n < iov[k].iov_len)
+				break;
+		}
+		
+		return (count);
+	}
+	
+	inode_lock(i);
+	
+	for (int k = 0; k < iovcnt; k++)
+	{
+		n = do_file_read(i, iov[k].iov_base, iov[k].iov_len, off + count);
+		
+		count += n;
+		if ((size_t)n < iov[k].iov_len)
+			break;
+	}
+	
+	inode_touch(i);
+	inode_unlock(i);
+	
+	return (count);
+}
+
+/**
+ * @brief Writes to a regular file.
+ * 
+ * @param i   Target file.
+ * @param buf Source buffer.
+ * @param n   Number of bytes to write.
+ * @param off Write offset.
+ * 
+ * @returns The number of bytes written. On a short write, the error code is
+ *          stored in the errno of the calling process.
+ * 
+ * @note @p i must be locked.
+ */
+PRIVATE ssize_t do_file_write
+(struct inode *i, const void *buf, size_t n, off_t off)
 {
+	int err;             /* Error code.           */
+	int spilled;         /* Inline data moved?    */
 	const char *p;       /* Reading pointer.      */
 	size_t blkoff;       /* Block offset.         */
 	size_t chunk;        /* Data chunk size.      */
@@ -343,8 +595,40 @@ PUBLIC ssize_t file_write(struct inode *i, const void *buf, size_t n, off_t off)
 	struct buffer *bbuf; /* Working block buffer. */
 		
 	p = buf;
+	spilled = 0;
 	
-	inode_lock(i);
+	/* Nothing to do. */
+	if (n == 0)
+		return (0);
+	
+	/* Empty files start out with inline data. */
+	if (file_can_inline(i))
+		i->flags |= INODE_INLINE;
+	
+	if (i->flags & INODE_INLINE)
+	{
+		/* Write inline data. */
+		if (off + (off_t)n <= (off_t)MINIX_INLINE_MAX)
+		{
+			kmemcpy((char *)i->blocks + off, p, n);
+			p += n;
+			
+			/* Update file size. */
+			if (off + (off_t)n > i->size)
+				i->size = off + n;
+			i->flags |= INODE_DSYNC;
+			
+			goto out;
+		}
+		
+		/* Grow file past inline data. */
+		if ((err = block_spill(i)))
+		{
+			curr_proc->errno = err;
+			goto out;
+		}
+		spilled = 1;
+	}
 	
 	/* Write data. */
 	do
@@ -360,8 +644,8 @@ PUBLIC ssize_t file_write(struct inode *i, const void *buf, size_t n, off_t off)
 		blkoff = off % BLOCK_SIZE;
 		
 		chunk = (n < BLOCK_SIZE - blkoff) ? n : BLOCK_SIZE - blkoff;
-		kmemcpy((char *)bbuf->data + blkoff, buf, chunk);
-		bbuf->flags |= BUFFER_DIRTY;
+		kmemcpy((char *)bbuf->data + blkoff, p, chunk);
+		bdirty(bbuf, i);
 		brelse(bbuf);
 		
 		n -= chunk;
@@ -372,14 +656,69 @@ PUBLIC ssize_t file_write(struct inode *i, const void *buf, size_t n, off_t off)
 		if (off > i->size)
 		{
 			i->size = off;
-			i->flags |= INODE_DIRTY;
+			i->flags |= INODE_DIRTY | INODE_DSYNC;
 		}
 		
 	} while (n > 0);
 
 out:
 
+	/* Failed to grow file. */
+	if (spilled && (i->size <= (off_t)MINIX_INLINE_MAX))
+		file_unspill(i);
+
+	return ((ssize_t)(p - (char *)buf));
+}
+
+/*
+ * Writes to a regular file.
+ */
+PUBLIC ssize_t file_write(struct inode *i, const void *buf, size_t n, off_t off)
+{
+	struct iovec iov; /* Source buffer. */
+	
+	iov.iov_base = (void *)buf;
+	iov.iov_len = n;
+	
+	return (file_writev(i, &iov, 1, off));
+}
+
+/**
+ * @brief Writes to a regular file from many buffers.
+ * 
+ * @details Writes the @p iovcnt buffers described by @p iov, in order, to the
+ *          file pointed to by @p i, starting at offset @p off. The inode is
+ *          locked only once for all buffers, and writing stops at the first
+ *          short write.
+ * 
+ * @param i      Target file.
+ * @param iov    Source buffers.
+ * @param iovcnt Number of source buffers.
+ * @param off    Write offset.
+ * 
+ * @returns The number of bytes written.
+ */
+PUBLIC ssize_t file_writev
+(struct inode *i, const struct iovec *iov, int iovcnt, off_t off)
+{
+	ssize_t n;     /* Bytes written from a buffer. */
+	ssize_t count; /* Bytes written.               */
+	
+	count = 0;
+	
+	inode_lock(i);
+	
+	for (int k = 0; k < iovcnt; k++)
+	{
+		n = do_file_write(i, iov[k].iov_base, iov[k].iov_len, off + count);
+		
+		count += n;
+		if ((size_t)n < iov[k].iov_len)
+			break;
+	}
+	
 	inode_touch(i);
 	inode_unlock(i);
-	return ((ssize_t)(p - (char *)buf));
+	
+	return (count);
 }
@@ -18,12 +18,15 @@
  */
 
 #include <nanvix/const.h>
+#include <nanvix/dev.h>
 #include <nanvix/fs.h>
 #include <nanvix/klib.h>
 #include <nanvix/mm.h>
 #include <nanvix/pm.h>
 #include <dirent.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
 #include "fs.h"
 
 #if NR_FILES < OPEN_MAX*NR_PROCS
@@ -106,6 +109,254 @@ PUBLIC void do_close(int fd)
 	inode_put(i);
 }
 
+/**
+ * @brief Gets I/O vectors from user space.
+ * 
+ * @param kiov   Where to copy the I/O vectors (#IOV_MAX entries long).
+ * @param iov    I/O vectors (in user space).
+ * @param iovcnt Number of I/O vectors.
+ * @param mask   Access that the buffers should allow.
+ * 
+ * @returns Upon successful completion, the total length of the buffers is
+ *          returned. Upon failure, a negative error code is returned
+ *          instead.
+ */
+PUBLIC int getiov
+(struct iovec *kiov, const struct iovec *iov, int iovcnt, mode_t mask)
+{
+	size_t total; /* Total length. */
+	
+	/* Invalid number of buffers. */
+	if ((iovcnt < 0) || (iovcnt > IOV_MAX))
+		return (-EINVAL);
+	
+	/* Invalid I/O vectors. */
+	if (!chkmem(iov, iovcnt*sizeof(struct iovec), MAY_READ))
+		return (-EINVAL);
+	kmemcpy(kiov, iov, iovcnt*sizeof(struct iovec));
+	
+	total = 0;
+	for (int i = 0; i < iovcnt; i++)
+	{
+		/* Invalid buffer. */
+		if (!chkmem(kiov[i].iov_base, kiov[i].iov_len, mask))
+			return (-EINVAL);
+		
+		total += kiov[i].iov_len;
+		
+		/* Total length overflow. */
+		if ((int)total < 0)
+			return (-EINVAL);
+	}
+	
+	return (total);
+}
+
+/**
+ * @brief Reads from a file.
+ * 
+ * @details Reads from the file pointed to by @p f into the @p iovcnt buffers
+ *          described by @p iov, in order, in a single pass. Regular files are
+ *          read under a single inode lock, and other files stop at the first
+ *          short read.
+ * 
+ * @param f      Target file.
+ * @param iov    Target buffers (in user space).
+ * @param iovcnt Number of target buffers.
+ * @param off    Offset where to read from. If #NULL, the file position is
+ *               used and advanced instead.
+ * 
+ * @returns Upon successful completion, the number of bytes read is returned.
+ *          Upon failure, a negative error code is returned instead.
+ */
+PUBLIC ssize_t do_read
+(struct file *f, const struct iovec *iov, int iovcnt, off_t *off)
+{
+	ssize_t n;       /* Bytes read in a buffer. */
+	off_t pos;       /* Read offset.            */
+	struct inode *i; /* Inode.                  */
+	ssize_t count;   /* Bytes actually read.    */
+	
+	/* File not opened for reading. */
+	if (ACCMODE(f->oflag) == O_WRONLY)
+		return (-EBADF);
+	
+	i = f->inode;
+	pos = (off != NULL) ? *off : f->pos;
+	
+	/* Not seekable. */
+	if ((off != NULL) && ((S_ISFIFO(i->mode)) || (i->flags & INODE_SOCKET)))
+		return (-ESPIPE);
+	
+	/* Socket. */
+	if (i->flags & INODE_SOCKET)
+		return (socket_read(i->sock, iov, iovcnt, f->oflag));
+	
+	/* Regular file/directory. */
+	if ((S_ISDIR(i->mode)) || (S_ISREG(i->mode)))
+		count = file_readv(i, iov, iovcnt, pos);
+	
+	else
+	{
+		count = 0;
+		
+		for (int k = 0; k < iovcnt; k++)
+		{
+			if (iov[k].iov_len == 0)
+				continue;
+			
+			/* Character special file. */
+			if (S_ISCHR(i->mode))
+				n = cdev_read(i->blocks[0], iov[k].iov_base, iov[k].iov_len);
+			
+			/* Block special file. */
+			else if (S_ISBLK(i->mode))
+			{
+				n = bdev_read(i->blocks[0], iov[k].iov_base,
+					iov[k].iov_len, pos + count);
+			}
+			
+			/* Pipe file. */
+			else if (S_ISFIFO(i->mode))
+			{
+				if ((n = pipe_read(i, iov[k].iov_base, iov[k].iov_len)) < 0)
+					n = curr_proc->errno;
+			}
+			
+			/* Unknown file type. */
+			else
+				return (-EINVAL);
+			
+			/* Failed to read. */
+			if (n < 0)
+			{
+				if (count == 0)
+					return (n);
+				break;
+			}
+			
+			count += n;
+			if ((size_t)n < iov[k].iov_len)
+				break;
+		}
+	}
+	
+	/* Failed to read. */
+	if (count < 0)
+		return (count);
+	
+	/* Character special files have no position. */
+	if (!S_ISCHR(i->mode))
+	{
+		inode_touch(i);
+		if (off == NULL)
+			f->pos += count;
+	}
+	
+	return (count);
+}
+
+/**
+ * @brief Writes to a file.
+ * 
+ * @details Writes the @p iovcnt buffers described by @p iov, in order, to the
+ *          file pointed to by @p f in a single pass. Regular files are
+ *          written under a single inode lock, and other files stop at the
+ *          first short write.
+ * 
+ * @param f      Target file.
+ * @param iov    Source buffers (in user space).
+ * @param iovcnt Number of source buffers.
+ * @param off    Offset where to write to. If #NULL, the file position is
+ *               used and advanced instead.
+ * 
+ * @returns Upon successful completion, the number of bytes written is
+ *          returned. Upon failure, a negative error code is returned instead.
+ */
+PUBLIC ssize_t do_write
+(struct file *f, const struct iovec *iov, int iovcnt, off_t *off)
+{
+	ssize_t n;       /* Bytes written from a buffer. */
+	off_t pos;       /* Write offset.                */
+	struct inode *i; /* Inode.                       */
+	ssize_t count;   /* Bytes actually written.      */
+	
+	/* File not opened for writing. */
+	if (ACCMODE(f->oflag) == O_RDONLY)
+		return (-EBADF);
+	
+	i = f->inode;
+	
+	/* Not seekable. */
+	if ((off != NULL) && ((S_ISFIFO(i->mode)) || (i->flags & INODE_SOCKET)))
+		return (-ESPIPE);
+	
+	/* Append mode. */
+	if ((off == NULL) && (f->oflag & O_APPEND))
+		f->pos = i->size;
+	
+	pos = (off != NULL) ? *off : f->pos;
+	
+	/* Socket. */
+	if (i->flags & INODE_SOCKET)
+		return (socket_write(i->sock, iov, iovcnt, f->oflag));
+	
+	/* Regular file. */
+	if (S_ISREG(i->mode))
+		count = file_writev(i, iov, iovcnt, pos);
+	
+	else
+	{
+		count = 0;
+		
+		for (int k = 0; k < iovcnt; k++)
+		{
+			if (iov[k].iov_len == 0)
+				continue;
+			
+			/* Character special file. */
+			if (S_ISCHR(i->mode))
+				n = cdev_write(i->blocks[0], iov[k].iov_base, iov[k].iov_len);
+			
+			/* Block special file. */
+			else if (S_ISBLK(i->mode))
+			{
+				n = bdev_write(i->blocks[0], iov[k].iov_base,
+					iov[k].iov_len, pos + count);
+			}
+			
+			/* Pipe file. */
+			else if (S_ISFIFO(i->mode))
+			{
+				if ((n = pipe_write(i, iov[k].iov_base, iov[k].iov_len)) < 0)
+					n = curr_proc->errno;
+			}
+			
+			/* Unknown file type. */
+			else
+				return (-EINVAL);
+			
+			/* Failed to write. */
+			if (n < 0)
+			{
+				if (count == 0)
+					return (n);
+				break;
+			}
+			
+			count += n;
+			if ((size_t)n < iov[k].iov_len)
+				break;
+		}
+	}
+	
+	/* Character special files have no position. */
+	if ((!S_ISCHR(i->mode)) && (off == NULL))
+		f->pos += count;
+	
+	return (count);
+}
+
 /*
  * Checks rwx permissions on a file.
  */
@@ -185,6 +436,82 @@ PUBLIC void putname(char *name)
 	putkpg(name);
 }
 
+/**
+ * @brief Resolves a path name lexically.
+ * 
+ * @details Builds in @p buf the canonical path name, as seen from the system
+ *          root directory, of the file that @p path refers to when looked
+ *          up by the process pointed to by @p proc. Absolute path names are
+ *          resolved from the root directory of the process, and relative
+ *          ones from its working directory. Dot entries are removed, and dot
+ *          dot entries never go above the root directory of the process,
+ *          just like when the path name is looked up.
+ * 
+ * @param buf  Canonical path name (#PATH_MAX characters long).
+ * @param path Path name to be resolved.
+ * @param proc Process that looks up the path name.
+ * 
+ * @returns Upon successful completion, zero is returned. Upon failure, a
+ *          negative error code is returned instead.
+ */
+PUBLIC int path_canon(char *buf, const char *path, struct process *proc)
+{
+	size_t n;     /* Component length.          */
+	size_t len;   /* Canonical path name length. */
+	size_t floor; /* Shortest length allowed.    */
+	
+	kstrcpy(buf, (*path == '/') ? proc->rootpath : proc->pwdpath);
+	len = kstrlen(buf);
+	floor = kstrlen(proc->rootpath);
+	
+	/* Working directory is outside the root directory. */
+	if ((kstrncmp(buf, proc->rootpath, floor)) ||
+		((buf[floor] != '\0') && (buf[floor] != '/')))
+		floor = 1;
+	
+	while (*path != '\0')
+	{
+		/* Skip slashes. */
+		if (*path == '/')
+		{
+			path++;
+			continue;
+		}
+		
+		for (n = 0; (path[n] != '\0') && (path[n] != '/'); n++)
+			/* noop */ ;
+		
+		/* Dot dot. */
+		if ((n == 2) && (path[0] == '.') && (path[1] == '.'))
+		{
+			while ((len > floor) && (buf[len - 1] != '/'))
+				len--;
+			if (len > floor)
+				len--;
+			if (len == 0)
+				len = 1;
+			buf[len] = '\0';
+		}
+		
+		/* Component. */
+		else if ((n != 1) || (path[0] != '.'))
+		{
+			/* Path name too long. */
+			if (len + n + 1 >= PATH_MAX)
+				return (-ENAMETOOLONG);
+			
+			if (len > 1)
+				buf[len++] = '/';
+			kmemcpy(&buf[len], path, n);
+			buf[len += n] = '\0';
+		}
+		
+		path += n;
+	}
+	
+	return (0);
+}
+
 /*
  * Initializes the file system manager.
  */
@@ -216,6 +543,8 @@ PUBLIC void fs_init(void)
 	/* Hand craft idle process. */
 	IDLE->pwd = root;
 	IDLE->root = root;
+	kstrcpy(IDLE->pwdpath, "/");
+	kstrcpy(IDLE->rootpath, "/");
 	root->count += 2;
 	
 	inode_unlock(root);
@@ -83,17 +83,36 @@
 		struct buffer *hash_next; /**< Next buffer in the hash table.     */
 		struct buffer *hash_prev; /**< Previous buffer in the hash table. */
 		/**@}*/
+		
+		/**
+		 * @name Owner information.
+		 */
+		/**@{*/
+		struct inode *owner;       /**< Inode that has dirtied the buffer. */
+		struct buffer *dirty_next; /**< Next dirty buffer of the owner.    */
+		struct buffer *dirty_prev; /**< Previous dirty buffer of owner.    */
+		/**@}*/
 	};
 	
 	/**@}*/
 	
 	/* Forward definitions. */
 	EXTERN void binit(void);
+	EXTERN void bdirty(struct buffer *, struct inode *);
+	EXTERN void bdisown(struct inode *);
+	EXTERN void bfsync(struct inode *);
 	
 /*============================================================================*
  *                               Inode Library                                *
  *============================================================================*/
 	
+	/**
+	 * @brief Asserts if an inode may hold inline data.
+	 */
+	#define INODE_CAN_INLINE(ip)                        \
+		(((ip)->sb->features & MINIX_FEATURE_INLINE) && \
+		S_ISREG((ip)->mode))
+	
 	/* Forward definitions. */
 	EXTERN void inode_init(void);
 
@@ -148,9 +167,25 @@
 		enum superblock_flags flags;    /**< Flags.                        */
 		ino_t isearch;		            /**< Inodes below this are in use. */
 		block_t zsearch;		        /**< Zones below this are in use.  */
+		block_t zpending;               /**< Zones pending reclaim.        */
+		unsigned features;              /**< Feature flags.                */
 		struct process *chain;          /**< Waiting chain.                */
 	};
 	
 	/**@}*/
 
+/*============================================================================*
+ *                              Reclaim Library                               *
+ *============================================================================*/
+
+	/* Forward definitions. */
+	EXTERN int reclaim_enqueue(struct inode *);
+
+/*============================================================================*
+ *                               Block Library                                *
+ *============================================================================*/
+
+	/* Forward definitions. */
+	EXTERN int block_spill(struct inode *);
+
 #endif /* _FS_H_ */
@@ -37,6 +37,10 @@
 /* Number of inodes per block. */
 #define INODES_PER_BLOCK (BLOCK_SIZE/sizeof(struct d_inode))
 
+/* Block where a disk inode is located. */
+#define INODE_BLOCK(sb, num) \
+	(2 + (sb)->imap_blocks + (sb)->zmap_blocks + ((num) - 1)/INODES_PER_BLOCK)
+
 /**
  * @brief In-core inodes table.
  */
@@ -53,6 +57,12 @@ PRIVATE struct inode *free_inodes = NULL;
 /* Inodes hash table. */
 PRIVATE struct inode *hashtab[HASHTAB_SIZE];
 
+/* Inode cache hits. */
+PRIVATE unsigned hits = 0;
+
+/* Inode cache misses. */
+PRIVATE unsigned misses = 0;
+
 /**
  * @brief Hash function for the inode cache.
  */
@@ -80,7 +90,7 @@ PRIVATE struct inode *inode_cache_evict(void)
 	 */
 	if (free_inodes == NULL)
 	{
-		kprintf("fs: inode table overflow");
+		kprintf_ratelimited(KERN_WARN "fs: inode table overflow");
 		return (NULL);
 	}
 	
@@ -159,7 +169,7 @@ PRIVATE void inode_write(struct inode *ip)
 	
 	superblock_lock(sb = ip->sb);
 	
-	blk = 2 + sb->imap_blocks + sb->zmap_blocks + (ip->num - 1)/INODES_PER_BLOCK;
+	blk = INODE_BLOCK(sb, ip->num);
 	
 	/* Read chunk of disk inodes. */
 	buf = bread(ip->dev, blk);
@@ -180,7 +190,7 @@ PRIVATE void inode_write(struct inode *ip)
 	d_i->i_time = ip->time;
 	for (unsigned i = 0; i < NR_ZONES; i++)
 		d_i->i_zones[i] = ip->blocks[i];
-	ip->flags &= ~INODE_DIRTY;
+	ip->flags &= ~(INODE_DIRTY | INODE_DSYNC);
 	buffer_dirty(buf, 1);
 	
 	brelse(buf);
@@ -216,7 +226,7 @@ PRIVATE struct inode *inode_read(dev_t dev, ino_t num)
 		goto error0;	
 	
 	/* Calculate block number. */
-	blk = 2 + sb->imap_blocks + sb->zmap_blocks + (num - 1)/INODES_PER_BLOCK;
+	blk = INODE_BLOCK(sb, num);
 	
 	/* Read chunk of disk inodes. */
 	buf = bread(dev, blk);
@@ -249,9 +259,14 @@ PRIVATE struct inode *inode_read(dev_t dev, ino_t num)
 	ip->dev = dev;
 	ip->num = num;
 	ip->sb = sb;
-	ip->flags &= ~(INODE_DIRTY | INODE_MOUNT | INODE_PIPE);
+	ip->flags &= ~(INODE_DIRTY|INODE_DSYNC|INODE_MOUNT|INODE_PIPE|INODE_INLINE);
+	ip->flags &= ~INODE_SOCKET;
 	ip->flags |= INODE_VALID;
 	
+	/* Tiny regular files hold inline data. */
+	if (INODE_CAN_INLINE(ip) && (ip->size <= (off_t)MINIX_INLINE_MAX))
+		ip->flags |= INODE_INLINE;
+	
 	brelse(buf);
 	superblock_put(sb);
 	
@@ -332,7 +347,7 @@ PUBLIC void inode_sync(void)
 		/* Write only valid inodes. */
 		if (ip->flags & INODE_VALID)
 		{
-			if (!(ip->flags & INODE_PIPE))
+			if (!(ip->flags & (INODE_PIPE | INODE_SOCKET | INODE_PROC)))
 				inode_write(ip);
 		}
 		
@@ -344,7 +359,10 @@ PUBLIC void inode_sync(void)
  * @brief Truncates an inode.
  * 
  * @details Truncates the inode pointed to by @p ip by freeing all underling 
- *          blocks.
+ *          blocks. If the inode has indirect zones, freeing is deferred to the
+ *          reclaim daemon, so that the calling process does not have to read
+ *          indirect blocks. Otherwise, blocks are freed right away. Truncated
+ *          regular files start over with inline data, if enabled.
  * 
  * @param ip Inode that shall be truncated.
  * 
@@ -354,6 +372,28 @@ PUBLIC void inode_truncate(struct inode *ip)
 {
 	struct superblock *sb;
 	
+	/* Inline data has no blocks. */
+	if (ip->flags & INODE_INLINE)
+	{
+		for (unsigned j = 0; j < NR_ZONES; j++)
+			ip->blocks[j] = BLOCK_NULL;
+		
+		goto out;
+	}
+	
+	/* Hand indirect zones to the reclaim daemon. */
+	if ((ip->blocks[ZONE_SINGLE] != BLOCK_NULL) ||
+		(ip->blocks[ZONE_DOUBLE] != BLOCK_NULL))
+	{
+		if (reclaim_enqueue(ip) == 0)
+		{
+			for (unsigned j = 0; j < NR_ZONES; j++)
+				ip->blocks[j] = BLOCK_NULL;
+			
+			goto out;
+		}
+	}
+	
 	superblock_lock(sb = ip->sb);
 	
 	/* Free direct zone. */
@@ -378,11 +418,51 @@ PUBLIC void inode_truncate(struct inode *ip)
 	}
 	
 	superblock_unlock(sb);
-	
+
+out:
 	ip->size = 0;
+	ip->flags |= INODE_DSYNC;
+	if (INODE_CAN_INLINE(ip))
+		ip->flags |= INODE_INLINE;
 	inode_touch(ip);
 }
 
+/**
+ * @brief Synchronizes an inode.
+ * 
+ * @details Writes back the inode pointed to by @p ip along with all its dirty
+ *          data and indirect blocks, and waits for writes to complete. If
+ *          @p datasync is not zero, the inode itself is written back only if
+ *          its size or zones have changed.
+ * 
+ * @param ip       Inode that shall be synchronized.
+ * @param datasync Synchronize only data?
+ * 
+ * @note The inode must be locked.
+ */
+PUBLIC void inode_fsync(struct inode *ip, int datasync)
+{
+	struct buffer *buf; /* Buffer. */
+	
+	/* Write inode to buffer. */
+	if ((ip->flags & INODE_DIRTY) && (!datasync || (ip->flags & INODE_DSYNC)))
+	{
+		inode_write(ip);
+		
+		/*
+		 * The block of disk inodes is shared by
+		 * several inodes, so it is only placed in
+		 * the dirty list right before flushing it.
+		 */
+		buf = bread(ip->dev, INODE_BLOCK(ip->sb, ip->num));
+		if (buf->flags & BUFFER_DIRTY)
+			bdirty(buf, ip);
+		brelse(buf);
+	}
+	
+	bfsync(ip);
+}
+
 /**
  * @brief Allocates an inode.
  * 
@@ -453,8 +533,8 @@ found:
 	ip->dev = sb->dev;
 	ip->num = num;
 	ip->sb = sb;
-	ip->flags &= ~(INODE_MOUNT | INODE_PIPE);
-	ip->flags |= INODE_VALID;
+	ip->flags &= ~(INODE_MOUNT | INODE_PIPE | INODE_INLINE | INODE_SOCKET);
+	ip->flags |= INODE_VALID | INODE_DSYNC;
 	inode_touch(ip);
 	
 	inode_cache_insert(ip);
@@ -468,6 +548,60 @@ error0:
 	return (NULL);
 }
 
+/**
+ * @brief Gets a process file system inode.
+ * 
+ * @details Gets an in-core inode for the file with number @p num of the
+ *          process file system. These inodes are not cached, so that their
+ *          attributes are always up to date.
+ * 
+ * @param num Number of the inode.
+ * 
+ * @returns Upon successful completion, a pointer to the inode is returned. In
+ *          this case, the inode is ensured to be locked. Upon failure, a #NULL
+ *          pointer is returned instead.
+ */
+PRIVATE struct inode *inode_proc(ino_t num)
+{
+	struct inode *ip; /* Process file system inode. */
+	
+	ip = inode_cache_evict();
+	
+	/* No free inode. */
+	if (ip == NULL)
+		return (NULL);
+	
+	/* Initialize inode. */
+	ip->nlinks = 1;
+	ip->uid = 0;
+	ip->gid = 0;
+	ip->size = 0;
+	ip->time = CURRENT_TIME;
+	for (unsigned i = 0; i < NR_ZONES; i++)
+		ip->blocks[i] = BLOCK_NULL;
+	ip->dev = PROC_DEV;
+	ip->num = num;
+	ip->sb = NULL;
+	ip->flags &= ~(INODE_DIRTY|INODE_DSYNC|INODE_MOUNT|INODE_PIPE|INODE_INLINE);
+	ip->flags &= ~INODE_SOCKET;
+	ip->flags |= INODE_VALID | INODE_PROC;
+	
+	/* No such file. */
+	if (procfs_inode(ip))
+	{
+		ip->flags &= ~INODE_PROC;
+		ip->count = 0;
+		ip->free_next = free_inodes;
+		free_inodes = ip;
+		ip->flags &= ~INODE_VALID;
+		inode_unlock(ip);
+		curr_proc->errno = -ENOENT;
+		return (NULL);
+	}
+	
+	return (ip);
+}
+
 /**
  * @brief Gets an inode.
  * 
@@ -489,6 +623,10 @@ PUBLIC struct inode *inode_get(dev_t dev, ino_t num)
 
 repeat:
 
+	/* Process file system. */
+	if (dev == PROC_DEV)
+		return (inode_proc(num));
+
 	/* Search in the hash table. */
 	for (ip = hashtab[HASH(dev, num)]; ip != NULL; ip = ip->hash_next)
 	{
@@ -506,16 +644,20 @@ repeat:
 		/* Cross mount point. */
 		if (ip->flags & INODE_MOUNT)
 		{
-			 dev = ip->dev;
-			 goto repeat;
+			dev = ip->mdev;
+			num = ip->mroot;
+			goto repeat;
 		}
 		
+		hits++;
 		ip->count++;
 		inode_lock(ip);
 		
 		return (ip);
 	}
 	
+	misses++;
+	
 	/* Read inode. */
 	ip = inode_read(dev, num);
 	if (ip == NULL)
@@ -569,6 +711,45 @@ error0:
 	return (NULL);
 }
 
+/**
+ * @brief Gets a socket inode.
+ * 
+ * @details Gets an in-core inode that is not backed by any device for the
+ *          socket pointed to by @p sock. When the inode is released, the
+ *          socket is destroyed.
+ * 
+ * @param sock Socket.
+ * 
+ * @returns Upon success, a pointer to the socket inode is returned. Upon
+ *          failure, a NULL pointer is returned instead.
+ */
+PUBLIC struct inode *inode_socket(struct socket *sock)
+{
+	struct inode *ip; /* Socket inode. */
+	
+	ip = inode_cache_evict();
+	
+	/* No free inode. */
+	if (ip == NULL)
+		return (NULL);
+	
+	/* Initialize inode. */
+	ip->mode = MAY_READ | MAY_WRITE | S_IFSOCK;
+	ip->nlinks = 0;
+	ip->uid = curr_proc->uid;
+	ip->gid = curr_proc->gid;
+	ip->size = 0;
+	ip->time = CURRENT_TIME;
+	ip->dev = NULL_DEV;
+	ip->num = INODE_NULL;
+	ip->count = 1;
+	ip->flags &= ~(INODE_DIRTY|INODE_DSYNC|INODE_MOUNT|INODE_PIPE|INODE_INLINE);
+	ip->flags |= INODE_VALID | INODE_SOCKET;
+	ip->sock = sock;
+	
+	return (ip);
+}
+
 /**
  * @brief Updates the time stamp of an inode.
  * 
@@ -609,6 +790,14 @@ PUBLIC void inode_put(struct inode *ip)
 		/* Pipe inode. */
 		if (ip->flags & INODE_PIPE)
 			putkpg(ip->pipe);
+		
+		/* Socket inode. */
+		else if (ip->flags & INODE_SOCKET)
+			socket_close(ip->sock);
+		
+		/* Process file system inode. */
+		else if (ip->flags & INODE_PROC)
+			procfs_put(ip);
 			
 		/* File inode. */
 		else
@@ -622,6 +811,7 @@ PUBLIC void inode_put(struct inode *ip)
 			
 			inode_write(ip);
 			inode_cache_remove(ip);
+			bdisown(ip);
 		}
 		
 		/* Insert inode in the free list. */
@@ -734,7 +924,9 @@ again:
 		}
 		
 		/* Root directory reached. */
-		if ((curr_proc->root->num == i->num) && (!kstrcmp(filename, "..")))
+		if ((curr_proc->root->num == i->num) &&
+			(curr_proc->root->dev == i->dev) &&
+			(!kstrcmp(filename, "..")))
 		{
 			do
 			{
@@ -767,7 +959,7 @@ again:
 		{
 			sb = i->sb;
 			inode_put(i);
-			i = sb->mp;
+			i = (sb != NULL) ? sb->mp : procfs_mp;
 			inode_lock(i);
 			i->count++;
 			goto again;
@@ -838,6 +1030,34 @@ PUBLIC struct inode *inode_name(const char *pathname)
 	return (inode_get(dev, num));
 }
 
+/**
+ * @brief Gets inode cache statistics.
+ * 
+ * @param st Store location for statistics.
+ */
+PUBLIC void inode_stat(struct icache_stat *st)
+{
+	st->ninodes = NR_INODES;
+	st->nvalid = st->ndirty = 0;
+	st->hits = hits;
+	st->misses = misses;
+	
+	for (struct inode *ip = &inodes[0]; ip < &inodes[NR_INODES]; ip++)
+	{
+		if (!(ip->flags & INODE_VALID))
+			continue;
+		
+		st->nvalid++;
+		
+		/* Pipes, sockets and proc inodes are never written back. */
+		if (ip->flags & (INODE_PIPE | INODE_SOCKET | INODE_PROC))
+			continue;
+		
+		if (ip->flags & INODE_DIRTY)
+			st->ndirty++;
+	}
+}
+
 /**
  * @brief Initializes the inode table.
  * 
@@ -854,6 +1074,7 @@ PUBLIC void inode_init(void)
 		inodes[i].count = 0;
 		inodes[i].flags = ~(INODE_LOCKED | INODE_VALID);
 		inodes[i].chain = NULL;
+		inodes[i].dirty = NULL;
 		inodes[i].free_next = ((i + 1) < NR_INODES) ? &inodes[i + 1] : NULL;
 		inodes[i].hash_next = NULL;
 		inodes[i].hash_prev = NULL;
@@ -0,0 +1,903 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ *
+ * This file is part of Nanvix.
+ *
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nanvix/clock.h>
+#include <nanvix/const.h>
+#include <nanvix/fs.h>
+#include <nanvix/hal.h>
+#include <nanvix/klib.h>
+#include <nanvix/mm.h>
+#include <nanvix/net.h>
+#include <nanvix/pm.h>
+#include <nanvix/region.h>
+#include <sys/stat.h>
+#include <errno.h>
+#include <stdarg.h>
+#include "fs.h"
+
+/**
+ * @file
+ * 
+ * @brief Process file system implementation.
+ * 
+ * @details The process file system exposes kernel statistics and information
+ *          about processes as read-only files. Its root directory holds one
+ *          file for each kernel subsystem and one directory for each process,
+ *          named after the process ID. Inodes are not backed by any device:
+ *          inode numbers encode the process table slot and the file, and the
+ *          contents of a file are generated every time that it is read.
+ */
+
+/**
+ * @name Inode Numbers
+ */
+/**@{*/
+#define PROC_INO(slot, file) ((ino_t)((((slot) + 1) << 4) | (file))) /**< Inode. */
+#define PROC_SLOT(num)       (((num) >> 4) - 1) /**< Process table slot.        */
+#define PROC_FILE(num)       ((num) & 0xf)      /**< File in the directory.     */
+#define PROC_GLOBAL(num)     (((num) >> 4) == 0) /**< Global file?              */
+#define PROC_FIRST           (PROC_ROOT + 1)     /**< First global file.        */
+/**@}*/
+
+/**
+ * @brief Process ID of a process file system inode.
+ */
+#define PROC_PID(ip) ((pid_t)(ip)->blocks[0])
+
+/**
+ * @brief Output buffer limit.
+ * 
+ * @details Lines are formatted with kvsprintf(), which is not bounded, so
+ *          output stops when less than a line is left in the buffer.
+ */
+#define PROCBUF_MAX (PAGE_SIZE - 128)
+
+/**
+ * @name Signed Output
+ */
+/**@{*/
+#define SIGN(x) (((x) < 0) ? "-" : "")   /**< Sign of a number.           */
+#define ABS(x)  (((x) < 0) ? -(x) : (x)) /**< Absolute value of a number. */
+/**@}*/
+
+/**
+ * @brief Output buffer.
+ */
+struct procbuf
+{
+	char *data; /**< Data.   */
+	size_t len; /**< Length. */
+};
+
+/**
+ * @brief Process file system file.
+ */
+struct procfile
+{
+	const char *name;                                 /**< Name.    */
+	void (*show)(struct procbuf *, struct process *); /**< Show it. */
+};
+
+/**
+ * @brief Mount point of the process file system.
+ */
+PUBLIC struct inode *procfs_mp = NULL;
+
+/**
+ * @brief Number of process file system inodes in use.
+ */
+PRIVATE unsigned nopen = 0;
+
+/**
+ * @brief Process state names.
+ */
+PRIVATE const char *states[] = {
+	"DEAD", "ZOMBIE", "RUNNING", "READY", "WAITING", "SLEEPING", "STOPPED"
+};
+
+/**
+ * @brief Writes formatted data to an output buffer.
+ * 
+ * @param b   Output buffer.
+ * @param fmt Formatted string.
+ */
+PRIVATE void pprintf(struct procbuf *b, const char *fmt, ...)
+{
+	va_list args;
+	
+	/* Buffer is full. */
+	if (b->len > PROCBUF_MAX)
+		return;
+	
+	va_start(args, fmt);
+	b->len += kvsprintf(b->data + b->len, fmt, args);
+	va_end(args);
+}
+
+/**
+ * @brief Writes a directory entry to an output buffer.
+ * 
+ * @param b    Output buffer.
+ * @param num  Inode number.
+ * @param name Entry name.
+ */
+PRIVATE void pdirent(struct procbuf *b, ino_t num, const char *name)
+{
+	struct d_dirent *d; /* Directory entry. */
+	
+	/* Buffer is full. */
+	if (b->len > PROCBUF_MAX)
+		return;
+	
+	d = (struct d_dirent *)(b->data + b->len);
+	d->d_ino = num;
+	kmemset(d->d_name, 0, MINIX_NAME_MAX);
+	kstrncpy(d->d_name, name, MINIX_NAME_MAX);
+	b->len += sizeof(struct d_dirent);
+}
+
+/**
+ * @brief Writes a histogram to an output buffer.
+ * 
+ * @param b    Output buffer.
+ * @param name Histogram name.
+ * @param h    Histogram buckets.
+ */
+PRIVATE void phist(struct procbuf *b, const char *name, const unsigned *h)
+{
+	pprintf(b, "%s:", name);
+	for (unsigned i = 0; i < NR_SCHEDHIST; i++)
+		pprintf(b, " %d", h[i]);
+	pprintf(b, "\n");
+}
+
+/*============================================================================*
+ *                                Global Files                                *
+ *============================================================================*/
+
+/**
+ * @brief Shows block buffer cache statistics.
+ */
+PRIVATE void show_buffers(struct procbuf *b, struct process *p)
+{
+	struct bcache_stat st;
+	
+	((void)p);
+	
+	buffer_stat(&st);
+	pprintf(b, "buffers:\t%d\n", st.nbuffers);
+	pprintf(b, "valid:\t%d\n", st.nvalid);
+	pprintf(b, "dirty:\t%d\n", st.ndirty);
+	pprintf(b, "busy:\t%d\n", st.nbusy);
+	pprintf(b, "hits:\t%d\n", st.hits);
+	pprintf(b, "misses:\t%d\n", st.misses);
+}
+
+/**
+ * @brief Shows inode cache statistics.
+ */
+PRIVATE void show_inodes(struct procbuf *b, struct process *p)
+{
+	struct icache_stat st;
+	
+	((void)p);
+	
+	inode_stat(&st);
+	pprintf(b, "inodes:\t%d\n", st.ninodes);
+	pprintf(b, "valid:\t%d\n", st.nvalid);
+	pprintf(b, "hits:\t%d\n", st.hits);
+	pprintf(b, "misses:\t%d\n", st.misses);
+}
+
+/**
+ * @brief Shows page frame allocator statistics.
+ */
+PRIVATE void show_frames(struct procbuf *b, struct process *p)
+{
+	struct mem_stat st;
+	
+	((void)p);
+	
+	mm_stat(&st);
+	pprintf(b, "frames:\t%d\n", st.nframes);
+	pprintf(b, "free:\t%d\n", st.nfree);
+	pprintf(b, "shared:\t%d\n", st.nshared);
+	pprintf(b, "locked:\t%d\n", st.nlocked);
+	pprintf(b, "kpages:\t%d\n", st.nkpages);
+	pprintf(b, "kfree:\t%d\n", st.nkfree);
+	pprintf(b, "faults:\t%d\n", st.faults);
+	pprintf(b, "cows:\t%d\n", st.cows);
+	pprintf(b, "evictions:\t%d\n", st.evictions);
+}
+
+/**
+ * @brief Shows swap statistics.
+ */
+PRIVATE void show_swap(struct procbuf *b, struct process *p)
+{
+	struct mem_stat mst;
+	struct swap_stat st;
+	
+	((void)p);
+	
+	mm_stat(&mst);
+	swap_stat(&st);
+	pprintf(b, "areas:\t%d\n", st.nareas);
+	pprintf(b, "slots:\t%d\n", st.nslots);
+	pprintf(b, "used:\t%d\n", st.nused);
+	pprintf(b, "swapins:\t%d\n", mst.swapins);
+	pprintf(b, "swapouts:\t%d\n", mst.swapouts);
+}
+
+/**
+ * @brief Shows scheduler statistics.
+ */
+PRIVATE void show_sched(struct procbuf *b, struct process *p)
+{
+	struct sched_stat st;
+	
+	((void)p);
+	
+	sched_stat(&st);
+	pprintf(b, "processes:\t%d\n", st.nprocs);
+	pprintf(b, "ready:\t%d\n", st.nready);
+	pprintf(b, "waiting:\t%d\n", st.nwaiting);
+	pprintf(b, "stopped:\t%d\n", st.nstopped);
+	pprintf(b, "switches:\t%d\n", st.nswitches);
+	pprintf(b, "ticks:\t%d\n", ticks);
+	pprintf(b, "freq:\t%d\n", CLOCK_FREQ);
+}
+
+/**
+ * @brief Shows scheduling latency histograms.
+ * 
+ * @details Prints histograms of the time that processes have been ready
+ *          before running, of the time that they have run in a time slice,
+ *          and of the run queue length. Latency buckets are logarithmic in
+ *          microseconds, and run queue buckets are linear.
+ */
+PRIVATE void show_latency(struct procbuf *b, struct process *p)
+{
+	struct sched_hist h;      /* Latency histograms.  */
+	unsigned q[NR_SCHEDHIST]; /* Run queue histogram. */
+	
+	((void)p);
+	
+	sched_hist(&h, q);
+	phist(b, "delay", h.delay);
+	phist(b, "slice", h.slice);
+	phist(b, "runq", q);
+}
+
+/**
+ * @brief Shows network interface statistics.
+ * 
+ * @details Addresses are printed in host byte order.
+ */
+PRIVATE void show_net(struct procbuf *b, struct process *p)
+{
+	struct netstat st;   /* Statistics.    */
+	struct netconf conf; /* Configuration. */
+	
+	((void)p);
+	
+	net_stat(&st, &conf);
+	pprintf(b, "up:\t%d\n", (conf.flags & IFF_UP) ? 1 : 0);
+	pprintf(b, "addr:\t%x\n", ntohl(conf.addr));
+	pprintf(b, "netmask:\t%x\n", ntohl(conf.netmask));
+	pprintf(b, "gateway:\t%x\n", ntohl(conf.gateway));
+	pprintf(b, "rxpackets:\t%d\n", st.rxpackets);
+	pprintf(b, "rxbytes:\t%d\n", st.rxbytes);
+	pprintf(b, "rxdropped:\t%d\n", st.rxdropped);
+	pprintf(b, "txpackets:\t%d\n", st.txpackets);
+	pprintf(b, "txbytes:\t%d\n", st.txbytes);
+	pprintf(b, "txdropped:\t%d\n", st.txdropped);
+	pprintf(b, "loopback:\t%d\n", st.loopback);
+	pprintf(b, "arpmisses:\t%d\n", st.arpmisses);
+	pprintf(b, "noport:\t%d\n", st.noport);
+	pprintf(b, "nobufs:\t%d\n", st.nobufs);
+}
+
+/**
+ * @brief Shows sleeping chain statistics.
+ * 
+ * @details Prints one line for each sleeping chain, with its address, the
+ *          number of sleeps, wakeups and wakeups that found no sleeping
+ *          process, the total and maximum blocked ticks, and the top call
+ *          sites with their sleep counts. Most blocked chains come first.
+ *          The number of chains evicted from the statistics table is shown
+ *          beforehand, and if it is non-zero, the table has been saturated.
+ */
+PRIVATE void show_chains(struct procbuf *b, struct process *p)
+{
+	unsigned max;             /* Most blocked chain.   */
+	unsigned total;           /* Most blocked ticks.   */
+	struct chain_stat st;     /* Working statistics.   */
+	char done[NR_CHAINSTATS]; /* Chain already shown?  */
+	
+	((void)p);
+	
+	pprintf(b, "evicted:\t%d\n", chain_evicted());
+	
+	kmemset(done, 0, NR_CHAINSTATS);
+	
+	/* Show most blocked chains first. */
+	while (b->len <= PROCBUF_MAX)
+	{
+		max = NR_CHAINSTATS;
+		total = 0;
+		for (unsigned i = 0; i < NR_CHAINSTATS; i++)
+		{
+			/* Entry not in use. */
+			if ((done[i]) || (chain_stat(i, &st)))
+				continue;
+			
+			if ((max == NR_CHAINSTATS) || (st.total > total))
+			{
+				max = i;
+				total = st.total;
+			}
+		}
+		
+		/* Done. */
+		if (max == NR_CHAINSTATS)
+			break;
+		
+		done[max] = 1;
+		chain_stat(max, &st);
+		
+		pprintf(b, "%x %d %d %d %d %d",
+			st.chain, st.nsleeps, st.nwakeups, st.nempty, st.total, st.max);
+		
+		for (unsigned j = 0; j < NR_CALLSITES; j++)
+		{
+			if (st.sites[j].count > 0)
+				pprintf(b, " %x:%d", st.sites[j].addr, st.sites[j].count);
+		}
+		
+		pprintf(b, "\n");
+	}
+}
+
+/**
+ * @brief Shows the longest interrupts-off sections.
+ * 
+ * @details Prints one line for each traced section, longest first, with the
+ *          call sites that have disabled and enabled interrupts, the number of
+ *          times that the section was seen and its longest duration in
+ *          nanoseconds. Nothing is printed unless IRQTRACE is enabled.
+ */
+PRIVATE void show_irqoff(struct procbuf *b, struct process *p)
+{
+	unsigned max;            /* Longest section.        */
+	unsigned cycles;         /* Longest duration.       */
+	struct irqtrace tr;      /* Working section.        */
+	char done[NR_IRQTRACES]; /* Section already shown?  */
+	
+	((void)p);
+	
+	kmemset(done, 0, NR_IRQTRACES);
+	
+	while (1)
+	{
+		max = NR_IRQTRACES;
+		cycles = 0;
+		for (unsigned i = 0; i < NR_IRQTRACES; i++)
+		{
+			/* Record not in use. */
+			if ((done[i]) || (irqtrace_stat(i, &tr)))
+				continue;
+			
+			if ((max == NR_IRQTRACES) || (tr.max > cycles))
+			{
+				max = i;
+				cycles = tr.max;
+			}
+		}
+		
+		/* Done. */
+		if (max == NR_IRQTRACES)
+			break;
+		
+		done[max] = 1;
+		irqtrace_stat(max, &tr);
+		
+		pprintf(b, "%x %x %d %d\n", tr.off, tr.on, tr.count, clock_nsec(tr.max));
+	}
+}
+
+/**
+ * @brief Global files.
+ */
+PRIVATE const struct procfile globals[] = {
+	{ "buffers", show_buffers },
+	{ "inodes",  show_inodes  },
+	{ "frames",  show_frames  },
+	{ "swap",    show_swap    },
+	{ "sched",   show_sched   },
+	{ "chains",  show_chains  },
+	{ "irqoff",  show_irqoff  },
+	{ "latency", show_latency },
+	{ "net",     show_net     }
+};
+
+/**
+ * @brief Number of global files.
+ */
+#define NR_GLOBALS (sizeof(globals)/sizeof(globals[0]))
+
+/*============================================================================*
+ *                               Process Files                                *
+ *============================================================================*/
+
+/**
+ * @brief Shows the status of a process.
+ */
+PRIVATE void show_status(struct procbuf *b, struct process *p)
+{
+	pprintf(b, "name:\t%s\n", p->name);
+	pprintf(b, "pid:\t%d\n", p->pid);
+	pprintf(b, "ppid:\t%d\n", (p->father != NULL) ? p->father->pid : 0);
+	pprintf(b, "pgrp:\t%d\n", (p->pgrp != NULL) ? p->pgrp->pid : 0);
+	pprintf(b, "uid:\t%d\n", p->uid);
+	pprintf(b, "euid:\t%d\n", p->euid);
+	pprintf(b, "gid:\t%d\n", p->gid);
+	pprintf(b, "egid:\t%d\n", p->egid);
+	pprintf(b, "state:\t%s\n", states[p->state]);
+	pprintf(b, "priority:\t%s%d\n", SIGN(p->priority), ABS(p->priority));
+	pprintf(b, "nice:\t%s%d\n", SIGN(p->nice), ABS(p->nice));
+	pprintf(b, "children:\t%d\n", p->nchildren);
+	pprintf(b, "syscalls:\t%d\n", p->nsyscalls);
+}
+
+/**
+ * @brief Shows the times of a process.
+ */
+PRIVATE void show_times(struct procbuf *b, struct process *p)
+{
+	pprintf(b, "utime:\t%d\n", p->utime);
+	pprintf(b, "ktime:\t%d\n", p->ktime);
+	pprintf(b, "cutime:\t%d\n", p->cutime);
+	pprintf(b, "cktime:\t%d\n", p->cktime);
+}
+
+/**
+ * @brief Shows the memory of a process.
+ */
+PRIVATE void show_memory(struct procbuf *b, struct process *p)
+{
+	unsigned npages;                 /* Resident pages.       */
+	struct region *reg;              /* Working region.       */
+	const char *names[NR_PREGIONS];  /* Process region names. */
+	
+	names[0] = "text";
+	names[1] = "data";
+	names[2] = "stack";
+	names[3] = "heap";
+	
+	pprintf(b, "size:\t%d\n", p->size);
+	
+	for (unsigned i = 0; i < NR_PREGIONS; i++)
+	{
+		/* Region not attached. */
+		if ((reg = p->pregs[i].reg) == NULL)
+			continue;
+		
+		/* Count resident pages. */
+		npages = 0;
+		for (unsigned j = 0; j < REGION_PGTABS; j++)
+		{
+			if (reg->pgtab[j] == NULL)
+				continue;
+			
+			for (unsigned k = 0; k < PAGE_SIZE/sizeof(struct pte); k++)
+			{
+				if (reg->pgtab[j][k].present)
+					npages++;
+			}
+		}
+		
+		pprintf(b, "%s:\t%x %d %d\n",
+			(i < 4) ? names[i] : "region",
+			p->pregs[i].start,
+			reg->size,
+			npages << PAGE_SHIFT
+		);
+	}
+}
+
+/**
+ * @brief Shows the scheduling latency histograms of a process.
+ */
+PRIVATE void show_platency(struct procbuf *b, struct process *p)
+{
+	phist(b, "delay", p->hist.delay);
+	phist(b, "slice", p->hist.slice);
+}
+
+/**
+ * @brief Shows the open files of a process.
+ */
+PRIVATE void show_files(struct procbuf *b, struct process *p)
+{
+	struct file *f;  /* Working file.  */
+	struct inode *i; /* Working inode. */
+	
+	for (unsigned fd = 0; fd < OPEN_MAX; fd++)
+	{
+		/* Not open. */
+		if ((f = p->ofiles[fd]) == NULL)
+			continue;
+		
+		i = f->inode;
+		pprintf(b, "%d:\t%x %d %x %d %x\n",
+			fd, i->dev, i->num, i->mode, f->pos, f->oflag);
+	}
+}
+
+/**
+ * @brief Process files.
+ */
+PRIVATE const struct procfile pfiles[] = {
+	{ "status",  show_status   },
+	{ "times",   show_times    },
+	{ "memory",  show_memory   },
+	{ "files",   show_files    },
+	{ "latency", show_platency }
+};
+
+/**
+ * @brief Number of process files.
+ */
+#define NR_PFILES (sizeof(pfiles)/sizeof(pfiles[0]))
+
+/*============================================================================*
+ *                                Directories                                 *
+ *============================================================================*/
+
+/**
+ * @brief Shows the root directory.
+ */
+PRIVATE void show_root(struct procbuf *b)
+{
+	char name[MINIX_NAME_MAX + 1]; /* Entry name.   */
+	struct procbuf nb;             /* Name buffer.  */
+	
+	pdirent(b, PROC_ROOT, ".");
+	pdirent(b, PROC_ROOT, "..");
+	
+	for (unsigned i = 0; i < NR_GLOBALS; i++)
+		pdirent(b, PROC_FIRST + i, globals[i].name);
+	
+	for (struct process *p = IDLE; p <= LAST_PROC; p++)
+	{
+		/* Skip invalid processes. */
+		if (!IS_VALID(p))
+			continue;
+		
+		nb.data = name;
+		nb.len = 0;
+		pprintf(&nb, "%d", p->pid);
+		name[nb.len] = '\0';
+		
+		pdirent(b, PROC_INO(p - IDLE, 0), name);
+	}
+}
+
+/**
+ * @brief Shows a process directory.
+ */
+PRIVATE void show_dir(struct procbuf *b, struct process *p)
+{
+	pdirent(b, PROC_INO(p - IDLE, 0), ".");
+	pdirent(b, PROC_ROOT, "..");
+	
+	for (unsigned i = 0; i < NR_PFILES; i++)
+		pdirent(b, PROC_INO(p - IDLE, i + 1), pfiles[i].name);
+}
+
+/*============================================================================*
+ *                              Inode Interface                               *
+ *============================================================================*/
+
+/**
+ * @brief Gets the process of a process file system inode.
+ * 
+ * @param ip Process file system inode.
+ * 
+ * @returns The process that the inode refers to, or a NULL pointer if the
+ *          inode does not refer to a process or the process is gone.
+ */
+PRIVATE struct process *procfs_proc(struct inode *ip)
+{
+	struct process *p; /* Process. */
+	
+	/* Not a process file. */
+	if ((ip->num == PROC_ROOT) || PROC_GLOBAL(ip->num))
+		return (NULL);
+	
+	p = &proctab[PROC_SLOT(ip->num)];
+	
+	/* Process is gone. */
+	if ((!IS_VALID(p)) || (p->pid != PROC_PID(ip)))
+		return (NULL);
+	
+	return (p);
+}
+
+/**
+ * @brief Fills in a process file system inode.
+ * 
+ * @details Fills in the attributes of the process file system inode pointed
+ *          to by @p ip, based on its inode number.
+ * 
+ * @param ip Process file system inode.
+ * 
+ * @returns Zero if the file exists, and non-zero otherwise.
+ * 
+ * @note The inode must be locked.
+ */
+PUBLIC int procfs_inode(struct inode *ip)
+{
+	unsigned slot;     /* Process table slot. */
+	unsigned file;     /* File.               */
+	struct process *p; /* Process.            */
+	
+	/* Root directory. */
+	if (ip->num == PROC_ROOT)
+	{
+		ip->mode = S_IFDIR | MAY_READ | MAY_EXEC;
+		ip->nlinks = 2;
+		goto found;
+	}
+	
+	/* Global file. */
+	if (PROC_GLOBAL(ip->num))
+	{
+		if ((unsigned)(ip->num - PROC_FIRST) >= NR_GLOBALS)
+			return (-1);
+		
+		ip->mode = S_IFREG | MAY_READ;
+		goto found;
+	}
+	
+	slot = PROC_SLOT(ip->num);
+	file = PROC_FILE(ip->num);
+	
+	/* No such process. */
+	if ((slot >= PROC_MAX) || (!IS_VALID(p = &proctab[slot])))
+		return (-1);
+	
+	/* No such file. */
+	if (file > NR_PFILES)
+		return (-1);
+	
+	ip->mode = (file == 0) ? S_IFDIR | MAY_READ | MAY_EXEC : S_IFREG | MAY_READ;
+	ip->nlinks = (file == 0) ? 2 : 1;
+	ip->uid = p->uid;
+	ip->gid = p->gid;
+	ip->blocks[0] = p->pid;
+
+found:
+	nopen++;
+	return (0);
+}
+
+/**
+ * @brief Releases a process file system inode.
+ * 
+ * @param ip Process file system inode.
+ */
+PUBLIC void procfs_put(struct inode *ip)
+{
+	((void)ip);
+	
+	nopen--;
+}
+
+/**
+ * @brief Searches for a file in a process file system directory.
+ * 
+ * @param dip  Directory where the file shall be searched.
+ * @param name Name of the file.
+ * 
+ * @returns If the file exists, its inode number is returned. Otherwise,
+ *          #INODE_NULL is returned instead.
+ * 
+ * @note The directory must be locked.
+ */
+PUBLIC ino_t procfs_lookup(struct inode *dip, const char *name)
+{
+	pid_t pid;         /* Process ID.   */
+	const char *s;     /* Working name. */
+	struct process *p; /* Process.      */
+	
+	/* Current directory. */
+	if (!kstrcmp(name, "."))
+		return (dip->num);
+	
+	/* Parent directory. */
+	if (!kstrcmp(name, ".."))
+		return (PROC_ROOT);
+	
+	/* Process directory. */
+	if (dip->num != PROC_ROOT)
+	{
+		if ((p = procfs_proc(dip)) == NULL)
+			return (INODE_NULL);
+		
+		for (unsigned i = 0; i < NR_PFILES; i++)
+		{
+			if (!kstrcmp(name, pfiles[i].name))
+				return (PROC_INO(p - IDLE, i + 1));
+		}
+		
+		return (INODE_NULL);
+	}
+	
+	/* Global file. */
+	for (unsigned i = 0; i < NR_GLOBALS; i++)
+	{
+		if (!kstrcmp(name, globals[i].name))
+			return (PROC_FIRST + i);
+	}
+	
+	/* Parse process ID. */
+	pid = 0;
+	for (s = name; (*s >= '0') && (*s <= '9'); s++)
+		pid = pid*10 + (*s - '0');
+	if ((s == name) || (*s != '\0'))
+		return (INODE_NULL);
+	
+	for (p = IDLE; p <= LAST_PROC; p++)
+	{
+		/* Found. */
+		if (IS_VALID(p) && (p->pid == pid))
+			return (PROC_INO(p - IDLE, 0));
+	}
+	
+	return (INODE_NULL);
+}
+
+/**
+ * @brief Reads from a process file system file.
+ * 
+ * @details Generates the contents of the file pointed to by @p ip and copies
+ *          up to @p n bytes, starting at offset @p off, to the buffer pointed
+ *          to by @p buf. Directories read as arrays of directory entries.
+ * 
+ * @param ip  File to be read.
+ * @param buf Target buffer.
+ * @param n   Number of bytes to read.
+ * @param off Read offset.
+ * 
+ * @returns Upon successful completion, the number of bytes read is returned.
+ *          Upon failure, -1 is returned instead, and the error code is set in
+ *          the calling process.
+ */
+PUBLIC ssize_t procfs_read(struct inode *ip, void *buf, size_t n, off_t off)
+{
+	struct procbuf b;  /* Output buffer. */
+	struct process *p; /* Process.       */
+	
+	if ((b.data = getkpg(0)) == NULL)
+	{
+		curr_proc->errno = -ENOMEM;
+		return (-1);
+	}
+	b.len = 0;
+	
+	p = procfs_proc(ip);
+	
+	/* Root directory. */
+	if (ip->num == PROC_ROOT)
+		show_root(&b);
+	
+	/* Global file. */
+	else if (PROC_GLOBAL(ip->num))
+		globals[ip->num - PROC_FIRST].show(&b, NULL);
+	
+	/* Process is gone. */
+	else if (p == NULL)
+		b.len = 0;
+	
+	/* Process directory. */
+	else if (PROC_FILE(ip->num) == 0)
+		show_dir(&b, p);
+	
+	/* Process file. */
+	else
+		pfiles[PROC_FILE(ip->num) - 1].show(&b, p);
+	
+	/* Copy data. */
+	if (off >= (off_t)b.len)
+		n = 0;
+	else if (n > b.len - off)
+		n = b.len - off;
+	kmemcpy(buf, b.data + off, n);
+	
+	putkpg(b.data);
+	
+	return ((ssize_t)n);
+}
+
+/*============================================================================*
+ *                                 Mounting                                   *
+ *============================================================================*/
+
+/**
+ * @brief Mounts the process file system.
+ * 
+ * @param mp Directory where the file system shall be mounted.
+ * 
+ * @returns Upon successful completion, zero is returned. Upon failure, a
+ *          negative error code is returned instead.
+ * 
+ * @note The directory must be locked. On success, the reference to it is
+ *       kept by the mount.
+ */
+PUBLIC int procfs_mount(struct inode *mp)
+{
+	/* Not a directory. */
+	if (!S_ISDIR(mp->mode))
+		return (-ENOTDIR);
+	
+	/* Already mounted. */
+	if ((procfs_mp != NULL) || (mp->dev == PROC_DEV))
+		return (-EBUSY);
+	
+	mp->mdev = PROC_DEV;
+	mp->mroot = PROC_ROOT;
+	mp->flags |= INODE_MOUNT;
+	procfs_mp = mp;
+	
+	return (0);
+}
+
+/**
+ * @brief Unmounts the process file system.
+ * 
+ * @param ip Root directory of the process file system.
+ * 
+ * @returns Upon successful completion, zero is returned. Upon failure, a
+ *          negative error code is returned instead.
+ * 
+ * @note The root directory must be locked.
+ */
+PUBLIC int procfs_umount(struct inode *ip)
+{
+	struct inode *mp; /* Mount point. */
+	
+	/* Not mounted here. */
+	if ((ip->dev != PROC_DEV) || (ip->num != PROC_ROOT) || (procfs_mp == NULL))
+		return (-EINVAL);
+	
+	/* Files in use. */
+	if (nopen > 1)
+		return (-EBUSY);
+	
+	mp = procfs_mp;
+	procfs_mp = NULL;
+	
+	inode_lock(mp);
+	mp->flags &= ~INODE_MOUNT;
+	inode_put(mp);
+	
+	return (0);
+}
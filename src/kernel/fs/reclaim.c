@@ -0,0 +1,398 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ *
+ * This file is part of Nanvix.
+ *
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nanvix/const.h>
+#include <nanvix/fs.h>
+#include <nanvix/klib.h>
+#include <nanvix/pm.h>
+#include <errno.h>
+#include "fs.h"
+
+/**
+ * @file
+ *
+ * @brief Block reclaim module implementation.
+ *
+ * @details Disk blocks of truncated inodes are not freed by the process that
+ *          has released them. Instead, zones are detached from the inode and
+ *          queued, and the reclaim daemon later walks indirect blocks and
+ *          clears the zone map, one batch of blocks at a time.
+ */
+
+/**
+ * @brief Number of blocks freed at once.
+ */
+#define RECLAIM_BATCH 512
+
+/* Error checking. */
+#if ZMAP_SIZE > 32
+	#error "ZMAP_SIZE must be smaller than or equal to 32"
+#endif
+
+/**
+ * @brief Pending reclaim.
+ */
+struct reclaim
+{
+	struct superblock *sb;    /**< Superblock.                 */
+	block_t blocks[NR_ZONES]; /**< Detached zones.             */
+	block_t nblocks;          /**< Estimated number of blocks. */
+};
+
+/**
+ * @brief Reclaim queue.
+ */
+PRIVATE struct reclaim reclaimq[NR_RECLAIMS];
+
+/**
+ * @brief First pending reclaim.
+ */
+PRIVATE unsigned head = 0;
+
+/**
+ * @brief Number of pending reclaims.
+ */
+PRIVATE unsigned nreclaims = 0;
+
+/**
+ * @brief Blocks that are about to be freed.
+ */
+PRIVATE block_t batch[RECLAIM_BATCH];
+
+/**
+ * @brief Number of blocks in the batch.
+ */
+PRIVATE unsigned nbatch = 0;
+
+/**
+ * @brief Is the reclaim queue being processed?
+ */
+PRIVATE int busy = 0;
+
+/**
+ * @brief Processes waiting for the reclaim queue.
+ */
+PRIVATE struct process *chain = NULL;
+
+/**
+ * @brief Sleeping chain of the reclaim daemon.
+ */
+PRIVATE struct process *reclaimd_chain = NULL;
+
+/**
+ * @brief Estimates the number of disk blocks of an inode.
+ *
+ * @details Estimates the number of disk blocks of the inode pointed to by
+ *          @p ip, including indirect blocks. Direct zones are counted exactly,
+ *          and blocks behind indirect zones are estimated from the file size,
+ *          without reading indirect blocks. Holes in sparse files are not
+ *          backed by any block, so the estimate is an upper bound.
+ *
+ * @param ip Inode to be inspected.
+ *
+ * @returns The estimated number of disk blocks.
+ *
+ * @note The inode must be locked.
+ */
+PRIVATE block_t reclaim_estimate(struct inode *ip)
+{
+	unsigned n;       /* Data blocks left. */
+	unsigned nblocks; /* Estimate.         */
+
+	n = (ip->size + BLOCK_SIZE - 1) >> BLOCK_SIZE_LOG2;
+	nblocks = 0;
+
+	/* Direct blocks. */
+	for (unsigned j = 0; j < NR_ZONES_DIRECT; j++)
+	{
+		if (ip->blocks[ZONE_DIRECT + j] != BLOCK_NULL)
+			nblocks++;
+	}
+
+	/* Single indirect block. */
+	if (n > NR_ZONES_DIRECT)
+	{
+		n -= NR_ZONES_DIRECT;
+		if (ip->blocks[ZONE_SINGLE] != BLOCK_NULL)
+			nblocks += 1 + ((n < NR_SINGLE) ? n : NR_SINGLE);
+
+		/* Double indirect block. */
+		if (n > NR_SINGLE)
+		{
+			n -= NR_SINGLE;
+			if (ip->blocks[ZONE_DOUBLE] != BLOCK_NULL)
+				nblocks += 1 + n + (n + NR_SINGLE - 1)/NR_SINGLE;
+		}
+	}
+
+	/* Cannot hold more blocks than the file system. */
+	if (nblocks > ip->sb->zones)
+		nblocks = ip->sb->zones;
+
+	return ((block_t)nblocks);
+}
+
+/**
+ * @brief Frees the blocks in the batch.
+ *
+ * @details Clears all blocks in the batch from the zone map of the superblock
+ *          pointed to by @p sb, locking the superblock only once. Each zone
+ *          map buffer that has been touched is marked as dirty.
+ *
+ * @param sb Superblock in which the blocks should be freed.
+ *
+ * @note The superblock must not be locked.
+ */
+PRIVATE void reclaim_commit(struct superblock *sb)
+{
+	block_t num;      /* Block number.            */
+	unsigned idx;     /* Bitmap index.            */
+	unsigned touched; /* Touched zone map blocks. */
+
+	/* Nothing to be done. */
+	if (nbatch == 0)
+		return;
+
+	touched = 0;
+
+	superblock_lock(sb);
+
+	for (unsigned i = 0; i < nbatch; i++)
+	{
+		num = batch[i];
+
+		/*
+		 * Remember free disk block to
+		 * speedup next block allocation.
+		 */
+		if (num < sb->zsearch)
+			sb->zsearch = num;
+
+		num -= sb->first_data_block;
+		idx = num/(BLOCK_SIZE << 3);
+
+		bitmap_clear(sb->zmap[idx]->data, num%(BLOCK_SIZE << 3));
+		touched |= 1 << idx;
+	}
+
+	/* Write back touched zone map blocks. */
+	for (idx = 0; idx < sb->zmap_blocks; idx++)
+	{
+		if (touched & (1 << idx))
+			sb->zmap[idx]->flags |= BUFFER_DIRTY;
+	}
+	sb->flags |= SUPERBLOCK_DIRTY;
+
+	superblock_unlock(sb);
+
+	nbatch = 0;
+}
+
+/**
+ * @brief Adds a block to the batch.
+ *
+ * @param sb  Superblock in which the block should be freed.
+ * @param num Number of the block.
+ */
+PRIVATE void reclaim_add(struct superblock *sb, block_t num)
+{
+	/* Nothing to be done. */
+	if (num == BLOCK_NULL)
+		return;
+
+	/* Bad block number. */
+	if ((num < sb->first_data_block) ||
+		(num >= sb->first_data_block + sb->zones))
+	{
+		kprintf("fs: bad block %d on reclaim", num);
+		return;
+	}
+
+	/* Batch is full. */
+	if (nbatch == RECLAIM_BATCH)
+		reclaim_commit(sb);
+
+	batch[nbatch++] = num;
+}
+
+/**
+ * @brief Adds a single indirect block to the batch.
+ *
+ * @param sb  Superblock in which the block should be freed.
+ * @param num Number of the single indirect block.
+ */
+PRIVATE void reclaim_add_indirect(struct superblock *sb, block_t num)
+{
+	struct buffer *buf; /* Block buffer. */
+
+	/* Nothing to be done. */
+	if (num == BLOCK_NULL)
+		return;
+
+	buf = bread(sb->dev, num);
+
+	for (unsigned i = 0; i < NR_SINGLE; i++)
+		reclaim_add(sb, ((block_t *)buf->data)[i]);
+	reclaim_add(sb, num);
+
+	brelse(buf);
+}
+
+/**
+ * @brief Adds a doubly indirect block to the batch.
+ *
+ * @param sb  Superblock in which the block should be freed.
+ * @param num Number of the doubly indirect block.
+ */
+PRIVATE void reclaim_add_dindirect(struct superblock *sb, block_t num)
+{
+	struct buffer *buf; /* Block buffer. */
+
+	/* Nothing to be done. */
+	if (num == BLOCK_NULL)
+		return;
+
+	buf = bread(sb->dev, num);
+
+	for (unsigned i = 0; i < NR_SINGLE; i++)
+		reclaim_add_indirect(sb, ((block_t *)buf->data)[i]);
+	reclaim_add(sb, num);
+
+	brelse(buf);
+}
+
+/**
+ * @brief Processes all pending reclaims.
+ *
+ * @note The reclaim queue must be owned by the calling process.
+ */
+PRIVATE void reclaim_run(void)
+{
+	struct reclaim r; /* Working reclaim. */
+
+	while (nreclaims > 0)
+	{
+		r = reclaimq[head];
+		head = (head + 1)%NR_RECLAIMS;
+		nreclaims--;
+
+		/* Collect blocks. */
+		for (unsigned j = 0; j < NR_ZONES_DIRECT; j++)
+			reclaim_add(r.sb, r.blocks[ZONE_DIRECT + j]);
+		for (unsigned j = 0; j < NR_ZONES_SINGLE; j++)
+			reclaim_add_indirect(r.sb, r.blocks[ZONE_SINGLE + j]);
+		for (unsigned j = 0; j < NR_ZONES_DOUBLE; j++)
+			reclaim_add_dindirect(r.sb, r.blocks[ZONE_DOUBLE + j]);
+
+		reclaim_commit(r.sb);
+
+		superblock_lock(r.sb);
+		r.sb->zpending -= r.nblocks;
+		superblock_put(r.sb);
+	}
+}
+
+/**
+ * @brief Queues the disk blocks of an inode for reclaim.
+ *
+ * @details Copies the zones of the inode pointed to by @p ip to the reclaim
+ *          queue and accounts them as free in the underlying superblock. The
+ *          caller is expected to detach these zones from the inode.
+ *
+ * @param ip Inode whose blocks shall be reclaimed.
+ *
+ * @returns Upon successful completion, zero is returned. If the reclaim queue
+ *          is full or the system is shutting down, a negative error code is
+ *          returned instead, and blocks should be freed synchronously.
+ *
+ * @note The inode must be locked.
+ */
+PUBLIC int reclaim_enqueue(struct inode *ip)
+{
+	struct reclaim *r;     /* Reclaim.                 */
+	struct superblock *sb; /* Underlying super block.  */
+
+	/* The reclaim daemon may be gone. */
+	if (shutting_down)
+		return (-EBUSY);
+
+	/* Reclaim queue overflow. */
+	if (nreclaims == NR_RECLAIMS)
+		return (-EAGAIN);
+
+	r = &reclaimq[(head + nreclaims)%NR_RECLAIMS];
+	nreclaims++;
+
+	r->sb = sb = ip->sb;
+	r->nblocks = reclaim_estimate(ip);
+	for (unsigned i = 0; i < NR_ZONES; i++)
+		r->blocks[i] = ip->blocks[i];
+
+	/* Account blocks as free and hold superblock. */
+	superblock_lock(sb);
+	sb->zpending += r->nblocks;
+	sb->count++;
+	superblock_unlock(sb);
+
+	wakeup(&reclaimd_chain);
+
+	return (0);
+}
+
+/**
+ * @brief Flushes the reclaim queue.
+ *
+ * @details Frees the disk blocks of all pending reclaims, waiting for any
+ *          reclaim that is already in progress.
+ */
+PUBLIC void reclaim_flush(void)
+{
+	while (busy)
+		sleep(&chain, PRIO_SUPERBLOCK);
+	busy = 1;
+
+	reclaim_run();
+
+	busy = 0;
+	wakeup(&chain);
+}
+
+/**
+ * @brief Reclaim daemon.
+ *
+ * @details Frees disk blocks of truncated inodes in background. This function
+ *          does not return: on system shutdown the reclaim queue is flushed
+ *          and the daemon exits.
+ */
+PUBLIC void reclaimd(void)
+{
+	while (1)
+	{
+		reclaim_flush();
+
+		/* Nothing else will be queued. */
+		if (shutting_down)
+			die(0);
+
+		curr_proc->received = 0;
+
+		if (nreclaims == 0)
+			sleep(&reclaimd_chain, PRIO_USER);
+	}
+}
@@ -0,0 +1,1517 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of Nanvix.
+ * 
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nanvix/config.h>
+#include <nanvix/const.h>
+#include <nanvix/fs.h>
+#include <nanvix/klib.h>
+#include <nanvix/mm.h>
+#include <nanvix/net.h>
+#include <nanvix/pm.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+
+/**
+ * @file
+ * 
+ * @brief UNIX domain and Internet sockets.
+ * 
+ * @details Each socket has a receive buffer, where peers place data, and a
+ *          queue of records describing it. A record marks the boundaries of
+ *          a datagram, and carries file descriptors that are passed along.
+ *          Stream sockets coalesce consecutive records that carry no file
+ *          descriptors, so that small writes do not use up the queue.
+ * 
+ *          Internet sockets are datagram sockets only. Outgoing datagrams
+ *          are handed to UDP, and incoming datagrams are placed in the
+ *          receive buffer by the network daemon.
+ */
+
+/**
+ * @brief Size of the receive buffer (in bytes).
+ */
+#define SOCK_BUFSIZE PAGE_SIZE
+
+/**
+ * @brief Number of records in a receive buffer.
+ */
+#define NR_RECORDS 16
+
+/**
+ * @name Ephemeral ports
+ */
+/**@{*/
+#define PORT_EPHEMERAL_MIN 49152 /**< First ephemeral port. */
+#define PORT_EPHEMERAL_MAX 65535 /**< Last ephemeral port.  */
+/**@}*/
+
+/**
+ * @brief First port that does not require privileges.
+ */
+#define PORT_RESERVED 1024
+
+/**
+ * @name Socket flags
+ */
+/**@{*/
+#define SOCK_USED      (1 << 0) /**< Used?                  */
+#define SOCK_LISTENING (1 << 1) /**< Accepting connections? */
+#define SOCK_CONNECTED (1 << 2) /**< Connected?             */
+/**@}*/
+
+/**
+ * @brief Record.
+ */
+struct record
+{
+	size_t len;                     /**< Data length.            */
+	int nfiles;                     /**< Number of passed files. */
+	struct file *files[SCM_MAX_FD]; /**< Passed files.           */
+	struct socket *from;            /**< Sender.                 */
+	unsigned fromgen;               /**< Generation of sender.   */
+	struct sockaddr_in fromin;      /**< Internet sender.        */
+};
+
+/**
+ * @brief Socket table.
+ */
+PRIVATE struct socket
+{
+	int flags;                          /**< Flags.                       */
+	int domain;                         /**< Address family.              */
+	int type;                           /**< Socket type.                 */
+	unsigned gen;                       /**< Generation number.           */
+	struct inode *name;                 /**< Bound name.                  */
+	char path[UNIX_PATH_MAX];           /**< Bound pathname.              */
+	struct inode *target;               /**< Default destination.         */
+	struct socket *peer;                /**< Connected peer.              */
+	struct sockaddr_in local;           /**< Bound Internet address.      */
+	struct sockaddr_in remote;          /**< Connected Internet address.  */
+	int backlog;                        /**< Maximum pending connections. */
+	int npending;                       /**< Pending connections.         */
+	struct socket *pending[SOMAXCONN];  /**< Pending connections.         */
+	char *buf;                          /**< Receive buffer.              */
+	size_t head;                        /**< First byte in the buffer.    */
+	size_t used;                        /**< Bytes in the buffer.         */
+	struct record records[NR_RECORDS];  /**< Records.                     */
+	unsigned rhead;                     /**< First record.                */
+	unsigned nrecords;                  /**< Number of records.           */
+	struct process *chain;              /**< Sleeping chain.              */
+} sockettab[NR_SOCKETS];
+
+/**
+ * @brief Next ephemeral port.
+ */
+PRIVATE unsigned nextport = PORT_EPHEMERAL_MIN;
+
+/**
+ * @brief I/O vector cursor.
+ */
+struct iocursor
+{
+	const struct iovec *iov; /**< Current buffer.         */
+	size_t off;              /**< Offset in the buffer.   */
+};
+
+/*============================================================================*
+ *                                  Helpers                                   *
+ *============================================================================*/
+
+/**
+ * @brief Releases a file.
+ * 
+ * @param f File to be released.
+ */
+PRIVATE void file_put(struct file *f)
+{
+	struct inode *i; /* Inode. */
+	
+	if (--f->count)
+		return;
+	
+	inode_lock(i = f->inode);
+	inode_put(i);
+}
+
+/**
+ * @brief Returns the last record of a socket.
+ * 
+ * @param sock Target socket.
+ * 
+ * @returns The last record of the socket, or NULL if there is none.
+ */
+PRIVATE struct record *socket_last(struct socket *sock)
+{
+	if (sock->nrecords == 0)
+		return (NULL);
+	
+	return (&sock->records[(sock->rhead + sock->nrecords - 1)%NR_RECORDS]);
+}
+
+/**
+ * @brief Removes the first record of a socket.
+ * 
+ * @param sock Target socket.
+ */
+PRIVATE void socket_pop(struct socket *sock)
+{
+	struct record *r; /* Record. */
+	
+	r = &sock->records[sock->rhead];
+	
+	/* Drop passed files. */
+	for (int i = 0; i < r->nfiles; i++)
+		file_put(r->files[i]);
+	r->nfiles = 0;
+	
+	sock->rhead = (sock->rhead + 1)%NR_RECORDS;
+	sock->nrecords--;
+}
+
+/**
+ * @brief Copies data into the receive buffer of a socket.
+ * 
+ * @details Copies @p n bytes from the user buffers at cursor @p c to the
+ *          receive buffer of the socket pointed to by @p sock, as few
+ *          contiguous chunks as possible at a time.
+ * 
+ * @param sock Target socket.
+ * @param c    User buffers.
+ * @param n    Number of bytes to copy.
+ * 
+ * @note There must be room enough in the receive buffer.
+ */
+PRIVATE void socket_copyin(struct socket *sock, struct iocursor *c, size_t n)
+{
+	size_t tail;  /* Buffer tail.    */
+	size_t chunk; /* Bytes to copy.  */
+	
+	while (n > 0)
+	{
+		/* Skip exhausted buffers. */
+		while (c->off == c->iov->iov_len)
+		{
+			c->iov++;
+			c->off = 0;
+		}
+		
+		tail = (sock->head + sock->used)%SOCK_BUFSIZE;
+		
+		chunk = SOCK_BUFSIZE - tail;
+		if (chunk > n)
+			chunk = n;
+		if (chunk > c->iov->iov_len - c->off)
+			chunk = c->iov->iov_len - c->off;
+		
+		kmemcpy(&sock->buf[tail], (char *)c->iov->iov_base + c->off, chunk);
+		
+		c->off += chunk;
+		sock->used += chunk;
+		n -= chunk;
+	}
+}
+
+/**
+ * @brief Copies data out of the receive buffer of a socket.
+ * 
+ * @details Copies @p n bytes from the receive buffer of the socket pointed to
+ *          by @p sock to the user buffers at cursor @p c, and removes them
+ *          from the receive buffer. If @p c is NULL, data is dropped.
+ * 
+ * @param sock Source socket.
+ * @param c    User buffers.
+ * @param n    Number of bytes to copy.
+ */
+PRIVATE void socket_copyout(struct socket *sock, struct iocursor *c, size_t n)
+{
+	size_t chunk; /* Bytes to copy. */
+	
+	while (n > 0)
+	{
+		chunk = SOCK_BUFSIZE - sock->head;
+		if (chunk > n)
+			chunk = n;
+		
+		if (c != NULL)
+		{
+			/* Skip exhausted buffers. */
+			while (c->off == c->iov->iov_len)
+			{
+				c->iov++;
+				c->off = 0;
+			}
+			
+			if (chunk > c->iov->iov_len - c->off)
+				chunk = c->iov->iov_len - c->off;
+			
+			kmemcpy
+			((char *)c->iov->iov_base + c->off, &sock->buf[sock->head], chunk);
+			c->off += chunk;
+		}
+		
+		sock->head = (sock->head + chunk)%SOCK_BUFSIZE;
+		sock->used -= chunk;
+		n -= chunk;
+	}
+}
+
+/**
+ * @brief Hands passed files over to the calling process.
+ * 
+ * @param r   Record that carries the files.
+ * @param msg Where the new file descriptors should be stored.
+ * @param max Maximum number of file descriptors to be stored.
+ */
+PRIVATE void socket_deliver(struct record *r, struct sockmsg *msg, int max)
+{
+	int fd; /* File descriptor. */
+	
+	for (int i = 0; i < r->nfiles; i++)
+	{
+		/* No room for file descriptor. */
+		if ((msg->nfds == max) || ((fd = getfildes()) < 0))
+		{
+			file_put(r->files[i]);
+			msg->flags |= MSG_CTRUNC;
+			continue;
+		}
+		
+		curr_proc->ofiles[fd] = r->files[i];
+		curr_proc->close &= ~(1 << fd);
+		msg->fds[msg->nfds++] = fd;
+	}
+	
+	r->nfiles = 0;
+}
+
+/**
+ * @brief Searches for the socket that is bound to a name.
+ * 
+ * @param ip Inode of the name.
+ * 
+ * @returns The socket that is bound to @p ip, or NULL if there is none.
+ */
+PRIVATE struct socket *socket_find(struct inode *ip)
+{
+	struct socket *sock;
+	
+	for (sock = &sockettab[0]; sock < &sockettab[NR_SOCKETS]; sock++)
+	{
+		if ((sock->flags & SOCK_USED) && (sock->name == ip))
+			return (sock);
+	}
+	
+	return (NULL);
+}
+
+/**
+ * @brief Looks up a socket by its pathname.
+ * 
+ * @param path Pathname.
+ * @param type Expected socket type.
+ * @param sock Where the socket should be stored.
+ * 
+ * @returns Upon successful completion, zero is returned. Upon failure, a
+ *          negative error code is returned instead.
+ */
+PRIVATE int socket_lookup(const char *path, int type, struct socket **sock)
+{
+	int err;          /* Error code. */
+	struct inode *ip; /* Name.       */
+	
+	/* No such file. */
+	if ((ip = inode_name(path)) == NULL)
+		return (-ENOENT);
+	
+	err = 0;
+	
+	/* Not a socket. */
+	if (!S_ISSOCK(ip->mode))
+		err = -ECONNREFUSED;
+	
+	/* Not allowed. */
+	else if (!permission(ip->mode, ip->uid, ip->gid, curr_proc, MAY_WRITE, 0))
+		err = -EACCES;
+	
+	/* Nobody bound. */
+	else if ((*sock = socket_find(ip)) == NULL)
+		err = -ECONNREFUSED;
+	
+	/* Wrong socket type. */
+	else if ((*sock)->type != type)
+		err = -EPROTOTYPE;
+	
+	inode_put(ip);
+	
+	return (err);
+}
+
+/**
+ * @brief Searches for the Internet socket that is bound to a port.
+ * 
+ * @param port Port number (in network byte order).
+ * 
+ * @returns The socket that is bound to @p port, or NULL if there is none.
+ */
+PRIVATE struct socket *socket_port(in_port_t port)
+{
+	struct socket *sock;
+	
+	for (sock = &sockettab[0]; sock < &sockettab[NR_SOCKETS]; sock++)
+	{
+		if (!(sock->flags & SOCK_USED) || (sock->domain != AF_INET))
+			continue;
+		
+		if (sock->local.sin_port == port)
+			return (sock);
+	}
+	
+	return (NULL);
+}
+
+/**
+ * @brief Binds an Internet address to a socket.
+ * 
+ * @param sock Target socket.
+ * @param in   Internet address. If the port is zero, an ephemeral port is
+ *             picked.
+ * 
+ * @returns Upon successful completion, zero is returned. Upon failure, a
+ *          negative error code is returned instead.
+ */
+PRIVATE int socket_inet_bind(struct socket *sock, const struct sockaddr_in *in)
+{
+	in_port_t port; /* Port number. */
+	
+	/* Already bound. */
+	if (sock->local.sin_port != 0)
+		return (-EINVAL);
+	
+	/* Not an address of this host. */
+	if ((in->sin_addr.s_addr != INADDR_ANY) && (!net_local(in->sin_addr.s_addr)))
+		return (-EADDRNOTAVAIL);
+	
+	port = in->sin_port;
+	
+	/* Pick an ephemeral port. */
+	if (port == 0)
+	{
+		for (unsigned i = PORT_EPHEMERAL_MIN; i <= PORT_EPHEMERAL_MAX; i++)
+		{
+			port = htons(nextport);
+			if (++nextport > PORT_EPHEMERAL_MAX)
+				nextport = PORT_EPHEMERAL_MIN;
+			
+			if (socket_port(port) == NULL)
+				goto found;
+		}
+		
+		return (-EADDRINUSE);
+	}
+	
+	/* Not allowed. */
+	if ((ntohs(port) < PORT_RESERVED) && (!IS_SUPERUSER(curr_proc)))
+		return (-EACCES);
+	
+	/* Port in use. */
+	if (socket_port(port) != NULL)
+		return (-EADDRINUSE);
+
+found:
+	
+	sock->local.sin_addr = in->sin_addr;
+	sock->local.sin_port = port;
+	
+	return (0);
+}
+
+/**
+ * @brief Binds an ephemeral port to a socket, if it is not bound yet.
+ * 
+ * @param sock Target socket.
+ * 
+ * @returns Upon successful completion, zero is returned. Upon failure, a
+ *          negative error code is returned instead.
+ */
+PRIVATE int socket_autobind(struct socket *sock)
+{
+	struct sockaddr_in any; /* Any address. */
+	
+	/* Already bound. */
+	if (sock->local.sin_port != 0)
+		return (0);
+	
+	kmemset(&any, 0, sizeof(struct sockaddr_in));
+	any.sin_family = AF_INET;
+	
+	return (socket_inet_bind(sock, &any));
+}
+
+/*============================================================================*
+ *                                  Sockets                                   *
+ *============================================================================*/
+
+/**
+ * @brief Gets a socket address from user space.
+ * 
+ * @param addr Socket address (in user space).
+ * @param len  Length of the socket address.
+ * @param name Where the socket name should be stored.
+ * 
+ * @returns Upon successful completion, zero is returned. Upon failure, a
+ *          negative error code is returned instead.
+ */
+PUBLIC int socket_getaddr
+(const struct sockaddr *addr, socklen_t len, struct sockname *name)
+{
+	size_t n;                       /* Length of pathname. */
+	const struct sockaddr_un *sun;  /* UNIX address.       */
+	
+	sun = (const struct sockaddr_un *)addr;
+	
+	/* Invalid address length. */
+	if (len <= sizeof(sa_family_t))
+		return (-EINVAL);
+	
+	/* Invalid address. */
+	if (!chkmem(addr, len, MAY_READ))
+		return (-EINVAL);
+	
+	switch (name->family = addr->sa_family)
+	{
+		/* Internet address. */
+		case AF_INET:
+			if (len < sizeof(struct sockaddr_in))
+				return (-EINVAL);
+			kmemcpy(&name->in, addr, sizeof(struct sockaddr_in));
+			return (0);
+		
+		/* UNIX address. */
+		case AF_UNIX:
+			if (len > sizeof(struct sockaddr_un))
+				return (-EINVAL);
+			
+			n = len - sizeof(sa_family_t);
+			kmemcpy(name->path, sun->sun_path, n);
+			name->path[n] = '\0';
+			
+			/* Empty pathname. */
+			if (name->path[0] == '\0')
+				return (-EINVAL);
+			
+			return (0);
+	}
+	
+	return (-EAFNOSUPPORT);
+}
+
+/**
+ * @brief Puts a socket address to user space.
+ * 
+ * @param name Socket name.
+ * @param addr Where the socket address should be stored (in user space).
+ * @param len  Length of the socket address buffer, updated with the length
+ *             of the socket address.
+ * 
+ * @returns Upon successful completion, zero is returned. Upon failure, a
+ *          negative error code is returned instead.
+ */
+PUBLIC int socket_putaddr
+(const struct sockname *name, struct sockaddr *addr, socklen_t *len)
+{
+	socklen_t n;            /* Length of address. */
+	socklen_t full;         /* Full length.       */
+	const void *src;        /* Socket address.    */
+	struct sockaddr_un sun; /* UNIX address.      */
+	
+	/* Nothing to be done. */
+	if (addr == NULL)
+		return (0);
+	
+	/* Invalid address length. */
+	if (!chkmem(len, sizeof(socklen_t), MAY_WRITE))
+		return (-EINVAL);
+	
+	/* Internet address. */
+	if (name->family == AF_INET)
+	{
+		src = &name->in;
+		full = sizeof(struct sockaddr_in);
+	}
+	
+	/* UNIX address. */
+	else
+	{
+		sun.sun_family = AF_UNIX;
+		kstrncpy(sun.sun_path, name->path, UNIX_PATH_MAX);
+		src = &sun;
+		full = sizeof(sa_family_t) + kstrlen(sun.sun_path) + 1;
+	}
+	
+	n = (full > *len) ? *len : full;
+	
+	/* Invalid address. */
+	if (!chkmem(addr, n, MAY_WRITE))
+		return (-EINVAL);
+	
+	kmemcpy(addr, src, n);
+	*len = full;
+	
+	return (0);
+}
+
+/**
+ * @brief Allocates a socket.
+ * 
+ * @param domain Address family.
+ * @param type   Socket type.
+ * 
+ * @returns Upon success, a pointer to the allocated socket is returned. Upon
+ *          failure, a NULL pointer is returned instead.
+ */
+PUBLIC struct socket *socket_alloc(int domain, int type)
+{
+	struct socket *sock;
+	
+	for (sock = &sockettab[0]; sock < &sockettab[NR_SOCKETS]; sock++)
+	{
+		/* Found. */
+		if (!(sock->flags & SOCK_USED))
+			goto found;
+	}
+	
+	return (NULL);
+
+found:
+
+	/* Failed to get receive buffer. */
+	if ((sock->buf = getkpg(0)) == NULL)
+		return (NULL);
+	
+	sock->flags = SOCK_USED;
+	sock->domain = domain;
+	sock->type = type;
+	sock->name = NULL;
+	sock->path[0] = '\0';
+	sock->target = NULL;
+	sock->peer = NULL;
+	kmemset(&sock->local, 0, sizeof(struct sockaddr_in));
+	kmemset(&sock->remote, 0, sizeof(struct sockaddr_in));
+	sock->local.sin_family = AF_INET;
+	sock->remote.sin_family = AF_INET;
+	sock->backlog = 0;
+	sock->npending = 0;
+	sock->head = 0;
+	sock->used = 0;
+	sock->rhead = 0;
+	sock->nrecords = 0;
+	sock->chain = NULL;
+	
+	return (sock);
+}
+
+/**
+ * @brief Destroys a socket.
+ * 
+ * @details Drops pending connections and queued data, hangs up the peer and
+ *          releases the name of the socket pointed to by @p sock.
+ * 
+ * @param sock Socket to be destroyed.
+ */
+PUBLIC void socket_close(struct socket *sock)
+{
+	/* Drop pending connections. */
+	while (sock->npending > 0)
+		socket_close(sock->pending[--sock->npending]);
+	
+	/* Hang up peer. */
+	if (sock->peer != NULL)
+	{
+		sock->peer->peer = NULL;
+		wakeup(&sock->peer->chain);
+	}
+	
+	/* Drop queued data. */
+	while (sock->nrecords > 0)
+		socket_pop(sock);
+	
+	/* Release names. */
+	if (sock->name != NULL)
+	{
+		inode_lock(sock->name);
+		inode_put(sock->name);
+	}
+	if (sock->target != NULL)
+	{
+		inode_lock(sock->target);
+		inode_put(sock->target);
+	}
+	
+	putkpg(sock->buf);
+	
+	sock->flags = 0;
+	sock->gen++;
+	wakeup(&sock->chain);
+}
+
+/**
+ * @brief Opens a file descriptor for a socket.
+ * 
+ * @param sock Target socket.
+ * 
+ * @returns Upon successful completion, the new file descriptor is returned.
+ *          Upon failure, a negative error code is returned instead.
+ */
+PUBLIC int socket_open(struct socket *sock)
+{
+	int fd;          /* File descriptor. */
+	struct file *f;  /* File.            */
+	struct inode *i; /* Socket inode.    */
+	
+	/* Get empty file descriptor. */
+	if ((fd = getfildes()) < 0)
+		return (-EMFILE);
+	
+	/* Get empty file. */
+	if ((f = getfile()) == NULL)
+		return (-ENFILE);
+	
+	/* Failed to get socket inode. */
+	if ((i = inode_socket(sock)) == NULL)
+		return (-ENFILE);
+	
+	f->oflag = O_RDWR;
+	f->count = 1;
+	f->pos = 0;
+	f->inode = i;
+	curr_proc->ofiles[fd] = f;
+	curr_proc->close &= ~(1 << fd);
+	
+	return (fd);
+}
+
+/**
+ * @brief Gets the socket of a file descriptor.
+ * 
+ * @param fd   File descriptor.
+ * @param sock Where the socket should be stored.
+ * 
+ * @returns Upon successful completion, zero is returned. Upon failure, a
+ *          negative error code is returned instead.
+ */
+PUBLIC int socket_get(int fd, struct socket **sock)
+{
+	struct file *f;
+	
+	/* Invalid file descriptor. */
+	if ((fd < 0) || (fd >= OPEN_MAX) || ((f = curr_proc->ofiles[fd]) == NULL))
+		return (-EBADF);
+	
+	/* Not a socket. */
+	if (!(f->inode->flags & INODE_SOCKET))
+		return (-ENOTSOCK);
+	
+	*sock = f->inode->sock;
+	
+	return (0);
+}
+
+/**
+ * @brief Binds a name to a socket.
+ * 
+ * @details UNIX domain sockets get a socket file named after the pathname in
+ *          @p sn. Internet sockets get the port in @p sn, or an ephemeral one
+ *          if it is zero.
+ * 
+ * @param sock Target socket.
+ * @param sn   Socket name (in kernel space).
+ * 
+ * @returns Upon successful completion, zero is returned. Upon failure, a
+ *          negative error code is returned instead.
+ */
+PUBLIC int socket_bind(struct socket *sock, const struct sockname *sn)
+{
+	int slot;             /* Free directory slot. */
+	const char *path;     /* Pathname.            */
+	const char *name;     /* File name.           */
+	struct inode *dinode; /* Parent directory.    */
+	struct inode *i;      /* Socket file.         */
+	
+	/* Wrong address family. */
+	if (sn->family != sock->domain)
+		return (-EAFNOSUPPORT);
+	
+	/* Internet socket. */
+	if (sock->domain == AF_INET)
+		return (socket_inet_bind(sock, &sn->in));
+	
+	path = sn->path;
+	
+	/* Already bound. */
+	if (sock->name != NULL)
+		return (-EINVAL);
+	
+	/* Name too long. */
+	if (kstrlen(path) >= UNIX_PATH_MAX)
+		return (-ENAMETOOLONG);
+	
+	/* Failed to get parent directory. */
+	if ((dinode = inode_dname(path, &name)) == NULL)
+		return (-ENOENT);
+	
+	/* Name in use. */
+	if (dir_lookup(dinode, name, &slot) != INODE_NULL)
+	{
+		inode_put(dinode);
+		return (-EADDRINUSE);
+	}
+	
+	/* Not allowed to write in parent directory. */
+	if (!permission(dinode->mode,dinode->uid,dinode->gid,curr_proc,MAY_WRITE,0))
+	{
+		inode_put(dinode);
+		return (-EACCES);
+	}
+	
+	/* Failed to allocate inode. */
+	if ((i = inode_alloc(dinode->sb)) == NULL)
+	{
+		inode_put(dinode);
+		return (-ENOSPC);
+	}
+	
+	i->mode = (MAY_ALL & ~curr_proc->umask) | S_IFSOCK;
+	
+	/* Failed to add directory entry. */
+	if (dir_add_slot(dinode, i, name, slot))
+	{
+		i->nlinks = 0;
+		inode_put(i);
+		inode_put(dinode);
+		return (-ENOSPC);
+	}
+	
+	inode_unlock(i);
+	inode_put(dinode);
+	
+	sock->name = i;
+	kstrncpy(sock->path, path, UNIX_PATH_MAX);
+	
+	return (0);
+}
+
+/**
+ * @brief Marks a socket as accepting connections.
+ * 
+ * @param sock    Target socket.
+ * @param backlog Maximum number of pending connections.
+ * 
+ * @returns Upon successful completion, zero is returned. Upon failure, a
+ *          negative error code is returned instead.
+ */
+PUBLIC int socket_listen(struct socket *sock, int backlog)
+{
+	/* Not a connection-mode socket. */
+	if (sock->type != SOCK_STREAM)
+		return (-EOPNOTSUPP);
+	
+	/* Already connected. */
+	if (sock->flags & SOCK_CONNECTED)
+		return (-EINVAL);
+	
+	/* Not bound. */
+	if (sock->name == NULL)
+		return (-EDESTADDRREQ);
+	
+	/* Adjust backlog. */
+	if (backlog < 1)
+		backlog = 1;
+	else if (backlog > SOMAXCONN)
+		backlog = SOMAXCONN;
+	
+	sock->backlog = backlog;
+	sock->flags |= SOCK_LISTENING;
+	
+	return (0);
+}
+
+/**
+ * @brief Accepts a connection on a socket.
+ * 
+ * @param sock     Listening socket.
+ * @param new      Where the connected socket should be stored.
+ * @param name     Where the peer name should be stored (in kernel space).
+ * @param nonblock Fail rather than wait if there is no pending connection?
+ * 
+ * @returns Upon successful completion, zero is returned. Upon failure, a
+ *          negative error code is returned instead.
+ */
+PUBLIC int socket_accept
+(struct socket *sock, struct socket **new, struct sockname *name, int nonblock)
+{
+	struct socket *s; /* Connected socket. */
+	
+	/* Wait for a connection. */
+	while (sock->npending == 0)
+	{
+		/* Not listening. */
+		if (!(sock->flags & SOCK_LISTENING))
+			return (-EINVAL);
+		
+		if (nonblock)
+			return (-EAGAIN);
+		
+		sleep(&sock->chain, PRIO_USER);
+		
+		/* Awaken by a signal. */
+		if (issig())
+			return (-EINTR);
+	}
+	
+	s = sock->pending[0];
+	sock->npending--;
+	for (int i = 0; i < sock->npending; i++)
+		sock->pending[i] = sock->pending[i + 1];
+	
+	/* Peer name. */
+	name->family = AF_UNIX;
+	name->path[0] = '\0';
+	if (s->peer != NULL)
+		kstrncpy(name->path, s->peer->path, UNIX_PATH_MAX);
+	
+	wakeup(&sock->chain);
+	
+	*new = s;
+	
+	return (0);
+}
+
+/**
+ * @brief Connects a socket.
+ * 
+ * @details Stream sockets are connected right away to a new socket, which is
+ *          queued on the listening socket named @p sn until it is accepted.
+ *          Datagram sockets just remember @p sn as their default destination.
+ * 
+ * @param sock     Target socket.
+ * @param sn       Name of the peer (in kernel space).
+ * @param nonblock Fail rather than wait if the backlog is full?
+ * 
+ * @returns Upon successful completion, zero is returned. Upon failure, a
+ *          negative error code is returned instead.
+ */
+PUBLIC int socket_connect
+(struct socket *sock, const struct sockname *sn, int nonblock)
+{
+	int err;          /* Error code.       */
+	const char *path; /* Pathname of peer. */
+	struct socket *l; /* Listening socket. */
+	struct socket *s; /* Accepting socket. */
+	
+	/* Wrong address family. */
+	if (sn->family != sock->domain)
+		return (-EAFNOSUPPORT);
+	
+	/* Internet socket. */
+	if (sock->domain == AF_INET)
+	{
+		if ((err = socket_autobind(sock)))
+			return (err);
+		
+		sock->remote = sn->in;
+		sock->flags |= SOCK_CONNECTED;
+		
+		return (0);
+	}
+	
+	path = sn->path;
+	
+	/* Datagram socket. */
+	if (sock->type == SOCK_DGRAM)
+	{
+		if ((err = socket_lookup(path, SOCK_DGRAM, &l)))
+			return (err);
+		
+		if (sock->target != NULL)
+		{
+			inode_lock(sock->target);
+			inode_put(sock->target);
+		}
+		
+		sock->target = l->name;
+		sock->target->count++;
+		sock->flags |= SOCK_CONNECTED;
+		
+		return (0);
+	}
+	
+	/* Listening socket. */
+	if (sock->flags & SOCK_LISTENING)
+		return (-EINVAL);
+	
+	/* Already connected. */
+	if (sock->flags & SOCK_CONNECTED)
+		return (-EISCONN);
+	
+	/* Wait for room in the backlog. */
+	while (1)
+	{
+		if ((err = socket_lookup(path, SOCK_STREAM, &l)))
+			return (err);
+		
+		/* Not listening. */
+		if (!(l->flags & SOCK_LISTENING))
+			return (-ECONNREFUSED);
+		
+		if (l->npending < l->backlog)
+			break;
+		
+		if (nonblock)
+			return (-EAGAIN);
+		
+		sleep(&l->chain, PRIO_USER);
+		
+		/* Awaken by a signal. */
+		if (issig())
+			return (-EINTR);
+	}
+	
+	/* Failed to allocate accepting socket. */
+	if ((s = socket_alloc(AF_UNIX, SOCK_STREAM)) == NULL)
+		return (-ENOBUFS);
+	
+	kstrncpy(s->path, l->path, UNIX_PATH_MAX);
+	s->flags |= SOCK_CONNECTED;
+	s->peer = sock;
+	sock->peer = s;
+	sock->flags |= SOCK_CONNECTED;
+	
+	l->pending[l->npending++] = s;
+	wakeup(&l->chain);
+	
+	return (0);
+}
+
+/*============================================================================*
+ *                               Data Transfer                                *
+ *============================================================================*/
+
+/**
+ * @brief Gets the destination of a datagram.
+ * 
+ * @param sock Sending socket.
+ * @param name Explicit destination, or NULL.
+ * @param dest Where the destination should be stored.
+ * 
+ * @returns Upon successful completion, zero is returned. Upon failure, a
+ *          negative error code is returned instead.
+ */
+PRIVATE int socket_dest
+(struct socket *sock, const struct sockname *name, struct socket **dest)
+{
+	/* Explicit destination. */
+	if (name != NULL)
+	{
+		if (name->family != AF_UNIX)
+			return (-EAFNOSUPPORT);
+		return (socket_lookup(name->path, SOCK_DGRAM, dest));
+	}
+	
+	/* Not connected. */
+	if (sock->target == NULL)
+		return (-EDESTADDRREQ);
+	
+	/* Peer has gone away. */
+	if ((*dest = socket_find(sock->target)) == NULL)
+		return (-ECONNREFUSED);
+	
+	return (0);
+}
+
+/**
+ * @brief Sends a datagram on an Internet socket.
+ * 
+ * @param sock Sending socket.
+ * @param msg  Message.
+ * @param len  Length of the message.
+ * 
+ * @returns Upon successful completion, the number of bytes sent is returned.
+ *          Upon failure, a negative error code is returned instead.
+ */
+PRIVATE ssize_t socket_udp_send
+(struct socket *sock, const struct sockmsg *msg, size_t len)
+{
+	int err;                       /* Error code.  */
+	const struct sockaddr_in *dst; /* Destination. */
+	
+	/* Passing files is not supported. */
+	if (msg->nfds > 0)
+		return (-EOPNOTSUPP);
+	
+	/* Explicit destination. */
+	if (msg->name != NULL)
+	{
+		if (msg->name->family != AF_INET)
+			return (-EAFNOSUPPORT);
+		dst = &msg->name->in;
+	}
+	
+	/* Not connected. */
+	else if (!(sock->flags & SOCK_CONNECTED))
+		return (-EDESTADDRREQ);
+	
+	else
+		dst = &sock->remote;
+	
+	/* Message too large. */
+	if (len > UDP_PAYLOAD_MAX)
+		return (-EMSGSIZE);
+	
+	if ((err = socket_autobind(sock)))
+		return (err);
+	
+	return (udp_output(&sock->local, dst, msg->iov, msg->iovcnt, len));
+}
+
+/**
+ * @brief Sends a message on a socket.
+ * 
+ * @details Datagrams are queued as a whole, or not at all. Stream data is
+ *          queued as room becomes available in the receive buffer of the
+ *          peer. File descriptors travel along with the first byte.
+ * 
+ * @param sock Sending socket.
+ * @param msg  Message.
+ * 
+ * @returns Upon successful completion, the number of bytes sent is returned.
+ *          Upon failure, a negative error code is returned instead.
+ */
+PUBLIC ssize_t socket_send(struct socket *sock, struct sockmsg *msg)
+{
+	int err;                        /* Error code.             */
+	int nonblock;                   /* Non-blocking operation? */
+	int nfiles;                     /* Number of passed files. */
+	size_t len;                     /* Message length.         */
+	size_t sent;                    /* Bytes sent.             */
+	size_t n;                       /* Bytes to send.          */
+	struct socket *p;               /* Receiving socket.       */
+	struct record *r;               /* Working record.         */
+	struct iocursor c;              /* User buffers.           */
+	struct file *files[SCM_MAX_FD]; /* Passed files.           */
+	
+	/* Get passed files. */
+	nfiles = msg->nfds;
+	for (int i = 0; i < nfiles; i++)
+	{
+		if ((msg->fds[i] < 0) || (msg->fds[i] >= OPEN_MAX))
+			return (-EBADF);
+		if ((files[i] = curr_proc->ofiles[msg->fds[i]]) == NULL)
+			return (-EBADF);
+	}
+	
+	nonblock = msg->flags & MSG_DONTWAIT;
+	c.iov = msg->iov;
+	c.off = 0;
+	len = 0;
+	for (int i = 0; i < msg->iovcnt; i++)
+		len += msg->iov[i].iov_len;
+	
+	/* Internet socket. */
+	if (sock->domain == AF_INET)
+		return (socket_udp_send(sock, msg, len));
+	
+	/* Datagrams. */
+	if (sock->type == SOCK_DGRAM)
+	{
+		/* Message too large. */
+		if (len > SOCK_BUFSIZE)
+			return (-EMSGSIZE);
+		
+		/* Wait for room. */
+		while (1)
+		{
+			if ((err = socket_dest(sock, msg->name, &p)))
+				return (err);
+			
+			if ((p->nrecords < NR_RECORDS) && (SOCK_BUFSIZE - p->used >= len))
+				break;
+			
+			if (nonblock)
+				return (-EAGAIN);
+			
+			sleep(&p->chain, PRIO_USER);
+			
+			/* Awaken by a signal. */
+			if (issig())
+				return (-EINTR);
+		}
+		
+		socket_copyin(p, &c, len);
+		r = &p->records[(p->rhead + p->nrecords++)%NR_RECORDS];
+		r->len = len;
+		r->nfiles = nfiles;
+		for (int i = 0; i < nfiles; i++)
+			(r->files[i] = files[i])->count++;
+		r->from = sock;
+		r->fromgen = sock->gen;
+		
+		wakeup(&p->chain);
+		
+		return (len);
+	}
+	
+	/* Not connected. */
+	if (!(sock->flags & SOCK_CONNECTED))
+		return (-ENOTCONN);
+	
+	/* Nothing to do. */
+	if ((len == 0) && (nfiles == 0))
+		return (0);
+	
+	sent = 0;
+	
+	do
+	{
+		p = sock->peer;
+		
+		/* Peer has gone away. */
+		if (p == NULL)
+		{
+			if (sent > 0)
+				break;
+			sndsig(curr_proc, SIGPIPE);
+			return (-EPIPE);
+		}
+		
+		r = socket_last(p);
+		
+		/* Passed files start a new record. */
+		if ((nfiles > 0) || (r == NULL) || (r->nfiles > 0))
+			r = NULL;
+		
+		/* Wait for room. */
+		if ((p->used == SOCK_BUFSIZE) ||
+			((r == NULL) && (p->nrecords == NR_RECORDS)))
+		{
+			if (sent > 0)
+				break;
+			
+			if (nonblock)
+				return (-EAGAIN);
+			
+			sleep(&p->chain, PRIO_USER);
+			
+			/* Awaken by a signal. */
+			if (issig())
+				return (-EINTR);
+			
+			continue;
+		}
+		
+		n = SOCK_BUFSIZE - p->used;
+		if (n > len - sent)
+			n = len - sent;
+		
+		socket_copyin(p, &c, n);
+		
+		/* New record. */
+		if (r == NULL)
+		{
+			r = &p->records[(p->rhead + p->nrecords++)%NR_RECORDS];
+			r->len = 0;
+			r->nfiles = nfiles;
+			for (int i = 0; i < nfiles; i++)
+				(r->files[i] = files[i])->count++;
+			r->from = sock;
+			r->fromgen = sock->gen;
+			nfiles = 0;
+		}
+		
+		r->len += n;
+		sent += n;
+		
+		wakeup(&p->chain);
+	} while (sent < len);
+	
+	return (sent);
+}
+
+/**
+ * @brief Receives a message from a socket.
+ * 
+ * @details A datagram is received as a whole, and anything that does not fit
+ *          in the user buffers is dropped. Stream data is received up to the
+ *          next record that carries file descriptors.
+ * 
+ * @param sock Receiving socket.
+ * @param msg  Message. On input, msg->nfds is the maximum number of file
+ *             descriptors that may be received.
+ * 
+ * @returns Upon successful completion, the number of bytes received is
+ *          returned. Upon failure, a negative error code is returned instead.
+ */
+PUBLIC ssize_t socket_recv(struct socket *sock, struct sockmsg *msg)
+{
+	int max;           /* Maximum number of descriptors. */
+	int nonblock;      /* Non-blocking operation?        */
+	size_t len;        /* Buffer length.                 */
+	size_t got;        /* Bytes received.                */
+	size_t n;          /* Bytes to receive.              */
+	struct record *r;  /* Working record.                */
+	struct iocursor c; /* User buffers.                  */
+	
+	max = msg->nfds;
+	nonblock = msg->flags & MSG_DONTWAIT;
+	msg->nfds = 0;
+	msg->flags = 0;
+	
+	/* Listening socket. */
+	if (sock->flags & SOCK_LISTENING)
+		return (-EINVAL);
+	
+	/* Wait for data. */
+	while (sock->nrecords == 0)
+	{
+		if (sock->type == SOCK_STREAM)
+		{
+			/* Not connected. */
+			if (!(sock->flags & SOCK_CONNECTED))
+				return (-ENOTCONN);
+			
+			/* Peer has gone away. */
+			if (sock->peer == NULL)
+				return (0);
+		}
+		
+		if (nonblock)
+			return (-EAGAIN);
+		
+		sleep(&sock->chain, PRIO_USER);
+		
+		/* Awaken by a signal. */
+		if (issig())
+			return (-EINTR);
+	}
+	
+	c.iov = msg->iov;
+	c.off = 0;
+	len = 0;
+	for (int i = 0; i < msg->iovcnt; i++)
+		len += msg->iov[i].iov_len;
+	
+	r = &sock->records[sock->rhead];
+	
+	/* Sender name. */
+	if (msg->name != NULL)
+	{
+		msg->name->family = sock->domain;
+		msg->name->path[0] = '\0';
+		if (sock->domain == AF_INET)
+			msg->name->in = r->fromin;
+		else if (r->from->gen == r->fromgen)
+			kstrncpy(msg->name->path, r->from->path, UNIX_PATH_MAX);
+	}
+	
+	socket_deliver(r, msg, max);
+	
+	/* Datagrams. */
+	if (sock->type == SOCK_DGRAM)
+	{
+		got = (r->len < len) ? r->len : len;
+		socket_copyout(sock, &c, got);
+		
+		/* Truncate datagram. */
+		if (r->len > got)
+		{
+			socket_copyout(sock, NULL, r->len - got);
+			msg->flags |= MSG_TRUNC;
+		}
+		
+		socket_pop(sock);
+	}
+	
+	/* Stream data. */
+	else
+	{
+		got = 0;
+		
+		while (sock->nrecords > 0)
+		{
+			r = &sock->records[sock->rhead];
+			
+			/* Stop at passed files. */
+			if (r->nfiles > 0)
+				break;
+			
+			n = (r->len < len - got) ? r->len : len - got;
+			socket_copyout(sock, &c, n);
+			r->len -= n;
+			got += n;
+			
+			/* Buffer is full. */
+			if (r->len > 0)
+				break;
+			
+			socket_pop(sock);
+		}
+	}
+	
+	wakeup(&sock->chain);
+	
+	return (got);
+}
+
+/**
+ * @brief Reads data from a socket.
+ * 
+ * @param sock   Socket.
+ * @param iov    Buffers where data should be placed (in user space).
+ * @param iovcnt Number of buffers.
+ * @param oflag  Open flags of the file.
+ * 
+ * @returns Upon successful completion, the number of bytes read is returned.
+ *          Upon failure, a negative error code is returned instead.
+ */
+PUBLIC ssize_t socket_read
+(struct socket *sock, const struct iovec *iov, int iovcnt, int oflag)
+{
+	struct sockmsg msg; /* Message. */
+	
+	msg.iov = iov;
+	msg.iovcnt = iovcnt;
+	msg.name = NULL;
+	msg.nfds = 0;
+	msg.flags = (oflag & O_NONBLOCK) ? MSG_DONTWAIT : 0;
+	
+	return (socket_recv(sock, &msg));
+}
+
+/**
+ * @brief Writes data to a socket.
+ * 
+ * @param sock   Socket.
+ * @param iov    Buffers where data should be taken from (in user space).
+ * @param iovcnt Number of buffers.
+ * @param oflag  Open flags of the file.
+ * 
+ * @returns Upon successful completion, the number of bytes written is
+ *          returned. Upon failure, a negative error code is returned instead.
+ */
+PUBLIC ssize_t socket_write
+(struct socket *sock, const struct iovec *iov, int iovcnt, int oflag)
+{
+	struct sockmsg msg; /* Message. */
+	
+	msg.iov = iov;
+	msg.iovcnt = iovcnt;
+	msg.name = NULL;
+	msg.nfds = 0;
+	msg.flags = (oflag & O_NONBLOCK) ? MSG_DONTWAIT : 0;
+	
+	return (socket_send(sock, &msg));
+}
+
+/**
+ * @brief Performs control operations on a socket.
+ * 
+ * @details Internet sockets accept the network interface commands.
+ * 
+ * @param sock Target socket.
+ * @param cmd  Command.
+ * @param arg  Argument.
+ * 
+ * @returns Upon successful completion, zero is returned. Upon failure, a
+ *          negative error code is returned instead.
+ */
+PUBLIC int socket_ioctl(struct socket *sock, unsigned cmd, unsigned arg)
+{
+	/* Not an Internet socket. */
+	if (sock->domain != AF_INET)
+		return (-EINVAL);
+	
+	return (net_ioctl(cmd, arg));
+}
+
+/**
+ * @brief Delivers a received UDP datagram.
+ * 
+ * @details Places the datagram in the receive buffer of the Internet socket
+ *          that is bound to the destination port. Connected sockets only
+ *          accept datagrams from their peer.
+ * 
+ * @param dst  Destination address.
+ * @param src  Source address.
+ * @param data Payload.
+ * @param len  Length of the payload.
+ * 
+ * @returns Upon successful completion, zero is returned. If no socket is
+ *          bound to the destination, -ECONNREFUSED is returned. If the
+ *          receive buffer is full, -ENOBUFS is returned.
+ */
+PUBLIC int socket_udp_input
+(const struct sockaddr_in *dst, const struct sockaddr_in *src,
+ const void *data, size_t len)
+{
+	struct iovec iov;    /* Payload.        */
+	struct iocursor c;   /* Payload cursor. */
+	struct record *r;    /* New record.     */
+	struct socket *sock; /* Target socket.  */
+	
+	sock = socket_port(dst->sin_port);
+	
+	/* Nobody bound. */
+	if (sock == NULL)
+		return (-ECONNREFUSED);
+	
+	/* Bound to another address. */
+	if ((sock->local.sin_addr.s_addr != INADDR_ANY) &&
+		(sock->local.sin_addr.s_addr != dst->sin_addr.s_addr))
+		return (-ECONNREFUSED);
+	
+	/* Not from the peer. */
+	if ((sock->flags & SOCK_CONNECTED) &&
+		((sock->remote.sin_port != src->sin_port) ||
+		(sock->remote.sin_addr.s_addr != src->sin_addr.s_addr)))
+		return (-ECONNREFUSED);
+	
+	/* No room. */
+	if ((sock->nrecords == NR_RECORDS) || (SOCK_BUFSIZE - sock->used < len))
+		return (-ENOBUFS);
+	
+	iov.iov_base = (void *)data;
+	iov.iov_len = len;
+	c.iov = &iov;
+	c.off = 0;
+	socket_copyin(sock, &c, len);
+	
+	r = &sock->records[(sock->rhead + sock->nrecords++)%NR_RECORDS];
+	r->len = len;
+	r->nfiles = 0;
+	r->from = NULL;
+	r->fromgen = 0;
+	r->fromin = *src;
+	
+	wakeup(&sock->chain);
+	
+	return (0);
+}
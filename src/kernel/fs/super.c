@@ -248,6 +248,71 @@ PUBLIC void superblock_put(struct superblock *sb)
 	superblock_unlock(sb);
 }
 
+/**
+ * @brief Checks a disk superblock.
+ * 
+ * @details Performs a quick consistency check on the disk superblock pointed
+ *          to by @p d_sb: the inode and zone maps should be large enough, the
+ *          inode table should fit before the first data block, and the root
+ *          directory should be allocated. This is the same check fsck.minix
+ *          does before walking the file system.
+ * 
+ * @param dev  Device number.
+ * @param d_sb Disk superblock.
+ * 
+ * @returns Zero if the superblock is consistent, and non-zero otherwise.
+ */
+PRIVATE int superblock_check(dev_t dev, struct d_superblock *d_sb)
+{
+	int bad;              /* Bad root directory? */
+	block_t inode_blocks; /* Inode table blocks. */
+	struct buffer *buf;   /* Inode table buffer. */
+	struct d_inode *root; /* Root directory.     */
+	
+	/*
+	 * Inode/zone map too small. The inode map must
+	 * have room for bit 0 of the Minix layout, too.
+	 */
+	if (((unsigned)d_sb->s_imap_nblocks*(BLOCK_SIZE << 3) < (unsigned)d_sb->s_ninodes + 1) ||
+		((unsigned)d_sb->s_bmap_nblocks*(BLOCK_SIZE << 3) < d_sb->s_nblocks))
+	{
+		kprintf("fs: inode/zone map too small");
+		return (-1);
+	}
+	
+	inode_blocks = (d_sb->s_ninodes*sizeof(struct d_inode) + BLOCK_SIZE - 1)
+		>> BLOCK_SIZE_LOG2;
+	
+	/* Inode table too small. */
+	if (d_sb->s_first_data_block <
+		2 + d_sb->s_imap_nblocks + d_sb->s_bmap_nblocks + inode_blocks)
+	{
+		kprintf("fs: inode table too small");
+		return (-1);
+	}
+	
+	/* No root directory. */
+	if (d_sb->s_ninodes < INODE_ROOT)
+	{
+		kprintf("fs: bad root directory");
+		return (-1);
+	}
+	
+	buf = bread(dev, 2 + d_sb->s_imap_nblocks + d_sb->s_bmap_nblocks);
+	root = &((struct d_inode *)buf->data)[INODE_ROOT - 1];
+	bad = ((root->i_nlinks == 0) || !S_ISDIR(root->i_mode));
+	brelse(buf);
+	
+	/* Bad root directory. */
+	if (bad)
+	{
+		kprintf("fs: bad root directory");
+		return (-1);
+	}
+	
+	return (0);
+}
+
 /**
  * @brief Reads a superblock from a device.
  * 
@@ -294,6 +359,17 @@ PUBLIC struct superblock *superblock_read(dev_t dev)
 		goto error1;
 	}
 	
+	/* Unknown features. */
+	if (d_sb->s_features & ~MINIX_FEATURES)
+	{
+		kprintf("fs: unsupported file system features");
+		goto error1;
+	}
+	
+	/* Inconsistent file system. */
+	if (superblock_check(dev, d_sb))
+		goto error1;
+	
 	/* Initialize superblock. */
 	sb->buf = buf;
 	sb->ninodes = d_sb->s_ninodes;
@@ -306,6 +382,7 @@ PUBLIC struct superblock *superblock_read(dev_t dev)
 	sb->first_data_block = d_sb->s_first_data_block;
 	sb->max_size = d_sb->s_max_size;
 	sb->zones = d_sb->s_nblocks;
+	sb->features = d_sb->s_features;
 	sb->root = NULL;
 	sb->mp = NULL;
 	sb->dev = dev;
@@ -313,6 +390,7 @@ PUBLIC struct superblock *superblock_read(dev_t dev)
 	sb->flags |= SUPERBLOCK_VALID;
 	sb->isearch = 0;
 	sb->zsearch = d_sb->s_first_data_block;
+	sb->zpending = 0;
 	sb->chain = NULL;
 	sb->count++;
 	
@@ -375,19 +453,16 @@ PUBLIC void superblock_stat(struct superblock *sb, struct ustat *ubuf)
 	tfree = 0;
 	bmap_size = sb->zmap_blocks;
 	for (int i = 0; i < bmap_size; i++)
-	{
-		for (int j = 0; j < (BLOCK_SIZE >> 2); j++)
-			tfree += bitmap_nclear(sb->zmap[i]->data, BLOCK_SIZE);
-	}
+		tfree += bitmap_nclear(sb->zmap[i]->data, BLOCK_SIZE);
+	
+	/* Blocks pending reclaim are free as well. */
+	tfree += sb->zpending;
 	
 	/* Count number of free inodes. */
 	tinode = 0;
-	imap_size = sb->zmap_blocks;
+	imap_size = sb->imap_blocks;
 	for (int i = 0; i < imap_size; i++)
-	{
-		for (int j = 0; j < (BLOCK_SIZE >> 2); j++)
-			tinode += bitmap_nclear(sb->imap[i]->data, BLOCK_SIZE);
-	}
+		tinode += bitmap_nclear(sb->imap[i]->data, BLOCK_SIZE);
 	
 	ubuf->f_tfree = tfree;
 	ubuf->f_tinode = tinode;
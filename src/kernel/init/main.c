@@ -24,6 +24,7 @@
 #include <nanvix/dev.h>
 #include <nanvix/pm.h>
 #include <nanvix/mm.h>
+#include <nanvix/net.h>
 #include <nanvix/syscall.h>
 #include <fcntl.h>
 
@@ -108,6 +109,28 @@ PRIVATE void init(void)
 	execve("/sbin/init", argv, envp);
 }
 
+/**
+ * @brief Spawns a kernel daemon.
+ * 
+ * @details Forks the idle process and runs @p daemon in the child process,
+ *          which never returns to user mode.
+ * 
+ * @param name   Name of the daemon.
+ * @param daemon Main loop of the daemon, which shall not return.
+ */
+PRIVATE void spawn(const char *name, void (*daemon)(void))
+{
+	pid_t pid; /* Child process ID. */
+	
+	if ((pid = fork()) < 0)
+		kpanic("failed to fork %s", name);
+	else if (pid == 0)
+	{
+		kstrncpy(curr_proc->name, name, NAME_MAX);
+		daemon();
+	}
+}
+
 /**
  * @brief Initializes the kernel.
  */
@@ -120,7 +143,9 @@ PUBLIC void kmain(void)
 	dev_init();
 	mm_init();
 	pm_init();
+	hibernate_resume();
 	fs_init();
+	net_init();
 	
 	chkout(DEVID(TTY_MAJOR, 0, CHRDEV));
 	
@@ -134,6 +159,11 @@ PUBLIC void kmain(void)
 		_exit(-1);
 	}
 	
+	/* Spawn kernel daemons. */
+	spawn("klogd", klogd);
+	spawn("reclaimd", reclaimd);
+	spawn("netd", netd);
+	
 	/* idle process. */	
 	while (1)
 	{
@@ -157,6 +187,9 @@ PUBLIC void kmain(void)
 			}
 		}
 		
+#if (IRQTRACE)
+		irqtrace_reset();
+#endif
 		halt();
 		yield();
 	}
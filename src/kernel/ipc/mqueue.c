@@ -0,0 +1,621 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of Nanvix.
+ * 
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nanvix/config.h>
+#include <nanvix/const.h>
+#include <nanvix/fs.h>
+#include <nanvix/hal.h>
+#include <nanvix/ipc.h>
+#include <nanvix/klib.h>
+#include <nanvix/mm.h>
+#include <nanvix/pm.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+
+/**
+ * @file
+ * 
+ * @brief Message queues implementation.
+ * 
+ * @details Messages are kept in priority order, and in arrival order among
+ *          messages with the same priority. Messages are usually copied to
+ *          kernel pages. Messages that are made of whole pages and that start
+ *          at a page boundary are not copied at all: their pages are handed
+ *          over from the sender to the receiver, copy on write.
+ */
+
+/* Error checking. */
+#if (NR_MESSAGES < NR_MQUEUES*MQ_MAXMSG_MAX)
+	#error "not enough messages for all message queues"
+#endif
+
+/**
+ * @brief Returns access permissions.
+ */
+#define PERM(o)                                        \
+	((ACCMODE(o) == O_RDWR) ? (MAY_READ | MAY_WRITE) : \
+	((ACCMODE(o) == O_WRONLY) ? MAY_WRITE : MAY_READ))
+
+/**
+ * @name Message queue flags
+ */
+/**@{*/
+#define MQ_USED     (1 << 0) /**< Used?     */
+#define MQ_UNLINKED (1 << 1) /**< Unlinked? */
+/**@}*/
+
+/**
+ * @name Message flags
+ */
+/**@{*/
+#define MSG_USED  (1 << 0) /**< Used?               */
+#define MSG_PAGES (1 << 1) /**< Made of user pages? */
+/**@}*/
+
+/**
+ * @brief Message.
+ */
+PRIVATE struct message
+{
+	unsigned flags;             /**< Flags (see above).         */
+	unsigned prio;              /**< Priority.                  */
+	size_t size;                /**< Size (in bytes).           */
+	unsigned npages;            /**< Number of pages.           */
+	void *kpages[MQ_PAGES];     /**< Kernel pages.              */
+	struct pte pages[MQ_PAGES]; /**< User pages.                */
+	struct message *next;       /**< Next message in the queue. */
+} msgtab[NR_MESSAGES];
+
+/**
+ * @brief Message queue.
+ */
+PRIVATE struct mqueue
+{
+	unsigned flags;          /**< Flags (see above).            */
+	int count;               /**< Reference count.              */
+	char name[NAME_MAX + 1]; /**< Name.                         */
+	mode_t mode;             /**< Access permissions.           */
+	uid_t uid;               /**< Owner's user ID.              */
+	gid_t gid;               /**< Owner's group ID.             */
+	long maxmsg;             /**< Maximum number of messages.   */
+	long msgsize;            /**< Maximum message size.         */
+	long curmsgs;            /**< Number of queued messages.    */
+	struct message *head;    /**< First message.                */
+	struct process *chain;   /**< Processes waiting for queue.  */
+} mqtab[NR_MQUEUES];
+
+/*============================================================================*
+ *                                 Messages                                   *
+ *============================================================================*/
+
+/**
+ * @brief Allocates a message.
+ * 
+ * @returns Upon success, a pointer to the allocated message is returned. Upon
+ *          failure, a NULL pointer is returned instead.
+ */
+PRIVATE struct message *msg_alloc(void)
+{
+	struct message *m;
+	
+	for (m = &msgtab[0]; m < &msgtab[NR_MESSAGES]; m++)
+	{
+		/* Found. */
+		if (!(m->flags & MSG_USED))
+		{
+			m->flags = MSG_USED;
+			m->npages = 0;
+			m->next = NULL;
+			return (m);
+		}
+	}
+	
+	return (NULL);
+}
+
+/**
+ * @brief Frees a message.
+ * 
+ * @param m Message to be freed.
+ */
+PRIVATE void msg_free(struct message *m)
+{
+	for (unsigned i = 0; i < m->npages; i++)
+	{
+		if (m->flags & MSG_PAGES)
+			putupg(&m->pages[i]);
+		else
+			putkpg(m->kpages[i]);
+	}
+	
+	m->flags = 0;
+}
+
+/**
+ * @brief Copies a message from user space.
+ * 
+ * @param m   Target message.
+ * @param buf User buffer.
+ * 
+ * @returns Upon successful completion, zero is returned. Upon failure, a
+ *          negative error code is returned instead.
+ */
+PRIVATE int msg_copyin(struct message *m, const char *buf)
+{
+	size_t n; /* Bytes to copy. */
+	
+	for (size_t off = 0; off < m->size; off += PAGE_SIZE)
+	{
+		if ((m->kpages[m->npages] = getkpg(0)) == NULL)
+			return (-ENOMEM);
+		m->npages++;
+		
+		n = ((m->size - off) < PAGE_SIZE) ? (m->size - off) : PAGE_SIZE;
+		kmemcpy(m->kpages[m->npages - 1], buf + off, n);
+	}
+	
+	return (0);
+}
+
+/**
+ * @brief Takes the pages of a message from user space.
+ * 
+ * @param m   Target message.
+ * @param buf User buffer, page aligned.
+ * 
+ * @returns Upon successful completion, zero is returned. Upon failure, a
+ *          negative error code is returned instead.
+ */
+PRIVATE int msg_grab(struct message *m, const char *buf)
+{
+	int err; /* Error code. */
+	
+	m->flags |= MSG_PAGES;
+	
+	for (size_t off = 0; off < m->size; off += PAGE_SIZE)
+	{
+		if ((err = getupg(ADDR(buf) + off, &m->pages[m->npages])))
+			return (err);
+		m->npages++;
+	}
+	
+	return (0);
+}
+
+/**
+ * @brief Delivers a message to user space.
+ * 
+ * @details Copies the message pointed to by @p m to the user buffer @p buf.
+ *          Pages of messages that are made of user pages are mapped at the
+ *          user buffer, if it is page aligned, and copied otherwise.
+ * 
+ * @param m   Message to be delivered.
+ * @param buf User buffer.
+ * @param kpg Kernel page used for copying.
+ */
+PRIVATE void msg_copyout(struct message *m, char *buf, void *kpg)
+{
+	size_t n;       /* Bytes to copy.      */
+	size_t off;     /* Offset in the page. */
+	struct pte *pg; /* Working page.       */
+	
+	for (unsigned i = 0; i < m->npages; i++)
+	{
+		off = i*PAGE_SIZE;
+		n = ((m->size - off) < PAGE_SIZE) ? (m->size - off) : PAGE_SIZE;
+		
+		/* Copied message. */
+		if (!(m->flags & MSG_PAGES))
+		{
+			kmemcpy(buf + off, m->kpages[i], n);
+			continue;
+		}
+		
+		pg = &m->pages[i];
+		
+		/* Hand page over. */
+		if (!(ADDR(buf) & ~PAGE_MASK))
+		{
+			if (!mapupg(ADDR(buf) + off, pg))
+			{
+				kmemset(pg, 0, sizeof(struct pte));
+				continue;
+			}
+		}
+		
+		/* Copy page. */
+		physcpy(ADDR(kpg) - KBASE_VIRT, pg->frame << PAGE_SHIFT, PAGE_SIZE);
+		kmemcpy(buf + off, kpg, n);
+	}
+}
+
+/*============================================================================*
+ *                              Message Queues                                *
+ *============================================================================*/
+
+/**
+ * @brief Destroys a message queue.
+ * 
+ * @param mq Message queue to be destroyed.
+ */
+PRIVATE void mqueue_free(struct mqueue *mq)
+{
+	struct message *m;
+	
+	while ((m = mq->head) != NULL)
+	{
+		mq->head = m->next;
+		msg_free(m);
+	}
+	
+	mq->flags = 0;
+}
+
+/**
+ * @brief Searches for a message queue.
+ * 
+ * @param name Name of the message queue.
+ * 
+ * @returns Upon success, a pointer to the message queue is returned. Upon
+ *          failure, a NULL pointer is returned instead.
+ */
+PRIVATE struct mqueue *mqueue_lookup(const char *name)
+{
+	struct mqueue *mq;
+	
+	for (mq = &mqtab[0]; mq < &mqtab[NR_MQUEUES]; mq++)
+	{
+		/* Skip unused and unlinked message queues. */
+		if ((mq->flags & (MQ_USED | MQ_UNLINKED)) != MQ_USED)
+			continue;
+		
+		/* Found. */
+		if (!kstrcmp(mq->name, name))
+			return (mq);
+	}
+	
+	return (NULL);
+}
+
+/**
+ * @brief Asserts if a message queue name is valid.
+ * 
+ * @param name Name to be checked.
+ * 
+ * @returns True if the name is valid, and false otherwise.
+ */
+PRIVATE int mqueue_name(const char *name)
+{
+	/* Not an absolute name. */
+	if (name[0] != '/')
+		return (0);
+	
+	/* Name too long. */
+	if (kstrlen(name) > NAME_MAX)
+		return (0);
+	
+	/* Only one slash is allowed. */
+	for (const char *p = name + 1; *p != '\0'; p++)
+	{
+		if (*p == '/')
+			return (0);
+	}
+	
+	return (1);
+}
+
+/**
+ * @brief Opens a message queue.
+ * 
+ * @param name  Name of the message queue.
+ * @param oflag Open flags.
+ * @param mode  Access permissions, if the message queue is created.
+ * @param attr  Attributes, if the message queue is created. If NULL, default
+ *              attributes are used.
+ * 
+ * @returns Upon success, a pointer to the message queue is returned. Upon
+ *          failure, a NULL pointer is returned instead, and the error code is
+ *          set in the current process.
+ */
+PUBLIC struct mqueue *mqueue_open
+(const char *name, int oflag, mode_t mode, const struct mq_attr *attr)
+{
+	long maxmsg;       /* Maximum number of messages. */
+	long msgsize;      /* Maximum message size.       */
+	struct mqueue *mq; /* Working message queue.      */
+	
+	/* Invalid name. */
+	if (!mqueue_name(name))
+	{
+		curr_proc->errno = -EINVAL;
+		return (NULL);
+	}
+	
+	/* Open existing message queue. */
+	if ((mq = mqueue_lookup(name)) != NULL)
+	{
+		/* Exclusive creation. */
+		if ((oflag & (O_CREAT | O_EXCL)) == (O_CREAT | O_EXCL))
+		{
+			curr_proc->errno = -EEXIST;
+			return (NULL);
+		}
+		
+		/* Not allowed. */
+		if (!permission(mq->mode, mq->uid, mq->gid, curr_proc, PERM(oflag), 0))
+		{
+			curr_proc->errno = -EACCES;
+			return (NULL);
+		}
+		
+		mq->count++;
+		return (mq);
+	}
+	
+	/* Not asked to create message queue. */
+	if (!(oflag & O_CREAT))
+	{
+		curr_proc->errno = -ENOENT;
+		return (NULL);
+	}
+	
+	maxmsg = (attr != NULL) ? attr->mq_maxmsg : MQ_MAXMSG_DEF;
+	msgsize = (attr != NULL) ? attr->mq_msgsize : MQ_MSGSIZE_DEF;
+	
+	/* Invalid attributes. */
+	if ((maxmsg <= 0) || (maxmsg > MQ_MAXMSG_MAX) ||
+		(msgsize <= 0) || (msgsize > MQ_MSGSIZE_MAX))
+	{
+		curr_proc->errno = -EINVAL;
+		return (NULL);
+	}
+	
+	/* Find a free message queue. */
+	for (mq = &mqtab[0]; mq < &mqtab[NR_MQUEUES]; mq++)
+	{
+		if (!(mq->flags & MQ_USED))
+			goto found;
+	}
+	
+	curr_proc->errno = -ENFILE;
+	return (NULL);
+
+found:
+
+	mq->flags = MQ_USED;
+	mq->count = 1;
+	kstrcpy(mq->name, name);
+	mq->mode = mode & MAY_ALL & ~curr_proc->umask;
+	mq->uid = curr_proc->euid;
+	mq->gid = curr_proc->egid;
+	mq->maxmsg = maxmsg;
+	mq->msgsize = msgsize;
+	mq->curmsgs = 0;
+	mq->head = NULL;
+	mq->chain = NULL;
+	
+	return (mq);
+}
+
+/**
+ * @brief Removes a message queue.
+ * 
+ * @details Removes the name of a message queue. The message queue itself is
+ *          destroyed once all processes have closed it.
+ * 
+ * @param name Name of the message queue.
+ * 
+ * @returns Upon successful completion, zero is returned. Upon failure, a
+ *          negative error code is returned instead.
+ */
+PUBLIC int mqueue_unlink(const char *name)
+{
+	struct mqueue *mq;
+	
+	/* No such message queue. */
+	if ((mq = mqueue_lookup(name)) == NULL)
+		return (-ENOENT);
+	
+	/* Not allowed. */
+	if ((mq->uid != curr_proc->euid) && (!IS_SUPERUSER(curr_proc)))
+		return (-EACCES);
+	
+	mq->flags |= MQ_UNLINKED;
+	
+	if (mq->count == 0)
+		mqueue_free(mq);
+	
+	return (0);
+}
+
+/**
+ * @brief Sends a message to a message queue.
+ * 
+ * @param mq       Target message queue.
+ * @param buf      Message (in user space).
+ * @param len      Message size.
+ * @param prio     Message priority.
+ * @param nonblock Fail rather than wait if the message queue is full?
+ * 
+ * @returns Upon successful completion, zero is returned. Upon failure, a
+ *          negative error code is returned instead.
+ */
+PUBLIC int mqueue_send
+(struct mqueue *mq, const char *buf, size_t len, unsigned prio, int nonblock)
+{
+	int err;             /* Error code.      */
+	struct message *m;   /* Working message. */
+	struct message **p;  /* Insertion point. */
+	
+	/* Message too large. */
+	if (len > (size_t)mq->msgsize)
+		return (-EMSGSIZE);
+	
+	/* Invalid priority. */
+	if (prio >= MQ_PRIO_MAX)
+		return (-EINVAL);
+	
+	/* Wait for room. */
+	while (mq->curmsgs == mq->maxmsg)
+	{
+		if (nonblock)
+			return (-EAGAIN);
+		
+		sleep(&mq->chain, PRIO_USER);
+		
+		/* Awaken by a signal. */
+		if (issig())
+			return (-EINTR);
+	}
+	
+	if ((m = msg_alloc()) == NULL)
+		return (-EAGAIN);
+	
+	/*
+	 * Reserve room in advance,
+	 * because we may sleep below.
+	 */
+	mq->curmsgs++;
+	m->prio = prio;
+	m->size = len;
+	
+	/* Hand whole pages over, copy anything else. */
+	if ((len > 0) && (!(ADDR(buf) & ~PAGE_MASK)) && (!(len & ~PAGE_MASK)))
+		err = msg_grab(m, buf);
+	else
+		err = msg_copyin(m, buf);
+	
+	if (err)
+	{
+		msg_free(m);
+		mq->curmsgs--;
+		wakeup(&mq->chain);
+		return (err);
+	}
+	
+	/* Enqueue message in priority order. */
+	for (p = &mq->head; *p != NULL; p = &(*p)->next)
+	{
+		if ((*p)->prio < prio)
+			break;
+	}
+	m->next = *p;
+	*p = m;
+	
+	wakeup(&mq->chain);
+	
+	return (0);
+}
+
+/**
+ * @brief Receives a message from a message queue.
+ * 
+ * @param mq       Source message queue.
+ * @param buf      Buffer where the message should be placed (in user space).
+ * @param len      Buffer size.
+ * @param prio     Where the message priority should be stored.
+ * @param nonblock Fail rather than wait if the message queue is empty?
+ * 
+ * @returns Upon successful completion, the size of the message is returned.
+ *          Upon failure, a negative error code is returned instead.
+ */
+PUBLIC ssize_t mqueue_receive
+(struct mqueue *mq, char *buf, size_t len, unsigned *prio, int nonblock)
+{
+	void *kpg;         /* Kernel page used for copying. */
+	ssize_t size;      /* Message size.                 */
+	struct message *m; /* Working message.              */
+	
+	/* Buffer too small. */
+	if (len < (size_t)mq->msgsize)
+		return (-EMSGSIZE);
+	
+	/* Get kernel page. */
+	if ((kpg = getkpg(0)) == NULL)
+		return (-ENOMEM);
+	
+	/* Wait for a message. */
+	while ((m = mq->head) == NULL)
+	{
+		if (nonblock)
+		{
+			putkpg(kpg);
+			return (-EAGAIN);
+		}
+		
+		sleep(&mq->chain, PRIO_USER);
+		
+		/* Awaken by a signal. */
+		if (issig())
+		{
+			putkpg(kpg);
+			return (-EINTR);
+		}
+	}
+	
+	mq->head = m->next;
+	
+	msg_copyout(m, buf, kpg);
+	size = m->size;
+	*prio = m->prio;
+	
+	msg_free(m);
+	mq->curmsgs--;
+	wakeup(&mq->chain);
+	
+	putkpg(kpg);
+	
+	return (size);
+}
+
+/**
+ * @brief Gets the attributes of a message queue.
+ * 
+ * @param mq   Message queue.
+ * @param attr Where the attributes should be stored.
+ */
+PUBLIC void mqueue_attr(struct mqueue *mq, struct mq_attr *attr)
+{
+	attr->mq_flags = 0;
+	attr->mq_maxmsg = mq->maxmsg;
+	attr->mq_msgsize = mq->msgsize;
+	attr->mq_curmsgs = mq->curmsgs;
+}
+
+/**
+ * @brief Duplicates a reference to a message queue.
+ * 
+ * @param mq Message queue.
+ */
+PUBLIC void mqueue_dup(struct mqueue *mq)
+{
+	mq->count++;
+}
+
+/**
+ * @brief Releases a reference to a message queue.
+ * 
+ * @param mq Message queue.
+ */
+PUBLIC void mqueue_put(struct mqueue *mq)
+{
+	if ((--mq->count == 0) && (mq->flags & MQ_UNLINKED))
+		mqueue_free(mq);
+}
@@ -43,8 +43,8 @@ PUBLIC void kpanic(const char *fmt, ...)
 	va_end(args);
 
 	/* Save on kernel log and write on kout. */
-	cdev_write(kout, buffer, i);
 	klog_write(0, buffer, i);
+	kflush();
 	
 	/*
 	 * Disable interrupts, so we cannot
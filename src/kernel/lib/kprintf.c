@@ -17,17 +17,63 @@
  * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <nanvix/clock.h>
+#include <nanvix/config.h>
 #include <nanvix/const.h>
 #include <nanvix/dev.h>
 #include <nanvix/klib.h>
+#include <nanvix/pm.h>
 #include <sys/types.h>
 #include <stdarg.h>
 
+/**
+ * @name Rate Limiting Parameters
+ */
+/**@{*/
+#define RATELIMIT_INTERVAL (5*CLOCK_FREQ) /**< Interval (in ticks).         */
+#define RATELIMIT_BURST              10   /**< Messages printed per interval. */
+/**@}*/
+
+/**
+ * @brief Size of chunks in which the kernel log is flushed (in bytes).
+ */
+#define KFLUSH_CHUNK 64
+
 /**
  * @brief Kernel's output device.
  */
 PUBLIC dev_t kout = DEVID(NULL_MAJOR, 0, CHRDEV);
 
+/**
+ * @brief Is the kernel log written asynchronously?
+ */
+PRIVATE int async = 0;
+
+/**
+ * @brief Sleeping chain of the kernel log daemon.
+ */
+PRIVATE struct process *klogd_chain = NULL;
+
+/**
+ * @brief Flushes the kernel log.
+ * 
+ * @details Writes on kout everything that has been written to the kernel log
+ *          but has not been written on kout yet.
+ */
+PUBLIC void kflush(void)
+{
+	ssize_t n;                 /* Number of bytes to be flushed. */
+	char buffer[KFLUSH_CHUNK]; /* Temporary buffer.              */
+	
+	/* No output device yet. */
+	if (kout == DEVID(NULL_MAJOR, 0, CHRDEV))
+		return;
+	
+	/* Keep stack usage low, as kprintf() and kpanic() call us. */
+	while ((n = klog_drain(buffer, KFLUSH_CHUNK)) > 0)
+		cdev_write(kout, buffer, n);
+}
+
 /**
  * @brief Changes kernel's output device.
  * 
@@ -35,35 +81,120 @@ PUBLIC dev_t kout = DEVID(NULL_MAJOR, 0, CHRDEV);
  */
 PUBLIC void chkout(dev_t dev)
 {	
-	ssize_t n;                 /* Number of bytes to be flushed. */
-	char buffer[KBUFFER_SIZE]; /* Temporary buffer.              */
-	
 	kout = dev;
 	
 	/* Flush the content of kernel log. */
-	n = klog_read(0, buffer, KLOG_SIZE);
-	
-	cdev_write(kout, buffer, n);
+	kflush();
 }
 
 /**
  * @brief Writes on the screen a formated string.
  * 
+ * @details The message is saved on the kernel log, and it is written on kout
+ *          by the kernel log daemon, or right away if there is no such
+ *          daemon. A log level may prefix @p fmt.
+ * 
  * @param fmt Formated string.
  */
 PUBLIC void kprintf(const char *fmt, ...)
 {
 	int i;                         /* Loop index.              */
+	int level;                     /* Log level.               */
+	const char *p;                 /* Message.                 */
 	va_list args;                  /* Variable arguments list. */
 	char buffer[KBUFFER_SIZE + 1]; /* Temporary buffer.        */
 	
+	p = fmt;
+	level = KERN_INFO[1] - '0';
+	
+	/* Parse log level. */
+	if ((p[0] == '<') && (p[1] >= '0') && (p[1] <= '9') && (p[2] == '>'))
+	{
+		level = p[1] - '0';
+		p += 3;
+	}
+	
+	/* Discard message. */
+	if (level > KLOG_LEVEL)
+		return;
+	
 	/* Convert to raw string. */
 	va_start(args, fmt);
-	i = kvsprintf(buffer, fmt, args);
+	i = kvsprintf(buffer, p, args);
 	buffer[i++] = '\n';
 	va_end(args);
 
-	/* Save on kernel log and write on kout. */
-	cdev_write(kout, buffer, i);
+	/* Save on kernel log. */
 	klog_write(0, buffer, i);
+	
+	/* Write on kout. */
+	if (async)
+		wakeup(&klogd_chain);
+	else
+		kflush();
+}
+
+/**
+ * @brief Rate limits a kernel message.
+ * 
+ * @details Allows at most RATELIMIT_BURST messages per RATELIMIT_INTERVAL
+ *          ticks for the rate limit state pointed to by @p rl. The number of
+ *          suppressed messages is reported when a new interval starts.
+ * 
+ * @param rl Rate limit state.
+ * 
+ * @returns Non-zero if the message should be printed, and zero otherwise.
+ */
+PUBLIC int kratelimit(struct ratelimit *rl)
+{
+	/* Start a new interval. */
+	if ((rl->printed == 0) || (ticks - rl->begin >= RATELIMIT_INTERVAL))
+	{
+		if (rl->missed > 0)
+			kprintf(KERN_WARN "kernel: %d messages suppressed", rl->missed);
+		
+		rl->begin = ticks;
+		rl->printed = 0;
+		rl->missed = 0;
+	}
+	
+	/* Too many messages. */
+	if (rl->printed >= RATELIMIT_BURST)
+	{
+		rl->missed++;
+		return (0);
+	}
+	
+	rl->printed++;
+	
+	return (1);
+}
+
+/**
+ * @brief Kernel log daemon.
+ * 
+ * @details Writes the kernel log on kout in background, so that processes do
+ *          not wait for the console. On system shutdown the kernel log is
+ *          flushed, kernel messages are written synchronously again, and the
+ *          daemon exits.
+ */
+PUBLIC void klogd(void)
+{
+	async = 1;
+	
+	while (1)
+	{
+		kflush();
+		
+		/* Go synchronous. */
+		if (shutting_down)
+		{
+			async = 0;
+			die(0);
+		}
+		
+		curr_proc->received = 0;
+		
+		sleep(&klogd_chain, PRIO_USER);
+	}
 }
@@ -0,0 +1,648 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of Nanvix.
+ * 
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nanvix/config.h>
+#include <nanvix/const.h>
+#include <nanvix/dev.h>
+#include <nanvix/fs.h>
+#include <nanvix/hal.h>
+#include <nanvix/klib.h>
+#include <nanvix/mm.h>
+#include <nanvix/net.h>
+#include <nanvix/pm.h>
+#include <nanvix/syscall.h>
+#include <errno.h>
+#include "mm.h"
+
+/**
+ * @file
+ * 
+ * @brief Hibernation implementation.
+ * 
+ * @details The hibernation image is written to reserved slots of the default
+ *          swap area, and it is described by a header that lives right
+ *          before these slots. The image holds kernel data, block buffers,
+ *          the kernel page pool and all page frames in use. Kernel pages and
+ *          kernel pool pages are first staged into free page frames, with
+ *          interrupts disabled, and then written out with the rest of the
+ *          system frozen.
+ * 
+ *          On resume, the boot kernel reads back page frames straight into
+ *          place, since it does not use them. Kernel pages are read into
+ *          page frames that are free in the image, and they are finally
+ *          copied over the running kernel by context_resume(), which jumps
+ *          back into hibernate_enter() as if context_save() had just returned.
+ */
+
+/**
+ * @brief Hibernation image magic number.
+ */
+#define HIBERNATE_MAGIC 0x52424948
+
+/**
+ * @brief Number of copy list entries in a page.
+ */
+#define NR_COPIES ((PAGE_SIZE/sizeof(addr_t) - 2)/2)
+
+/**
+ * @brief Number of block buffer pages.
+ */
+#define NR_BUFFER_PAGES ((NR_BUFFERS*BLOCK_SIZE)/PAGE_SIZE)
+
+/**
+ * @brief Number of kernel data pages.
+ */
+#define NR_DATA_PAGES ((ADDR(KDATA_END) - ADDR(KDATA_START))/PAGE_SIZE)
+
+/**
+ * @brief Number of kernel pages, including the kernel stack.
+ */
+#define NR_KERNEL_PAGES (1 + NR_BUFFER_PAGES + NR_DATA_PAGES + 1)
+
+/**
+ * @brief Asserts if a bit is set in a bitmap.
+ */
+#define bitmap_isset(bitmap, pos) \
+	((bitmap)[IDX(pos)] & (1 << OFF(pos)))
+
+/**
+ * @brief Physical address of a page frame.
+ */
+#define FRAME_PHYS(i) (UBASE_PHYS + ((i) << PAGE_SHIFT))
+
+/* Kernel memory layout. */
+EXTERN char KTEXT_START[];
+EXTERN char KDATA_START[];
+EXTERN char KDATA_END[];
+EXTERN struct pde idle_pgdir[];
+
+/**
+ * @brief Hibernation header.
+ */
+struct hibhdr
+{
+	unsigned magic;                 /**< Magic number.               */
+	unsigned checksum;              /**< Kernel text checksum.       */
+	off_t off;                      /**< Offset of the image.        */
+	unsigned nslots;                /**< Number of image slots.      */
+	unsigned nkern;                 /**< Number of kernel pages.     */
+	unsigned nkpool;                /**< Number of kernel pool pages. */
+	unsigned nframes;               /**< Number of page frames.      */
+	addr_t kstack;                  /**< Kernel stack.               */
+	uint32_t kpool[NR_KPAGES/32];   /**< Kernel pool pages in use.   */
+	uint32_t frames[NR_FRAMES/32];  /**< Page frames in use.         */
+	
+	/* Padding. */
+	byte_t unused[PAGE_SIZE - 8*sizeof(unsigned) -
+		(NR_KPAGES/32 + NR_FRAMES/32)*sizeof(uint32_t)];
+};
+
+/**
+ * @brief Saved processor context.
+ */
+PRIVATE dword_t context[CONTEXT_SIZE];
+
+/**
+ * @brief Hibernation header.
+ */
+PRIVATE struct hibhdr *hdr = NULL;
+
+/**
+ * @brief Bounce page.
+ */
+PRIVATE void *bounce = NULL;
+
+/**
+ * @brief Staging page frames.
+ */
+PRIVATE unsigned stage[NR_FRAMES];
+
+/**
+ * @brief Staging page frames bitmap.
+ */
+PRIVATE uint32_t staged[NR_FRAMES/32];
+
+/**
+ * @brief Number of staging page frames.
+ */
+PRIVATE unsigned nstage = 0;
+
+/**
+ * @brief First swap slot of the image.
+ */
+PRIVATE unsigned first = 0;
+
+/**
+ * @brief Computes the kernel text checksum.
+ * 
+ * @returns The kernel text checksum.
+ */
+PRIVATE unsigned checksum(void)
+{
+	unsigned sum;      /* Checksum.     */
+	const unsigned *p; /* Working word. */
+	
+	sum = 0;
+	for (p = (unsigned *)KTEXT_START; p < (unsigned *)KDATA_START; p++)
+		sum = ((sum << 1) | (sum >> 31)) ^ *p;
+	
+	return (sum);
+}
+
+/**
+ * @brief Gets the physical address of a kernel page in the image.
+ * 
+ * @param i      Number of the page.
+ * @param kstack Kernel stack of the hibernating process.
+ * 
+ * @returns The physical address of the target kernel page.
+ */
+PRIVATE addr_t kernel_page(unsigned i, addr_t kstack)
+{
+	/* Page directory of the idle process. */
+	if (i == 0)
+		return (ADDR(idle_pgdir));
+	i--;
+	
+	/* Block buffers. */
+	if (i < NR_BUFFER_PAGES)
+		return (BUFFERS_VIRT - KBASE_VIRT + (i << PAGE_SHIFT));
+	i -= NR_BUFFER_PAGES;
+	
+	/* Kernel data. */
+	if (i < NR_DATA_PAGES)
+		return (ADDR(KDATA_START) - KBASE_VIRT + (i << PAGE_SHIFT));
+	
+	/* Kernel stack. */
+	return (kstack - KPOOL_VIRT + KPOOL_PHYS);
+}
+
+/**
+ * @brief Gets the physical address of a staged page in the image.
+ * 
+ * @param i Number of the staged page.
+ * 
+ * @returns The physical address of the target page.
+ */
+PRIVATE addr_t staged_page(unsigned i)
+{
+	/* Kernel page. */
+	if (i < hdr->nkern)
+		return (kernel_page(i, hdr->kstack));
+	i -= hdr->nkern;
+	
+	/* Kernel pool page. */
+	for (unsigned j = 0; j < NR_KPAGES; j++)
+	{
+		if (!bitmap_isset(hdr->kpool, j))
+			continue;
+		
+		if (i-- == 0)
+			return (KPOOL_PHYS + (j << PAGE_SHIFT));
+	}
+	
+	kpanic("mm: bad hibernation image");
+	
+	return (0);
+}
+
+/**
+ * @brief Reads or writes a page of the image.
+ * 
+ * @param i     Number of the page in the image.
+ * @param buf   Page buffer.
+ * @param write Write page?
+ * 
+ * @returns Zero upon success, and non-zero otherwise.
+ */
+PRIVATE int image_io(unsigned i, void *buf, int write)
+{
+	ssize_t n; /* Number of bytes transferred. */
+	off_t off; /* Device offset.               */
+	
+	off = hdr->off + i*PAGE_SIZE;
+	
+	n = (write) ? bdev_write(SWAP_DEV, buf, PAGE_SIZE, off) :
+		bdev_read(SWAP_DEV, buf, PAGE_SIZE, off);
+	
+	return ((n == PAGE_SIZE) ? 0 : -1);
+}
+
+/**
+ * @brief Releases staging page frames.
+ */
+PRIVATE void unstage(void)
+{
+	for (unsigned i = 0; i < nstage; i++)
+	{
+		releasef(stage[i]);
+		bitmap_clear(staged, stage[i]);
+	}
+	nstage = 0;
+}
+
+/**
+ * @brief Takes a snapshot of the system.
+ * 
+ * @details Records kernel pool pages and page frames in use, and copies
+ *          kernel pages and kernel pool pages to staging page frames, so
+ *          that interrupt handlers cannot change them while the image is
+ *          written.
+ * 
+ * @returns Zero upon success, and non-zero otherwise.
+ * 
+ * @note Interrupts must be disabled.
+ */
+PRIVATE int snapshot(void)
+{
+	unsigned ncopies; /* Number of staged pages. */
+	unsigned nlists;  /* Number of list pages.   */
+	
+	hdr->nkern = NR_KERNEL_PAGES;
+	hdr->kstack = ADDR(curr_proc->kstack);
+	hdr->nkpool = hdr->nframes = 0;
+	
+	/* Kernel pool pages. */
+	for (unsigned i = 0; i < NR_KPAGES; i++)
+	{
+		bitmap_clear(hdr->kpool, i);
+		
+		/* Kernel stack is a kernel page. */
+		if (KPOOL_VIRT + (i << PAGE_SHIFT) == hdr->kstack)
+			continue;
+		
+		if (usedkpg(i))
+		{
+			bitmap_set(hdr->kpool, i);
+			hdr->nkpool++;
+		}
+	}
+	
+	/* Page frames. */
+	for (unsigned i = 0; i < NR_FRAMES; i++)
+	{
+		bitmap_clear(hdr->frames, i);
+		
+		if (usedf(i) && !bitmap_isset(staged, i))
+		{
+			bitmap_set(hdr->frames, i);
+			hdr->nframes++;
+		}
+	}
+	
+	/* Image has grown since reservations. */
+	ncopies = hdr->nkern + hdr->nkpool;
+	nlists = (ncopies + NR_COPIES - 1)/NR_COPIES;
+	if ((ncopies + nlists > nstage) || (ncopies + hdr->nframes > hdr->nslots))
+		return (-1);
+	
+	/* Stage kernel pages. */
+	for (unsigned i = 0; i < hdr->nkern; i++)
+		physcpy(FRAME_PHYS(stage[i]), kernel_page(i, hdr->kstack), PAGE_SIZE);
+	
+	/* Stage kernel pool pages. */
+	for (unsigned i = 0, j = hdr->nkern; i < NR_KPAGES; i++)
+	{
+		if (bitmap_isset(hdr->kpool, i))
+			physcpy(FRAME_PHYS(stage[j++]), KPOOL_PHYS + (i << PAGE_SHIFT), PAGE_SIZE);
+	}
+	
+	return (0);
+}
+
+/**
+ * @brief Writes the hibernation image.
+ * 
+ * @returns Zero upon success, and non-zero otherwise.
+ */
+PRIVATE int image_write(void)
+{
+	unsigned slot; /* Image slot. */
+	
+	slot = 0;
+	
+	/* Kernel pages and kernel pool pages. */
+	for (unsigned i = 0; i < hdr->nkern + hdr->nkpool; i++)
+	{
+		physcpy(ADDR(bounce) - KBASE_VIRT, FRAME_PHYS(stage[i]), PAGE_SIZE);
+		if (image_io(slot++, bounce, 1))
+			return (-1);
+	}
+	
+	/* Page frames. */
+	for (unsigned i = 0; i < NR_FRAMES; i++)
+	{
+		if (!bitmap_isset(hdr->frames, i))
+			continue;
+		
+		physcpy(ADDR(bounce) - KBASE_VIRT, FRAME_PHYS(i), PAGE_SIZE);
+		if (image_io(slot++, bounce, 1))
+			return (-1);
+	}
+	
+	/* Header. */
+	hdr->magic = HIBERNATE_MAGIC;
+	hdr->checksum = checksum();
+	if (bdev_write(SWAP_DEV, (char *)hdr, PAGE_SIZE, HIBERNATE_OFF) != PAGE_SIZE)
+		return (-1);
+	
+	return (0);
+}
+
+/**
+ * @brief Invalidates the hibernation image on disk.
+ * 
+ * @returns Zero upon success, and non-zero otherwise.
+ */
+PRIVATE int image_invalidate(void)
+{
+	kmemset(bounce, 0, PAGE_SIZE);
+	
+	if (bdev_write(SWAP_DEV, bounce, PAGE_SIZE, HIBERNATE_OFF) != PAGE_SIZE)
+		return (-1);
+	
+	return (0);
+}
+
+/**
+ * @brief Asserts if file system state is all on disk.
+ * 
+ * @returns Non-zero if there are neither dirty nor locked block buffers, nor
+ *          dirty inodes, and zero otherwise.
+ */
+PRIVATE int quiescent(void)
+{
+	struct bcache_stat bst; /* Block buffer cache statistics. */
+	struct icache_stat ist; /* Inode cache statistics.        */
+	
+	buffer_stat(&bst);
+	inode_stat(&ist);
+	
+	return ((bst.ndirty == 0) && (bst.nlocked == 0) && (ist.ndirty == 0));
+}
+
+/**
+ * @brief Thaws the system after resume.
+ */
+PRIVATE void thaw(void)
+{
+	processor_reload();
+	enable_interrupts();
+	
+	net_resume();
+	image_invalidate();
+	unstage();
+	swap_release(first, hdr->nslots);
+	
+	kprintf("kernel: resumed from hibernation (%d pages)", hdr->nslots);
+	
+	putkpg(bounce);
+	putkpg(hdr);
+	
+	freezer = NULL;
+}
+
+/**
+ * @brief Hibernates the system.
+ * 
+ * @details Saves the state of the system to the default swap area and halts
+ *          the processor. File systems are synced beforehand, and then other
+ *          processes are frozen while the image is built. Syncing is not
+ *          done with the system frozen, since a frozen process may hold a
+ *          lock that sync needs, so hibernation backs off if anything got
+ *          dirty in the meantime.
+ * 
+ * @returns Zero when the system is resumed, or a negative error code if it
+ *          could not be hibernated.
+ */
+PUBLIC int hibernate_enter(void)
+{
+	int err;          /* Error code.             */
+	int slot;         /* First image slot.       */
+	int i;            /* Page frame.             */
+	unsigned ncopies; /* Number of staged pages. */
+	unsigned nframes; /* Number of frames.       */
+	
+	/* Already hibernating. */
+	if (freezer != NULL)
+		return (-EBUSY);
+	
+	sys_sync();
+	
+	/* Someone else got there while we synced. */
+	if (freezer != NULL)
+		return (-EBUSY);
+	
+	freezer = curr_proc;
+	
+	err = -ENOMEM;
+	if ((hdr = getkpg(1)) == NULL)
+		goto error0;
+	if ((bounce = getkpg(0)) == NULL)
+		goto error1;
+	
+	/* Reserve staging page frames. */
+	ncopies = NR_KERNEL_PAGES;
+	for (unsigned j = 0; j < NR_KPAGES; j++)
+	{
+		if (usedkpg(j))
+			ncopies++;
+	}
+	ncopies += (ncopies + NR_COPIES - 1)/NR_COPIES;
+	while (nstage < ncopies)
+	{
+		if ((i = reservef()) < 0)
+			goto error2;
+		
+		stage[nstage++] = i;
+		bitmap_set(staged, i);
+	}
+	
+	/* Reserve image slots. */
+	nframes = 0;
+	for (unsigned j = 0; j < NR_FRAMES; j++)
+	{
+		if (usedf(j) && !bitmap_isset(staged, j))
+			nframes++;
+	}
+	err = -ENOSPC;
+	hdr->nslots = ncopies + nframes;
+	if ((slot = swap_reserve(hdr->nslots, &hdr->off)) < 0)
+		goto error2;
+	first = slot;
+	
+	/* Drains the disk queue, as well. */
+	err = -EIO;
+	if (image_invalidate())
+		goto error3;
+	
+	/* Frozen processes dirtied something while we synced. */
+	err = -EAGAIN;
+	if (!quiescent())
+		goto error3;
+	
+	disable_interrupts();
+	
+	/* Resumed. */
+	if (context_save(context))
+	{
+		thaw();
+		return (0);
+	}
+	
+	/* Image has grown since reservations. */
+	err = -EAGAIN;
+	if (snapshot())
+	{
+		enable_interrupts();
+		goto error3;
+	}
+	
+	enable_interrupts();
+	
+	err = -EIO;
+	if (image_write())
+		goto error3;
+	
+	kprintf("kernel: hibernated, it is now safe to turn off your computer");
+	kflush();
+	
+	disable_interrupts();
+	while (1)
+		halt();
+
+error3:
+	swap_release(first, hdr->nslots);
+error2:
+	unstage();
+	putkpg(bounce);
+error1:
+	putkpg(hdr);
+error0:
+	freezer = NULL;
+	return (err);
+}
+
+/**
+ * @brief Resumes the system from a hibernation image.
+ * 
+ * @details Looks for a valid hibernation image in the default swap area and,
+ *          if there is one, loads it and resumes the hibernated system. This
+ *          function returns only if the image is absent or unusable, and in
+ *          the latter case the image is invalidated, so that it is not found
+ *          again on the next boot.
+ * 
+ * @note This function must be called at system startup, before any process
+ *       is created.
+ */
+PUBLIC void hibernate_resume(void)
+{
+	unsigned ncopies; /* Number of staged pages. */
+	unsigned nlists;  /* Number of list pages.   */
+	unsigned slot;    /* Image slot.             */
+	addr_t *list;     /* Copy list page.         */
+	
+	CHKSIZE(sizeof(struct hibhdr), PAGE_SIZE);
+	
+	if ((hdr = getkpg(0)) == NULL)
+		return;
+	if ((bounce = getkpg(0)) == NULL)
+		goto out1;
+	
+	/* No hibernation image. */
+	if (bdev_read(SWAP_DEV, (char *)hdr, PAGE_SIZE, HIBERNATE_OFF) != PAGE_SIZE)
+		goto out0;
+	if (hdr->magic != HIBERNATE_MAGIC)
+		goto out0;
+	
+	/* Hibernated by another kernel. */
+	if ((hdr->checksum != checksum()) || (hdr->nkern != NR_KERNEL_PAGES))
+	{
+		kprintf("kernel: hibernation image does not match kernel");
+		goto invalidate;
+	}
+	
+	kprintf("kernel: resuming from hibernation");
+	
+	/* Pick staging page frames among those free in the image. */
+	ncopies = hdr->nkern + hdr->nkpool;
+	nlists = (ncopies + NR_COPIES - 1)/NR_COPIES;
+	nstage = 0;
+	for (unsigned i = 0; i < NR_FRAMES; i++)
+	{
+		if (nstage == ncopies + nlists)
+			break;
+		
+		if (!bitmap_isset(hdr->frames, i))
+			stage[nstage++] = i;
+	}
+	if (nstage < ncopies + nlists)
+		goto error;
+	
+	/* Kernel pages and kernel pool pages. */
+	for (slot = 0; slot < ncopies; slot++)
+	{
+		if (image_io(slot, bounce, 0))
+			goto error;
+		physcpy(FRAME_PHYS(stage[slot]), ADDR(bounce) - KBASE_VIRT, PAGE_SIZE);
+	}
+	
+	/* Page frames, straight into place. */
+	for (unsigned i = 0; i < NR_FRAMES; i++)
+	{
+		if (!bitmap_isset(hdr->frames, i))
+			continue;
+		
+		if (image_io(slot++, bounce, 0))
+			goto error;
+		physcpy(FRAME_PHYS(i), ADDR(bounce) - KBASE_VIRT, PAGE_SIZE);
+	}
+	
+	/* Build copy list. */
+	list = bounce;
+	for (unsigned j = 0; j < nlists; j++)
+	{
+		kmemset(list, 0, PAGE_SIZE);
+		
+		for (unsigned k = j*NR_COPIES; (k < ncopies) && (k < (j + 1)*NR_COPIES); k++)
+		{
+			list[2 + 2*list[0]] = staged_page(k);
+			list[3 + 2*list[0]] = FRAME_PHYS(stage[k]);
+			list[0]++;
+		}
+		
+		if (j + 1 < nlists)
+			list[1] = FRAME_PHYS(stage[ncopies + j + 1]);
+		
+		physcpy(FRAME_PHYS(stage[ncopies + j]), ADDR(list) - KBASE_VIRT, PAGE_SIZE);
+	}
+	
+	disable_interrupts();
+	context_resume(FRAME_PHYS(stage[ncopies]), context);
+
+error:
+	kprintf("kernel: failed to resume from hibernation");
+invalidate:
+	image_invalidate();
+out0:
+	putkpg(bounce);
+out1:
+	putkpg(hdr);
+	nstage = 0;
+}
@@ -58,6 +58,13 @@
 	#error "bad UBASE_VIRT"
 #endif
 
+/*
+ * Bad USHARED_ADDR ?
+ */
+#if ((USHARED_ADDR < KMEM_SIZE) || (USHARED_ADDR + PGTAB_SIZE > UBASE_VIRT))
+	#error "bad USHARED_ADDR"
+#endif
+
 /*
  * Bad identity mapping?
  */
@@ -72,6 +79,7 @@
 PUBLIC void mm_init(void)
 {
 	initreg();
+	swap_init();
 }
 
 /**
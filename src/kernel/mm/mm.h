@@ -24,7 +24,27 @@
 	#define PAGE_FILL 0 /* Demand fill. */
 	#define PAGE_ZERO 1 /* Demand zero. */
 	
+	/* Number of kernel pages and page frames. */
+	#define NR_KPAGES (KPOOL_SIZE/PAGE_SIZE) /* Number of kernel pages. */
+	#define NR_FRAMES (UMEM_SIZE/PAGE_SIZE)  /* Number of page frames.  */
+	
+	/* Default swap area layout. */
+	#define HIBERNATE_OFF HDD_SIZE               /* Hibernation header. */
+	#define SWAP_OFF      (HDD_SIZE + PAGE_SIZE) /* Swap slots.         */
+	
 	/* Forward definitions. */
+	EXTERN int reservef(void);
+	EXTERN void releasef(unsigned);
+	EXTERN int usedf(unsigned);
+	EXTERN int usedkpg(unsigned);
+	EXTERN int swap_alloc(void);
+	EXTERN int swap_drain(unsigned, unsigned);
+	EXTERN int swap_read(unsigned, void *);
+	EXTERN int swap_write(unsigned, const void *);
+	EXTERN void swap_dup(unsigned);
+	EXTERN void swap_free(unsigned);
+	EXTERN int swap_reserve(unsigned, off_t *);
+	EXTERN void swap_release(unsigned, unsigned);
 	EXTERN void freeupg(struct pte *);
 	EXTERN void linkupg(struct pte *, struct pte *);
 	EXTERN void mappgtab(struct process *, addr_t, void *);
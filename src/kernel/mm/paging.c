@@ -26,15 +26,15 @@
 #include <nanvix/klib.h>
 #include <nanvix/mm.h>
 #include <nanvix/region.h>
+#include <sys/mman.h>
+#include <errno.h>
 #include <signal.h>
 #include "mm.h"
 
-/*
- * Swapping area too small?
+/**
+ * @brief Idle process page directory.
  */
-#if (SWP_SIZE < MEMORY_SIZE)
-	#error "swapping area to small"
-#endif
+EXTERN struct pde idle_pgdir[];
 
 /**
  * @brief Gets a page directory entry of a process.
@@ -58,38 +58,43 @@
 #define getpte(p, a) \
 	(&((struct pte *)((getpde(p, a)->frame << PAGE_SHIFT) + KBASE_VIRT))[PG(a)])
 
-
-/*============================================================================*
- *                             Swapping System                                *
- *============================================================================*/
+/**
+ * @brief Gets a page table entry of a process region.
+ * 
+ * @param preg Process region.
+ * @param a    Address.
+ * 
+ * @returns The requested page table entry.
+ */
+#define getrpte(preg, a)                                            \
+	(((preg)->reg->flags & REGION_DOWNWARDS) ?                      \
+		&(preg)->reg->pgtab[REGION_PGTABS -                         \
+			(PGTAB((preg)->start) - PGTAB(a)) - 1][PG(a)] :         \
+		&(preg)->reg->pgtab[PGTAB(a) - PGTAB((preg)->start)][PG(a)])
 
 /**
- * @brief Swap space.
+ * @name Read-ahead windows (in pages)
  */
-PRIVATE struct
-{
-	unsigned count[SWP_SIZE/PAGE_SIZE];         /**< Reference count. */
-	uint32_t bitmap[(SWP_SIZE/PAGE_SIZE) >> 5]; /**< Bitmap.          */
-} swap = {{0, }, {0, } };
+/**@{*/
+#define READAHEAD_NORMAL      2 /**< No advice.          */
+#define READAHEAD_SEQUENTIAL 16 /**< Sequential access.  */
+/**@}*/
 
 /**
- * @brief Clears the swap space that is associated to a page.
- * 
- * @param pg Page to be inspected.
+ * @brief Paging statistics.
  */
-PRIVATE void swap_clear(struct pte *pg)
+PRIVATE struct
 {
-	unsigned i;
-	
-	i = pg->frame;
-	
-	/* Free swap space. */
-	if (swap.count[i] > 0)
-	{
-		bitmap_clear(swap.bitmap, i);
-		swap.count[i]--;
-	}
-}
+	unsigned faults;    /**< Validity page faults.      */
+	unsigned cows;      /**< Copy-on-write page faults. */
+	unsigned evictions; /**< Evicted pages.             */
+	unsigned swapins;   /**< Pages swapped in.          */
+	unsigned swapouts;  /**< Pages swapped out.         */
+} stats = {0, 0, 0, 0, 0};
+
+/*============================================================================*
+ *                             Swapping System                                *
+ *============================================================================*/
 
 /**
  * @brief Swaps a page out to disk.
@@ -101,11 +106,10 @@ PRIVATE void swap_clear(struct pte *pg)
  */
 PRIVATE int swap_out(struct process *proc, addr_t addr)
 {
-	unsigned blk;   /* Block number in swap device.  */
-	struct pte *pg; /* Page table entry.             */
-	off_t off;      /* Offset in swap device.        */
-	ssize_t n;      /* # bytes written.              */
-	void *kpg;      /* Kernel page used for copying. */
+	int slot;        /* Swap slot.                    */
+	unsigned frame;  /* Page frame.                   */
+	struct pte *pg;  /* Page table entry.             */
+	void *kpg;       /* Kernel page used for copying. */
 	
 	addr &= PAGE_MASK;
 	pg = getpte(proc, addr);
@@ -114,35 +118,43 @@ PRIVATE int swap_out(struct process *proc, addr_t addr)
 	if ((kpg = getkpg(0)) == NULL)
 		goto error0;
 	
-	/* Get free block in swap device. */
-	blk = bitmap_first_free(swap.bitmap, (SWP_SIZE/PAGE_SIZE) >> 3);
-	if (blk == BITMAP_FULL)
+	/*
+	 * Get free swap slot in advance,
+	 * because we may sleep below.
+	 */
+	if ((slot = swap_alloc()) < 0)
 		goto error1;
 	
 	/*
-	 * Set block on swap device as used
-	 * in advance, because we may sleep below.
+	 * Copy page through its physical address,
+	 * since the page may not be mapped in the
+	 * address space of the current process.
 	 */
-	off = HDD_SIZE + blk*PAGE_SIZE;
-	bitmap_set(swap.bitmap, blk);
-	
-	/* Write page to disk. */
-	kmemcpy(kpg, (void *)addr, PAGE_SIZE);
-	n = bdev_write(SWAP_DEV, (void *)addr, PAGE_SIZE, off);
-	if (n != PAGE_SIZE)
-		goto error2;
-	swap.count[blk]++;
+	frame = pg->frame;
+	physcpy(ADDR(kpg) - KBASE_VIRT, frame << PAGE_SHIFT, PAGE_SIZE);
 	
-	/* Set page as non-present. */
+	/*
+	 * Set page as non-present before writing
+	 * it to disk, so that later changes are
+	 * not lost while we sleep.
+	 */
 	pg->present = 0;
-	pg->frame = blk;
+	pg->frame = slot;
 	tlb_flush();
 	
+	/* Write page to disk. */
+	if (swap_write(slot, kpg))
+		goto error2;
+	
+	stats.swapouts++;
 	putkpg(kpg);
 	return (0);
 
 error2:
-	bitmap_clear(swap.bitmap, blk);
+	pg->present = 1;
+	pg->frame = frame;
+	tlb_flush();
+	swap_free(slot);
 error1:
 	putkpg(kpg);
 error0:
@@ -159,10 +171,8 @@ error0:
  */
 PRIVATE int swap_in(unsigned frame, addr_t addr)
 {
-	unsigned blk;   /* Block number in swap device.  */
+	unsigned slot;  /* Swap slot.                    */
 	struct pte *pg; /* Page table entry.             */
-	off_t off;      /* Offset in swap device.        */
-	ssize_t n;      /* # bytes read.                 */
 	void *kpg;      /* Kernel page used for copying. */
 	
 	addr &= PAGE_MASK;
@@ -172,15 +182,11 @@ PRIVATE int swap_in(unsigned frame, addr_t addr)
 	if ((kpg = getkpg(0)) == NULL)
 		goto error0;
 	
-	/* Get block # in swap device. */
-	blk = pg->frame;
-	off = HDD_SIZE + blk*PAGE_SIZE;
-	
 	/* Read page from disk. */
-	n = bdev_read(SWAP_DEV, kpg, PAGE_SIZE, off);
-	if (n != PAGE_SIZE)
+	slot = pg->frame;
+	if (swap_read(slot, kpg))
 		goto error1;
-	swap_clear(pg);
+	swap_free(slot);
 	
 	/* Set page as present. */
 	pg->present = 1;
@@ -191,7 +197,8 @@ PRIVATE int swap_in(unsigned frame, addr_t addr)
 	kmemcpy((void *)addr, kpg, PAGE_SIZE);
 	pg->accessed = 0;
 	pg->dirty = 0;
-		
+	
+	stats.swapins++;
 	putkpg(kpg);
 	return (0);
 
@@ -206,7 +213,6 @@ error0:
  *============================================================================*/
 
 /* Kernel pages. */
-#define NR_KPAGES (KPOOL_SIZE/PAGE_SIZE) /* Number of kernel pages.  */
 PRIVATE int kpages[NR_KPAGES] = { 0,  }; /* Reference count.         */
 
 /**
@@ -230,7 +236,7 @@ PUBLIC void *getkpg(int clean)
 			goto found;
 	}
 
-	kprintf("mm: kernel page pool overflow");
+	kprintf_ratelimited(KERN_WARN "mm: kernel page pool overflow");
 	
 	return (NULL);
 
@@ -270,33 +276,278 @@ PUBLIC void putkpg(void *kpg)
  *                              Paging System                                 *
  *============================================================================*/
 
-/* Number of page frames. */
-#define NR_FRAMES (UMEM_SIZE/PAGE_SIZE)
-
 /**
  * @brief Page frames.
  */
 PRIVATE struct
 {
-	unsigned count; /**< Reference count.     */
-	unsigned age;   /**< Age.                 */
-	pid_t owner;    /**< Page owner.          */
-	addr_t addr;    /**< Address of the page. */
-} frames[NR_FRAMES] = {{0, 0, 0, 0},  };
+	unsigned count;  /**< Reference count.     */
+	unsigned age;    /**< Age.                 */
+	pid_t owner;     /**< Page owner.          */
+	addr_t addr;     /**< Address of the page. */
+	unsigned locked; /**< Pinned in memory?    */
+} frames[NR_FRAMES] = {{0, 0, 0, 0, 0},  };
+
+/**
+ * @brief Gets a process.
+ * 
+ * @param pid ID of the process.
+ * 
+ * @returns A pointer to the process, or a NULL pointer if there is no such
+ *          process.
+ */
+PRIVATE struct process *getproc(pid_t pid)
+{
+	struct process *p;
+	
+	for (p = FIRST_PROC; p <= LAST_PROC; p++)
+	{
+		/* Skip invalid processes. */
+		if (!IS_VALID(p))
+			continue;
+		
+		/* Found. */
+		if (p->pid == pid)
+			return (p);
+	}
+	
+	return (NULL);
+}
+
+/**
+ * @brief Evicts a page of another process.
+ * 
+ * @details Releases a page frame owned by some process other than the current
+ *          one. Clean pages of text regions are dropped, since they may be read
+ *          again from the executable file. Otherwise, the oldest page is
+ *          swapped out. Pages of locked regions are left alone, because their
+ *          owners are working on them.
+ * 
+ * @returns Upon success, the number of the released frame is returned. Upon
+ *          failure, a negative number is returned instead.
+ */
+PRIVATE int evictf(void)
+{
+	int i;                /* Loop index.              */
+	int err;              /* Error code.              */
+	int oldest;           /* Oldest page.             */
+	addr_t addr;          /* Address of the page.     */
+	struct pte *pg;       /* Working page.            */
+	struct region *reg;   /* Working region.          */
+	struct process *proc; /* Owner of the page.       */
+	struct pregion *preg; /* Working process region. */
+	
+	oldest = -1;
+	for (i = 0; i < NR_FRAMES; i++)
+	{
+		/* Skip shared and locked pages. */
+		if ((frames[i].count != 1) || (frames[i].locked))
+			continue;
+		
+		/* Page is about to be reused. */
+		if ((proc = getproc(frames[i].owner)) == NULL)
+			continue;
+		
+		addr = frames[i].addr;
+		preg = findreg(proc, addr);
+		
+		/* Owner is working on the region. */
+		if ((preg == NULL) || (preg->reg->flags & REGION_LOCKED))
+			continue;
+		
+		reg = preg->reg;
+		
+		/* Drop page from executable file. */
+		if ((!(reg->mode & MAY_WRITE)) && (reg->file.inode != NULL) &&
+			(addr >= preg->start) &&
+			(addr - preg->start < ALIGN(reg->file.size, PAGE_SIZE)))
+		{
+			pg = getpte(proc, addr);
+			freeupg(pg);
+			markpg(pg, PAGE_FILL);
+			stats.evictions++;
+			return (i);
+		}
+		
+		/* Oldest page found. */
+		if ((oldest < 0) || (frames[i].age < frames[oldest].age))
+			oldest = i;
+	}
+	
+	/* No page left. */
+	if (oldest < 0)
+		return (-1);
+	
+	proc = getproc(frames[oldest].owner);
+	preg = findreg(proc, frames[oldest].addr);
+	
+	/* Swap page out. */
+	lockreg(reg = preg->reg);
+	frames[oldest].owner = 0;
+	if ((err = swap_out(proc, frames[oldest].addr)))
+		frames[oldest].owner = proc->pid;
+	else
+		stats.evictions++;
+	unlockreg(reg);
+	
+	return ((err) ? -1 : oldest);
+}
+
+/**
+ * @brief Computes the badness of a process.
+ * 
+ * @details The badness of a process is the number of page frames that would be
+ *          freed by killing it. Processes with superuser privileges are
+ *          likely to be system services, so they are penalized less.
+ * 
+ * @param proc Process to be inspected.
+ * 
+ * @returns The badness of the process.
+ */
+PRIVATE unsigned badness(struct process *proc)
+{
+	unsigned points = 0;
+	
+	for (int i = 0; i < NR_FRAMES; i++)
+	{
+		if ((frames[i].count > 0) && (frames[i].owner == proc->pid))
+			points++;
+	}
+	
+	/* System service. */
+	if (IS_SUPERUSER(proc))
+		points -= points/4;
+	
+	return (points);
+}
+
+/**
+ * @brief Kills a process to free memory.
+ * 
+ * @details Sends SIGKILL to the process with the highest badness. The init
+ *          process, zombies and processes that have already been killed are
+ *          never chosen.
+ * 
+ * @returns A pointer to the killed process, or a NULL pointer if no process
+ *          could be killed.
+ */
+PRIVATE struct process *oomkill(void)
+{
+	unsigned points;      /* Badness of a process. */
+	unsigned max;         /* Highest badness.      */
+	struct process *p;    /* Working process.      */
+	struct process *best; /* Victim.               */
+	
+	max = 0;
+	best = NULL;
+	for (p = FIRST_PROC; p <= LAST_PROC; p++)
+	{
+		/* Skip invalid processes. */
+		if (!IS_VALID(p))
+			continue;
+		
+		/* Skip init, zombies and dying processes. */
+		if ((p == INIT) || (p->state == PROC_ZOMBIE))
+			continue;
+		if (p->received & (1 << SIGKILL))
+			continue;
+		
+		if ((points = badness(p)) > max)
+		{
+			max = points;
+			best = p;
+		}
+	}
+	
+	/* No process to kill. */
+	if (best == NULL)
+		return (NULL);
+	
+	kprintf("mm: out of memory, killing %s (pid %d)", best->name, best->pid);
+	sndsig(best, SIGKILL);
+	
+	return (best);
+}
+
+/**
+ * @brief Frees the memory of a killed process.
+ * 
+ * @details Releases the private pages of the process pointed to by @p proc
+ *          without waiting for it to exit. Pages are marked for demand zero,
+ *          in case the process touches them on its way out.
+ * 
+ * @param proc Process that has been killed.
+ * 
+ * @returns The number of page frames freed.
+ */
+PRIVATE unsigned reapmem(struct process *proc)
+{
+	unsigned i;           /* Frame index.             */
+	unsigned n;           /* Frames freed.            */
+	addr_t addr;          /* Working address.         */
+	struct pte *pg;       /* Working page.            */
+	struct region *reg;   /* Working region.          */
+	struct pregion *preg; /* Working process region. */
+	
+	n = 0;
+	for (int j = 0; j < NR_PREGIONS; j++)
+	{
+		preg = &proc->pregs[j];
+		
+		/* Skip unused process regions. */
+		if ((reg = preg->reg) == NULL)
+			continue;
+		
+		/* Skip shared and locked regions. */
+		if ((reg->count > 1) || (reg->flags & REGION_LOCKED))
+			continue;
+		
+		for (size_t off = 0; off < reg->size; off += PAGE_SIZE)
+		{
+			addr = (reg->flags & REGION_DOWNWARDS) ?
+				preg->start - off : preg->start + off;
+			pg = getrpte(preg, addr);
+			
+			/* Not in-core. */
+			if (!pg->present)
+				continue;
+			
+			/* Shared page. */
+			i = pg->frame - (UBASE_PHYS >> PAGE_SHIFT);
+			if (frames[i].count > 1)
+				continue;
+			
+			frames[i].locked = 0;
+			freeupg(pg);
+			markpg(pg, PAGE_ZERO);
+			n++;
+		}
+	}
+	
+	return (n);
+}
 
 /**
  * @brief Allocates a page frame.
  * 
+ * @details Looks for a free page frame. If there is none, the oldest page of
+ *          the current process is swapped out. If that is not possible either,
+ *          pages of other processes are evicted and, as a last resort, the
+ *          process with the highest badness is killed.
+ * 
  * @returns Upon success, the number of the frame is returned. Upon failure, a
  *          negative number is returned instead.
  */
 PRIVATE int allocf(void)
 {
-	int i;      /* Loop index.  */
-	int oldest; /* Oldest page. */
+	int i;                  /* Loop index.  */
+	int oldest;             /* Oldest page. */
+	struct process *victim; /* OOM victim.  */
 	
 	#define OLDEST(x, y) (frames[x].age < frames[y].age)
-	
+
+again:
+
 	/* Search for a free frame. */
 	oldest = -1;
 	for (i = 0; i < NR_FRAMES; i++)
@@ -308,8 +559,8 @@ PRIVATE int allocf(void)
 		/* Local page replacement policy. */
 		if (frames[i].owner == curr_proc->pid)
 		{
-			/* Skip shared pages. */
-			if (frames[i].count > 1)
+			/* Skip shared and locked pages. */
+			if ((frames[i].count > 1) || (frames[i].locked))
 				continue;
 			
 			/* Oldest page found. */
@@ -318,22 +569,169 @@ PRIVATE int allocf(void)
 		}
 	}
 	
-	/* No frame left. */
-	if (oldest < 0)
+	/*
+	 * Swap page out. The page frame is kept
+	 * away from other evictions meanwhile.
+	 */
+	if (oldest >= 0)
+	{
+		frames[oldest].owner = 0;
+		if (!swap_out(curr_proc, frames[i = oldest].addr))
+			goto found;
+		frames[oldest].owner = curr_proc->pid;
+	}
+	
+	/* Global page replacement. */
+	if ((i = evictf()) >= 0)
+		goto found;
+	
+	/* Out of memory. */
+	if ((victim = oomkill()) == NULL)
 		return (-1);
 	
-	/* Swap page out. */
-	if (swap_out(curr_proc, frames[i = oldest].addr))
+	/* The current process is about to die. */
+	if (victim == curr_proc)
 		return (-1);
 	
+	if (reapmem(victim) > 0)
+		goto again;
+	
+	return (-1);
+	
 found:		
 
 	frames[i].age = ticks;
 	frames[i].count = 1;
+	frames[i].locked = 0;
+	
+	return (i);
+}
+
+/**
+ * @brief Asserts if there is a free page frame.
+ * 
+ * @returns True if some page frame may be allocated without swapping a page
+ *          out, and false otherwise.
+ */
+PRIVATE int hasfreef(void)
+{
+	for (int i = 0; i < NR_FRAMES; i++)
+	{
+		/* Found it. */
+		if (frames[i].count == 0)
+			return (1);
+	}
+	
+	return (0);
+}
+
+/**
+ * @brief Reserves a page frame.
+ * 
+ * @details Looks for a free page frame, evicting a page of some other process
+ *          if there is none. The frame is not owned by any process and it is
+ *          locked, so that it is not evicted later on.
+ * 
+ * @returns Upon success, the number of the frame is returned. Upon failure, a
+ *          negative number is returned instead.
+ */
+PUBLIC int reservef(void)
+{
+	int i; /* Loop index. */
+	
+	/* Search for a free frame. */
+	for (i = 0; i < NR_FRAMES; i++)
+	{
+		/* Found it. */
+		if (frames[i].count == 0)
+			goto found;
+	}
+	
+	/* Global page replacement. */
+	if ((i = evictf()) >= 0)
+		goto found;
+	
+	return (-1);
+
+found:
+
+	frames[i].age = ticks;
+	frames[i].count = 1;
+	frames[i].owner = 0;
+	frames[i].locked = 1;
 	
 	return (i);
 }
 
+/**
+ * @brief Releases a page frame that was reserved with reservef().
+ * 
+ * @param i Number of the frame.
+ */
+PUBLIC void releasef(unsigned i)
+{
+	frames[i].count = 0;
+	frames[i].locked = 0;
+}
+
+/**
+ * @brief Asserts if a page frame is in use.
+ * 
+ * @param i Number of the frame.
+ * 
+ * @returns True if the page frame is in use, and false otherwise.
+ */
+PUBLIC int usedf(unsigned i)
+{
+	return (frames[i].count > 0);
+}
+
+/**
+ * @brief Asserts if a kernel page is in use.
+ * 
+ * @param i Number of the kernel page.
+ * 
+ * @returns True if the kernel page is in use, and false otherwise.
+ */
+PUBLIC int usedkpg(unsigned i)
+{
+	return (kpages[i] > 0);
+}
+
+/**
+ * @brief Gets memory statistics.
+ * 
+ * @param st Store location for statistics.
+ */
+PUBLIC void mm_stat(struct mem_stat *st)
+{
+	st->nframes = NR_FRAMES;
+	st->nfree = st->nshared = st->nlocked = 0;
+	for (unsigned i = 0; i < NR_FRAMES; i++)
+	{
+		if (frames[i].count == 0)
+			st->nfree++;
+		else if (frames[i].count > 1)
+			st->nshared++;
+		if (frames[i].locked)
+			st->nlocked++;
+	}
+	
+	st->nkpages = NR_KPAGES;
+	st->nkfree = 0;
+	for (unsigned i = 0; i < NR_KPAGES; i++)
+	{
+		if (kpages[i] == 0)
+			st->nkfree++;
+	}
+	
+	st->faults = stats.faults;
+	st->cows = stats.cows;
+	st->evictions = stats.evictions;
+	st->swapins = stats.swapins;
+	st->swapouts = stats.swapouts;
+}
+
 /**
  * @brief Copies a page.
  * 
@@ -365,37 +763,85 @@ PRIVATE int cpypg(struct pte *pg1, struct pte *pg2)
 }
 
 /**
- * @brief Allocates a user page.
+ * @brief Breaks copy on write of a page.
  * 
- * @param addr     Address where the page resides.
- * @param writable Is the page writable?
+ * @param pg   Page table entry of the page.
+ * @param addr Address where the page resides.
  * 
  * @returns Zero upon successful completion, and non-zero otherwise.
  */
-PRIVATE int allocupg(addr_t addr, int writable)
+PRIVATE int cowpg(struct pte *pg, addr_t addr)
 {
-	int i;          /* Page frame index.         */
-	struct pte *pg; /* Working page table entry. */
-	
-	/* Failed to allocate page frame. */
-	if ((i = allocf()) < 0)
-		return (-1);
+	unsigned i;        /* Frame index. */
+	struct pte new_pg; /* New page.    */
 	
-	/* Initialize page frame. */
-	frames[i].owner = curr_proc->pid;
-	frames[i].addr = addr & PAGE_MASK;
-	
-	/* Allocate page. */
-	pg = getpte(curr_proc, addr);
-	kmemset(pg, 0, sizeof(struct pte));
-	pg->present = 1;
-	pg->writable = (writable) ? 1 : 0;
-	pg->user = 1;
-	pg->frame = (UBASE_PHYS >> PAGE_SHIFT) + i;
-	tlb_flush();
-	
-	return (0);
-}
+	i = pg->frame - (UBASE_PHYS >> PAGE_SHIFT);
+
+	/* Duplicate page. */
+	if (frames[i].count > 1)
+	{
+		if (cpypg(&new_pg, pg))
+			return (-1);
+		
+		new_pg.cow = 0;
+		new_pg.writable = 1;
+		
+		/* Unlik page. */
+		if (--frames[i].count == 1)
+			frames[i].owner = 0;
+		kmemcpy(pg, &new_pg, sizeof(struct pte));
+		
+		i = pg->frame - (UBASE_PHYS >> PAGE_SHIFT);
+		frames[i].owner = curr_proc->pid;
+		frames[i].addr = addr & PAGE_MASK;
+	}
+		
+	/* Steal page. */
+	else
+	{
+		pg->cow = 0;
+		pg->writable = 1;
+		frames[i].owner = curr_proc->pid;
+		frames[i].addr = addr & PAGE_MASK;
+	}
+	
+	tlb_flush();
+	
+	return (0);
+}
+
+/**
+ * @brief Allocates a user page.
+ * 
+ * @param addr     Address where the page resides.
+ * @param writable Is the page writable?
+ * 
+ * @returns Zero upon successful completion, and non-zero otherwise.
+ */
+PRIVATE int allocupg(addr_t addr, int writable)
+{
+	int i;          /* Page frame index.         */
+	struct pte *pg; /* Working page table entry. */
+	
+	/* Failed to allocate page frame. */
+	if ((i = allocf()) < 0)
+		return (-1);
+	
+	/* Initialize page frame. */
+	frames[i].owner = curr_proc->pid;
+	frames[i].addr = addr & PAGE_MASK;
+	
+	/* Allocate page. */
+	pg = getpte(curr_proc, addr);
+	kmemset(pg, 0, sizeof(struct pte));
+	pg->present = 1;
+	pg->writable = (writable) ? 1 : 0;
+	pg->user = 1;
+	pg->frame = (UBASE_PHYS >> PAGE_SHIFT) + i;
+	tlb_flush();
+	
+	return (0);
+}
 
 /**
  * @brief Reads a page from a file.
@@ -442,6 +888,108 @@ PRIVATE int readpg(struct region *reg, addr_t addr)
 	return (0);
 }
 
+/**
+ * @brief Loads a non-present page.
+ * 
+ * @param reg  Region where the page resides.
+ * @param pg   Page table entry of the page.
+ * @param addr Address where the page should be loaded.
+ * 
+ * @returns Zero upon successful completion, and non-zero upon failure.
+ */
+PRIVATE int loadpg(struct region *reg, struct pte *pg, addr_t addr)
+{
+	int frame; /* Frame index of page to be swapped in. */
+	
+	/* Clear page. */
+	if (pg->zero)
+	{
+		if (allocupg(addr, reg->mode & MAY_WRITE))
+			return (-1);
+		kmemset((void *)(addr & PAGE_MASK), 0, PAGE_SIZE);
+	}
+		
+	/* Load page from executable file. */
+	else if (pg->fill)
+	{
+		/* Read page. */
+		if (readpg(reg, addr))
+			return (-1);
+	}
+		
+	/* Swap page in. */
+	else
+	{
+		if ((frame = allocf()) < 0)
+			return (-1);
+		if (swap_in(frame, addr))
+		{
+			frames[frame].count = 0;
+			return (-1);
+		}
+		frames[frame].owner = curr_proc->pid;
+		frames[frame].addr = addr & PAGE_MASK;
+	}
+	
+	return (0);
+}
+
+/**
+ * @brief Reads ahead pages from a file.
+ * 
+ * @details Loads the demand fill pages that follow the page at address @p addr
+ *          of the process region pointed to by @p preg. The size of the window
+ *          depends on the access pattern advised for the region, and reading
+ *          stops early rather than swapping pages out.
+ * 
+ * @param preg Process region where the pages reside.
+ * @param addr Address of the page that has just been loaded.
+ * 
+ * @note The underlying region must be locked.
+ */
+PRIVATE void readahead(struct pregion *preg, addr_t addr)
+{
+	unsigned n;     /* Pages left.               */
+	struct pte *pg; /* Working page table entry. */
+	
+	switch (preg->reg->advice)
+	{
+		case MADV_RANDOM:
+			n = 0;
+			break;
+		
+		case MADV_SEQUENTIAL:
+			n = READAHEAD_SEQUENTIAL;
+			break;
+		
+		default:
+			n = READAHEAD_NORMAL;
+			break;
+	}
+	
+	for (addr &= PAGE_MASK; n > 0; n--)
+	{
+		addr += PAGE_SIZE;
+		
+		/* End of region. */
+		if (!withinreg(preg, addr))
+			break;
+		
+		pg = getrpte(preg, addr);
+		
+		/* Not a demand fill page. */
+		if ((pg->present) || (!pg->fill))
+			break;
+		
+		/* Do not swap pages out. */
+		if (!hasfreef())
+			break;
+		
+		if (readpg(preg->reg, addr))
+			break;
+	}
+}
+
 /**
  * @brief Maps a page table into user address space.
  * 
@@ -508,7 +1056,7 @@ PUBLIC void freeupg(struct pte *pg)
 	/* In-disk page. */
 	if (!pg->present)
 	{
-		swap_clear(pg);
+		swap_free(pg->frame);
 		kmemset(pg, 0, sizeof(struct pte));
 		return;
 	}
@@ -581,12 +1129,169 @@ PUBLIC void linkupg(struct pte *upg1, struct pte *upg2)
 	
 	/* In-disk page. */
 	else
+		swap_dup(upg1->frame);
+	
+	kmemcpy(upg2, upg1, sizeof(struct pte));
+}
+
+/**
+ * @brief Gets a reference to a user page.
+ * 
+ * @details Loads the page at address @p addr of the current process, if
+ *          needed, and links it to the page table entry pointed to by @p pg,
+ *          so that the page may be mapped elsewhere later on. Writable pages
+ *          become copy on write.
+ * 
+ * @param addr Address of the page.
+ * @param pg   Page table entry where the reference should be stored.
+ * 
+ * @returns Upon successful completion, zero is returned. Upon failure, a
+ *          negative error code is returned instead.
+ */
+PUBLIC int getupg(addr_t addr, struct pte *pg)
+{
+	struct pte *upg;      /* Working page.            */
+	struct region *reg;   /* Working region.          */
+	struct pregion *preg; /* Working process region. */
+	
+	/* Not mapped. */
+	preg = findreg(curr_proc, addr);
+	if ((preg == NULL) || (!withinreg(preg, addr)))
+		return (-EFAULT);
+	
+	lockreg(reg = preg->reg);
+	
+	upg = getpte(curr_proc, addr);
+	
+	/* Load page. */
+	if (!upg->present)
 	{
-		 i = upg1->frame;
-		 swap.count[i]++;
+		if (loadpg(reg, upg, addr))
+		{
+			unlockreg(reg);
+			return (-ENOMEM);
+		}
 	}
 	
-	kmemcpy(upg2, upg1, sizeof(struct pte));
+	linkupg(upg, pg);
+	tlb_flush();
+	
+	unlockreg(reg);
+	
+	return (0);
+}
+
+/**
+ * @brief Maps a user page.
+ * 
+ * @details Replaces the page at address @p addr of the current process by the
+ *          page referenced by the page table entry pointed to by @p pg. The
+ *          reference is handed over to the current process, and the page is
+ *          mapped copy on write.
+ * 
+ * @param addr Address where the page should be mapped.
+ * @param pg   Reference to the page, as returned by getupg().
+ * 
+ * @returns Upon successful completion, zero is returned. Upon failure, a
+ *          negative error code is returned instead.
+ */
+PUBLIC int mapupg(addr_t addr, struct pte *pg)
+{
+	struct pte *upg;      /* Working page.            */
+	struct region *reg;   /* Working region.          */
+	struct pregion *preg; /* Working process region. */
+	
+	/* Not mapped. */
+	preg = findreg(curr_proc, addr);
+	if ((preg == NULL) || (!withinreg(preg, addr)))
+		return (-EFAULT);
+	
+	/* Not writable. */
+	if (!(preg->reg->mode & MAY_WRITE))
+		return (-EFAULT);
+	
+	lockreg(reg = preg->reg);
+	
+	upg = getpte(curr_proc, addr);
+	
+	/* Locked page. */
+	if (upg->present)
+	{
+		if (frames[upg->frame - (UBASE_PHYS >> PAGE_SHIFT)].locked)
+		{
+			unlockreg(reg);
+			return (-EBUSY);
+		}
+	}
+	
+	freeupg(upg);
+	kmemcpy(upg, pg, sizeof(struct pte));
+	upg->user = 1;
+	upg->writable = 0;
+	upg->cow = 1;
+	tlb_flush();
+	
+	unlockreg(reg);
+	
+	return (0);
+}
+
+/**
+ * @brief Releases a reference to a user page.
+ * 
+ * @param pg Reference to the page, as returned by getupg().
+ */
+PUBLIC void putupg(struct pte *pg)
+{
+	freeupg(pg);
+}
+
+/**
+ * @brief Shares a kernel page with all processes.
+ * 
+ * @details Maps the kernel page pointed to by @p kpg read-only at address
+ *          @p addr of the shared kernel pages area. The mapping is installed
+ *          in the page directory of the idle process, which every other
+ *          process inherits on fork(), and it is kept across execve().
+ * 
+ * @param addr Address where the page should be mapped.
+ * @param kpg  Kernel page to be shared.
+ * 
+ * @note This function should be called on system initialization only.
+ */
+PUBLIC void sharekpg(addr_t addr, void *kpg)
+{
+	struct pde *pde;   /* Shared page directory entry. */
+	struct pte *pgtab; /* Shared page table.           */
+	struct pte *pg;    /* Working page.                */
+	
+	/* Bad address. */
+	if (PGTAB(addr) != PGTAB(USHARED_ADDR))
+		kpanic("mm: bad shared page address");
+	
+	pde = &idle_pgdir[PGTAB(USHARED_ADDR)];
+	
+	/* Create shared page table. */
+	if (!pde->present)
+	{
+		if ((pgtab = getkpg(1)) == NULL)
+			kpanic("mm: cannot allocate shared page table");
+		
+		pde->present = 1;
+		pde->writable = 0;
+		pde->user = 1;
+		pde->frame = (ADDR(pgtab) - KBASE_VIRT) >> PAGE_SHIFT;
+	}
+	
+	pgtab = (struct pte *)((pde->frame << PAGE_SHIFT) + KBASE_VIRT);
+	pg = &pgtab[PG(addr)];
+	
+	pg->present = 1;
+	pg->writable = 0;
+	pg->user = 1;
+	pg->frame = (ADDR(kpg) - KBASE_VIRT) >> PAGE_SHIFT;
+	
+	tlb_flush();
 }
 
 /**
@@ -618,6 +1323,7 @@ PUBLIC int crtpgdir(struct process *proc)
 	pgdir[PGTAB(KBASE_VIRT)] = curr_proc->pgdir[PGTAB(KBASE_VIRT)];
 	pgdir[PGTAB(KPOOL_VIRT)] = curr_proc->pgdir[PGTAB(KPOOL_VIRT)];
 	pgdir[PGTAB(INITRD_VIRT)] = curr_proc->pgdir[PGTAB(INITRD_VIRT)];
+	pgdir[PGTAB(USHARED_ADDR)] = curr_proc->pgdir[PGTAB(USHARED_ADDR)];
 	
 	/* Clone kernel stack. */
 	kmemcpy(kstack, curr_proc->kstack, KSTACK_SIZE);
@@ -666,10 +1372,13 @@ PUBLIC void dstrypgdir(struct process *proc)
  */
 PUBLIC int vfault(addr_t addr)
 {
-	int frame;            /* Frame index of page to be swapped in. */
-	struct pte *pg;       /* Working page.                         */
-	struct region *reg;   /* Working region.                       */
-	struct pregion *preg; /* Working process region.               */
+	int fill;             /* Demand fill page?        */
+	struct pte *pg;       /* Working page.            */
+	struct region *reg;   /* Working region.          */
+	struct pregion *preg; /* Working process region. */
+	
+	stats.faults++;
+	curr_proc->faults++;
 	
 	/* Get associated region. */
 	preg = findreg(curr_proc, addr);
@@ -685,48 +1394,27 @@ PUBLIC int vfault(addr_t addr)
 		if (preg != STACK(curr_proc))
 			goto error1;
 	
-		kprintf("growing stack");
+		kdebug("mm: growing stack");
 		
 		/* Expand region. */
 		if (growreg(curr_proc,preg,(preg->start-reg->size)-(addr&~PGTAB_MASK)))
 			goto error1;
 	}
 
-	pg = (reg->flags & REGION_DOWNWARDS) ?
-		&reg->pgtab[REGION_PGTABS-(PGTAB(preg->start)-PGTAB(addr))-1][PG(addr)]: 
-		&reg->pgtab[PGTAB(addr) - PGTAB(preg->start)][PG(addr)];
-		
-	/* Clear page. */
-	if (pg->zero)
-	{
-		if (allocupg(addr, reg->mode & MAY_WRITE))
-			goto error1;
-		kmemset((void *)(addr & PAGE_MASK), 0, PAGE_SIZE);
-	}
-		
-	/* Load page from executable file. */
-	else if (pg->fill)
-	{
-		/* Read page. */
-		if (readpg(reg, addr))
-			goto error1;
-	}
-		
-	/* Swap page in. */
-	else
-	{
-		if ((frame = allocf()) < 0)
-			goto error1;
-		if (swap_in(frame, addr))
-			goto error2;
-		frames[frame].addr = addr & PAGE_MASK;
-	}
+	pg = getrpte(preg, addr);
+	fill = pg->fill;
+	
+	/* Load page. */
+	if (loadpg(reg, pg, addr))
+		goto error1;
+	
+	/* Read ahead from executable file. */
+	if (fill)
+		readahead(preg, addr);
 	
 	unlockreg(reg);
 	return (0);
 
-error2:
-	frames[frame].count = 0;
 error1:
 	unlockreg(reg);
 error0:
@@ -742,12 +1430,13 @@ error0:
  */
 PUBLIC int pfault(addr_t addr)
 {
-	unsigned i;           /* Frame index.            */
 	struct pte *pg;       /* Faulting page.          */
-	struct pte new_pg;    /* New page.               */
 	struct region *reg;   /* Working memory region.  */
 	struct pregion *preg; /* Working process region. */
 
+	stats.cows++;
+	curr_proc->faults++;
+	
 	preg = findreg(curr_proc, addr);
 	
 	/* Outside virtual address space. */
@@ -756,42 +1445,456 @@ PUBLIC int pfault(addr_t addr)
 	
 	lockreg(reg = preg->reg);
 
-	pg = (reg->flags & REGION_DOWNWARDS) ?
-		&reg->pgtab[REGION_PGTABS-(PGTAB(preg->start)-PGTAB(addr))-1][PG(addr)]: 
-		&reg->pgtab[PGTAB(addr) - PGTAB(preg->start)][PG(addr)];
+	pg = getrpte(preg, addr);
 
 	/* Copy on write not enabled. */
 	if (!pg->cow)
 		goto error1;
+	
+	if (cowpg(pg, addr))
+		goto error1;
+	
+	unlockreg(reg);
+	return(0);
+
+error1:
+	unlockreg(reg);
+error0:
+	return (-1);
+}
+
+/**
+ * @brief Swaps a page in to a process region.
+ * 
+ * @details Swaps the page at address @p addr of the process region pointed to
+ *          by @p preg in, if it lies in the swap slots @p first to
+ *          @p first + @p n - 1. Unlike swap_in(), the process region need not
+ *          belong to the current process.
+ * 
+ * @param pid   ID of the process that owns the process region.
+ * @param preg  Process region where the page resides.
+ * @param addr  Address of the page.
+ * @param first First swap slot.
+ * @param n     Number of swap slots.
+ * 
+ * @returns Zero upon success, and non-zero otherwise.
+ * 
+ * @note The underlying region must be locked.
+ */
+PRIVATE int drainpg
+(pid_t pid, struct pregion *preg, addr_t addr, unsigned first, unsigned n)
+{
+	int i;          /* Frame index.                  */
+	unsigned slot;  /* Swap slot.                    */
+	struct pte *pg; /* Working page table entry.     */
+	void *kpg;      /* Kernel page used for copying. */
+	
+	pg = getrpte(preg, addr);
+	
+	/* In-core or not loaded yet. */
+	if ((pg->present) || (pg->zero) || (pg->fill))
+		return (0);
+	
+	/* Swapped out to another swap area. */
+	slot = pg->frame;
+	if ((slot < first) || (slot - first >= n))
+		return (0);
+	
+	/* Get kernel page. */
+	if ((kpg = getkpg(0)) == NULL)
+		goto error0;
+	
+	if ((i = allocf()) < 0)
+		goto error1;
+	
+	if (swap_read(slot, kpg))
+		goto error2;
+	
+	physcpy(UBASE_PHYS + (i << PAGE_SHIFT), ADDR(kpg) - KBASE_VIRT, PAGE_SIZE);
+	swap_free(slot);
+	
+	/* Set page as present. */
+	pg->present = 1;
+	pg->frame = (UBASE_PHYS >> PAGE_SHIFT) + i;
+	pg->accessed = 0;
+	pg->dirty = 0;
+	frames[i].owner = pid;
+	frames[i].addr = addr & PAGE_MASK;
+	tlb_flush();
+	
+	putkpg(kpg);
+	return (0);
+
+error2:
+	frames[i].count = 0;
+error1:
+	putkpg(kpg);
+error0:
+	return (-1);
+}
+
+/**
+ * @brief Swaps pages in from a range of swap slots.
+ * 
+ * @details Walks the memory regions of all processes and swaps in every page
+ *          that has been swapped out to the swap slots @p first to
+ *          @p first + @p n - 1, so that the underlying swap area may be
+ *          removed.
+ * 
+ * @param first First swap slot.
+ * @param n     Number of swap slots.
+ * 
+ * @returns Zero upon success, and non-zero otherwise.
+ * 
+ * @note Page frames are allocated on behalf of the current process, so pages
+ *       of the current process may be swapped out to other swap areas.
+ */
+PUBLIC int swap_drain(unsigned first, unsigned n)
+{
+	addr_t addr;          /* Working address.         */
+	struct process *p;    /* Working process.         */
+	struct region *reg;   /* Working region.          */
+	struct pregion *preg; /* Working process region. */
+	
+	for (p = FIRST_PROC; p <= LAST_PROC; p++)
+	{
+		/* Skip invalid processes. */
+		if (!IS_VALID(p))
+			continue;
 		
-	i = pg->frame - (UBASE_PHYS >> PAGE_SHIFT);
+		for (int i = 0; i < NR_PREGIONS; i++)
+		{
+			preg = &p->pregs[i];
+			
+			/* Skip unused process regions. */
+			if ((reg = preg->reg) == NULL)
+				continue;
+			
+			lockreg(reg);
+			
+			/* Region has been detached while we slept. */
+			if (preg->reg != reg)
+			{
+				unlockreg(reg);
+				continue;
+			}
+			
+			for (size_t off = 0; off < reg->size; off += PAGE_SIZE)
+			{
+				addr = (reg->flags & REGION_DOWNWARDS) ?
+					preg->start - off : preg->start + off;
+				
+				if (drainpg(p->pid, preg, addr, first, n))
+				{
+					unlockreg(reg);
+					return (-1);
+				}
+			}
+			
+			unlockreg(reg);
+		}
+	}
+	
+	return (0);
+}
 
-	/* Duplicate page. */
-	if (frames[i].count > 1)
+/*============================================================================*
+ *                               Paging Hints                                 *
+ *============================================================================*/
+
+/**
+ * @brief Finds the process region of a range of memory.
+ * 
+ * @param addr Start address.
+ * @param len  Length in bytes.
+ * 
+ * @returns Upon success, a pointer to the process region of the current
+ *          process in which the whole range resides is returned. Upon failure,
+ *          a NULL pointer is returned instead.
+ */
+PRIVATE struct pregion *rangereg(addr_t addr, size_t len)
+{
+	struct pregion *preg; /* Working process region. */
+	
+	/* Address overflow. */
+	if (addr + len < addr)
+		return (NULL);
+	
+	preg = findreg(curr_proc, addr);
+	
+	/* Range spans more than one region. */
+	if ((preg == NULL) || (!withinreg(preg, addr)))
+		return (NULL);
+	if (!withinreg(preg, addr + len - 1))
+		return (NULL);
+	
+	return (preg);
+}
+
+/**
+ * @brief Counts the pages locked by a process.
+ * 
+ * @param proc Process to be inspected.
+ * 
+ * @returns The number of page frames that are locked by the process.
+ */
+PRIVATE unsigned nlocked(struct process *proc)
+{
+	unsigned n = 0;
+	
+	for (int i = 0; i < NR_FRAMES; i++)
 	{
-		if (cpypg(&new_pg, pg))
-			goto error1;
+		if ((frames[i].count > 0) && (frames[i].locked))
+		{
+			if (frames[i].owner == proc->pid)
+				n++;
+		}
+	}
+	
+	return (n);
+}
+
+/**
+ * @brief Drops a page.
+ * 
+ * @details Releases the page at address @p addr of the process region pointed
+ *          to by @p preg, so that the next reference loads it again from the
+ *          underlying file or fills it with zeros. Locked pages are kept.
+ * 
+ * @param preg Process region where the page resides.
+ * @param addr Address of the page.
+ * 
+ * @note The underlying region must be locked.
+ */
+PRIVATE void droppg(struct pregion *preg, addr_t addr)
+{
+	struct pte *pg;     /* Working page table entry. */
+	struct region *reg; /* Working region.           */
+	
+	reg = preg->reg;
+	pg = getrpte(preg, addr);
+	
+	/* In-core page. */
+	if (pg->present)
+	{
+		/* Locked page. */
+		if (frames[pg->frame - (UBASE_PHYS >> PAGE_SHIFT)].locked)
+			return;
+	}
+	
+	/* Not loaded yet. */
+	else if ((pg->zero) || (pg->fill))
+		return;
+	
+	freeupg(pg);
+	
+	/* Page from executable file. */
+	if ((reg->file.inode != NULL) && (addr >= preg->start) &&
+		(addr - preg->start < ALIGN(reg->file.size, PAGE_SIZE)))
+		markpg(pg, PAGE_FILL);
+	else
+		markpg(pg, PAGE_ZERO);
+}
+
+/**
+ * @brief Advises the paging system about the use of memory.
+ * 
+ * @param addr   Start address.
+ * @param len    Length in bytes.
+ * @param advice Advice.
+ * 
+ * @returns Upon successful completion, zero is returned. Upon failure, a
+ *          negative error code is returned instead.
+ * 
+ * @note The start address must be page aligned.
+ */
+PUBLIC int advisepg(addr_t addr, size_t len, int advice)
+{
+	int ret;              /* Return value.            */
+	struct pte *pg;       /* Working page.            */
+	struct region *reg;   /* Working region.          */
+	struct pregion *preg; /* Working process region. */
+	
+	/* Nothing to be done. */
+	if (len == 0)
+		return (0);
+	
+	/* Not mapped. */
+	if ((preg = rangereg(addr, len)) == NULL)
+		return (-ENOMEM);
+	
+	ret = 0;
+	lockreg(reg = preg->reg);
+	
+	switch (advice)
+	{
+		/* Prefetch pages. */
+		case MADV_WILLNEED:
+			for (addr_t a = addr; a - addr < len; a += PAGE_SIZE)
+			{
+				pg = getrpte(preg, a);
+				
+				/* Skip in-core and demand zero pages. */
+				if ((pg->present) || (pg->zero))
+					continue;
+				
+				/* Do not swap pages out. */
+				if (!hasfreef())
+					break;
+				
+				if (loadpg(reg, pg, a))
+					break;
+			}
+			break;
 		
-		new_pg.cow = 0;
-		new_pg.writable = 1;
+		/* Drop pages. */
+		case MADV_DONTNEED:
+			/* Other processes may still need them. */
+			if (reg->flags & REGION_SHARED)
+			{
+				ret = -EINVAL;
+				break;
+			}
+			
+			for (addr_t a = addr; a - addr < len; a += PAGE_SIZE)
+				droppg(preg, a);
+			break;
 		
-		/* Unlik page. */
-		frames[i].count--;
-		kmemcpy(pg, &new_pg, sizeof(struct pte));
+		/* Access pattern. */
+		default:
+			reg->advice = advice;
+			break;
 	}
-		
-	/* Steal page. */
-	else
+	
+	unlockreg(reg);
+	
+	return (ret);
+}
+
+/**
+ * @brief Locks pages in memory.
+ * 
+ * @details Loads all pages in the range and pins their page frames, so that
+ *          they are not swapped out. The total amount of memory that a process
+ *          may lock is bounded by MLOCK_MAX, unless it is the superuser.
+ * 
+ * @param addr Start address.
+ * @param len  Length in bytes.
+ * 
+ * @returns Upon successful completion, zero is returned. Upon failure, a
+ *          negative error code is returned instead.
+ * 
+ * @note The start address must be page aligned.
+ */
+PUBLIC int lockpg(addr_t addr, size_t len)
+{
+	int ret;              /* Return value.            */
+	unsigned n;           /* Pages to be locked.      */
+	struct pte *pg;       /* Working page.            */
+	struct region *reg;   /* Working region.          */
+	struct pregion *preg; /* Working process region. */
+	
+	/* Nothing to be done. */
+	if (len == 0)
+		return (0);
+	
+	/* Not mapped. */
+	if ((preg = rangereg(addr, len)) == NULL)
+		return (-ENOMEM);
+	
+	ret = 0;
+	lockreg(reg = preg->reg);
+	
+	/* Count pages that are not locked yet. */
+	n = 0;
+	for (addr_t a = addr; a - addr < len; a += PAGE_SIZE)
 	{
-		pg->cow = 0;
-		pg->writable = 1;
+		pg = getrpte(preg, a);
+		if ((!pg->present) ||
+			(!frames[pg->frame - (UBASE_PHYS >> PAGE_SHIFT)].locked))
+			n++;
+	}
+	
+	/* Too much locked memory. */
+	if (!IS_SUPERUSER(curr_proc))
+	{
+		if ((nlocked(curr_proc) + n) > (MLOCK_MAX >> PAGE_SHIFT))
+		{
+			ret = -ENOMEM;
+			goto out;
+		}
 	}
 	
+	for (addr_t a = addr; a - addr < len; a += PAGE_SIZE)
+	{
+		pg = getrpte(preg, a);
+		
+		/* Load page. */
+		if (!pg->present)
+		{
+			if (loadpg(reg, pg, a))
+			{
+				ret = -EAGAIN;
+				break;
+			}
+		}
+		
+		/* Make page private. */
+		else if (pg->cow)
+		{
+			if (cowpg(pg, a))
+			{
+				ret = -EAGAIN;
+				break;
+			}
+		}
+		
+		frames[pg->frame - (UBASE_PHYS >> PAGE_SHIFT)].locked = 1;
+	}
+
+out:
 	unlockreg(reg);
-	return(0);
+	
+	return (ret);
+}
 
-error1:
+/**
+ * @brief Unlocks pages in memory.
+ * 
+ * @param addr Start address.
+ * @param len  Length in bytes.
+ * 
+ * @returns Upon successful completion, zero is returned. Upon failure, a
+ *          negative error code is returned instead.
+ * 
+ * @note The start address must be page aligned.
+ */
+PUBLIC int unlockpg(addr_t addr, size_t len)
+{
+	struct pte *pg;       /* Working page.            */
+	struct region *reg;   /* Working region.          */
+	struct pregion *preg; /* Working process region. */
+	
+	/* Nothing to be done. */
+	if (len == 0)
+		return (0);
+	
+	/* Not mapped. */
+	if ((preg = rangereg(addr, len)) == NULL)
+		return (-ENOMEM);
+	
+	lockreg(reg = preg->reg);
+	
+	for (addr_t a = addr; a - addr < len; a += PAGE_SIZE)
+	{
+		pg = getrpte(preg, a);
+		
+		/* Unlock page. */
+		if (pg->present)
+			frames[pg->frame - (UBASE_PHYS >> PAGE_SHIFT)].locked = 0;
+	}
+	
 	unlockreg(reg);
-error0:
-	return (-1);
+	
+	return (0);
 }
@@ -25,6 +25,7 @@
 #include <nanvix/mm.h>
 #include <nanvix/pm.h>
 #include <nanvix/region.h>
+#include <sys/mman.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <errno.h>
@@ -35,18 +36,67 @@
  */
 PRIVATE struct region regtab[NR_REGIONS];
 
+/**
+ * @brief Number of pages in a page table.
+ */
+#define PGTAB_PAGES (PAGE_SIZE/PTE_SIZE)
+
+/**
+ * @brief Gets the page table of a page of a memory region.
+ * 
+ * @param reg Memory region.
+ * @param k   Page number, counted from the start of the region.
+ * 
+ * @returns The index of the page table where the requested page resides.
+ */
+#define regpgtab(reg, k)                                            \
+	(((reg)->flags & REGION_DOWNWARDS) ?                            \
+		REGION_PGTABS - (k)/PGTAB_PAGES - 1 : (k)/PGTAB_PAGES)
+
+/**
+ * @brief Gets a page table entry of a page of a memory region.
+ * 
+ * @param reg Memory region.
+ * @param k   Page number, counted from the start of the region.
+ * 
+ * @returns The requested page table entry.
+ */
+#define regpte(reg, k)                                              \
+	(&(reg)->pgtab[regpgtab(reg, k)][                               \
+		((reg)->flags & REGION_DOWNWARDS) ?                         \
+			PGTAB_PAGES - (k)%PGTAB_PAGES - 1 : (k)%PGTAB_PAGES])
+
+/**
+ * @brief Gets the address where a page table of a memory region is mapped.
+ * 
+ * @param preg Process region where the memory region is attached.
+ * @param t    Page table number, counted from the start of the region.
+ * 
+ * @returns The requested address.
+ */
+#define regpgtabaddr(preg, t)                                       \
+	(((preg)->reg->flags & REGION_DOWNWARDS) ?                      \
+		(preg)->start - (t)*PGTAB_SIZE : (preg)->start + (t)*PGTAB_SIZE)
+
 /**
  * @brief Expands a memory region.
  * 
+ * @details Expands the memory region pointed to by @p reg one page table at a
+ *          time: the page table is allocated and mapped at once, if needed,
+ *          and then all new pages that lie on it are marked as demand zero.
+ * 
  * @param proc Process who owns the memory region.
  * @param reg  Memory region that shall be expanded.
  * @param size Size in bytes to be added to the memory region.
+ * 
+ * @returns Zero upon success, and non-zero otherwise.
  */
 PRIVATE int expand(struct process *proc, struct region *reg, size_t size)
 {	
-	unsigned i, j;        /* Loop indexes.                  */
-	unsigned npages;      /* Number of pages in the region. */
-	struct pregion *preg; /* Working process region.        */
+	unsigned i;           /* Page table index.          */
+	unsigned k, n;        /* First and last page + 1.   */
+	unsigned last;        /* Last page + 1 of the run.  */
+	struct pregion *preg; /* Working process region.    */
 	
 	size = ALIGN(size, PAGE_SIZE);
 	
@@ -55,113 +105,32 @@ PRIVATE int expand(struct process *proc, struct region *reg, size_t size)
 		return (-1);
 	
 	preg = reg->preg;
-	npages = size >> PAGE_SHIFT;
+	n = (reg->size + size) >> PAGE_SHIFT;
 	
-	/* Expand downwards. */
-	if (reg->flags & REGION_DOWNWARDS)
-	{		
-		/* Allocate first page table. */
-		if (reg->size == 0)
-		{
-			reg->pgtab[REGION_PGTABS - 1] = getkpg(1);
-			if (reg->pgtab[REGION_PGTABS - 1] == NULL)
-				return (-1);
-		}
-		
-		i = REGION_PGTABS - (reg->size >> PGTAB_SHIFT) - 1;
-		j = PAGE_SIZE/PTE_SIZE - 
-				(((PAGE_MASK^PGTAB_MASK) & reg->size) >> PAGE_SHIFT);
-				
-		if (reg->size != 0 && j == (PAGE_SIZE / PTE_SIZE) - 1)
-		{
-			reg->pgtab[i] = getkpg(1);
-			if (reg->pgtab[i] == NULL)
-				return (-1);
-				
-			/* Map page table. */
-			if (proc != NULL)
-				mappgtab(proc, preg->start + reg->size, reg->pgtab[i]);
-		}
-		
-		/* Mark pages as demand zero. */
-		while (npages > 0)
-		{
-			/* Create new page table. */
-			if (j == 0)
-			{
-				i--;
-				j = PAGE_SIZE/PTE_SIZE;
-				
-				reg->pgtab[i] = getkpg(1);
-				if (reg->pgtab[i] == NULL)
-					return (-1);
-					
-				/* Map page table. */
-				if (proc != NULL)
-					mappgtab(proc, preg->start - reg->size, reg->pgtab[i]);
-				
-				continue;
-			}
-		
-			j--;
-			npages--;
-			reg->size += PAGE_SIZE;
-			
-			markpg(&reg->pgtab[i][j], PAGE_ZERO);
-		}
-	}
-
-	/* Expand upwards. */
-	else
+	for (k = reg->size >> PAGE_SHIFT; k < n; k = last)
 	{
-		/* Allocate first page table. */
-		if (reg->size == 0)
-		{
-			reg->pgtab[0] = getkpg(1);
-			if (reg->pgtab[0] == NULL)
-				return (-1);
-		}
+		i = regpgtab(reg, k);
+		last = (k/PGTAB_PAGES + 1)*PGTAB_PAGES;
+		if (last > n)
+			last = n;
 		
-		i = reg->size >> PGTAB_SHIFT;
-		j = ((PAGE_MASK^PGTAB_MASK) & reg->size) >> PAGE_SHIFT;
-		
-		if (reg->size != 0 && j == 0)
+		/* Create new page table. */
+		if (reg->pgtab[i] == NULL)
 		{
 			reg->pgtab[i] = getkpg(1);
 			if (reg->pgtab[i] == NULL)
 				return (-1);
-				
+			
 			/* Map page table. */
 			if (proc != NULL)
-				mappgtab(proc, preg->start + reg->size, reg->pgtab[i]);
+				mappgtab(proc, regpgtabaddr(preg, k/PGTAB_PAGES), reg->pgtab[i]);
 		}
 		
 		/* Mark pages as demand zero. */
-		while (npages > 0)
-		{
-			/* Reset. */
-			if (j == PAGE_SIZE/PTE_SIZE)
-			{
-				i++;
-				j = 0;
-				
-				reg->pgtab[i] = getkpg(1);
-				if (reg->pgtab[i] == NULL)
-					return (-1);
-				
-				/* Map page table. */
-				if (proc != NULL)
-					mappgtab(proc, preg->start + reg->size, reg->pgtab[i]);
-				
-				continue;
-			}
-			
-			markpg(&reg->pgtab[i][j], PAGE_ZERO);
-			
-			j++;
-			npages--;
-			reg->size += PAGE_SIZE;
-		}
+		for (unsigned j = k; j < last; j++)
+			markpg(regpte(reg, j), PAGE_ZERO);
+		
+		reg->size += (last - k) << PAGE_SHIFT;
 	}
 	
 	return (0);
@@ -170,6 +139,10 @@ PRIVATE int expand(struct process *proc, struct region *reg, size_t size)
 /**
  * @brief Contracts a memory region.
  * 
+ * @details Contracts the memory region pointed to by @p reg one page table at
+ *          a time: all pages that lie on the page table are freed, and then
+ *          the page table is unmapped and released if it became empty.
+ * 
  * @param proc Process who owns the memory region.
  * @param reg  Memory region that shall be contracted.
  * @param size Size in bytes to be removed from the memory region.
@@ -178,9 +151,10 @@ PRIVATE int expand(struct process *proc, struct region *reg, size_t size)
  */
 PRIVATE int contract(struct process *proc, struct region *reg, size_t size)
 {
-	unsigned i, j;        /* Loop indexes.                  */
-	unsigned npages;      /* Number of pages in the region. */
-	struct pregion *preg; /* Working process region.        */
+	unsigned i;           /* Page table index.        */
+	unsigned k, n;        /* First and last page + 1. */
+	unsigned first;       /* First page of the run.   */
+	struct pregion *preg; /* Working process region.  */
 	
 	size = ALIGN(size, PAGE_SIZE);
 	
@@ -189,71 +163,29 @@ PRIVATE int contract(struct process *proc, struct region *reg, size_t size)
 		return (-1);
 
 	preg = reg->preg;
-	npages = reg->size >> PAGE_SHIFT;
+	k = (reg->size - size) >> PAGE_SHIFT;
 	
-	/* Contract downwards. */
-	if (reg->flags & REGION_DOWNWARDS)
-	{		
-		i = REGION_PGTABS - (reg->size >> PGTAB_SHIFT) - 1;
-		j = PAGE_SIZE/PTE_SIZE - 
-				(((PAGE_MASK^PGTAB_MASK) & reg->size) >> PAGE_SHIFT);
+	for (n = reg->size >> PAGE_SHIFT; n > k; n = first)
+	{
+		i = regpgtab(reg, n - 1);
+		first = ((n - 1)/PGTAB_PAGES)*PGTAB_PAGES;
+		if (first < k)
+			first = k;
 		
-		/* Mark pages as demand zero. */
-		while (npages > 0)
-		{
-			/* Create new page table. */
-			if (j == PAGE_SIZE/PTE_SIZE)
-			{
-				/* Unmap page table. */
-				if (proc != NULL)
-					umappgtab(proc, preg->start - reg->size);
-				putkpg(reg->pgtab[i]);
-				reg->pgtab[i] = NULL;
-				
-				i++;
-				j = 0;
-				
-				continue;
-			}
-			
-			freeupg(&reg->pgtab[i][j]);
-			
-			j++;
-			npages--;
-			reg->size -= PAGE_SIZE;
+		/* Free pages. */
+		for (unsigned j = first; j < n; j++)
+			freeupg(regpte(reg, j));
 		
-		}
-	}
-
-	/* Contract upwards. */
-	else
-	{
-		i = reg->size >> PGTAB_SHIFT;
-		j = ((PAGE_MASK^PGTAB_MASK) & reg->size) >> PAGE_SHIFT;
+		reg->size -= (n - first) << PAGE_SHIFT;
 		
-		/* Mark pages as demand zero. */
-		while (npages > 0)
+		/* Release empty page table. */
+		if ((first % PGTAB_PAGES) == 0)
 		{
-			/* Reset. */
-			if (j == 0)
-			{
-				/* Unmap page table. */
-				if (proc != NULL)
-					umappgtab(proc, preg->start - reg->size);
-				putkpg(reg->pgtab[i]);
-				reg->pgtab[i] = NULL;
-				
-				i--;
-				j = PAGE_SIZE/PTE_SIZE;
-				
-				continue;
-			}
-			
-			j--;
-			npages--;
-			reg->size -= PAGE_SIZE;
-			
-			freeupg(&reg->pgtab[i][j]);
+			/* Unmap page table. */
+			if (proc != NULL)
+				umappgtab(proc, regpgtabaddr(preg, first/PGTAB_PAGES));
+			putkpg(reg->pgtab[i]);
+			reg->pgtab[i] = NULL;
 		}
 	}
 	
@@ -308,7 +240,7 @@ PUBLIC struct region *allocreg(mode_t mode, size_t size, int flags)
 			goto found;
 	}
 
-	kprintf("region table overflow");
+	kprintf_ratelimited(KERN_WARN "region table overflow");
 	
 	return (NULL);
 
@@ -319,6 +251,7 @@ found:
 	reg->count = 0;
 	reg->size = 0;
 	reg->chain = NULL;
+	reg->advice = MADV_NORMAL;
 	reg->file.inode = NULL;
 	reg->file.off = 0;
 	reg->file.size = 0;
@@ -576,6 +509,7 @@ PUBLIC struct region *dupreg(struct region *reg)
 	}
 	
 	/* Copy region fields. */
+	new_reg->advice = reg->advice;
 	if (reg->file.inode != NULL)
 	{
 		new_reg->file.inode = reg->file.inode;
@@ -0,0 +1,624 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of Nanvix.
+ * 
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nanvix/config.h>
+#include <nanvix/const.h>
+#include <nanvix/dev.h>
+#include <nanvix/fs.h>
+#include <nanvix/hal.h>
+#include <nanvix/klib.h>
+#include <nanvix/mm.h>
+#include <nanvix/pm.h>
+#include <sys/stat.h>
+#include <errno.h>
+#include "mm.h"
+
+/**
+ * @file
+ * 
+ * @brief Swap areas implementation.
+ * 
+ * @details Pages are swapped out to swap slots. Each swap area, either a block
+ *          device or a preallocated regular file, owns a contiguous range of
+ *          slots. Pages are swapped out to the active area with the highest
+ *          priority that has free slots, in round-robin among areas with the
+ *          same priority.
+ */
+
+/*
+ * Swapping area too small?
+ */
+#if (SWP_SIZE < MEMORY_SIZE)
+	#error "swapping area to small"
+#endif
+
+/*
+ * Swapping area too big?
+ */
+#if (SWP_SIZE > SWP_MAX)
+	#error "swapping area too big"
+#endif
+
+/**
+ * @brief Number of swap slots.
+ */
+#define NR_SLOTS (SWP_MAX/PAGE_SIZE)
+
+/**
+ * @brief Priority of the default swap area.
+ */
+#define SWAP_PRIO_DEFAULT -1
+
+/**
+ * @name Swap area flags
+ */
+/**@{*/
+#define SWAP_USED   (1 << 0) /**< Used?            */
+#define SWAP_ACTIVE (1 << 1) /**< Accepting pages? */
+/**@}*/
+
+/**
+ * @brief Swap area.
+ */
+PRIVATE struct swaparea
+{
+	unsigned flags;        /**< Flags (see above).            */
+	int prio;              /**< Priority.                     */
+	dev_t dev;             /**< Underlying block device.      */
+	off_t off;             /**< Offset in the block device.   */
+	struct inode *inode;   /**< Swap file.                    */
+	unsigned first;        /**< First slot.                   */
+	unsigned nslots;       /**< Number of slots.              */
+	unsigned nused;        /**< Number of used slots.         */
+	unsigned next;         /**< Next slot to look at.         */
+	unsigned busy;         /**< Number of pending writes.     */
+	struct process *chain; /**< Processes waiting for writes. */
+} swaptab[NR_SWAPS];
+
+/**
+ * @brief Swap slots.
+ * 
+ * @details The first slot is never used, since page table entries of pages
+ *          that are not present and not marked for demand fill or demand
+ *          zero look like pages that were swapped out to it. It is reserved
+ *          by swap_init(), so that this table stays out of kernel data.
+ */
+PRIVATE struct
+{
+	unsigned count[NR_SLOTS];       /**< Reference count. */
+	uint32_t bitmap[NR_SLOTS >> 5]; /**< Bitmap.          */
+} swap;
+
+/**
+ * @brief Last swap area that a page was swapped out to.
+ */
+PRIVATE unsigned last = 0;
+
+/**
+ * @brief Gets the swap area of a swap slot.
+ * 
+ * @param slot Swap slot.
+ * 
+ * @returns A pointer to the swap area that owns the swap slot, or a NULL
+ *          pointer if there is no such area.
+ */
+PRIVATE struct swaparea *swap_area(unsigned slot)
+{
+	struct swaparea *a;
+	
+	for (a = &swaptab[0]; a < &swaptab[NR_SWAPS]; a++)
+	{
+		/* Found. */
+		if ((a->flags & SWAP_USED) && (slot >= a->first) &&
+			(slot - a->first < a->nslots))
+			return (a);
+	}
+	
+	return (NULL);
+}
+
+/**
+ * @brief Asserts if a swap area is backed by an inode.
+ * 
+ * @param a  Swap area.
+ * @param ip Swap file or block device.
+ * 
+ * @returns True if the swap area is backed by the inode, and false otherwise.
+ */
+PRIVATE int swap_match(struct swaparea *a, struct inode *ip)
+{
+	/* Swap file. */
+	if (a->inode != NULL)
+		return (a->inode == ip);
+	
+	return ((S_ISBLK(ip->mode)) && (a->dev == ip->blocks[0]));
+}
+
+/**
+ * @brief Allocates a swap slot.
+ * 
+ * @returns Upon success, the number of the swap slot is returned. Upon
+ *          failure, a negative number is returned instead.
+ */
+PUBLIC int swap_alloc(void)
+{
+	unsigned slot;         /* Swap slot.         */
+	struct swaparea *a;    /* Working swap area. */
+	struct swaparea *best; /* Best swap area.    */
+	
+	/* Look for the best swap area. */
+	best = NULL;
+	for (unsigned i = 1; i <= NR_SWAPS; i++)
+	{
+		a = &swaptab[(last + i)%NR_SWAPS];
+		
+		/* Skip inactive and full swap areas. */
+		if (!(a->flags & SWAP_ACTIVE) || (a->nused == a->nslots))
+			continue;
+		
+		if ((best == NULL) || (a->prio > best->prio))
+			best = a;
+	}
+	
+	/* No swap space left. */
+	if (best == NULL)
+		return (-1);
+	
+	last = best - swaptab;
+	
+	/* Look for a free swap slot. */
+	for (unsigned i = 0; i < best->nslots; i++)
+	{
+		slot = best->first + (best->next + i)%best->nslots;
+		
+		/* Found. */
+		if (!(swap.bitmap[IDX(slot)] & (1 << OFF(slot))))
+		{
+			bitmap_set(swap.bitmap, slot);
+			swap.count[slot] = 1;
+			best->nused++;
+			best->next = (slot - best->first + 1)%best->nslots;
+			return (slot);
+		}
+	}
+	
+	kpanic("mm: swap area bitmap corrupted");
+	
+	return (-1);
+}
+
+/**
+ * @brief Reserves a range of swap slots.
+ * 
+ * @details Looks for @p n contiguous free slots in the default swap area, and
+ *          marks them as used. Unlike other swap areas, the default one is
+ *          known at system startup, so that these slots may be read before
+ *          any swap area is enabled.
+ * 
+ * @param n   Number of slots.
+ * @param off Store location for the device offset of the range.
+ * 
+ * @returns Upon success, the first slot of the range is returned. Upon
+ *          failure, a negative number is returned instead.
+ */
+PUBLIC int swap_reserve(unsigned n, off_t *off)
+{
+	unsigned slot;      /* Swap slot.           */
+	unsigned run;       /* Free slots in a row. */
+	struct swaparea *a; /* Working swap area.   */
+	
+	/* Find default swap area. */
+	for (a = &swaptab[0]; a < &swaptab[NR_SWAPS]; a++)
+	{
+		if (!(a->flags & SWAP_ACTIVE))
+			continue;
+		
+		if ((a->inode == NULL) && (a->dev == SWAP_DEV) && (a->off == SWAP_OFF))
+			goto found;
+	}
+	
+	return (-1);
+
+found:
+
+	run = 0;
+	for (slot = a->first; slot < a->first + a->nslots; slot++)
+	{
+		run = (swap.bitmap[IDX(slot)] & (1 << OFF(slot))) ? 0 : run + 1;
+		
+		/* Found. */
+		if (run == n)
+		{
+			for (unsigned i = slot + 1 - n; i <= slot; i++)
+			{
+				bitmap_set(swap.bitmap, i);
+				swap.count[i] = 1;
+			}
+			a->nused += n;
+			
+			*off = a->off + (slot + 1 - n - a->first)*PAGE_SIZE;
+			return (slot + 1 - n);
+		}
+	}
+	
+	return (-1);
+}
+
+/**
+ * @brief Releases a range of swap slots.
+ * 
+ * @param first First slot of the range.
+ * @param n     Number of slots.
+ */
+PUBLIC void swap_release(unsigned first, unsigned n)
+{
+	for (unsigned i = first; i < first + n; i++)
+		swap_free(i);
+}
+
+/**
+ * @brief Adds a reference to a swap slot.
+ * 
+ * @param slot Swap slot.
+ */
+PUBLIC void swap_dup(unsigned slot)
+{
+	/* Not in use. */
+	if (swap.count[slot] == 0)
+		return;
+	
+	swap.count[slot]++;
+}
+
+/**
+ * @brief Releases a reference to a swap slot.
+ * 
+ * @param slot Swap slot.
+ */
+PUBLIC void swap_free(unsigned slot)
+{
+	/* Not in use. */
+	if (swap.count[slot] == 0)
+		return;
+	
+	/* Free swap slot. */
+	if (--swap.count[slot] == 0)
+	{
+		bitmap_clear(swap.bitmap, slot);
+		swap_area(slot)->nused--;
+	}
+}
+
+/**
+ * @brief Gets swap statistics.
+ * 
+ * @param st Store location for statistics.
+ */
+PUBLIC void swap_stat(struct swap_stat *st)
+{
+	st->nareas = st->nslots = st->nused = 0;
+	
+	for (struct swaparea *a = &swaptab[0]; a < &swaptab[NR_SWAPS]; a++)
+	{
+		if (!(a->flags & SWAP_ACTIVE))
+			continue;
+		
+		st->nareas++;
+		st->nslots += a->nslots;
+		st->nused += a->nused;
+	}
+}
+
+/**
+ * @brief Reads a page from a swap slot.
+ * 
+ * @param slot Swap slot.
+ * @param buf  Page where the data should be placed.
+ * 
+ * @returns Zero upon success, and non-zero otherwise.
+ */
+PUBLIC int swap_read(unsigned slot, void *buf)
+{
+	ssize_t n;          /* # bytes read.      */
+	off_t off;          /* Offset.            */
+	struct swaparea *a; /* Working swap area. */
+	
+	a = swap_area(slot);
+	off = a->off + (slot - a->first)*PAGE_SIZE;
+	
+	/* Swap file. */
+	if (a->inode != NULL)
+		n = file_read(a->inode, buf, PAGE_SIZE, off);
+	
+	/* Swap device. */
+	else
+		n = bdev_read(a->dev, buf, PAGE_SIZE, off);
+	
+	return ((n == PAGE_SIZE) ? 0 : -1);
+}
+
+/**
+ * @brief Writes a page to a swap slot.
+ * 
+ * @param slot Swap slot.
+ * @param buf  Page to be written.
+ * 
+ * @returns Zero upon success, and non-zero otherwise.
+ */
+PUBLIC int swap_write(unsigned slot, const void *buf)
+{
+	ssize_t n;          /* # bytes written.   */
+	off_t off;          /* Offset.            */
+	struct swaparea *a; /* Working swap area. */
+	
+	a = swap_area(slot);
+	off = a->off + (slot - a->first)*PAGE_SIZE;
+	
+	a->busy++;
+	
+	/* Swap file. */
+	if (a->inode != NULL)
+		n = file_write(a->inode, buf, PAGE_SIZE, off);
+	
+	/* Swap device. */
+	else
+		n = bdev_write(a->dev, buf, PAGE_SIZE, off);
+	
+	if (--a->busy == 0)
+		wakeup(&a->chain);
+	
+	return ((n == PAGE_SIZE) ? 0 : -1);
+}
+
+/**
+ * @brief Adds a swap area.
+ * 
+ * @param dev   Underlying block device.
+ * @param off   Offset in the block device.
+ * @param inode Swap file, or NULL for a swap device.
+ * @param size  Size in bytes.
+ * @param prio  Priority.
+ * 
+ * @returns Upon successful completion, zero is returned. Upon failure, a
+ *          negative error code is returned instead.
+ */
+PRIVATE int swap_add
+(dev_t dev, off_t off, struct inode *inode, size_t size, int prio)
+{
+	unsigned start, end; /* Working range of slots. */
+	unsigned first, n;   /* Largest range of slots. */
+	struct swaparea *a;  /* Working swap area.      */
+	struct swaparea *b;  /* Another swap area.      */
+	
+	/* Find a free swap area. */
+	for (a = &swaptab[0]; a < &swaptab[NR_SWAPS]; a++)
+	{
+		if (!(a->flags & SWAP_USED))
+			goto found;
+	}
+	
+	return (-ENOMEM);
+
+found:
+
+	/*
+	 * Find the largest range of slots that is
+	 * not owned by any swap area. Such a range
+	 * starts either at the first usable slot or
+	 * right after some swap area.
+	 */
+	first = n = 0;
+	for (int i = -1; i < NR_SWAPS; i++)
+	{
+		if (i < 0)
+			start = 1;
+		else if (swaptab[i].flags & SWAP_USED)
+			start = swaptab[i].first + swaptab[i].nslots;
+		else
+			continue;
+		
+		end = NR_SLOTS;
+		for (b = &swaptab[0]; b < &swaptab[NR_SWAPS]; b++)
+		{
+			if (!(b->flags & SWAP_USED))
+				continue;
+			
+			if ((b->first >= start) && (b->first < end))
+				end = b->first;
+		}
+		
+		if (end - start > n)
+		{
+			first = start;
+			n = end - start;
+		}
+	}
+	
+	/* Clamp swap area. */
+	if (n > size/PAGE_SIZE)
+		n = size/PAGE_SIZE;
+	
+	/* No swap slots left. */
+	if (n == 0)
+		return (-ENOMEM);
+	
+	a->flags = SWAP_USED | SWAP_ACTIVE;
+	a->prio = prio;
+	a->dev = dev;
+	a->off = off;
+	a->inode = inode;
+	a->first = first;
+	a->nslots = n;
+	a->nused = 0;
+	a->next = 0;
+	a->busy = 0;
+	a->chain = NULL;
+	
+	kprintf("mm: swap area of %d KB (priority %d)", (n*PAGE_SIZE) >> 10, prio);
+	
+	return (0);
+}
+
+/**
+ * @brief Enables swapping to a file or block device.
+ * 
+ * @details Adds a swap area backed by the inode pointed to by @p ip. Block
+ *          devices are used as a whole, except for the root device, where the
+ *          swap area lies after the file system. Regular files must be
+ *          preallocated, that is, they may not have holes.
+ * 
+ * @param ip   Swap file or block device.
+ * @param prio Priority.
+ * 
+ * @returns Upon successful completion, zero is returned. Upon failure, a
+ *          negative error code is returned instead.
+ * 
+ * @note The inode must be locked.
+ */
+PUBLIC int swap_on(struct inode *ip, int prio)
+{
+	int err;            /* Error code.            */
+	ssize_t size;       /* Size of the swap area. */
+	struct swaparea *a; /* Working swap area.     */
+	
+	/* Already in use. */
+	for (a = &swaptab[0]; a < &swaptab[NR_SWAPS]; a++)
+	{
+		if (!(a->flags & SWAP_USED))
+			continue;
+		
+		if (swap_match(a, ip))
+			return (-EBUSY);
+	}
+	
+	/* Swap device. */
+	if (S_ISBLK(ip->mode))
+	{
+		/* Swap after the file system. */
+		if (ip->blocks[0] == SWAP_DEV)
+		{
+			return (swap_add(SWAP_DEV, SWAP_OFF, NULL, SWP_SIZE - PAGE_SIZE,
+				prio));
+		}
+		
+		/* Device is mounted. */
+		if (ip->blocks[0] == ROOT_DEV)
+			return (-EBUSY);
+		
+		if ((size = bdev_size(ip->blocks[0])) < 0)
+			return (size);
+		
+		return (swap_add(ip->blocks[0], 0, NULL, size, prio));
+	}
+	
+	/* Not a regular file. */
+	if (!S_ISREG(ip->mode))
+		return (-EINVAL);
+	
+	/* Swap file too small. */
+	if (ip->size < PAGE_SIZE)
+		return (-EINVAL);
+	
+	/* Swap file has holes. */
+	for (off_t off = 0; off < (off_t)ip->size; off += BLOCK_SIZE)
+	{
+		if (block_map(ip, off, 0) == BLOCK_NULL)
+			return (-EINVAL);
+	}
+	
+	/* Hold swap file. */
+	if ((err = swap_add(ip->dev, 0, ip, ip->size, prio)) == 0)
+		ip->count++;
+	
+	return (err);
+}
+
+/**
+ * @brief Disables swapping to a file or block device.
+ * 
+ * @details Swaps in all pages that have been swapped out to the swap area
+ *          backed by the inode pointed to by @p ip, and then removes it.
+ * 
+ * @param ip Swap file or block device.
+ * 
+ * @returns Upon successful completion, zero is returned. Upon failure, a
+ *          negative error code is returned instead.
+ * 
+ * @note The inode must not be locked, since pages may be read from it.
+ */
+PUBLIC int swap_off(struct inode *ip)
+{
+	struct swaparea *a; /* Working swap area. */
+	
+	/* Find swap area. */
+	for (a = &swaptab[0]; a < &swaptab[NR_SWAPS]; a++)
+	{
+		if (!(a->flags & SWAP_USED))
+			continue;
+		
+		if (swap_match(a, ip))
+			goto found;
+	}
+	
+	return (-EINVAL);
+
+found:
+
+	/* Stop swapping out and wait for pending writes. */
+	a->flags &= ~SWAP_ACTIVE;
+	while (a->busy > 0)
+		sleep(&a->chain, PRIO_IO);
+	
+	/* Failed to swap pages in. */
+	if ((swap_drain(a->first, a->nslots)) || (a->nused > 0))
+	{
+		a->flags |= SWAP_ACTIVE;
+		return (-ENOMEM);
+	}
+	
+	a->flags = 0;
+	
+	/* Release swap file. */
+	if (a->inode != NULL)
+	{
+		inode_lock(a->inode);
+		inode_put(a->inode);
+	}
+	
+	return (0);
+}
+
+/**
+ * @brief Initializes swap areas.
+ * 
+ * @details Adds the default swap area, which lies on the root device, right
+ *          after the file system and the hibernation header.
+ */
+PUBLIC void swap_init(void)
+{
+	for (unsigned i = 0; i < NR_SWAPS; i++)
+		swaptab[i].flags = 0;
+	
+	/* Reserve first slot. */
+	swap.bitmap[0] |= 1;
+	
+	if (swap_add(SWAP_DEV, SWAP_OFF, NULL, SWP_SIZE - PAGE_SIZE,
+		SWAP_PRIO_DEFAULT))
+		kpanic("mm: failed to add default swap area");
+}
@@ -0,0 +1,258 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of Nanvix.
+ * 
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nanvix/clock.h>
+#include <nanvix/config.h>
+#include <nanvix/const.h>
+#include <nanvix/klib.h>
+#include <nanvix/net.h>
+#include <errno.h>
+#include "net.h"
+
+/**
+ * @file
+ * 
+ * @brief Address resolution protocol.
+ * 
+ * @details A packet whose next hop has not been resolved yet is held in the
+ *          ARP table, and sent as soon as the reply arrives. Only the last
+ *          such packet is held, so senders never sleep on address resolution.
+ */
+
+/**
+ * @name ARP entry states
+ */
+/**@{*/
+#define ARP_FREE     0 /**< Unused.                  */
+#define ARP_PENDING  1 /**< Waiting for a reply.     */
+#define ARP_RESOLVED 2 /**< Hardware address known.  */
+/**@}*/
+
+/**
+ * @brief ARP table entry.
+ */
+PRIVATE struct arpent
+{
+	int state;             /**< State.                      */
+	in_addr_t addr;        /**< Internet address.           */
+	uint8_t mac[ETH_ALEN]; /**< Hardware address.           */
+	unsigned time;         /**< Last time used (in ticks).  */
+	struct netbuf *hold;   /**< Packet waiting for a reply. */
+} arptab[NR_ARPS];
+
+/**
+ * @brief Broadcast hardware address.
+ */
+PRIVATE const uint8_t broadcast[ETH_ALEN] = {
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff
+};
+
+/**
+ * @brief Looks up an entry in the ARP table.
+ * 
+ * @param addr   Internet address.
+ * @param create Create entry if there is none?
+ * 
+ * @returns The ARP entry for @p addr, or NULL if there is none and @p create
+ *          is zero. When the table is full, the least recently used entry is
+ *          recycled.
+ */
+PRIVATE struct arpent *arp_lookup(in_addr_t addr, int create)
+{
+	struct arpent *e;      /* Working entry. */
+	struct arpent *victim; /* Recycled.      */
+	
+	victim = NULL;
+	
+	for (e = &arptab[0]; e < &arptab[NR_ARPS]; e++)
+	{
+		if (e->state == ARP_FREE)
+		{
+			if ((victim == NULL) || (victim->state != ARP_FREE))
+				victim = e;
+			continue;
+		}
+		
+		/* Found. */
+		if (e->addr == addr)
+			return (e);
+		
+		if ((victim == NULL) ||
+			((victim->state != ARP_FREE) && (e->time < victim->time)))
+			victim = e;
+	}
+	
+	if (!create)
+		return (NULL);
+	
+	/* Drop held packet. */
+	if (victim->hold != NULL)
+	{
+		netbuf_put(victim->hold);
+		victim->hold = NULL;
+		netstats.txdropped++;
+	}
+	
+	victim->state = ARP_PENDING;
+	victim->addr = addr;
+	victim->time = ticks;
+	
+	return (victim);
+}
+
+/**
+ * @brief Sends an ARP packet.
+ * 
+ * @param op  Operation.
+ * @param tha Target hardware address.
+ * @param tpa Target Internet address.
+ */
+PRIVATE void arp_send(uint16_t op, const uint8_t *tha, in_addr_t tpa)
+{
+	struct netbuf *nb; /* Network buffer. */
+	struct arphdr *ah; /* ARP packet.     */
+	
+	/* No free network buffer. */
+	if ((nb = netbuf_get(0)) == NULL)
+	{
+		netstats.txdropped++;
+		return;
+	}
+	
+	ah = (struct arphdr *)&nb->data[ETH_HLEN];
+	ah->htype = htons(1);
+	ah->ptype = htons(ETH_P_IP);
+	ah->hlen = ETH_ALEN;
+	ah->plen = sizeof(in_addr_t);
+	ah->op = htons(op);
+	kmemcpy(ah->sha, netif.mac, ETH_ALEN);
+	ah->spa = netif.addr;
+	if (op == ARP_REQUEST)
+		kmemset(ah->tha, 0, ETH_ALEN);
+	else
+		kmemcpy(ah->tha, tha, ETH_ALEN);
+	ah->tpa = tpa;
+	nb->len = ETH_HLEN + sizeof(struct arphdr);
+	
+	eth_output(nb, tha, ETH_P_ARP);
+}
+
+/**
+ * @brief Processes a received ARP packet.
+ * 
+ * @param data ARP packet.
+ * @param len  Length of the packet.
+ */
+PUBLIC void arp_input(const void *data, size_t len)
+{
+	struct arpent *e;        /* ARP entry.   */
+	struct netbuf *nb;       /* Held packet. */
+	const struct arphdr *ah; /* ARP packet.  */
+	
+	ah = data;
+	
+	/* Bad packet. */
+	if ((len < sizeof(struct arphdr)) ||
+		(ah->htype != htons(1)) || (ah->ptype != htons(ETH_P_IP)) ||
+		(ah->hlen != ETH_ALEN) || (ah->plen != sizeof(in_addr_t)))
+	{
+		netstats.rxdropped++;
+		return;
+	}
+	
+	/*
+	 * Learn the sender if it is already known or
+	 * if it is talking to us, as it will most
+	 * likely want to hear back.
+	 */
+	e = arp_lookup(ah->spa, ah->tpa == netif.addr);
+	if (e != NULL)
+	{
+		kmemcpy(e->mac, ah->sha, ETH_ALEN);
+		e->state = ARP_RESOLVED;
+		e->time = ticks;
+		
+		/* Send held packet. */
+		if ((nb = e->hold) != NULL)
+		{
+			e->hold = NULL;
+			eth_output(nb, e->mac, ETH_P_IP);
+		}
+	}
+	
+	/* Answer request. */
+	if ((ah->op == htons(ARP_REQUEST)) && (ah->tpa == netif.addr))
+		arp_send(ARP_REPLY, ah->sha, ah->spa);
+}
+
+/**
+ * @brief Sends an IPv4 packet to its next hop.
+ * 
+ * @param nb      Network buffer that holds the packet.
+ * @param nexthop Internet address of the next hop.
+ */
+PUBLIC void arp_output(struct netbuf *nb, in_addr_t nexthop)
+{
+	struct arpent *e; /* ARP entry. */
+	
+	/* Broadcast. */
+	if ((nexthop == INADDR_BROADCAST) ||
+		(nexthop == (netif.addr | ~netif.netmask)))
+	{
+		eth_output(nb, broadcast, ETH_P_IP);
+		return;
+	}
+	
+	e = arp_lookup(nexthop, 1);
+	e->time = ticks;
+	
+	/* Resolved. */
+	if (e->state == ARP_RESOLVED)
+	{
+		eth_output(nb, e->mac, ETH_P_IP);
+		return;
+	}
+	
+	/* Hold packet and ask for the next hop. */
+	if (e->hold != NULL)
+	{
+		netbuf_put(e->hold);
+		netstats.txdropped++;
+	}
+	e->hold = nb;
+	netstats.arpmisses++;
+	
+	arp_send(ARP_REQUEST, broadcast, nexthop);
+}
+
+/**
+ * @brief Flushes the ARP table.
+ */
+PUBLIC void arp_flush(void)
+{
+	for (struct arpent *e = &arptab[0]; e < &arptab[NR_ARPS]; e++)
+	{
+		if (e->hold != NULL)
+		{
+			netbuf_put(e->hold);
+			e->hold = NULL;
+		}
+		e->state = ARP_FREE;
+	}
+}
@@ -0,0 +1,234 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of Nanvix.
+ * 
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nanvix/const.h>
+#include <nanvix/klib.h>
+#include <nanvix/net.h>
+#include <errno.h>
+#include "net.h"
+
+/**
+ * @file
+ * 
+ * @brief Internet protocol (version 4).
+ * 
+ * @details Packets are neither fragmented nor reassembled, and options are
+ *          never sent. ICMP is handled only so far as to answer echo
+ *          requests.
+ */
+
+/**
+ * @name Fragmentation
+ */
+/**@{*/
+#define IP_DF      0x4000 /**< Don't fragment.  */
+#define IP_MF      0x2000 /**< More fragments.  */
+#define IP_OFFMASK 0x1fff /**< Fragment offset. */
+/**@}*/
+
+/**
+ * @brief Default time to live.
+ */
+#define IP_TTL 64
+
+/**
+ * @brief Next packet identification.
+ */
+PRIVATE uint16_t ipid = 0;
+
+/**
+ * @brief Computes an Internet checksum.
+ * 
+ * @param data Data.
+ * @param len  Length of the data.
+ * @param sum  Partial sum to start with (e.g. of a pseudo header).
+ * 
+ * @returns The checksum of @p data, in network byte order. If @p data carries
+ *          a valid checksum itself, zero is returned.
+ */
+PUBLIC uint16_t ip_checksum(const void *data, size_t len, uint32_t sum)
+{
+	const uint8_t *p; /* Working byte. */
+	
+	for (p = data; len > 1; p += 2, len -= 2)
+		sum += (p[0] << 8) | p[1];
+	if (len > 0)
+		sum += p[0] << 8;
+	
+	while (sum >> 16)
+		sum = (sum & 0xffff) + (sum >> 16);
+	
+	return (htons(~sum & 0xffff));
+}
+
+/**
+ * @brief Sends an IPv4 packet.
+ * 
+ * @details Fills in the IPv4 header of the packet in the network buffer
+ *          pointed to by @p nb, whose payload of @p len bytes has already been
+ *          placed, and routes it. The network buffer is released afterwards.
+ * 
+ * @param nb    Network buffer.
+ * @param proto Transport protocol.
+ * @param src   Source address.
+ * @param dst   Destination address.
+ * @param len   Length of the payload.
+ * 
+ * @returns Upon successful completion, zero is returned. Upon failure, a
+ *          negative error code is returned instead.
+ */
+PUBLIC int ip_output
+(struct netbuf *nb, uint8_t proto, in_addr_t src, in_addr_t dst, size_t len)
+{
+	in_addr_t nexthop; /* Next hop.    */
+	struct iphdr *ih;  /* IPv4 header. */
+	
+	ih = (struct iphdr *)&nb->data[IP_OFF];
+	ih->vihl = 0x45;
+	ih->tos = 0;
+	ih->len = htons(IP_HLEN + len);
+	ih->id = htons(ipid);
+	ipid++;
+	ih->frag = htons(IP_DF);
+	ih->ttl = IP_TTL;
+	ih->proto = proto;
+	ih->csum = 0;
+	ih->src = src;
+	ih->dst = dst;
+	ih->csum = ip_checksum(ih, IP_HLEN, 0);
+	nb->len = DATA_OFF + len;
+	
+	/* Addressed to this host. */
+	if (net_local(dst))
+	{
+		net_loopback(nb);
+		return (0);
+	}
+	
+	/* Interface is down. */
+	if (!(netif.flags & IFF_UP))
+	{
+		netbuf_put(nb);
+		netstats.txdropped++;
+		return (-ENETUNREACH);
+	}
+	
+	/* Route packet. */
+	nexthop = dst;
+	if ((dst != INADDR_BROADCAST) && ((dst ^ netif.addr) & netif.netmask))
+		nexthop = netif.gateway;
+	
+	arp_output(nb, nexthop);
+	
+	return (0);
+}
+
+/**
+ * @brief Processes a received ICMP message.
+ * 
+ * @param ih   IPv4 header.
+ * @param data ICMP message.
+ * @param len  Length of the message.
+ */
+PRIVATE void icmp_input(const struct iphdr *ih, const void *data, size_t len)
+{
+	struct netbuf *nb;         /* Network buffer. */
+	struct icmphdr *reply;     /* Echo reply.     */
+	const struct icmphdr *req; /* Echo request.   */
+	
+	req = data;
+	
+	/* Bad message. */
+	if ((len < ICMP_HLEN) || (ip_checksum(data, len, 0) != 0))
+	{
+		netstats.rxdropped++;
+		return;
+	}
+	
+	/* Only echo requests sent to us are answered. */
+	if ((req->type != ICMP_ECHO) || (!net_local(ih->dst)))
+		return;
+	
+	/* No free network buffer. */
+	if ((nb = netbuf_get(0)) == NULL)
+	{
+		netstats.txdropped++;
+		return;
+	}
+	
+	reply = (struct icmphdr *)&nb->data[DATA_OFF];
+	kmemcpy(reply, req, len);
+	reply->type = ICMP_ECHOREPLY;
+	reply->code = 0;
+	reply->csum = 0;
+	reply->csum = ip_checksum(reply, len, 0);
+	
+	ip_output(nb, IPPROTO_ICMP, ih->dst, ih->src, len);
+}
+
+/**
+ * @brief Processes a received IPv4 packet.
+ * 
+ * @param data IPv4 packet.
+ * @param len  Length of the packet.
+ */
+PUBLIC void ip_input(const void *data, size_t len)
+{
+	size_t hlen;            /* Header length. */
+	size_t total;           /* Total length.  */
+	const struct iphdr *ih; /* IPv4 header.   */
+	
+	ih = data;
+	
+	/* Bad packet. */
+	if ((len < IP_HLEN) || ((ih->vihl >> 4) != 4))
+		goto drop;
+	
+	hlen = (ih->vihl & 0xf) << 2;
+	total = ntohs(ih->len);
+	
+	/* Bad packet. */
+	if ((hlen < IP_HLEN) || (total < hlen) || (total > len))
+		goto drop;
+	if (ip_checksum(ih, hlen, 0) != 0)
+		goto drop;
+	
+	/* Fragments are not supported. */
+	if (ntohs(ih->frag) & (IP_MF | IP_OFFMASK))
+		goto drop;
+	
+	/* Not for us. */
+	if ((!net_local(ih->dst)) && (ih->dst != INADDR_BROADCAST) &&
+		(ih->dst != (netif.addr | ~netif.netmask)))
+		goto drop;
+	
+	switch (ih->proto)
+	{
+		case IPPROTO_UDP:
+			udp_input(ih, (const char *)ih + hlen, total - hlen);
+			return;
+		
+		case IPPROTO_ICMP:
+			icmp_input(ih, (const char *)ih + hlen, total - hlen);
+			return;
+	}
+
+drop:
+	netstats.rxdropped++;
+}
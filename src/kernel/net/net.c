@@ -0,0 +1,423 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of Nanvix.
+ * 
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nanvix/config.h>
+#include <nanvix/const.h>
+#include <nanvix/hal.h>
+#include <nanvix/klib.h>
+#include <nanvix/mm.h>
+#include <nanvix/net.h>
+#include <nanvix/pm.h>
+#include <errno.h>
+#include "net.h"
+
+/**
+ * @file
+ * 
+ * @brief Network interface.
+ * 
+ * @details Frames are built in network buffers and handed to the network
+ *          device, or to the loopback queue if they are addressed to this
+ *          host. Received frames and looped back frames are both processed
+ *          by the network daemon, so protocol input never runs in interrupt
+ *          context nor on behalf of a sending process.
+ */
+
+/**
+ * @brief Network interface.
+ */
+PUBLIC struct netconf netif = {
+	{ 0, 0, 0, 0, 0, 0 },
+	htonl(NET_ADDR),
+	htonl(NET_NETMASK),
+	htonl(NET_GATEWAY),
+	0
+};
+
+/**
+ * @brief Network statistics.
+ */
+PUBLIC struct netstat netstats;
+
+/**
+ * @brief Network device.
+ */
+PRIVATE const struct netdev *netdev = NULL;
+
+/**
+ * @brief Network buffers.
+ */
+PRIVATE struct netbuf netbufs[NR_NETBUFS];
+
+/**
+ * @brief Free network buffers.
+ */
+PRIVATE struct netbuf *freebufs = NULL;
+
+/**
+ * @brief Processes waiting for a network buffer.
+ */
+PRIVATE struct process *bufchain = NULL;
+
+/**
+ * @brief Loopback queue.
+ */
+PRIVATE struct
+{
+	struct netbuf *head; /**< First frame. */
+	struct netbuf *tail; /**< Last frame.  */
+} loopq = { NULL, NULL };
+
+/**
+ * @brief Frames pending on the network device?
+ */
+PRIVATE volatile int pending = 1;
+
+/**
+ * @brief Sleeping chain of the network daemon.
+ */
+PRIVATE struct process *netd_chain = NULL;
+
+/**
+ * @brief Received frame.
+ */
+PRIVATE unsigned char frame[ETH_FRAME_MAX];
+
+/*============================================================================*
+ *                              Network Buffers                               *
+ *============================================================================*/
+
+/**
+ * @brief Gets a network buffer.
+ * 
+ * @param wait Wait for a free buffer?
+ * 
+ * @returns A network buffer, or NULL if there is none and @p wait is zero.
+ */
+PUBLIC struct netbuf *netbuf_get(int wait)
+{
+	struct netbuf *nb;
+	
+	while ((nb = freebufs) == NULL)
+	{
+		if (!wait)
+			return (NULL);
+		
+		sleep(&bufchain, PRIO_IO);
+	}
+	
+	freebufs = nb->next;
+	nb->next = NULL;
+	nb->len = 0;
+	
+	return (nb);
+}
+
+/**
+ * @brief Releases a network buffer.
+ * 
+ * @param nb Network buffer.
+ */
+PUBLIC void netbuf_put(struct netbuf *nb)
+{
+	nb->next = freebufs;
+	freebufs = nb;
+	
+	wakeup(&bufchain);
+}
+
+/*============================================================================*
+ *                                  Ethernet                                  *
+ *============================================================================*/
+
+/**
+ * @brief Sends a frame.
+ * 
+ * @details Fills in the Ethernet header of the frame in the network buffer
+ *          pointed to by @p nb and hands it to the network device. The
+ *          network buffer is released afterwards.
+ * 
+ * @param nb   Network buffer.
+ * @param dst  Destination hardware address.
+ * @param type Ethernet type.
+ */
+PUBLIC void eth_output(struct netbuf *nb, const uint8_t *dst, uint16_t type)
+{
+	struct ethhdr *eh; /* Ethernet header. */
+	
+	eh = (struct ethhdr *)nb->data;
+	kmemcpy(eh->dst, dst, ETH_ALEN);
+	kmemcpy(eh->src, netif.mac, ETH_ALEN);
+	eh->type = htons(type);
+	
+	/* Failed to send frame. */
+	if ((netdev == NULL) || (netdev->send(nb->data, nb->len)))
+		netstats.txdropped++;
+	else
+	{
+		netstats.txpackets++;
+		netstats.txbytes += nb->len;
+	}
+	
+	netbuf_put(nb);
+}
+
+/**
+ * @brief Loops back a frame.
+ * 
+ * @details Queues the IPv4 frame in the network buffer pointed to by @p nb,
+ *          so that the network daemon receives it as if it had come from the
+ *          network device.
+ * 
+ * @param nb Network buffer.
+ */
+PUBLIC void net_loopback(struct netbuf *nb)
+{
+	struct ethhdr *eh; /* Ethernet header. */
+	
+	eh = (struct ethhdr *)nb->data;
+	kmemcpy(eh->dst, netif.mac, ETH_ALEN);
+	kmemcpy(eh->src, netif.mac, ETH_ALEN);
+	eh->type = htons(ETH_P_IP);
+	
+	nb->next = NULL;
+	if (loopq.head == NULL)
+		loopq.head = nb;
+	else
+		loopq.tail->next = nb;
+	loopq.tail = nb;
+	
+	netstats.loopback++;
+	
+	wakeup(&netd_chain);
+}
+
+/**
+ * @brief Processes a received frame.
+ * 
+ * @param data Frame.
+ * @param len  Length of the frame.
+ */
+PRIVATE void net_input(const void *data, size_t len)
+{
+	const struct ethhdr *eh; /* Ethernet header. */
+	
+	/* Runt frame. */
+	if (len < ETH_HLEN)
+	{
+		netstats.rxdropped++;
+		return;
+	}
+	
+	eh = data;
+	
+	switch (ntohs(eh->type))
+	{
+		case ETH_P_ARP:
+			arp_input(eh + 1, len - ETH_HLEN);
+			break;
+		
+		case ETH_P_IP:
+			ip_input(eh + 1, len - ETH_HLEN);
+			break;
+		
+		/* Unsupported protocol. */
+		default:
+			netstats.rxdropped++;
+			break;
+	}
+}
+
+/*============================================================================*
+ *                               Network Device                               *
+ *============================================================================*/
+
+/**
+ * @brief Registers the network device.
+ * 
+ * @param dev Network device.
+ * 
+ * @returns Upon successful completion, zero is returned. Upon failure, a
+ *          negative error code is returned instead.
+ */
+PUBLIC int netdev_register(const struct netdev *dev)
+{
+	/* Network device already registered. */
+	if (netdev != NULL)
+		return (-EBUSY);
+	
+	netdev = dev;
+	kmemcpy(netif.mac, dev->mac, ETH_ALEN);
+	netif.flags |= IFF_UP;
+	
+	return (0);
+}
+
+/**
+ * @brief Notifies that frames have arrived on the network device.
+ * 
+ * @note This function may be called from interrupt context.
+ */
+PUBLIC void net_wakeup(void)
+{
+	pending = 1;
+	wakeup(&netd_chain);
+}
+
+/**
+ * @brief Resumes the network device after hibernation.
+ * 
+ * @details The state of the network device does not match the one that has
+ *          been restored from the hibernation image, so the device is set up
+ *          all over again.
+ */
+PUBLIC void net_resume(void)
+{
+	if ((netdev != NULL) && (netdev->resume != NULL))
+		netdev->resume();
+}
+
+/**
+ * @brief Network daemon.
+ * 
+ * @details Drains the receive ring of the network device and the loopback
+ *          queue, and processes incoming frames. This function does not
+ *          return: on system shutdown the daemon exits.
+ */
+PUBLIC void netd(void)
+{
+	ssize_t n;         /* Frame length. */
+	struct netbuf *nb; /* Looped frame. */
+	
+	while (1)
+	{
+		pending = 0;
+		
+		/* Received frames. */
+		if (netdev != NULL)
+		{
+			while ((n = netdev->recv(frame, ETH_FRAME_MAX)) > 0)
+			{
+				netstats.rxpackets++;
+				netstats.rxbytes += n;
+				net_input(frame, n);
+			}
+		}
+		
+		/* Looped back frames. */
+		while ((nb = loopq.head) != NULL)
+		{
+			loopq.head = nb->next;
+			net_input(nb->data, nb->len);
+			netbuf_put(nb);
+		}
+		
+		if (shutting_down)
+			die(0);
+		
+		curr_proc->received = 0;
+		
+		disable_interrupts();
+		if ((!pending) && (loopq.head == NULL))
+			sleep(&netd_chain, PRIO_IO);
+		enable_interrupts();
+	}
+}
+
+/*============================================================================*
+ *                                 Interface                                  *
+ *============================================================================*/
+
+/**
+ * @brief Asserts if an address belongs to this host.
+ * 
+ * @param addr Internet address (in network byte order).
+ * 
+ * @returns Non-zero if @p addr is the address of the network interface or a
+ *          loopback address, and zero otherwise.
+ */
+PUBLIC int net_local(in_addr_t addr)
+{
+	return ((addr == netif.addr) || ((ntohl(addr) >> 24) == 127));
+}
+
+/**
+ * @brief Performs control operations on the network interface.
+ * 
+ * @param cmd Command.
+ * @param arg Argument (in user space).
+ * 
+ * @returns Upon successful completion, zero is returned. Upon failure, a
+ *          negative error code is returned instead.
+ */
+PUBLIC int net_ioctl(unsigned cmd, unsigned arg)
+{
+	struct netconf *conf; /* Configuration. */
+	
+	conf = (struct netconf *)arg;
+	
+	switch (cmd)
+	{
+		/* Get configuration. */
+		case SIOCGNETCONF:
+			if (!chkmem(conf, sizeof(struct netconf), MAY_WRITE))
+				return (-EINVAL);
+			kmemcpy(conf, &netif, sizeof(struct netconf));
+			return (0);
+		
+		/* Set configuration. */
+		case SIOCSNETCONF:
+			if (!IS_SUPERUSER(curr_proc))
+				return (-EPERM);
+			if (!chkmem(conf, sizeof(struct netconf), MAY_READ))
+				return (-EINVAL);
+			netif.addr = conf->addr;
+			netif.netmask = conf->netmask;
+			netif.gateway = conf->gateway;
+			arp_flush();
+			return (0);
+	}
+	
+	return (-EINVAL);
+}
+
+/**
+ * @brief Gets network statistics.
+ * 
+ * @param st   Where statistics should be stored, or NULL.
+ * @param conf Where the configuration should be stored, or NULL.
+ */
+PUBLIC void net_stat(struct netstat *st, struct netconf *conf)
+{
+	if (st != NULL)
+		kmemcpy(st, &netstats, sizeof(struct netstat));
+	if (conf != NULL)
+		kmemcpy(conf, &netif, sizeof(struct netconf));
+}
+
+/**
+ * @brief Initializes the network interface.
+ */
+PUBLIC void net_init(void)
+{
+	for (int i = 0; i < NR_NETBUFS; i++)
+		netbuf_put(&netbufs[i]);
+	
+	kprintf("net: %s", (netdev != NULL) ? "interface up" : "loopback only");
+}
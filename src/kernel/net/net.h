@@ -0,0 +1,197 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of Nanvix.
+ * 
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ * 
+ * @brief Private network interface.
+ */
+
+#ifndef _NET_H_
+#define _NET_H_
+
+	#include <nanvix/const.h>
+	#include <nanvix/net.h>
+	#include <stdint.h>
+
+/*============================================================================*
+ *                              Protocol Headers                              *
+ *============================================================================*/
+
+	/**
+	 * @name Header lengths
+	 */
+	/**@{*/
+	#define ETH_HLEN  14 /**< Ethernet header. */
+	#define IP_HLEN   20 /**< IPv4 header.     */
+	#define UDP_HLEN   8 /**< UDP header.      */
+	#define ICMP_HLEN  8 /**< ICMP header.     */
+	/**@}*/
+
+	/**
+	 * @brief Maximum transfer unit.
+	 */
+	#define ETH_MTU 1500
+
+	/**
+	 * @brief Maximum frame length (without frame check sequence).
+	 */
+	#define ETH_FRAME_MAX (ETH_HLEN + ETH_MTU)
+
+	/* Error checking. */
+	#if (UDP_PAYLOAD_MAX != ETH_MTU - IP_HLEN - UDP_HLEN)
+		#error "bad UDP_PAYLOAD_MAX"
+	#endif
+
+	/**
+	 * @name Ethernet types
+	 */
+	/**@{*/
+	#define ETH_P_IP  0x0800 /**< IPv4. */
+	#define ETH_P_ARP 0x0806 /**< ARP.  */
+	/**@}*/
+
+	/**
+	 * @brief Ethernet header.
+	 */
+	struct ethhdr
+	{
+		uint8_t dst[ETH_ALEN]; /**< Destination address. */
+		uint8_t src[ETH_ALEN]; /**< Source address.      */
+		uint16_t type;         /**< Ethernet type.       */
+	} __attribute__((packed));
+
+	/**
+	 * @brief ARP packet (Ethernet/IPv4).
+	 */
+	struct arphdr
+	{
+		uint16_t htype;        /**< Hardware type.           */
+		uint16_t ptype;        /**< Protocol type.           */
+		uint8_t hlen;          /**< Hardware address length. */
+		uint8_t plen;          /**< Protocol address length. */
+		uint16_t op;           /**< Operation.               */
+		uint8_t sha[ETH_ALEN]; /**< Sender hardware address. */
+		uint32_t spa;          /**< Sender protocol address. */
+		uint8_t tha[ETH_ALEN]; /**< Target hardware address. */
+		uint32_t tpa;          /**< Target protocol address. */
+	} __attribute__((packed));
+
+	/**
+	 * @name ARP operations
+	 */
+	/**@{*/
+	#define ARP_REQUEST 1 /**< Request. */
+	#define ARP_REPLY   2 /**< Reply.   */
+	/**@}*/
+
+	/**
+	 * @brief IPv4 header (without options).
+	 */
+	struct iphdr
+	{
+		uint8_t vihl;  /**< Version and header length. */
+		uint8_t tos;   /**< Type of service.           */
+		uint16_t len;  /**< Total length.              */
+		uint16_t id;   /**< Identification.            */
+		uint16_t frag; /**< Flags and fragment offset. */
+		uint8_t ttl;   /**< Time to live.              */
+		uint8_t proto; /**< Protocol.                  */
+		uint16_t csum; /**< Header checksum.           */
+		uint32_t src;  /**< Source address.            */
+		uint32_t dst;  /**< Destination address.       */
+	} __attribute__((packed));
+
+	/**
+	 * @brief UDP header.
+	 */
+	struct udphdr
+	{
+		uint16_t sport; /**< Source port.      */
+		uint16_t dport; /**< Destination port. */
+		uint16_t len;   /**< Length.           */
+		uint16_t csum;  /**< Checksum.         */
+	} __attribute__((packed));
+
+	/**
+	 * @brief ICMP echo header.
+	 */
+	struct icmphdr
+	{
+		uint8_t type;  /**< Message type.    */
+		uint8_t code;  /**< Message code.    */
+		uint16_t csum; /**< Checksum.        */
+		uint16_t id;   /**< Identifier.      */
+		uint16_t seq;  /**< Sequence number. */
+	} __attribute__((packed));
+
+	/**
+	 * @name ICMP message types
+	 */
+	/**@{*/
+	#define ICMP_ECHOREPLY 0 /**< Echo reply.   */
+	#define ICMP_ECHO      8 /**< Echo request. */
+	/**@}*/
+
+	/**
+	 * @name Offsets in a frame
+	 */
+	/**@{*/
+	#define IP_OFF   (ETH_HLEN)           /**< IPv4 header.      */
+	#define DATA_OFF (ETH_HLEN + IP_HLEN) /**< Transport header. */
+	/**@}*/
+
+/*============================================================================*
+ *                                  Interface                                 *
+ *============================================================================*/
+
+	/**
+	 * @brief Network buffer.
+	 */
+	struct netbuf
+	{
+		struct netbuf *next;               /**< Next buffer in a queue. */
+		size_t len;                        /**< Frame length.           */
+		unsigned char data[ETH_FRAME_MAX]; /**< Frame.                  */
+	};
+
+	/**
+	 * @brief Network interface.
+	 */
+	EXTERN struct netconf netif;
+
+	/**
+	 * @brief Network statistics.
+	 */
+	EXTERN struct netstat netstats;
+
+	/* Forward definitions. */
+	EXTERN struct netbuf *netbuf_get(int);
+	EXTERN void netbuf_put(struct netbuf *);
+	EXTERN void eth_output(struct netbuf *, const uint8_t *, uint16_t);
+	EXTERN void net_loopback(struct netbuf *);
+	EXTERN void arp_input(const void *, size_t);
+	EXTERN void arp_output(struct netbuf *, in_addr_t);
+	EXTERN void arp_flush(void);
+	EXTERN uint16_t ip_checksum(const void *, size_t, uint32_t);
+	EXTERN void ip_input(const void *, size_t);
+	EXTERN int ip_output(struct netbuf *, uint8_t, in_addr_t, in_addr_t, size_t);
+	EXTERN void udp_input(const struct iphdr *, const void *, size_t);
+
+#endif /* _NET_H_ */
@@ -0,0 +1,172 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of Nanvix.
+ * 
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nanvix/const.h>
+#include <nanvix/fs.h>
+#include <nanvix/klib.h>
+#include <nanvix/net.h>
+#include <errno.h>
+#include "net.h"
+
+/**
+ * @file
+ * 
+ * @brief User datagram protocol.
+ * 
+ * @details Datagrams are copied from the user buffers straight into a network
+ *          buffer on output, and from the received frame straight into the
+ *          receive buffer of the socket on input.
+ */
+
+/**
+ * @brief Computes the checksum of a UDP datagram.
+ * 
+ * @param src Source address.
+ * @param dst Destination address.
+ * @param uh  UDP datagram.
+ * @param len Length of the datagram.
+ * 
+ * @returns The checksum of the datagram and its pseudo header, in network
+ *          byte order.
+ */
+PRIVATE uint16_t udp_checksum
+(in_addr_t src, in_addr_t dst, const struct udphdr *uh, size_t len)
+{
+	uint32_t sum; /* Pseudo header sum. */
+	
+	src = ntohl(src);
+	dst = ntohl(dst);
+	sum = (src >> 16) + (src & 0xffff) + (dst >> 16) + (dst & 0xffff);
+	sum += IPPROTO_UDP + len;
+	
+	return (ip_checksum(uh, len, sum));
+}
+
+/**
+ * @brief Sends a UDP datagram.
+ * 
+ * @param src    Source socket address.
+ * @param dst    Destination socket address.
+ * @param iov    Data buffers.
+ * @param iovcnt Number of data buffers.
+ * @param len    Total length of the data buffers.
+ * 
+ * @returns Upon successful completion, the number of bytes sent is returned.
+ *          Upon failure, a negative error code is returned instead.
+ */
+PUBLIC ssize_t udp_output
+(const struct sockaddr_in *src, const struct sockaddr_in *dst,
+ const struct iovec *iov, int iovcnt, size_t len)
+{
+	int err;           /* Error code.     */
+	char *p;           /* Write pointer.  */
+	in_addr_t saddr;   /* Source address. */
+	struct netbuf *nb; /* Network buffer. */
+	struct udphdr *uh; /* UDP header.     */
+	
+	/* Datagram too large. */
+	if (len > UDP_PAYLOAD_MAX)
+		return (-EMSGSIZE);
+	
+	nb = netbuf_get(1);
+	
+	uh = (struct udphdr *)&nb->data[DATA_OFF];
+	p = (char *)(uh + 1);
+	for (int i = 0; i < iovcnt; i++)
+	{
+		kmemcpy(p, iov[i].iov_base, iov[i].iov_len);
+		p += iov[i].iov_len;
+	}
+	
+	/* Pick source address. */
+	saddr = src->sin_addr.s_addr;
+	if (saddr == INADDR_ANY)
+	{
+		saddr = netif.addr;
+		if ((ntohl(dst->sin_addr.s_addr) >> 24) == 127)
+			saddr = dst->sin_addr.s_addr;
+	}
+	
+	uh->sport = src->sin_port;
+	uh->dport = dst->sin_port;
+	uh->len = htons(UDP_HLEN + len);
+	uh->csum = 0;
+	uh->csum = udp_checksum(saddr, dst->sin_addr.s_addr, uh, UDP_HLEN + len);
+	if (uh->csum == 0)
+		uh->csum = 0xffff;
+	
+	err = ip_output(nb, IPPROTO_UDP, saddr, dst->sin_addr.s_addr, UDP_HLEN+len);
+	if (err)
+		return (err);
+	
+	return (len);
+}
+
+/**
+ * @brief Processes a received UDP datagram.
+ * 
+ * @param ih   IPv4 header.
+ * @param data UDP datagram.
+ * @param len  Length of the datagram.
+ */
+PUBLIC void udp_input(const struct iphdr *ih, const void *data, size_t len)
+{
+	const struct udphdr *uh; /* UDP header.          */
+	struct sockaddr_in src;  /* Source address.      */
+	struct sockaddr_in dst;  /* Destination address. */
+	
+	uh = data;
+	
+	/* Bad datagram. */
+	if ((len < UDP_HLEN) || (ntohs(uh->len) < UDP_HLEN) ||
+		(ntohs(uh->len) > len))
+	{
+		netstats.rxdropped++;
+		return;
+	}
+	
+	len = ntohs(uh->len);
+	
+	/* Bad checksum. */
+	if ((uh->csum != 0) && (udp_checksum(ih->src, ih->dst, uh, len) != 0))
+	{
+		netstats.rxdropped++;
+		return;
+	}
+	
+	src.sin_family = AF_INET;
+	src.sin_port = uh->sport;
+	src.sin_addr.s_addr = ih->src;
+	dst.sin_family = AF_INET;
+	dst.sin_port = uh->dport;
+	dst.sin_addr.s_addr = ih->dst;
+	
+	switch (socket_udp_input(&dst, &src, uh + 1, len - UDP_HLEN))
+	{
+		/* Nobody bound. */
+		case -ECONNREFUSED:
+			netstats.noport++;
+			break;
+		
+		/* Receive buffer is full. */
+		case -ENOBUFS:
+			netstats.nobufs++;
+			break;
+	}
+}
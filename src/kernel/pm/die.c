@@ -20,6 +20,7 @@
 #include <nanvix/const.h>
 #include <nanvix/dev.h>
 #include <nanvix/fs.h>
+#include <nanvix/ipc.h>
 #include <nanvix/klib.h>
 #include <nanvix/mm.h>
 #include <nanvix/pm.h>
@@ -56,6 +57,16 @@ PUBLIC void die(int status)
 	for (unsigned i = 0; i < OPEN_MAX; i++)
 		do_close(i);
 	
+	/* Close message queue descriptors. */
+	for (unsigned i = 0; i < MQ_OPEN_MAX; i++)
+	{
+		if (curr_proc->mqdes[i] != NULL)
+		{
+			mqueue_put(curr_proc->mqdes[i]);
+			curr_proc->mqdes[i] = NULL;
+		}
+	}
+	
 	/* Hangup terminal. */
 	if (IS_LEADER(curr_proc) && (curr_proc->tty != NULL_DEV))
 		cdev_close(curr_proc->tty);
@@ -74,6 +74,9 @@ PUBLIC void pm_init(void)
 	int i;             /* Loop index.      */
 	struct process *p; /* Working process. */
 	
+	/* System call counter follows the FPU saved status. */
+	CHKSIZE(sizeof(struct fpu), PROC_NSYSCALLS - PROC_FSS);
+	
 	/* Initialize the process table. */
 	for (p = FIRST_PROC; p <= LAST_PROC; p++)
 		p->flags = 0, p->state = PROC_DEAD;
@@ -88,10 +91,12 @@ PUBLIC void pm_init(void)
 	for (i = 0; i < NR_SIGNALS; i++)
 		IDLE->handlers[i] = SIG_DFL;
 	IDLE->irqlvl = INT_LVL_5;
+	IDLE->nsyscalls = 0;
 	IDLE->pgdir = idle_pgdir;
 	for (i = 0; i < NR_PREGIONS; i++)
 		IDLE->pregs[i].reg = NULL;
 	IDLE->size = 0;
+	IDLE->faults = 0;
 	for (i = 0; i < OPEN_MAX; i++)
 		IDLE->ofiles[i] = NULL;
 	IDLE->close = 0;
@@ -21,9 +21,57 @@
 #include <nanvix/clock.h>
 #include <nanvix/const.h>
 #include <nanvix/hal.h>
+#include <nanvix/klib.h>
 #include <nanvix/pm.h>
 #include <signal.h>
 
+/**
+ * @brief Only process allowed to run, if any.
+ * 
+ * @details While the system is frozen, say, for hibernation, other processes
+ *          may be woken up, but they are not chosen to run.
+ */
+PUBLIC struct process *freezer = NULL;
+
+/**
+ * @brief Number of context switches.
+ */
+PRIVATE unsigned nswitches = 0;
+
+/**
+ * @brief System-wide scheduling latency histograms.
+ */
+PRIVATE struct sched_hist hist;
+
+/**
+ * @brief Run queue length histogram.
+ * 
+ * @details Bucket i counts how many times i processes were ready when
+ *          choosing a process to run. The last bucket also counts anything
+ *          longer.
+ */
+PRIVATE unsigned runq[NR_SCHEDHIST];
+
+/**
+ * @brief Gets the histogram bucket of a time interval.
+ * 
+ * @param cycles Time interval (in time stamp counter cycles).
+ * 
+ * @returns The histogram bucket of the time interval.
+ */
+PRIVATE unsigned sched_bucket(uint64_t cycles)
+{
+	unsigned us;     /* Microseconds.     */
+	unsigned bucket; /* Histogram bucket. */
+	
+	us = clock_nsec((cycles >> 32) ? 0xffffffff : (unsigned)cycles)/1000;
+	
+	for (bucket = 0; (us > 0) && (bucket < NR_SCHEDHIST - 1); bucket++)
+		us >>= 1;
+	
+	return (bucket);
+}
+
 /**
  * @brief Schedules a process to execution.
  * 
@@ -33,6 +81,7 @@ PUBLIC void sched(struct process *proc)
 {
 	proc->state = PROC_READY;
 	proc->counter = 0;
+	proc->readytsc = read_tsc();
 }
 
 /**
@@ -64,8 +113,11 @@ PUBLIC void resume(struct process *proc)
  */
 PUBLIC void yield(void)
 {
-	struct process *p;    /* Working process.     */
-	struct process *next; /* Next process to run. */
+	uint64_t now;         /* Current time.         */
+	unsigned nready;      /* Ready processes.      */
+	unsigned bucket;      /* Histogram bucket.     */
+	struct process *p;    /* Working process.      */
+	struct process *next; /* Next process to run.  */
 
 	/* Re-schedule process for execution. */
 	if (curr_proc->state == PROC_RUNNING)
@@ -88,12 +140,19 @@ PUBLIC void yield(void)
 
 	/* Choose a process to run next. */
 	next = IDLE;
+	nready = 0;
 	for (p = FIRST_PROC; p <= LAST_PROC; p++)
 	{
 		/* Skip non-ready process. */
 		if (p->state != PROC_READY)
 			continue;
 		
+		nready++;
+		
+		/* Skip frozen process. */
+		if ((freezer != NULL) && (p != freezer))
+			continue;
+		
 		/*
 		 * Process with higher
 		 * waiting time found.
@@ -112,9 +171,88 @@ PUBLIC void yield(void)
 			p->counter++;
 	}
 	
+	runq[(nready < NR_SCHEDHIST) ? nready : NR_SCHEDHIST - 1]++;
+	
+	now = read_tsc();
+	
+	/* Account time slice of the last process. */
+	if (curr_proc != IDLE)
+	{
+		bucket = sched_bucket(now - curr_proc->runtsc);
+		curr_proc->hist.slice[bucket]++;
+		hist.slice[bucket]++;
+	}
+	
+	/* Account time that the next process has been ready. */
+	if (next != IDLE)
+	{
+		bucket = sched_bucket(now - next->readytsc);
+		next->hist.delay[bucket]++;
+		hist.delay[bucket]++;
+	}
+	next->runtsc = now;
+	
 	/* Switch to next process. */
+	if (next != curr_proc)
+		nswitches++;
 	next->priority = PRIO_USER;
 	next->state = PROC_RUNNING;
 	next->counter = PROC_QUANTUM;
+#if (IRQTRACE)
+	irqtrace_reset();
+#endif
 	switch_to(next);
 }
+
+/**
+ * @brief Gets scheduler statistics.
+ * 
+ * @param st Store location for statistics.
+ */
+PUBLIC void sched_stat(struct sched_stat *st)
+{
+	st->nprocs = st->nready = st->nwaiting = st->nstopped = 0;
+	st->nswitches = nswitches;
+	
+	for (struct process *p = IDLE; p <= LAST_PROC; p++)
+	{
+		/* Skip invalid processes. */
+		if (!IS_VALID(p))
+			continue;
+		
+		st->nprocs++;
+		
+		switch (p->state)
+		{
+			case PROC_RUNNING:
+			case PROC_READY:
+				st->nready++;
+				break;
+			
+			case PROC_WAITING:
+			case PROC_SLEEPING:
+				st->nwaiting++;
+				break;
+			
+			case PROC_STOPPED:
+				st->nstopped++;
+				break;
+			
+			default:
+				break;
+		}
+	}
+}
+
+/**
+ * @brief Gets scheduling latency histograms.
+ * 
+ * @param h Store location for system-wide latency histograms.
+ * @param q Store location for the run queue length histogram, which should
+ *          have #NR_SCHEDHIST buckets.
+ */
+PUBLIC void sched_hist(struct sched_hist *h, unsigned *q)
+{
+	kmemcpy(h, &hist, sizeof(struct sched_hist));
+	kmemcpy(q, runq, sizeof(runq));
+}
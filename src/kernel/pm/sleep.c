@@ -17,6 +17,7 @@
  * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <nanvix/clock.h>
 #include <nanvix/const.h>
 #include <nanvix/hal.h>
 #include <nanvix/klib.h>
@@ -27,6 +28,127 @@
  */
 PRIVATE struct process **idle_chain = NULL;
 
+/**
+ * @brief Sleeping chain statistics.
+ */
+PRIVATE struct chain_stat chainstats[NR_CHAINSTATS];
+
+/**
+ * @brief Number of entries evicted from the statistics table.
+ */
+PRIVATE unsigned evicted = 0;
+
+/**
+ * @brief Hash function for sleeping chain statistics.
+ */
+#define CHAIN_HASH(chain) ((((addr_t)(chain)) >> 2)%NR_CHAINSTATS)
+
+/**
+ * @brief Looks up the statistics of a sleeping chain.
+ * 
+ * @details Searches the statistics table for the sleeping chain pointed to by
+ *          @p chain. If the chain is not found and @p create is non-zero, a new
+ *          entry is allocated. If the table is full, the entry that has not
+ *          been slept on for the longest time is evicted, so that chains in
+ *          use eventually show up.
+ * 
+ * @param chain  Sleeping chain.
+ * @param create Allocate an entry if none is found?
+ * 
+ * @returns A pointer to the statistics of the sleeping chain, or a NULL
+ *          pointer if the chain is not tracked.
+ * 
+ * @note Entries are only allocated in process context, and the chain is filled
+ *       in last, so interrupt handlers never see a partial entry. A wakeup
+ *       that races with an eviction is not accounted.
+ */
+PRIVATE struct chain_stat *chain_lookup(struct process **chain, int create)
+{
+	unsigned i;             /* Table index.                */
+	struct chain_stat *st;  /* Working entry.              */
+	struct chain_stat *lru; /* Least recently slept entry. */
+	
+	i = CHAIN_HASH(chain);
+	lru = &chainstats[i];
+	for (unsigned n = 0; n < NR_CHAINSTATS; n++)
+	{
+		st = &chainstats[(i + n)%NR_CHAINSTATS];
+		
+		/* Found. */
+		if (st->chain == chain)
+			return (st);
+		
+		/* Not tracked. */
+		if (st->chain == NULL)
+		{
+			if (!create)
+				return (NULL);
+			
+			kmemset(st, 0, sizeof(struct chain_stat));
+			st->chain = chain;
+			return (st);
+		}
+		
+		if (st->last < lru->last)
+			lru = st;
+	}
+	
+	/* Not tracked. */
+	if (!create)
+		return (NULL);
+	
+	/*
+	 * Table is full, so evict the least recently
+	 * slept entry. Probe sequences are not broken,
+	 * since the entry is replaced and not freed.
+	 */
+	evicted++;
+	kmemset(lru, 0, sizeof(struct chain_stat));
+	lru->chain = chain;
+	
+	return (lru);
+}
+
+/**
+ * @brief Accounts a sleep in a sleeping chain.
+ * 
+ * @param st     Sleeping chain statistics.
+ * @param addr   Return address of the caller of sleep().
+ * @param nticks Number of ticks that the process has been blocked.
+ */
+PRIVATE void chain_account(struct chain_stat *st, addr_t addr, unsigned nticks)
+{
+	unsigned min; /* Least used call site. */
+	
+	st->nsleeps++;
+	st->last = ticks;
+	st->total += nticks;
+	if (nticks > st->max)
+		st->max = nticks;
+	
+	/* Account call site. */
+	min = 0;
+	for (unsigned i = 0; i < NR_CALLSITES; i++)
+	{
+		/* Found. */
+		if (st->sites[i].addr == addr)
+		{
+			st->sites[i].count++;
+			return;
+		}
+		
+		if (st->sites[i].count < st->sites[min].count)
+			min = i;
+	}
+	
+	/*
+	 * Replace the least used call site, so that
+	 * frequent call sites eventually show up.
+	 */
+	st->sites[min].addr = addr;
+	st->sites[min].count = 1;
+}
+
 /**
  * @brief Puts the current process to sleep in a chain of sleeping processes.
  * 
@@ -41,7 +163,11 @@ PRIVATE struct process **idle_chain = NULL;
  * @param priority Priority that the process shall assume after waking up.
  */
 PUBLIC void sleep(struct process **chain, int priority)
-{	
+{
+	addr_t addr;           /* Call site.                   */
+	unsigned start;        /* Time when process has slept. */
+	struct chain_stat *st; /* Chain statistics.            */
+	
 	/*
 	 * Idle process trying to sleep. Although that may
 	 * sound weird, it happens at system startup. So,
@@ -74,7 +200,14 @@ PUBLIC void sleep(struct process **chain, int priority)
 	curr_proc->priority = priority;
 	curr_proc->chain = chain;
 	
+	addr = (addr_t)__builtin_return_address(0);
+	start = ticks;
+	
 	yield();
+	
+	/* Account sleep. */
+	st = chain_lookup(chain, 1);
+	chain_account(st, addr, ticks - start);
 }
 
 /**
@@ -83,7 +216,9 @@ PUBLIC void sleep(struct process **chain, int priority)
  * @param chain Chain of sleeping processes to be awaken.
  */
 PUBLIC void wakeup(struct process **chain)
-{	
+{
+	struct chain_stat *st; /* Chain statistics. */
+	
 	/*
 	 * Wakeup idle process. Note that here we don't
 	 * schedule the idle process for execution, once
@@ -96,6 +231,14 @@ PUBLIC void wakeup(struct process **chain)
 		return;
 	}
 	
+	/* Account wakeup. */
+	if ((st = chain_lookup(chain, 0)) != NULL)
+	{
+		st->nwakeups++;
+		if (*chain == NULL)
+			st->nempty++;
+	}
+	
 	/* Wakeup sleeping processes. */
 	while (*chain != NULL)
 	{
@@ -103,3 +246,35 @@ PUBLIC void wakeup(struct process **chain)
 		*chain = (*chain)->next;
 	}
 }
+
+/**
+ * @brief Gets sleeping chain statistics.
+ * 
+ * @param i  Index in the statistics table.
+ * @param st Store location for the statistics.
+ * 
+ * @returns Zero if the @p i th entry of the statistics table is in use, and
+ *          non-zero otherwise.
+ */
+PUBLIC int chain_stat(unsigned i, struct chain_stat *st)
+{
+	/* Entry not in use. */
+	if ((i >= NR_CHAINSTATS) || (chainstats[i].chain == NULL))
+		return (-1);
+	
+	kmemcpy(st, &chainstats[i], sizeof(struct chain_stat));
+	
+	return (0);
+}
+
+/**
+ * @brief Gets the number of entries evicted from the statistics table.
+ * 
+ * @returns The number of entries evicted from the statistics table. If it is
+ *          non-zero, the table has been saturated, and statistics of evicted
+ *          chains have been lost.
+ */
+PUBLIC unsigned chain_evicted(void)
+{
+	return (evicted);
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of Nanvix.
+ * 
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nanvix/const.h>
+#include <nanvix/fs.h>
+#include <nanvix/mm.h>
+#include <nanvix/pm.h>
+#include <sys/socket.h>
+#include <errno.h>
+#include <fcntl.h>
+
+/*
+ * Accepts a connection on a socket.
+ */
+PUBLIC int sys_accept(int fd, struct sockaddr *addr, socklen_t *len)
+{
+	int err;                      /* Error code.         */
+	int newfd;                    /* New descriptor.     */
+	struct socket *sock;          /* Listening socket.   */
+	struct socket *new;           /* Connected socket.   */
+	struct sockname sn;           /* Name of peer.       */
+	
+	if ((err = socket_get(fd, &sock)))
+		return (err);
+	
+	/* Invalid address length. */
+	if ((addr != NULL) && (!chkmem(len, sizeof(socklen_t), MAY_WRITE)))
+		return (-EINVAL);
+	
+	err = socket_accept(sock, &new, &sn,
+		curr_proc->ofiles[fd]->oflag & O_NONBLOCK);
+	if (err)
+		return (err);
+	
+	/* Failed to open socket. */
+	if ((newfd = socket_open(new)) < 0)
+	{
+		socket_close(new);
+		return (newfd);
+	}
+	
+	socket_putaddr(&sn, addr, len);
+	
+	return (newfd);
+}
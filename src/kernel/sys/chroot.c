@@ -19,32 +19,56 @@
 
 #include <nanvix/const.h>
 #include <nanvix/fs.h>
+#include <nanvix/klib.h>
 #include <nanvix/pm.h>
 #include <errno.h>
+#include <limits.h>
 
 /*
- * Changes working directory.
+ * Changes root directory.
  */
 PUBLIC int sys_chroot(const char *path)
 {
-	struct inode *inode;
+	int err;              /* Error code.          */
+	char *name;           /* Path name.           */
+	struct inode *inode;  /* Directory.           */
+	char canon[PATH_MAX]; /* Canonical path name. */
 	
-	inode = inode_name(path);
+	/* Fetch path from user address space. */
+	if ((name = getname(path)) == NULL)
+		return (curr_proc->errno);
+	
+	inode = inode_name(name);
 	
 	/* Failed to get inode. */
 	if (inode == NULL)
+	{
+		putname(name);
 		return (curr_proc->errno);
+	}
 	
 	/* Not a directory. */
 	if (!S_ISDIR(inode->mode))
 	{
+		putname(name);
 		inode_put(inode);
 		return (-ENOTDIR);
 	}
 	
+	err = path_canon(canon, name, curr_proc);
+	putname(name);
+	
+	/* Path name too long. */
+	if (err < 0)
+	{
+		inode_put(inode);
+		return (err);
+	}
+	
 	inode_put(curr_proc->root);
 	
 	curr_proc->root = inode;
+	kstrcpy(curr_proc->rootpath, canon);
 	inode_unlock(inode);
 	
 	return (0);
@@ -0,0 +1,43 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of Nanvix.
+ * 
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nanvix/const.h>
+#include <nanvix/fs.h>
+#include <nanvix/pm.h>
+#include <sys/socket.h>
+#include <fcntl.h>
+
+/*
+ * Connects a socket.
+ */
+PUBLIC int sys_connect(int fd, const struct sockaddr *addr, socklen_t len)
+{
+	int err;             /* Error code.  */
+	struct socket *sock; /* Socket.      */
+	struct sockname sn;  /* Socket name. */
+	
+	if ((err = socket_get(fd, &sock)))
+		return (err);
+	
+	if ((err = socket_getaddr(addr, len, &sn)))
+		return (err);
+	
+	return (socket_connect(sock, &sn,
+		curr_proc->ofiles[fd]->oflag & O_NONBLOCK));
+}
@@ -21,6 +21,7 @@
 #include <nanvix/const.h>
 #include <nanvix/fs.h>
 #include <nanvix/hal.h>
+#include <nanvix/ipc.h>
 #include <nanvix/klib.h>
 #include <nanvix/mm.h>
 #include <nanvix/pm.h>
@@ -382,6 +383,16 @@ PUBLIC int sys_execve(const char *filename, const char **argv, const char **envp
 		if (curr_proc->close & (1 << i))
 			do_close(i);
 	}
+	
+	/* Close message queue descriptors. */
+	for (i = 0; i < MQ_OPEN_MAX; i++)
+	{
+		if (curr_proc->mqdes[i] != NULL)
+		{
+			mqueue_put(curr_proc->mqdes[i]);
+			curr_proc->mqdes[i] = NULL;
+		}
+	}
 
 	/* Detach process memory regions. */
 	for (i = 0; i < NR_PREGIONS; i++)
@@ -20,6 +20,7 @@
 #include <nanvix/config.h>
 #include <nanvix/const.h>
 #include <nanvix/hal.h>
+#include <nanvix/ipc.h>
 #include <nanvix/klib.h>
 #include <nanvix/mm.h>
 #include <nanvix/pm.h>
@@ -57,7 +58,7 @@ PUBLIC pid_t sys_fork(void)
 			goto found;
 	}
 
-	kprintf("process table overflow");
+	kprintf_ratelimited(KERN_WARN "process table overflow");
 	
 	return (-EAGAIN);
 
@@ -117,11 +118,15 @@ found:
 	for (i = 0; i < NR_SIGNALS; i++)
 		proc->handlers[i] = curr_proc->handlers[i];
 	proc->irqlvl = curr_proc->irqlvl;
+	proc->nsyscalls = 0;
 	proc->size = curr_proc->size;
+	proc->faults = 0;
 	proc->pwd = curr_proc->pwd;
 	proc->pwd->count++;
 	proc->root = curr_proc->root;
 	proc->root->count++;
+	kstrcpy(proc->pwdpath, curr_proc->pwdpath);
+	kstrcpy(proc->rootpath, curr_proc->rootpath);
 	for (i = 0; i < OPEN_MAX; i++)
 	{
 		proc->ofiles[i] = curr_proc->ofiles[i];
@@ -131,6 +136,15 @@ found:
 			proc->ofiles[i]->count++;
 	}
 	proc->close = curr_proc->close;
+	for (i = 0; i < MQ_OPEN_MAX; i++)
+	{
+		proc->mqdes[i] = curr_proc->mqdes[i];
+		proc->mqflags[i] = curr_proc->mqflags[i];
+		
+		/* Increment message queue reference count. */
+		if (proc->mqdes[i] != NULL)
+			mqueue_dup(proc->mqdes[i]);
+	}
 	proc->umask = curr_proc->umask;
 	proc->tty = curr_proc->tty;
 	proc->status = 0;
@@ -154,6 +168,7 @@ found:
 	proc->alarm = 0;
 	proc->next = NULL;
 	proc->chain = NULL;
+	kmemset(&proc->hist, 0, sizeof(struct sched_hist));
 	sched(proc);
 
 	curr_proc->nchildren++;
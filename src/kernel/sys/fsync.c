@@ -0,0 +1,48 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of Nanvix.
+ * 
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nanvix/const.h>
+#include <nanvix/fs.h>
+#include <nanvix/pm.h>
+#include <errno.h>
+
+/*
+ * Synchronizes changes to a file.
+ */
+PUBLIC int sys_fsync(int fd)
+{
+	struct file *f;  /* File.  */
+	struct inode *i; /* Inode. */
+	
+	/* Invalid file descriptor. */
+	if ((fd < 0) || (fd >= OPEN_MAX) || ((f = curr_proc->ofiles[fd]) == NULL))
+		return (-EBADF);
+	
+	i = f->inode;
+	
+	/* Pipes, sockets and process files cannot be synchronized. */
+	if (i->flags & (INODE_PIPE | INODE_SOCKET | INODE_PROC))
+		return (-EINVAL);
+	
+	inode_lock(i);
+	inode_fsync(i, 0);
+	inode_unlock(i);
+	
+	return (0);
+}
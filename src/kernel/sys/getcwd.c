@@ -0,0 +1,72 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of Nanvix.
+ * 
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nanvix/const.h>
+#include <nanvix/klib.h>
+#include <nanvix/mm.h>
+#include <nanvix/pm.h>
+#include <errno.h>
+
+/**
+ * @brief Gets the path name of the working directory.
+ * 
+ * @details Copies the path name of the working directory of the calling
+ *          process, relative to its root directory, to the buffer pointed to
+ *          by @p buf. The path name is kept by chdir() and chroot(), so no
+ *          directory is read.
+ * 
+ * @param buf  Target buffer.
+ * @param size Size of the target buffer.
+ * 
+ * @returns Upon successful completion, zero is returned. Upon failure, a
+ *          negative error code is returned instead.
+ */
+PUBLIC int sys_getcwd(char *buf, size_t size)
+{
+	size_t len;      /* Length of root directory path. */
+	const char *cwd; /* Working directory path.        */
+	
+	/* Invalid buffer. */
+	if ((size == 0) || (!chkmem(buf, size, MAY_WRITE)))
+		return (-EINVAL);
+	
+	cwd = curr_proc->pwdpath;
+	len = kstrlen(curr_proc->rootpath);
+	
+	/* Strip root directory path. */
+	if (len > 1)
+	{
+		/* Working directory is outside the root directory. */
+		if ((kstrncmp(cwd, curr_proc->rootpath, len)) ||
+			((cwd[len] != '\0') && (cwd[len] != '/')))
+			return (-ENOENT);
+		
+		cwd += len;
+		if (*cwd == '\0')
+			cwd = "/";
+	}
+	
+	/* Buffer too small. */
+	if (kstrlen(cwd) >= size)
+		return (-ERANGE);
+	
+	kstrcpy(buf, cwd);
+	
+	return (0);
+}
@@ -26,7 +26,7 @@
 #include <sys/types.h>
 
 /*
- * Performs control operations on a device.
+ * Performs control operations on a device or socket.
  */
 PUBLIC int sys_ioctl(unsigned fd, unsigned cmd, unsigned arg)
 {
@@ -38,8 +38,14 @@ PUBLIC int sys_ioctl(unsigned fd, unsigned cmd, unsigned arg)
 	if ((fd >= OPEN_MAX) || ((fp = curr_proc->ofiles[fd]) == NULL))
 		return (-EBADF);
 	
+	ip = fp->inode;
+	
+	/* Socket. */
+	if (ip->flags & INODE_SOCKET)
+		return (socket_ioctl(ip->sock, cmd, arg));
+	
 	/* Not a character device. */
-	if (!S_ISCHR((ip = fp->inode)->mode))
+	if (!S_ISCHR(ip->mode))
 		return (-EINVAL);
 	
 	dev = ip->blocks[0];
@@ -0,0 +1,40 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of Nanvix.
+ * 
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nanvix/const.h>
+#include <nanvix/hal.h>
+#include <nanvix/mm.h>
+#include <sys/mman.h>
+#include <errno.h>
+
+/*
+ * Advises the system about the use of memory.
+ */
+PUBLIC int sys_madvise(void *addr, size_t len, int advice)
+{
+	/* Invalid advice. */
+	if ((advice < MADV_NORMAL) || (advice > MADV_DONTNEED))
+		return (-EINVAL);
+	
+	/* Start address not page aligned. */
+	if (ADDR(addr) & ~PAGE_MASK)
+		return (-EINVAL);
+	
+	return (advisepg(ADDR(addr), len, advice));
+}
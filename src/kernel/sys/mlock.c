@@ -0,0 +1,35 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of Nanvix.
+ * 
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nanvix/const.h>
+#include <nanvix/hal.h>
+#include <nanvix/mm.h>
+#include <errno.h>
+
+/*
+ * Locks a range of memory.
+ */
+PUBLIC int sys_mlock(const void *addr, size_t len)
+{
+	/* Start address not page aligned. */
+	if (ADDR(addr) & ~PAGE_MASK)
+		return (-EINVAL);
+	
+	return (lockpg(ADDR(addr), len));
+}
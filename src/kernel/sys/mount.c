@@ -0,0 +1,70 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of Nanvix.
+ * 
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nanvix/const.h>
+#include <nanvix/fs.h>
+#include <nanvix/klib.h>
+#include <nanvix/pm.h>
+#include <errno.h>
+
+/**
+ * @brief Mounts a file system.
+ * 
+ * @param source Device to be mounted. Ignored by pseudo file systems.
+ * @param target Directory where the file system shall be mounted.
+ * @param type   File system type.
+ * 
+ * @returns Upon successful completion, zero is returned. Upon failure, a
+ *          negative error code is returned instead.
+ */
+PUBLIC int sys_mount(const char *source, const char *target, const char *type)
+{
+	int ret;         /* Return value.     */
+	char *name;      /* File system type. */
+	struct inode *i; /* Mount point.      */
+	
+	((void)source);
+	
+	/* Not allowed. */
+	if (!IS_SUPERUSER(curr_proc))
+		return (-EPERM);
+	
+	if ((name = getname(type)) == NULL)
+		return (curr_proc->errno);
+	
+	/* Only the process file system is supported. */
+	ret = kstrcmp(name, "proc");
+	putname(name);
+	if (ret)
+		return (-ENODEV);
+	
+	if ((i = inode_name(target)) == NULL)
+		return (curr_proc->errno);
+	
+	/* Failed to mount. */
+	if ((ret = procfs_mount(i)) < 0)
+	{
+		inode_put(i);
+		return (ret);
+	}
+	
+	inode_unlock(i);
+	
+	return (0);
+}
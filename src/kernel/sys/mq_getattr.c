@@ -0,0 +1,50 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of Nanvix.
+ * 
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nanvix/const.h>
+#include <nanvix/fs.h>
+#include <nanvix/ipc.h>
+#include <nanvix/klib.h>
+#include <nanvix/mm.h>
+#include <nanvix/pm.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <mqueue.h>
+
+/*
+ * Gets the attributes of a message queue.
+ */
+PUBLIC int sys_mq_getattr(int mqd, struct mq_attr *attr)
+{
+	struct mq_attr kattr; /* Kernel attributes. */
+	
+	/* Invalid message queue descriptor. */
+	if ((mqd < 0) || (mqd >= MQ_OPEN_MAX) || (curr_proc->mqdes[mqd] == NULL))
+		return (-EBADF);
+	
+	/* Invalid buffer. */
+	if (!chkmem(attr, sizeof(struct mq_attr), MAY_WRITE))
+		return (-EFAULT);
+	
+	mqueue_attr(curr_proc->mqdes[mqd], &kattr);
+	kattr.mq_flags = curr_proc->mqflags[mqd] & O_NONBLOCK;
+	kmemcpy(attr, &kattr, sizeof(struct mq_attr));
+	
+	return (0);
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of Nanvix.
+ * 
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nanvix/const.h>
+#include <nanvix/fs.h>
+#include <nanvix/ipc.h>
+#include <nanvix/klib.h>
+#include <nanvix/mm.h>
+#include <nanvix/pm.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <mqueue.h>
+
+/*
+ * Opens a message queue.
+ */
+PUBLIC int sys_mq_open
+(const char *name, int oflag, mode_t mode, const struct mq_attr *attr)
+{
+	int mqd;              /* Message queue descriptor. */
+	char *kname;          /* Kernel name.              */
+	struct mqueue *mq;    /* Message queue.            */
+	struct mq_attr kattr; /* Kernel attributes.        */
+	
+	/* Get a free message queue descriptor. */
+	for (mqd = 0; mqd < MQ_OPEN_MAX; mqd++)
+	{
+		if (curr_proc->mqdes[mqd] == NULL)
+			goto found;
+	}
+	
+	return (-EMFILE);
+
+found:
+
+	/* Get attributes. */
+	if ((oflag & O_CREAT) && (attr != NULL))
+	{
+		if (!chkmem(attr, sizeof(struct mq_attr), MAY_READ))
+			return (-EFAULT);
+		
+		kmemcpy(&kattr, attr, sizeof(struct mq_attr));
+		attr = &kattr;
+	}
+	else
+		attr = NULL;
+	
+	if ((kname = getname(name)) == NULL)
+		return (curr_proc->errno);
+	
+	mq = mqueue_open(kname, oflag, mode, attr);
+	putname(kname);
+	
+	/* Failed to open message queue. */
+	if (mq == NULL)
+		return (curr_proc->errno);
+	
+	curr_proc->mqdes[mqd] = mq;
+	curr_proc->mqflags[mqd] = oflag & (O_ACCMODE | O_NONBLOCK);
+	
+	return (mqd);
+}
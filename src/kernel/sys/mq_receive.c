@@ -0,0 +1,60 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of Nanvix.
+ * 
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nanvix/const.h>
+#include <nanvix/fs.h>
+#include <nanvix/ipc.h>
+#include <nanvix/mm.h>
+#include <nanvix/pm.h>
+#include <errno.h>
+#include <fcntl.h>
+
+/*
+ * Receives a message from a message queue.
+ */
+PUBLIC ssize_t sys_mq_receive(int mqd, char *msg, size_t len, unsigned *prio)
+{
+	int flags;      /* Descriptor flags.  */
+	ssize_t ret;    /* Return value.      */
+	unsigned kprio; /* Message priority.  */
+	
+	/* Invalid message queue descriptor. */
+	if ((mqd < 0) || (mqd >= MQ_OPEN_MAX) || (curr_proc->mqdes[mqd] == NULL))
+		return (-EBADF);
+	
+	flags = curr_proc->mqflags[mqd];
+	
+	/* Not open for reading. */
+	if (ACCMODE(flags) == O_WRONLY)
+		return (-EBADF);
+	
+	/* Invalid buffer. */
+	if (!chkmem(msg, len, MAY_WRITE))
+		return (-EFAULT);
+	if ((prio != NULL) && (!chkmem(prio, sizeof(unsigned), MAY_WRITE)))
+		return (-EFAULT);
+	
+	ret = mqueue_receive(curr_proc->mqdes[mqd], msg, len, &kprio,
+		flags & O_NONBLOCK);
+	
+	if ((ret >= 0) && (prio != NULL))
+		*prio = kprio;
+	
+	return (ret);
+}
@@ -0,0 +1,51 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of Nanvix.
+ * 
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nanvix/const.h>
+#include <nanvix/fs.h>
+#include <nanvix/ipc.h>
+#include <nanvix/mm.h>
+#include <nanvix/pm.h>
+#include <errno.h>
+#include <fcntl.h>
+
+/*
+ * Sends a message to a message queue.
+ */
+PUBLIC int sys_mq_send(int mqd, const char *msg, size_t len, unsigned prio)
+{
+	int flags; /* Descriptor flags. */
+	
+	/* Invalid message queue descriptor. */
+	if ((mqd < 0) || (mqd >= MQ_OPEN_MAX) || (curr_proc->mqdes[mqd] == NULL))
+		return (-EBADF);
+	
+	flags = curr_proc->mqflags[mqd];
+	
+	/* Not open for writing. */
+	if (ACCMODE(flags) == O_RDONLY)
+		return (-EBADF);
+	
+	/* Invalid buffer. */
+	if (!chkmem(msg, len, MAY_READ))
+		return (-EFAULT);
+	
+	return (mqueue_send(curr_proc->mqdes[mqd], msg, len, prio,
+		flags & O_NONBLOCK));
+}
@@ -36,8 +36,10 @@
 /*
  * Creates a file.
  */
-PRIVATE struct inode *do_creat(struct inode *d, const char *name, mode_t mode, int oflag)
+PRIVATE struct inode *do_creat
+(struct inode *d, const char *name, mode_t mode, int oflag, int slot)
 {
+	int err;
 	struct inode *i;
 	
 	/* Not asked to create file. */
@@ -54,6 +56,13 @@ PRIVATE struct inode *do_creat(struct inode *d, const char *name, mode_t mode, i
 		return (NULL);
 	}	
 	
+	/* Read-only file system. */
+	if (d->dev == PROC_DEV)
+	{
+		curr_proc->errno = -EROFS;
+		return (NULL);
+	}
+	
 	i = inode_alloc(d->sb);
 	
 	/* Failed to allocate inode. */
@@ -63,8 +72,10 @@ PRIVATE struct inode *do_creat(struct inode *d, const char *name, mode_t mode, i
 	i->mode = (mode & MAY_ALL & ~curr_proc->umask) | S_IFREG;
 
 	/* Failed to add directory entry. */
-	if (dir_add(d, i, name))
+	if ((err = dir_add_slot(d, i, name, slot)) < 0)
 	{
+		curr_proc->errno = err;
+		i->nlinks = 0;
 		inode_put(i);
 		return (NULL);
 	}
@@ -80,6 +91,7 @@ PRIVATE struct inode *do_creat(struct inode *d, const char *name, mode_t mode, i
 PRIVATE struct inode *do_open(const char *path, int oflag, mode_t mode)
 {
 	int err;              /* Error?               */
+	int slot;             /* Free directory slot. */
 	const char *name;     /* File name.           */
 	struct inode *dinode; /* Directory's inode.   */
 	ino_t num;            /* File's inode number. */
@@ -92,12 +104,12 @@ PRIVATE struct inode *do_open(const char *path, int oflag, mode_t mode)
 	if (dinode == NULL)
 		return (NULL);
 	
-	num = dir_search(dinode, name);
+	num = dir_lookup(dinode, name, &slot);
 	
 	/* File does not exist. */
 	if (num == INODE_NULL)
 	{
-		i = do_creat(dinode, name, mode, oflag);
+		i = do_creat(dinode, name, mode, oflag, slot);
 		
 		/* Failed to create inode. */
 		if (i == NULL)
@@ -133,6 +145,13 @@ PRIVATE struct inode *do_open(const char *path, int oflag, mode_t mode)
 		goto error;
 	}
 	
+	/* Read-only file system. */
+	if ((i->dev == PROC_DEV) && (PERM(oflag) & MAY_WRITE))
+	{
+		curr_proc->errno = -EROFS;
+		goto error;
+	}
+	
 	/* Character special file. */
 	if (S_ISCHR(i->mode))
 	{
@@ -0,0 +1,68 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of Nanvix.
+ * 
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nanvix/const.h>
+#include <nanvix/fs.h>
+#include <nanvix/klib.h>
+#include <nanvix/mm.h>
+#include <nanvix/pm.h>
+#include <sys/uio.h>
+#include <errno.h>
+
+/**
+ * @brief Reads from a file at a given offset.
+ * 
+ * @details Reads @p n bytes from the file referred to by @p fd, starting at
+ *          offset @p off, into the buffer pointed to by @p buf. The file
+ *          offset is not changed.
+ * 
+ * @param fd  File descriptor.
+ * @param buf Target buffer.
+ * @param n   Number of bytes to read.
+ * @param off Read offset.
+ * 
+ * @returns Upon successful completion, the number of bytes read is returned.
+ *          Upon failure, a negative error code is returned instead.
+ */
+PUBLIC ssize_t sys_pread(int fd, void *buf, size_t n, off_t off)
+{
+	struct file *f;   /* File.          */
+	struct iovec iov; /* Target buffer. */
+	
+	/* Invalid file descriptor. */
+	if ((fd < 0) || (fd >= OPEN_MAX) || ((f = curr_proc->ofiles[fd]) == NULL))
+		return (-EBADF);
+	
+	/* Invalid offset. */
+	if (off < 0)
+		return (-EINVAL);
+	
+	/* Invalid buffer. */
+	if (!chkmem(buf, n, MAY_WRITE))
+		return (-EINVAL);
+	
+	/* Nothing to do. */
+	if (n == 0)
+		return (0);
+	
+	iov.iov_base = buf;
+	iov.iov_len = n;
+	
+	return (do_read(f, &iov, 1, &off));
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of Nanvix.
+ * 
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nanvix/const.h>
+#include <nanvix/klib.h>
+#include <nanvix/mm.h>
+#include <nanvix/pm.h>
+#include <sys/pstat.h>
+#include <errno.h>
+
+/**
+ * @brief Takes a snapshot of all processes.
+ * 
+ * @details Copies the status of up to @p n processes to the array pointed to
+ *          by @p buf in a single pass over the process table, without
+ *          formatting anything, so that it is cheap enough to be called
+ *          periodically by monitors.
+ * 
+ * @param buf Process status array.
+ * @param n   Number of entries in the array.
+ * 
+ * @returns Upon successful completion, the number of existing processes is
+ *          returned, which may be greater than @p n. Upon failure, a negative
+ *          error code is returned instead.
+ */
+PUBLIC int sys_pstat(struct pstat *buf, int n)
+{
+	int nprocs;        /* Existing processes. */
+	struct pstat *st;  /* Working entry.      */
+	struct process *p; /* Working process.    */
+	
+	/* Invalid number of entries. */
+	if (n < 0)
+		return (-EINVAL);
+	
+	if (n > PROC_MAX)
+		n = PROC_MAX;
+	
+	/* Not a valid buffer. */
+	if (!chkmem(buf, n*sizeof(struct pstat), MAY_WRITE))
+		return (-EINVAL);
+	
+	nprocs = 0;
+	for (p = IDLE; p <= LAST_PROC; p++)
+	{
+		/* Skip invalid processes. */
+		if (!IS_VALID(p))
+			continue;
+		
+		if (nprocs < n)
+		{
+			st = &buf[nprocs];
+			st->pid = p->pid;
+			st->ppid = (p->father != NULL) ? p->father->pid : 0;
+			st->uid = p->uid;
+			st->priority = p->priority;
+			st->nice = p->nice;
+			st->state = p->state;
+			st->utime = p->utime;
+			st->ktime = p->ktime;
+			st->size = p->size;
+			st->faults = p->faults;
+			st->nsyscalls = p->nsyscalls;
+			kstrncpy(st->name, p->name, NAME_MAX);
+			st->name[NAME_MAX] = '\0';
+		}
+		
+		nprocs++;
+	}
+	
+	return (nprocs);
+}
@@ -18,13 +18,10 @@
  */
 
 #include <nanvix/const.h>
-#include <nanvix/clock.h>
-#include <nanvix/dev.h>
 #include <nanvix/fs.h>
 #include <nanvix/klib.h>
 #include <nanvix/mm.h>
-#include <sys/stat.h>
-#include <fcntl.h>
+#include <sys/uio.h>
 #include <errno.h>
 
 /*
@@ -32,18 +29,12 @@
  */
 PUBLIC ssize_t sys_read(int fd, void *buf, size_t n)
 {
-	dev_t dev;       /* Device number.       */
-	struct file *f;  /* File.                */
-	struct inode *i; /* Inode.               */
-	ssize_t count;   /* Bytes actually read. */
+	struct file *f;   /* File.          */
+	struct iovec iov; /* Target buffer. */
 	
 	/* Invalid file descriptor. */
 	if ((fd < 0) || (fd >= OPEN_MAX) || ((f = curr_proc->ofiles[fd]) == NULL))
 		return (-EBADF);
-	
-	/* File not opened for reading. */
-	if (ACCMODE(f->oflag) == O_WRONLY)
-		return (-EBADF);
 
 #if (EDUCATIONAL_KERNEL == 0)
 	
@@ -57,44 +48,8 @@ PUBLIC ssize_t sys_read(int fd, void *buf, size_t n)
 	if (n == 0)
 		return (0);
 	
-	 i = f->inode;
-	
-	/* Character special file. */
-	if (S_ISCHR(i->mode))
-	{		
-		dev = i->blocks[0];
-		count = cdev_read(dev, buf, n);
-		return (count);
-	}
-	
-	/* Block special file. */
-	else if (S_ISBLK(i->mode))
-	{
-		dev = i->blocks[0];
-		count = bdev_read(dev, buf, n, f->pos);
-	}
-	
-	/* Pipe file. */
-	else if (S_ISFIFO(i->mode))
-	{
-		kprintf("read from pipe");
-		count = pipe_read(i, buf, n);
-	}
+	iov.iov_base = buf;
+	iov.iov_len = n;
 	
-	/* Regular file/directory. */
-	else if ((S_ISDIR(i->mode)) || (S_ISREG(i->mode)))
-		count = file_read(i, buf, n, f->pos);
-	
-	/* Unknown file type. */
-	else
-		return (-EINVAL);
-	
-	/* Failed to read. */
-	if (count < 0)
-		return (curr_proc->errno);
-
-	inode_touch(i);
-	f->pos += count;
-
-	return (count);
+	return (do_read(f, &iov, 1, NULL));
 }
@@ -0,0 +1,107 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of Nanvix.
+ * 
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nanvix/const.h>
+#include <nanvix/fs.h>
+#include <nanvix/klib.h>
+#include <nanvix/mm.h>
+#include <nanvix/pm.h>
+#include <sys/socket.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+
+/*
+ * Receives a message from a socket.
+ */
+PUBLIC ssize_t sys_recvmsg(int fd, struct msghdr *msg, int flags)
+{
+	int err;                      /* Error code.       */
+	ssize_t ret;                  /* Bytes received.   */
+	struct msghdr m;              /* Message header.   */
+	struct cmsghdr *c;            /* Control message.  */
+	struct socket *sock;          /* Socket.           */
+	struct sockmsg smsg;          /* Socket message.   */
+	struct iovec iov[IOV_MAX];    /* User buffers.     */
+	struct sockname sn;           /* Name of peer.     */
+	
+	if ((err = socket_get(fd, &sock)))
+		return (err);
+	
+	/* Invalid message header. */
+	if (!chkmem(msg, sizeof(struct msghdr), MAY_WRITE))
+		return (-EINVAL);
+	kmemcpy(&m, msg, sizeof(struct msghdr));
+	
+	/* Too many buffers. */
+	if ((m.msg_iovlen < 0) || (m.msg_iovlen > IOV_MAX))
+		return (-EMSGSIZE);
+	
+	/* Get user buffers. */
+	if (!chkmem(m.msg_iov, m.msg_iovlen*sizeof(struct iovec), MAY_READ))
+		return (-EINVAL);
+	kmemcpy(iov, m.msg_iov, m.msg_iovlen*sizeof(struct iovec));
+	for (int i = 0; i < m.msg_iovlen; i++)
+	{
+		if (!chkmem(iov[i].iov_base, iov[i].iov_len, MAY_WRITE))
+			return (-EINVAL);
+	}
+	
+	smsg.iov = iov;
+	smsg.iovcnt = m.msg_iovlen;
+	smsg.name = &sn;
+	smsg.nfds = 0;
+	smsg.flags = flags & MSG_DONTWAIT;
+	if (curr_proc->ofiles[fd]->oflag & O_NONBLOCK)
+		smsg.flags |= MSG_DONTWAIT;
+	
+	/* Room for passed file descriptors. */
+	if ((m.msg_control != NULL) && (m.msg_controllen >= CMSG_LEN(sizeof(int))))
+	{
+		if (!chkmem(m.msg_control, m.msg_controllen, MAY_WRITE))
+			return (-EINVAL);
+		
+		smsg.nfds = (m.msg_controllen - CMSG_LEN(0))/sizeof(int);
+		if (smsg.nfds > SCM_MAX_FD)
+			smsg.nfds = SCM_MAX_FD;
+	}
+	
+	if ((ret = socket_recv(sock, &smsg)) < 0)
+		return (ret);
+	
+	/* Sender name. */
+	if (m.msg_name != NULL)
+		socket_putaddr(&sn, m.msg_name, &msg->msg_namelen);
+	
+	/* Passed file descriptors. */
+	msg->msg_controllen = 0;
+	if (smsg.nfds > 0)
+	{
+		c = (struct cmsghdr *)m.msg_control;
+		c->cmsg_len = CMSG_LEN(smsg.nfds*sizeof(int));
+		c->cmsg_level = SOL_SOCKET;
+		c->cmsg_type = SCM_RIGHTS;
+		kmemcpy(CMSG_DATA(c), smsg.fds, smsg.nfds*sizeof(int));
+		msg->msg_controllen = CMSG_SPACE(smsg.nfds*sizeof(int));
+	}
+	
+	msg->msg_flags = smsg.flags;
+	
+	return (ret);
+}
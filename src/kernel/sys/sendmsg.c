@@ -0,0 +1,113 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of Nanvix.
+ * 
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nanvix/const.h>
+#include <nanvix/fs.h>
+#include <nanvix/klib.h>
+#include <nanvix/mm.h>
+#include <nanvix/pm.h>
+#include <sys/socket.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+
+/*
+ * Sends a message on a socket.
+ */
+PUBLIC ssize_t sys_sendmsg(int fd, const struct msghdr *msg, int flags)
+{
+	int n;                        /* Number of descriptors. */
+	int err;                      /* Error code.            */
+	char *end;                    /* End of control data.   */
+	struct msghdr m;              /* Message header.        */
+	struct cmsghdr *c;            /* Control message.       */
+	struct socket *sock;          /* Socket.                */
+	struct sockmsg smsg;          /* Socket message.        */
+	struct iovec iov[IOV_MAX];    /* User buffers.          */
+	struct sockname sn;           /* Name of peer.          */
+	
+	if ((err = socket_get(fd, &sock)))
+		return (err);
+	
+	/* Invalid message header. */
+	if (!chkmem(msg, sizeof(struct msghdr), MAY_READ))
+		return (-EINVAL);
+	kmemcpy(&m, msg, sizeof(struct msghdr));
+	
+	/* Too many buffers. */
+	if ((m.msg_iovlen < 0) || (m.msg_iovlen > IOV_MAX))
+		return (-EMSGSIZE);
+	
+	/* Get user buffers. */
+	if (!chkmem(m.msg_iov, m.msg_iovlen*sizeof(struct iovec), MAY_READ))
+		return (-EINVAL);
+	kmemcpy(iov, m.msg_iov, m.msg_iovlen*sizeof(struct iovec));
+	for (int i = 0; i < m.msg_iovlen; i++)
+	{
+		if (!chkmem(iov[i].iov_base, iov[i].iov_len, MAY_READ))
+			return (-EINVAL);
+	}
+	
+	smsg.iov = iov;
+	smsg.iovcnt = m.msg_iovlen;
+	smsg.name = NULL;
+	smsg.nfds = 0;
+	smsg.flags = flags & MSG_DONTWAIT;
+	if (curr_proc->ofiles[fd]->oflag & O_NONBLOCK)
+		smsg.flags |= MSG_DONTWAIT;
+	
+	/* Get destination. */
+	if (m.msg_name != NULL)
+	{
+		if ((err = socket_getaddr(m.msg_name, m.msg_namelen, &sn)))
+			return (err);
+		smsg.name = &sn;
+	}
+	
+	/* Get passed file descriptors. */
+	if ((m.msg_control != NULL) && (m.msg_controllen > 0))
+	{
+		if (!chkmem(m.msg_control, m.msg_controllen, MAY_READ))
+			return (-EINVAL);
+		
+		end = (char *)m.msg_control + m.msg_controllen;
+		
+		for (c = CMSG_FIRSTHDR(&m); c != NULL; c = CMSG_NXTHDR(&m, c))
+		{
+			/* Bad control message. */
+			if ((c->cmsg_len < CMSG_LEN(0)) || ((char *)c + c->cmsg_len > end))
+				return (-EINVAL);
+			
+			/* Unsupported control message. */
+			if ((c->cmsg_level != SOL_SOCKET) || (c->cmsg_type != SCM_RIGHTS))
+				return (-EINVAL);
+			
+			n = (c->cmsg_len - CMSG_LEN(0))/sizeof(int);
+			
+			/* Too many file descriptors. */
+			if (smsg.nfds + n > SCM_MAX_FD)
+				return (-EINVAL);
+			
+			kmemcpy(&smsg.fds[smsg.nfds], CMSG_DATA(c), n*sizeof(int));
+			smsg.nfds += n;
+		}
+	}
+	
+	return (socket_send(sock, &smsg));
+}
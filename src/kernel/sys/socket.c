@@ -0,0 +1,65 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of Nanvix.
+ * 
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nanvix/const.h>
+#include <nanvix/fs.h>
+#include <nanvix/pm.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <errno.h>
+
+/*
+ * Creates a socket.
+ */
+PUBLIC int sys_socket(int domain, int type, int protocol)
+{
+	int fd;              /* File descriptor. */
+	struct socket *sock; /* Socket.          */
+	
+	/* Unsupported address family. */
+	if ((domain != AF_UNIX) && (domain != AF_INET))
+		return (-EAFNOSUPPORT);
+	
+	/* Unsupported socket type. */
+	if ((type != SOCK_STREAM) && (type != SOCK_DGRAM))
+		return (-EPROTOTYPE);
+	
+	/* Internet sockets are UDP sockets. */
+	if (domain == AF_INET)
+	{
+		if (type != SOCK_DGRAM)
+			return (-EPROTOTYPE);
+		if (protocol == IPPROTO_UDP)
+			protocol = 0;
+	}
+	
+	/* Unsupported protocol. */
+	if (protocol != 0)
+		return (-EPROTONOSUPPORT);
+	
+	/* Failed to allocate socket. */
+	if ((sock = socket_alloc(domain, type)) == NULL)
+		return (-ENOBUFS);
+	
+	/* Failed to open socket. */
+	if ((fd = socket_open(sock)) < 0)
+		socket_close(sock);
+	
+	return (fd);
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of Nanvix.
+ * 
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nanvix/const.h>
+#include <nanvix/fs.h>
+#include <nanvix/mm.h>
+#include <nanvix/pm.h>
+#include <errno.h>
+
+/*
+ * Disables swapping to a file or block device.
+ */
+PUBLIC int sys_swapoff(const char *path)
+{
+	int ret;             /* Return value.        */
+	char *pathname;      /* Path name.           */
+	struct inode *inode; /* Swap file or device. */
+	
+	/* Not allowed. */
+	if (!IS_SUPERUSER(curr_proc))
+		return (-EPERM);
+	
+	if ((pathname = getname(path)) == NULL)
+		return (curr_proc->errno);
+	
+	inode = inode_name(pathname);
+	putname(pathname);
+	
+	/* Failed to get inode. */
+	if (inode == NULL)
+		return (curr_proc->errno);
+	
+	/* Pages may be read from the swap file. */
+	inode_unlock(inode);
+	ret = swap_off(inode);
+	inode_lock(inode);
+	
+	inode_put(inode);
+	
+	return (ret);
+}
@@ -25,6 +25,7 @@
  */
 PUBLIC void sys_sync(void)
 {
+	reclaim_flush();
 	inode_sync();
 	superblock_sync();
 	
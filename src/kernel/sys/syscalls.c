@@ -72,5 +72,37 @@ PUBLIC void (*syscalls_table[NR_SYSCALLS])(void)  = {
 	(void (*)(void))&sys_times,
 	(void (*)(void))&sys_shutdown,
 	(void (*)(void))&sys_ps,
-	(void (*)(void))&sys_gticks
+	(void (*)(void))&sys_gticks,
+	(void (*)(void))&sys_nosys,
+	(void (*)(void))&sys_nosys,
+	(void (*)(void))&sys_nosys,
+	(void (*)(void))&sys_fsync,
+	(void (*)(void))&sys_fdatasync,
+	(void (*)(void))&sys_madvise,
+	(void (*)(void))&sys_mlock,
+	(void (*)(void))&sys_munlock,
+	(void (*)(void))&sys_swapon,
+	(void (*)(void))&sys_swapoff,
+	(void (*)(void))&sys_mq_open,
+	(void (*)(void))&sys_mq_close,
+	(void (*)(void))&sys_mq_unlink,
+	(void (*)(void))&sys_mq_send,
+	(void (*)(void))&sys_mq_receive,
+	(void (*)(void))&sys_mq_getattr,
+	(void (*)(void))&sys_socket,
+	(void (*)(void))&sys_bind,
+	(void (*)(void))&sys_listen,
+	(void (*)(void))&sys_accept,
+	(void (*)(void))&sys_connect,
+	(void (*)(void))&sys_sendmsg,
+	(void (*)(void))&sys_recvmsg,
+	(void (*)(void))&sys_hibernate,
+	(void (*)(void))&sys_mount,
+	(void (*)(void))&sys_umount,
+	(void (*)(void))&sys_pstat,
+	(void (*)(void))&sys_getcwd,
+	(void (*)(void))&sys_readv,
+	(void (*)(void))&sys_writev,
+	(void (*)(void))&sys_pread,
+	(void (*)(void))&sys_pwrite
 };
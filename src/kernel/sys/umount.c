@@ -0,0 +1,55 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of Nanvix.
+ * 
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nanvix/const.h>
+#include <nanvix/fs.h>
+#include <nanvix/pm.h>
+#include <errno.h>
+
+/**
+ * @brief Unmounts a file system.
+ * 
+ * @param target Directory where the file system is mounted.
+ * 
+ * @returns Upon successful completion, zero is returned. Upon failure, a
+ *          negative error code is returned instead.
+ */
+PUBLIC int sys_umount(const char *target)
+{
+	int ret;         /* Return value.                 */
+	struct inode *i; /* Root directory of the mount.  */
+	
+	/* Not allowed. */
+	if (!IS_SUPERUSER(curr_proc))
+		return (-EPERM);
+	
+	if ((i = inode_name(target)) == NULL)
+		return (curr_proc->errno);
+	
+	/* Failed to unmount. */
+	if ((ret = procfs_umount(i)) < 0)
+	{
+		inode_put(i);
+		return (ret);
+	}
+	
+	inode_put(i);
+	
+	return (0);
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of Nanvix.
+ * 
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nanvix/const.h>
+#include <nanvix/fs.h>
+#include <nanvix/mm.h>
+#include <nanvix/pm.h>
+#include <sys/uio.h>
+#include <limits.h>
+#include <errno.h>
+
+/**
+ * @brief Writes to a file from many buffers.
+ * 
+ * @details Writes the @p iovcnt buffers described by @p iov, in order, to
+ *          the file referred to by @p fd, as if by a single call to write().
+ * 
+ * @param fd     File descriptor.
+ * @param iov    Source buffers.
+ * @param iovcnt Number of source buffers.
+ * 
+ * @returns Upon successful completion, the number of bytes written is
+ *          returned. Upon failure, a negative error code is returned instead.
+ */
+PUBLIC ssize_t sys_writev(int fd, const struct iovec *iov, int iovcnt)
+{
+	ssize_t total;              /* Total length. */
+	struct file *f;             /* File.         */
+	struct iovec kiov[IOV_MAX]; /* I/O vectors.  */
+	
+	/* Invalid file descriptor. */
+	if ((fd < 0) || (fd >= OPEN_MAX) || ((f = curr_proc->ofiles[fd]) == NULL))
+		return (-EBADF);
+	
+	/* Invalid I/O vectors. */
+	if ((total = getiov(kiov, iov, iovcnt, MAY_READ)) < 0)
+		return (total);
+	
+	/* Nothing to do. */
+	if (total == 0)
+		return (0);
+	
+	return (do_write(f, kiov, iovcnt, NULL));
+}
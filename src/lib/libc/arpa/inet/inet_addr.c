@@ -0,0 +1,69 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of Nanvix.
+ * 
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <arpa/inet.h>
+
+/**
+ * @brief Converts a dotted decimal string into an Internet address.
+ *
+ * @param cp String to be converted.
+ *
+ * @returns The address in network byte order, or INADDR_BROADCAST
+ *          (i.e. (in_addr_t)-1) if @p cp is not a valid address.
+ */
+in_addr_t inet_addr(const char *cp)
+{
+	uint32_t addr;  /* Address.          */
+	unsigned part;  /* Current part.     */
+	unsigned ndots; /* Number of dots.   */
+	int digits;     /* Digits in a part. */
+
+	addr = 0;
+	ndots = 0;
+
+	while (1)
+	{
+		part = 0;
+		digits = 0;
+
+		/* Parse part. */
+		while ((*cp >= '0') && (*cp <= '9'))
+		{
+			part = part*10 + (*cp++ - '0');
+			if ((++digits > 3) || (part > 255))
+				return (INADDR_BROADCAST);
+		}
+
+		if (digits == 0)
+			return (INADDR_BROADCAST);
+
+		addr = (addr << 8) | part;
+
+		if (*cp == '\0')
+			break;
+
+		if ((*cp++ != '.') || (++ndots > 3))
+			return (INADDR_BROADCAST);
+	}
+
+	if (ndots != 3)
+		return (INADDR_BROADCAST);
+
+	return (htonl(addr));
+}
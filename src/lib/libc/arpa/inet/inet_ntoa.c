@@ -0,0 +1,56 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of Nanvix.
+ * 
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <arpa/inet.h>
+
+/**
+ * @brief Converts an Internet address into a dotted decimal string.
+ *
+ * @param in Address to be converted.
+ *
+ * @returns A pointer to a static buffer holding the converted address. The
+ *          buffer is overwritten by subsequent calls.
+ */
+char *inet_ntoa(struct in_addr in)
+{
+	static char buf[16]; /* "255.255.255.255" */
+	char *p;             /* Write pointer.    */
+	uint32_t addr;       /* Host address.     */
+	unsigned part;       /* Current part.     */
+
+	p = buf;
+	addr = ntohl(in.s_addr);
+
+	for (int i = 3; i >= 0; i--)
+	{
+		part = (addr >> (i << 3)) & 0xff;
+
+		if (part >= 100)
+			*p++ = '0' + part/100;
+		if (part >= 10)
+			*p++ = '0' + (part/10)%10;
+		*p++ = '0' + part%10;
+
+		if (i > 0)
+			*p++ = '.';
+	}
+	*p = '\0';
+
+	return (buf);
+}
@@ -48,7 +48,7 @@ static int do_fflush(FILE *stream)
 	
 	/* Reset buffer. */
 	stream->ptr = buf;
-	stream->count = (stream->flags & _IOLBF) ? 0 : stream->bufsiz - 1;
+	stream->count = (stream->flags & _IOLBF) ? 0 : (int)stream->bufsiz;
 	
 	/* Flush. */
 	if (write(fileno(stream), buf, n) != n)
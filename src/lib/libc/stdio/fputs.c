@@ -25,12 +25,13 @@
  */
 int fputs(const char *str, FILE *stream)
 {
-	int c;       /* Working character. */
-	int ret = 0; /* Return value.      */
+	size_t n; /* String length. */
+	
+	n = strlen(str);
 	
 	/* Write string. */
-	while ((c = *str++) != '\0')
-		ret = putc(c, stream);
+	if (fwrite(str, 1, n, stream) != n)
+		return (EOF);
 		
-	return (ret);
+	return (0);
 }
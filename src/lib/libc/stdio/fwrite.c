@@ -0,0 +1,146 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of Nanvix.
+ * 
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <sys/uio.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "stdio.h"
+
+/*
+ * Writes items to a file.
+ */
+size_t fwrite(const void *ptr, size_t size, size_t nitems, FILE *stream)
+{
+	size_t n;            /* Bytes to write.         */
+	ssize_t ret;         /* Bytes actually written. */
+	size_t pending;      /* Bytes in the buffer.    */
+	char *buf;           /* Buffer.                 */
+	struct iovec iov[2]; /* Buffer and payload.     */
+	
+	n = size*nitems;
+	
+	/* Nothing to do. */
+	if (n == 0)
+		return (0);
+	
+	/* Fits in the buffer. */
+	if ((stream->flags & (_IOWRITE | _IOFBF)) == (_IOWRITE | _IOFBF))
+	{
+		if ((stream->count > 0) && ((size_t)stream->count >= n))
+		{
+			memcpy(stream->ptr, ptr, n);
+			stream->ptr += n;
+			stream->count -= n;
+			return (nitems);
+		}
+	}
+	
+	/* Now writing. */
+	if (stream->flags & _IORW)
+	{
+		stream->flags &= ~_IOREAD;
+		stream->flags |= _IOWRITE;
+	}
+	
+	/* File is not writable. */
+	if (!(stream->flags & _IOWRITE))
+		return (0);
+
+	/* Synchronize file position. */
+	if (!(stream->flags & _IOEOF))
+	{
+		if ((stream->flags & (_IOSYNC | _IOAPPEND)) == (_IOSYNC | _IOAPPEND))
+		{
+			/* Failed. */
+			if (lseek(fileno(stream), 0, SEEK_END) < 0)
+			{
+				stream->flags |= _IOERROR;
+				return (0);
+			}
+		}
+	}
+	
+	pending = 0;
+	
+	/* Not buffered. */
+	if (stream->flags & _IONBF)
+		goto flush;
+	
+	/* Assign buffer. */
+	if ((buf = stream->buf) == NULL)
+	{
+		/* Failed to allocate buffer. */
+		if ((buf = malloc(BUFSIZ)) == NULL)
+		{
+			stream->flags &= ~(_IOLBF | _IOFBF);
+			stream->flags |= _IONBF;
+			goto flush;
+		}
+		
+		/* Initialize buffer. */
+		stream->flags |= _IOMYBUF;
+		stream->buf = buf;
+		stream->ptr = buf;
+		stream->bufsiz = BUFSIZ;
+	}
+	
+	pending = stream->ptr - buf;
+	
+	/* Buffer payload. */
+	if (pending + n <= stream->bufsiz)
+	{
+		if (!(stream->flags & _IOLBF) || (memchr(ptr, '\n', n) == NULL))
+		{
+			memcpy(stream->ptr, ptr, n);
+			stream->ptr += n;
+			stream->count = (stream->flags & _IOLBF) ? 0 :
+				(int)(stream->bufsiz - (pending + n));
+			return (nitems);
+		}
+	}
+	
+	/* Reset buffer. */
+	stream->ptr = buf;
+	stream->count = (stream->flags & _IOLBF) ? 0 : (int)stream->bufsiz;
+
+flush:
+	
+	/*
+	 * Write pending data and
+	 * payload at once.
+	 */
+	iov[0].iov_base = stream->buf;
+	iov[0].iov_len = pending;
+	iov[1].iov_base = (void *)ptr;
+	iov[1].iov_len = n;
+	ret = writev(fileno(stream), &iov[(pending == 0) ? 1 : 0],
+		(pending == 0) ? 1 : 2);
+	
+	/* Failed to write. */
+	if ((ret < 0) || ((size_t)ret != pending + n))
+	{
+		stream->flags |= _IOERROR;
+		return (((ret < 0) || ((size_t)ret <= pending)) ?
+			0 : ((size_t)ret - pending)/size);
+	}
+	
+	return (nitems);
+}
@@ -29,10 +29,30 @@
 #include <string.h>
 #include <unistd.h>
 
+/**
+ * @brief Page size (in bytes).
+ */
+#define PAGE_SIZE 4096
+
 /**
  * @brief expand() in at least NALLOC blocks.
  */
-#define NALLOC 511
+#define NALLOC 512
+
+/**
+ * @brief expand() in at most HEAP_GROW_MAX bytes, unless asked for more.
+ */
+#define HEAP_GROW_MAX (1024*1024)
+
+/**
+ * @brief trim() only free tails of at least HEAP_TRIM bytes.
+ */
+#define HEAP_TRIM (512*1024)
+
+/**
+ * @brief trim() keeps HEAP_KEEP bytes in the free tail.
+ */
+#define HEAP_KEEP (128*1024)
 
 /**
  * @brief Size of block structure.
@@ -55,20 +75,26 @@ static struct block head;
 static struct block *freep = NULL;
 
 /**
- * @brief Frees allocated memory.
+ * @brief Heap size (in bytes).
+ */
+static size_t heapsize = 0;
+
+/**
+ * @brief End of the heap.
+ */
+static struct block *heapend = NULL;
+
+/**
+ * @brief Inserts a block in the free list.
  * 
- * @param ptr Memory area to free.
+ * @param bp Block to be inserted.
+ * 
+ * @returns The free block that contains the inserted block, after it has been
+ *          merged with its neighbours.
  */
-void free(void *ptr)
+static struct block *insert(struct block *bp)
 {
-	struct block *p;  /* Working block.     */
-	struct block *bp; /* Block being freed. */
-	
-	/* Nothing to be done. */
-	if (ptr == NULL)
-		return;
-	
-	bp = (struct block *)ptr - 1;
+	struct block *p; /* Working block. */
 	
 	/* Look for insertion point. */
 	for (p = freep; p > bp || p->nextp < bp; p = p->nextp)
@@ -81,28 +107,85 @@ void free(void *ptr)
 	/* Merge with upper block. */
 	if (bp + bp->nblocks == p->nextp)
 	{
-		bp->nblocks += p->nextp->nblocks + 1;
+		bp->nblocks += p->nextp->nblocks;
 		bp->nextp = p->nextp->nextp;
 	}
 	else
 		bp->nextp = p->nextp;
 	
+	freep = p;
+	
 	/* Merge with lower block. */
 	if (p + p->nblocks == bp)
 	{
-		p->nblocks += bp->nblocks + 1;
+		p->nblocks += bp->nblocks;
 		p->nextp = bp->nextp;
+		
+		return (p);
 	}
-	else
-		p->nextp = bp;
 	
-	freep = p;
+	p->nextp = bp;
+	
+	return (bp);
+}
+
+/**
+ * @brief Trims the heap.
+ * 
+ * @details Gives back to the kernel the memory at the end of the free block
+ *          pointed to by @p p, if this block is at the end of the heap and
+ *          it is big enough. Some memory is kept, so that a program that
+ *          allocates and frees memory repeatedly does not call the kernel
+ *          every time.
+ * 
+ * @param p Free block.
+ */
+static void trim(struct block *p)
+{
+	size_t excess; /* Memory to give back (in bytes). */
+	
+	/* Not at the end of the heap. */
+	if (p + p->nblocks != heapend)
+		return;
+	
+	/* Free tail is too small. */
+	if (p->nblocks*SIZEOF_BLOCK < HEAP_TRIM)
+		return;
+	
+	/* Someone else has moved the breakpoint. */
+	if (sbrk(0) != heapend)
+		return;
+	
+	excess = (p->nblocks*SIZEOF_BLOCK - HEAP_KEEP) & ~(PAGE_SIZE - 1);
+	if (sbrk(-(ssize_t)excess) == (void *)-1)
+		return;
+	
+	p->nblocks -= excess/SIZEOF_BLOCK;
+	heapend -= excess/SIZEOF_BLOCK;
+	heapsize -= excess;
+}
+
+/**
+ * @brief Frees allocated memory.
+ * 
+ * @param ptr Memory area to free.
+ */
+void free(void *ptr)
+{
+	/* Nothing to be done. */
+	if (ptr == NULL)
+		return;
+	
+	trim(insert((struct block *)ptr - 1));
 }
 
 /**
  * @brief Expands the heap.
  * 
- * @details Expands the heap by @p nblocks.
+ * @details Expands the heap by at least @p nblocks. The heap grows
+ *          geometrically, by as much as its current size, but in at most
+ *          HEAP_GROW_MAX bytes, so that programs that allocate a lot of memory
+ *          call the kernel fewer times.
  * 
  * @param nblocks Number of blocks to expand.
  * 
@@ -112,18 +195,32 @@ void free(void *ptr)
  */
 static void *expand(unsigned nblocks)
 {
-	struct block *p;
-
+	size_t size;     /* Expansion size (in bytes). */
+	struct block *p; /* Expansion.                 */
+	
+	size = (heapsize < HEAP_GROW_MAX) ? heapsize : HEAP_GROW_MAX;
+	
 	/* Expand in at least NALLOC blocks. */
-	if (nblocks < NALLOC)
-		nblocks = NALLOC;
+	if (size < NALLOC*SIZEOF_BLOCK)
+		size = NALLOC*SIZEOF_BLOCK;
+	if (size < nblocks*SIZEOF_BLOCK)
+		size = nblocks*SIZEOF_BLOCK;
+	size = (size + (PAGE_SIZE - 1)) & ~(PAGE_SIZE - 1);
 	
 	/* Request more memory to the kernel. */
-	if ((p = sbrk((nblocks + 1)*SIZEOF_BLOCK)) == (void *)-1)
-		return (NULL);
+	if ((p = sbrk(size)) == (void *)-1)
+	{
+		/* Try the bare minimum. */
+		size = (nblocks*SIZEOF_BLOCK + (PAGE_SIZE - 1)) & ~(PAGE_SIZE - 1);
+		if ((p = sbrk(size)) == (void *)-1)
+			return (NULL);
+	}
+	
+	heapsize += size;
+	heapend = p + size/SIZEOF_BLOCK;
 	
-	p->nblocks = nblocks;
-	free(p + 1);
+	p->nblocks = size/SIZEOF_BLOCK;
+	insert(p);
 	
 	return (freep);
 }
@@ -207,6 +304,7 @@ void *malloc(size_t size)
 void *realloc(void *ptr, size_t size)
 {
 	void *newptr;
+	size_t oldsize;
 	
 	/* Nothing to be done. */
 	if (size == 0)
@@ -215,9 +313,19 @@ void *realloc(void *ptr, size_t size)
 		return (NULL);
 	}
 	
-	newptr = malloc(size);
+	if ((newptr = malloc(size)) == NULL)
+		return (NULL);
+	
+	/*
+	 * Do not copy past the end of the old
+	 * object, since memory after it may have
+	 * been given back to the kernel.
+	 */
 	if (ptr != NULL)
-		memcpy(newptr, ptr, size);
+	{
+		oldsize = (((struct block *)ptr - 1)->nblocks - 1)*SIZEOF_BLOCK;
+		memcpy(newptr, ptr, (oldsize < size) ? oldsize : size);
+	}
 		
 	free(ptr);
 	
@@ -0,0 +1,54 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of Nanvix.
+ * 
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nanvix/syscall.h>
+#include <sys/pstat.h>
+#include <errno.h>
+
+/**
+ * @brief Takes a snapshot of all processes.
+ * 
+ * @param buf Process status array.
+ * @param n   Number of entries in the array.
+ * 
+ * @returns Upon successful completion, the number of existing processes is
+ *          returned, which may be greater than @p n. Upon failure, -1 is
+ *          returned and errno set to indicate the error.
+ */
+int pstat(struct pstat *buf, int n)
+{
+	int ret;
+	
+	__asm__ volatile (
+		"int $0x80"
+		: "=a" (ret)
+		: "0" (NR_pstat),
+		  "b" (buf),
+		  "c" (n)
+	);
+	
+	/* Error. */
+	if (ret < 0)
+	{
+		errno = -ret;
+		return (-1);
+	}
+	
+	return (ret);
+}
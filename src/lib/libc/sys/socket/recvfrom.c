@@ -0,0 +1,50 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of Nanvix.
+ * 
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <sys/socket.h>
+
+/*
+ * Receives a message from a socket.
+ */
+ssize_t recvfrom
+(int fd, void *buf, size_t n, int flags,
+ struct sockaddr *addr, socklen_t *len)
+{
+	ssize_t ret;
+	struct iovec iov;
+	struct msghdr msg;
+	
+	iov.iov_base = buf;
+	iov.iov_len = n;
+	
+	msg.msg_name = addr;
+	msg.msg_namelen = (len != 0) ? *len : 0;
+	msg.msg_iov = &iov;
+	msg.msg_iovlen = 1;
+	msg.msg_control = 0;
+	msg.msg_controllen = 0;
+	msg.msg_flags = 0;
+	
+	ret = recvmsg(fd, &msg, flags);
+	
+	if ((ret >= 0) && (len != 0))
+		*len = msg.msg_namelen;
+	
+	return (ret);
+}
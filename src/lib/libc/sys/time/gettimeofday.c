@@ -0,0 +1,38 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of Nanvix.
+ * 
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <sys/time.h>
+#include <time.h>
+
+/*
+ * Get the date and time.
+ */
+int gettimeofday(struct timeval *tp, void *tzp)
+{
+	struct timespec ts;
+	
+	((void)tzp);
+	
+	clock_gettime(CLOCK_REALTIME, &ts);
+	
+	tp->tv_sec = ts.tv_sec;
+	tp->tv_usec = ts.tv_nsec/1000;
+	
+	return (0);
+}
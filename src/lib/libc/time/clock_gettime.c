@@ -0,0 +1,98 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of Nanvix.
+ * 
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nanvix/clock.h>
+#include <errno.h>
+#include <stdint.h>
+#include <time.h>
+
+/*
+ * Reads the time stamp counter.
+ */
+static inline uint64_t rdtsc(void)
+{
+	uint64_t tsc;
+	
+	__asm__ volatile ("rdtsc" : "=A" (tsc));
+	
+	return (tsc);
+}
+
+/*
+ * Get the time of a clock.
+ * 
+ * The time is read from the shared time page, without entering the kernel:
+ * clock ticks give the coarse time, and the time stamp counter, scaled by
+ * the kernel's calibration, interpolates within the current tick.
+ */
+int clock_gettime(clockid_t clock_id, struct timespec *tp)
+{
+	unsigned seq;            /* Sequence counter.        */
+	unsigned ticks;          /* Ticks since startup.     */
+	unsigned startup;        /* Time at system startup.  */
+	unsigned freq;           /* Clock frequency.         */
+	unsigned mult;           /* Scaled ns per cycle.     */
+	unsigned nsec;           /* Nanoseconds within tick. */
+	unsigned tick;           /* Nanoseconds per tick.    */
+	uint64_t tsc, now;       /* Time stamp counter.      */
+	uint64_t delta;          /* Cycles since last tick.  */
+	const struct timepg *pg; /* Shared time page.        */
+	
+	/* Invalid clock. */
+	if ((clock_id != CLOCK_REALTIME) && (clock_id != CLOCK_MONOTONIC))
+	{
+		errno = EINVAL;
+		return (-1);
+	}
+	
+	pg = (const struct timepg *)TIMEPG_ADDR;
+	
+	/* Take a consistent snapshot. */
+	do
+	{
+		seq = pg->seq;
+		freq = pg->freq;
+		ticks = pg->ticks;
+		startup = pg->startup_time;
+		tsc = pg->tsc;
+		mult = pg->tsc_mult;
+		now = rdtsc();
+	} while ((seq & 1) || (seq != pg->seq));
+	
+	tick = 1000000000/freq;
+	
+	/* Interpolate within current tick. */
+	nsec = 0;
+	if ((mult != 0) && (now > tsc))
+	{
+		delta = now - tsc;
+		if ((delta >> 32) == 0)
+			delta = (delta*mult) >> TIMEPG_SHIFT;
+		
+		/* Do not run into the next tick. */
+		nsec = (delta < tick) ? (unsigned) delta : tick - 1;
+	}
+	
+	tp->tv_sec = ticks/freq;
+	tp->tv_nsec = (ticks%freq)*tick + nsec;
+	if (clock_id == CLOCK_REALTIME)
+		tp->tv_sec += startup;
+	
+	return (0);
+}
@@ -28,11 +28,19 @@ static void *current_brk = (void *)UHEAP_ADDR;
 /*
  * Changes process's breakpoint value.
  */
-void *sbrk(size_t size)
+void *sbrk(ssize_t size)
 {
 	void *old_brk;
 	
-	size = (((size) + (PAGE_SIZE - 1)) & ~(PAGE_SIZE - 1));
+	/* Nothing to be done. */
+	if (size == 0)
+		return (current_brk);
+	
+	/* Round to page boundary. */
+	if (size > 0)
+		size = (((size) + (PAGE_SIZE - 1)) & ~(PAGE_SIZE - 1));
+	else
+		size = -((-size) & ~(PAGE_SIZE - 1));
 	
 	old_brk = current_brk;
 	current_brk = (void *)((unsigned)old_brk + size);
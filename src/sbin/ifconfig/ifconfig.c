@@ -0,0 +1,159 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of Nanvix.
+ * 
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <arpa/inet.h>
+#include <net/if.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stropts.h>
+#include <unistd.h>
+
+/**
+ * @brief Prints an Internet address.
+ */
+static void address(const char *label, in_addr_t addr)
+{
+	struct in_addr in;
+	
+	in.s_addr = addr;
+	printf("  %s %s\n", label, inet_ntoa(in));
+}
+
+/**
+ * @brief Prints a hardware address.
+ */
+static void hwaddr(const unsigned char *mac)
+{
+	const char *digits = "0123456789abcdef";
+	
+	fputs("  hwaddr  ", stdout);
+	for (int i = 0; i < 6; i++)
+	{
+		putchar(digits[mac[i] >> 4]);
+		putchar(digits[mac[i] & 0xf]);
+		putchar((i < 5) ? ':' : '\n');
+	}
+}
+
+/**
+ * @brief Prints traffic counters of the network interface.
+ * 
+ * @returns Zero upon success, and non-zero otherwise.
+ */
+static int counters(void)
+{
+	FILE *fp;      /* Statistics file. */
+	char *s;       /* Working token.   */
+	char line[64]; /* Working line.    */
+	
+	if ((fp = fopen("/proc/net", "r")) == NULL)
+		return (-1);
+	
+	while (fgets(line, sizeof(line), fp) != NULL)
+	{
+		/* Bad line. */
+		if ((s = strchr(line, ':')) == NULL)
+			continue;
+		*s++ = '\0';
+		
+		/* Already printed. */
+		if ((!strcmp(line, "up")) || (!strcmp(line, "addr")) ||
+			(!strcmp(line, "netmask")) || (!strcmp(line, "gateway")))
+			continue;
+		
+		printf("  %s:%s", line, s);
+	}
+	
+	fclose(fp);
+	
+	return (0);
+}
+
+/**
+ * @brief Parses an Internet address.
+ */
+static in_addr_t parse(const char *s)
+{
+	in_addr_t addr;
+	
+	/* Bad address. */
+	if (((addr = inet_addr(s)) == INADDR_BROADCAST) &&
+		(strcmp(s, "255.255.255.255")))
+	{
+		fprintf(stderr, "ifconfig: bad address %s\n", s);
+		exit(EXIT_FAILURE);
+	}
+	
+	return (addr);
+}
+
+/**
+ * @brief Shows or sets the network interface configuration.
+ * 
+ * @details With no arguments, prints the configuration and traffic counters
+ *          of the network interface. Otherwise, sets its address and,
+ *          optionally, its network mask and default gateway.
+ */
+int main(int argc, char **argv)
+{
+	int fd;              /* Socket.        */
+	struct netconf conf; /* Configuration. */
+	
+	if ((fd = socket(AF_INET, SOCK_DGRAM, 0)) < 0)
+	{
+		fprintf(stderr, "ifconfig: cannot create socket\n");
+		return (EXIT_FAILURE);
+	}
+	
+	if (ioctl(fd, SIOCGNETCONF, &conf) < 0)
+	{
+		fprintf(stderr, "ifconfig: cannot get configuration\n");
+		return (EXIT_FAILURE);
+	}
+	
+	/* Set configuration. */
+	if (argc > 1)
+	{
+		conf.addr = parse(argv[1]);
+		if (argc > 2)
+			conf.netmask = parse(argv[2]);
+		if (argc > 3)
+			conf.gateway = parse(argv[3]);
+		
+		if (ioctl(fd, SIOCSNETCONF, &conf) < 0)
+		{
+			fprintf(stderr, "ifconfig: cannot set configuration\n");
+			return (EXIT_FAILURE);
+		}
+	}
+	
+	printf("eth0: %s\n", (conf.flags & IFF_UP) ? "up" : "loopback only");
+	hwaddr(conf.mac);
+	address("inet   ", conf.addr);
+	address("netmask", conf.netmask);
+	address("gateway", conf.gateway);
+	counters();
+	
+	close(fd);
+	
+	return (EXIT_SUCCESS);
+}
@@ -167,6 +167,9 @@ int main(int argc, char **argv)
 	((void)argc);
 	((void)argv);
 	
+	/* Mount process file system. */
+	mount("proc", "/proc", "proc");
+	
 	/* Read init table. */
 	if (inittab_read())
 		goto out;
@@ -0,0 +1,330 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of Nanvix.
+ * 
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/**
+ * @brief Maximum number of sleeping chains.
+ */
+#define NR_CHAINS 64
+
+/**
+ * @brief Maximum number of call sites of a sleeping chain.
+ */
+#define NR_SITES 4
+
+/**
+ * @brief Length of an address.
+ */
+#define ADDR_LEN 11
+
+/**
+ * @brief Sleeping chain statistics.
+ */
+struct chain
+{
+	char addr[ADDR_LEN]; /**< Chain address.             */
+	unsigned nsleeps;    /**< Number of sleeps.          */
+	unsigned nwakeups;   /**< Number of wakeups.         */
+	unsigned nempty;     /**< Wakeups with no sleeper.   */
+	unsigned total;      /**< Total blocked ticks.       */
+	unsigned max;        /**< Maximum blocked ticks.     */
+	unsigned nsites;     /**< Number of call sites.      */
+	
+	/**
+	 * @brief Call sites.
+	 */
+	struct
+	{
+		char addr[ADDR_LEN]; /**< Return address.   */
+		unsigned count;      /**< Number of sleeps. */
+	} sites[NR_SITES];
+};
+
+/**
+ * @brief Sleeping chain statistics snapshot.
+ */
+struct snapshot
+{
+	unsigned evicted;               /**< Evicted chains.      */
+	unsigned nchains;               /**< Number of chains.    */
+	struct chain chains[NR_CHAINS]; /**< Chain statistics.    */
+};
+
+/**
+ * @brief Snapshots taken before and after running a command.
+ */
+static struct snapshot before, after;
+
+/**
+ * @brief Copies an address token.
+ */
+static char *getaddr(char *dest, char *s)
+{
+	unsigned i;
+	
+	for (i = 0; (i < ADDR_LEN - 1) && (s[i] != '\0'); i++)
+	{
+		if ((s[i] == ' ') || (s[i] == ':') || (s[i] == '\n'))
+			break;
+		dest[i] = s[i];
+	}
+	dest[i] = '\0';
+	
+	return (&s[i]);
+}
+
+/**
+ * @brief Reads sleeping chain statistics.
+ * 
+ * @param snap Store location for the statistics.
+ * 
+ * @returns Zero upon success, and non-zero otherwise.
+ */
+static int readstats(struct snapshot *snap)
+{
+	FILE *fp;         /* Statistics file. */
+	char *s;          /* Working token.   */
+	struct chain *c;  /* Working chain.   */
+	char line[192];   /* Working line.    */
+	
+	if ((fp = fopen("/proc/chains", "r")) == NULL)
+		return (-1);
+	
+	snap->evicted = 0;
+	snap->nchains = 0;
+	
+	while (fgets(line, sizeof(line), fp) != NULL)
+	{
+		/* Evicted chains. */
+		if (!strncmp(line, "evicted:", 8))
+		{
+			snap->evicted = strtoul(&line[8], NULL, 10);
+			continue;
+		}
+		
+		/* Too many chains. */
+		if (snap->nchains == NR_CHAINS)
+			break;
+		
+		c = &snap->chains[snap->nchains++];
+		s = getaddr(c->addr, line);
+		c->nsleeps = strtoul(s, &s, 10);
+		c->nwakeups = strtoul(s, &s, 10);
+		c->nempty = strtoul(s, &s, 10);
+		c->total = strtoul(s, &s, 10);
+		c->max = strtoul(s, &s, 10);
+		
+		/* Call sites. */
+		for (c->nsites = 0; c->nsites < NR_SITES; c->nsites++)
+		{
+			if (*s++ != ' ')
+				break;
+			
+			s = getaddr(c->sites[c->nsites].addr, s);
+			if (*s++ != ':')
+				break;
+			c->sites[c->nsites].count = strtoul(s, &s, 10);
+		}
+	}
+	
+	fclose(fp);
+	
+	return (0);
+}
+
+/**
+ * @brief Subtracts a previous snapshot from the current one.
+ */
+static void delta(struct snapshot *curr, const struct snapshot *prev)
+{
+	struct chain *c;       /* Current chain.  */
+	const struct chain *p; /* Previous chain. */
+	
+	curr->evicted -= prev->evicted;
+	
+	for (unsigned i = 0; i < curr->nchains; i++)
+	{
+		c = &curr->chains[i];
+		
+		for (unsigned j = 0; j < prev->nchains; j++)
+		{
+			p = &prev->chains[j];
+			
+			/* Not this chain. */
+			if (strcmp(c->addr, p->addr))
+				continue;
+			
+			/* Evicted and tracked again in the meantime. */
+			if ((c->nsleeps < p->nsleeps) || (c->nwakeups < p->nwakeups))
+				break;
+			
+			c->nsleeps -= p->nsleeps;
+			c->nwakeups -= p->nwakeups;
+			c->nempty -= p->nempty;
+			c->total -= p->total;
+			
+			for (unsigned k = 0; k < c->nsites; k++)
+			{
+				for (unsigned l = 0; l < p->nsites; l++)
+				{
+					if (!strcmp(c->sites[k].addr, p->sites[l].addr) &&
+						(c->sites[k].count >= p->sites[l].count))
+						c->sites[k].count -= p->sites[l].count;
+				}
+			}
+			
+			break;
+		}
+	}
+}
+
+/**
+ * @brief Prints a left aligned column.
+ */
+static void column(const char *s, int width)
+{
+	fputs(s, stdout);
+	for (int i = strlen(s); i < width; i++)
+		putchar(' ');
+}
+
+/**
+ * @brief Prints a left aligned numeric column.
+ */
+static void ncolumn(unsigned n, int width)
+{
+	int i;
+	char buf[12];
+	
+	i = sizeof(buf) - 1;
+	buf[i] = '\0';
+	do
+	{
+		buf[--i] = '0' + n%10;
+		n /= 10;
+	} while (n > 0);
+	
+	column(&buf[i], width);
+}
+
+/**
+ * @brief Prints sleeping chain statistics.
+ */
+static void report(const struct snapshot *snap)
+{
+	const struct chain *c;
+	
+	printf("CHAIN      SLEEPS WAKEUPS EMPTY  TICKS  MAX    CALL SITES\n");
+	
+	for (unsigned i = 0; i < snap->nchains; i++)
+	{
+		c = &snap->chains[i];
+		
+		/* Nothing happened. */
+		if ((c->nsleeps == 0) && (c->nwakeups == 0))
+			continue;
+		
+		column(c->addr, 11);
+		ncolumn(c->nsleeps, 7);
+		ncolumn(c->nwakeups, 8);
+		ncolumn(c->nempty, 7);
+		ncolumn(c->total, 7);
+		ncolumn(c->max, 7);
+		
+		for (unsigned j = 0; j < c->nsites; j++)
+		{
+			if (c->sites[j].count > 0)
+				printf("%s:%d ", c->sites[j].addr, c->sites[j].count);
+		}
+		putchar('\n');
+	}
+	
+	/* Statistics table is saturated. */
+	if (snap->evicted > 0)
+	{
+		printf("statistics table saturated: %d chains evicted, "
+			"their statistics are incomplete\n", snap->evicted);
+	}
+}
+
+/**
+ * @brief Reports sleeping chain contention.
+ * 
+ * @details Prints, for each sleeping chain, the number of sleeps, wakeups and
+ *          wakeups that found no sleeping process, the total and maximum
+ *          blocked ticks, and the call sites that have slept in it. Chain and
+ *          call site addresses can be matched against the kernel symbol table.
+ *          If a command is given, only contention that happened while the
+ *          command was running is reported. Otherwise, statistics since system
+ *          startup are reported.
+ */
+int main(int argc, char **argv)
+{
+	pid_t pid;
+	
+	/* Report since system startup. */
+	if (argc < 2)
+	{
+		if (readstats(&after))
+		{
+			fprintf(stderr, "lockstat: cannot read /proc/chains\n");
+			return (EXIT_FAILURE);
+		}
+		
+		report(&after);
+		return (EXIT_SUCCESS);
+	}
+	
+	if (readstats(&before))
+	{
+		fprintf(stderr, "lockstat: cannot read /proc/chains\n");
+		return (EXIT_FAILURE);
+	}
+	
+	/* Run command. */
+	if ((pid = fork()) < 0)
+	{
+		fprintf(stderr, "lockstat: cannot fork\n");
+		return (EXIT_FAILURE);
+	}
+	else if (pid == 0)
+	{
+		execve(argv[1], &argv[1], (char *const *)environ);
+		fprintf(stderr, "lockstat: cannot execute %s\n", argv[1]);
+		_exit(EXIT_FAILURE);
+	}
+	wait(NULL);
+	
+	if (readstats(&after))
+	{
+		fprintf(stderr, "lockstat: cannot read /proc/chains\n");
+		return (EXIT_FAILURE);
+	}
+	
+	delta(&after, &before);
+	report(&after);
+	
+	return (EXIT_SUCCESS);
+}
@@ -0,0 +1,301 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of Nanvix.
+ * 
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * @brief Default port.
+ */
+#define NETPERF_PORT 7777
+
+/**
+ * @brief Largest datagram.
+ */
+#define NETPERF_MAX 1472
+
+/**
+ * @brief Seconds to wait for a reply before counting it as lost.
+ */
+#define NETPERF_TIMEOUT 2
+
+/**
+ * @brief Marker of datagrams that should not be echoed.
+ */
+#define NETPERF_NOECHO 'n'
+
+/**
+ * @brief Working buffer.
+ */
+static char buf[NETPERF_MAX];
+
+/**
+ * @brief Alarm handler.
+ */
+static void timeout(int sig)
+{
+	((void)sig);
+}
+
+/**
+ * @brief Returns the current time in milliseconds.
+ */
+static unsigned now(void)
+{
+	struct timespec ts;
+	
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	
+	return (ts.tv_sec*1000 + ts.tv_nsec/1000000);
+}
+
+/**
+ * @brief Prints program usage and exits.
+ */
+static void usage(void)
+{
+	printf("Usage: netperf -s [port]\n");
+	printf("       netperf [-b] addr [port [size [count]]]\n\n");
+	printf("Measures UDP latency and bandwidth against a netperf server.\n\n");
+	printf("Options:\n");
+	printf("  -s Run as a server\n");
+	printf("  -b Send datagrams back to back instead of in request/reply\n");
+	
+	exit(EXIT_SUCCESS);
+}
+
+/**
+ * @brief Echo server.
+ * 
+ * @details Echoes back every datagram to its sender, but those starting with
+ *          NETPERF_NOECHO, which are only counted. An empty datagram asks
+ *          for the number of datagrams counted since the last such request.
+ */
+static int server(in_port_t port)
+{
+	int fd;                  /* Socket.            */
+	ssize_t n;               /* Datagram length.   */
+	uint32_t count;          /* Datagrams counted. */
+	uint32_t reply;          /* Count report.      */
+	socklen_t len;           /* Address length.    */
+	struct sockaddr_in addr; /* Peer address.      */
+	
+	fd = socket(AF_INET, SOCK_DGRAM, 0);
+	
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons(port);
+	addr.sin_addr.s_addr = htonl(INADDR_ANY);
+	
+	if ((fd < 0) || (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0))
+	{
+		fprintf(stderr, "netperf: cannot bind port %d\n", port);
+		return (EXIT_FAILURE);
+	}
+	
+	printf("netperf: listening on port %d\n", port);
+	
+	count = 0;
+	while (1)
+	{
+		len = sizeof(addr);
+		n = recvfrom(fd, buf, sizeof(buf), 0, (struct sockaddr *)&addr, &len);
+		
+		if (n < 0)
+			continue;
+		
+		/* Report. */
+		if (n == 0)
+		{
+			reply = htonl(count);
+			sendto(fd, &reply, sizeof(reply), 0, (struct sockaddr *)&addr, len);
+			count = 0;
+			continue;
+		}
+		
+		count++;
+		
+		if (buf[0] != NETPERF_NOECHO)
+			sendto(fd, buf, n, 0, (struct sockaddr *)&addr, len);
+	}
+	
+	return (EXIT_SUCCESS);
+}
+
+/**
+ * @brief Request/reply benchmark.
+ * 
+ * @details Sends one datagram at a time and waits for its echo. Replies that
+ *          do not arrive within NETPERF_TIMEOUT seconds are counted as lost.
+ */
+static void pingpong(int fd, size_t size, unsigned count)
+{
+	ssize_t n;        /* Reply length. */
+	unsigned ok;      /* Round trips.  */
+	unsigned start;   /* Start time.   */
+	unsigned elapsed; /* Elapsed time. */
+	
+	memset(buf, 'x', size);
+	
+	ok = 0;
+	start = now();
+	for (unsigned i = 0; i < count; i++)
+	{
+		if (send(fd, buf, size, 0) < 0)
+			continue;
+		
+		alarm(NETPERF_TIMEOUT);
+		n = recv(fd, buf, size, 0);
+		alarm(0);
+		
+		if (n == (ssize_t)size)
+			ok++;
+	}
+	elapsed = now() - start;
+	if (elapsed == 0)
+		elapsed = 1;
+	
+	printf("  Round trips: %d of %d\n", ok, count);
+	printf("  Elapsed:     %d ms\n", elapsed);
+	printf("  Rate:        %d round trips/s\n", (ok*1000)/elapsed);
+	printf("  Latency:     %d us\n", ok ? (elapsed*1000)/ok : 0);
+	printf("  Bandwidth:   %d kB/s\n", (2*size*ok)/elapsed);
+}
+
+/**
+ * @brief Back to back benchmark.
+ * 
+ * @details Sends datagrams as fast as possible without waiting for replies,
+ *          and then asks the server how many of them have arrived.
+ */
+static void blast(int fd, size_t size, unsigned count)
+{
+	ssize_t n;        /* Reply length. */
+	unsigned sent;    /* Sent.         */
+	uint32_t got;     /* Received.     */
+	unsigned start;   /* Start time.   */
+	unsigned elapsed; /* Elapsed time. */
+	
+	memset(buf, 'x', size);
+	buf[0] = NETPERF_NOECHO;
+	
+	/* Reset server counter. */
+	send(fd, buf, 0, 0);
+	alarm(NETPERF_TIMEOUT);
+	recv(fd, &got, sizeof(got), 0);
+	alarm(0);
+	
+	sent = 0;
+	start = now();
+	for (unsigned i = 0; i < count; i++)
+	{
+		if (send(fd, buf, size, 0) == (ssize_t)size)
+			sent++;
+	}
+	elapsed = now() - start;
+	if (elapsed == 0)
+		elapsed = 1;
+	
+	/* Ask server. */
+	send(fd, buf, 0, 0);
+	alarm(NETPERF_TIMEOUT);
+	n = recv(fd, &got, sizeof(got), 0);
+	alarm(0);
+	got = (n == sizeof(got)) ? ntohl(got) : 0;
+	
+	printf("  Sent:        %d of %d\n", sent, count);
+	printf("  Elapsed:     %d ms\n", elapsed);
+	printf("  Rate:        %d datagrams/s\n", (sent*1000)/elapsed);
+	printf("  Bandwidth:   %d kB/s\n", (size*sent)/elapsed);
+	printf("  Received:    %d\n", got);
+	printf("  Lost:        %d\n", (got < sent) ? sent - got : 0);
+}
+
+/**
+ * @brief Measures UDP performance.
+ */
+int main(int argc, char **argv)
+{
+	int fd;                  /* Socket.              */
+	int i;                   /* Argument index.      */
+	int back;                /* Back to back?        */
+	in_port_t port;          /* Server port.         */
+	size_t size;             /* Datagram size.       */
+	unsigned count;          /* Number of datagrams. */
+	struct sockaddr_in addr; /* Server address.      */
+	
+	if (argc < 2)
+		usage();
+	
+	/* Server. */
+	if (!strcmp(argv[1], "-s"))
+		return (server((argc > 2) ? atoi(argv[2]) : NETPERF_PORT));
+	
+	back = 0;
+	i = 1;
+	if (!strcmp(argv[i], "-b"))
+	{
+		back = 1;
+		if (++i == argc)
+			usage();
+	}
+	
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = inet_addr(argv[i]);
+	port = (argc > i + 1) ? atoi(argv[i + 1]) : NETPERF_PORT;
+	addr.sin_port = htons(port);
+	size = (argc > i + 2) ? (size_t)atoi(argv[i + 2]) : 64;
+	count = (argc > i + 3) ? (unsigned)atoi(argv[i + 3]) : 1000;
+	
+	/* Bad size. */
+	if ((size < 1) || (size > NETPERF_MAX))
+	{
+		fprintf(stderr, "netperf: size must be between 1 and %d\n", NETPERF_MAX);
+		return (EXIT_FAILURE);
+	}
+	
+	signal(SIGALRM, timeout);
+	
+	fd = socket(AF_INET, SOCK_DGRAM, 0);
+	if ((fd < 0) || (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0))
+	{
+		fprintf(stderr, "netperf: cannot reach %s\n", argv[i]);
+		return (EXIT_FAILURE);
+	}
+	
+	printf("netperf: %s port %d, %d x %d bytes\n", argv[i], port, count, size);
+	
+	if (back)
+		blast(fd, size, count);
+	else
+		pingpong(fd, size, count);
+	
+	close(fd);
+	
+	return (EXIT_SUCCESS);
+}
@@ -0,0 +1,235 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of Nanvix.
+ * 
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Number of histogram buckets.
+ */
+#define NR_BUCKETS 20
+
+/**
+ * @brief Width of histogram bars.
+ */
+#define BAR_WIDTH 40
+
+/**
+ * @brief Histogram.
+ */
+struct hist
+{
+	const char *name;             /**< Name.                 */
+	const char *title;            /**< Title.                */
+	int log2;                     /**< Logarithmic buckets?  */
+	int found;                    /**< Read?                 */
+	unsigned buckets[NR_BUCKETS]; /**< Buckets.              */
+};
+
+/**
+ * @brief Histograms.
+ */
+static struct hist hists[] = {
+	{ "delay", "Time ready before running (us)", 1, 0, {0, } },
+	{ "slice", "Time run per time slice (us)",   1, 0, {0, } },
+	{ "runq",  "Run queue length",               0, 0, {0, } },
+	{ NULL,    NULL,                             0, 0, {0, } }
+};
+
+/**
+ * @brief Reads histograms.
+ * 
+ * @param path Histograms file.
+ * 
+ * @returns Zero upon success, and non-zero otherwise.
+ */
+static int readhists(const char *path)
+{
+	FILE *fp;       /* Histograms file. */
+	char *s;        /* Working token.   */
+	char line[256]; /* Working line.    */
+	
+	if ((fp = fopen(path, "r")) == NULL)
+		return (-1);
+	
+	while (fgets(line, sizeof(line), fp) != NULL)
+	{
+		/* Bad line. */
+		if ((s = strchr(line, ':')) == NULL)
+			continue;
+		*s++ = '\0';
+		
+		for (int i = 0; hists[i].name != NULL; i++)
+		{
+			/* Not this histogram. */
+			if (strcmp(line, hists[i].name))
+				continue;
+			
+			for (int j = 0; j < NR_BUCKETS; j++)
+				hists[i].buckets[j] = strtoul(s, &s, 10);
+			hists[i].found = 1;
+		}
+	}
+	
+	fclose(fp);
+	
+	return (0);
+}
+
+/**
+ * @brief Prints a right aligned number.
+ */
+static void number(unsigned n, int width)
+{
+	int i;
+	char buf[12];
+	
+	i = sizeof(buf) - 1;
+	buf[i] = '\0';
+	do
+	{
+		buf[--i] = '0' + n%10;
+		n /= 10;
+	} while (n > 0);
+	
+	for (int j = strlen(&buf[i]); j < width; j++)
+		putchar(' ');
+	fputs(&buf[i], stdout);
+}
+
+/**
+ * @brief Gets the upper bound of a histogram bucket.
+ */
+static unsigned bound(const struct hist *h, int i)
+{
+	return ((h->log2) ? (1U << i) : (unsigned)i);
+}
+
+/**
+ * @brief Prints a histogram.
+ * 
+ * @details Prints one row for each non-empty bucket, followed by the buckets
+ *          where the 50th, 90th and 99th percentiles fall.
+ */
+static void report(const struct hist *h)
+{
+	unsigned n;   /* Number of samples. */
+	unsigned max; /* Largest bucket.    */
+	unsigned sum; /* Running sum.       */
+	int p50, p90, p99;
+	
+	n = max = 0;
+	for (int i = 0; i < NR_BUCKETS; i++)
+	{
+		n += h->buckets[i];
+		if (h->buckets[i] > max)
+			max = h->buckets[i];
+	}
+	
+	printf("%s, %d samples\n", h->title, n);
+	
+	/* Nothing to report. */
+	if (n == 0)
+		return;
+	
+	for (int i = 0; i < NR_BUCKETS; i++)
+	{
+		/* Empty bucket. */
+		if (h->buckets[i] == 0)
+			continue;
+		
+		if (i == NR_BUCKETS - 1)
+		{
+			fputs(" >=", stdout);
+			number((h->log2) ? bound(h, i - 1) : bound(h, i), 8);
+		}
+		else
+		{
+			fputs((h->log2) ? "  <" : "   ", stdout);
+			number(bound(h, i), 8);
+		}
+		number(h->buckets[i], 10);
+		putchar(' ');
+		for (unsigned j = 0; j < (h->buckets[i]*BAR_WIDTH + max - 1)/max; j++)
+			putchar('#');
+		putchar('\n');
+	}
+	
+	/* Percentiles. */
+	p50 = p90 = p99 = -1;
+	sum = 0;
+	for (int i = 0; i < NR_BUCKETS; i++)
+	{
+		sum += h->buckets[i];
+		if ((p50 < 0) && (sum*2 >= n))
+			p50 = i;
+		if ((p90 < 0) && (sum*10 >= n*9))
+			p90 = i;
+		if ((p99 < 0) && (sum*100 >= n*99))
+			p99 = i;
+	}
+	
+	printf("  p50 %s%d p90 %s%d p99 %s%d\n\n",
+		(h->log2) ? "<" : "<=", bound(h, p50),
+		(h->log2) ? "<" : "<=", bound(h, p90),
+		(h->log2) ? "<" : "<=", bound(h, p99));
+}
+
+/**
+ * @brief Reports scheduling latency.
+ * 
+ * @details Prints histograms of the time that processes have been ready
+ *          before running, of the time that they have run in a time slice, and
+ *          of the run queue length, with their tail percentiles. If a process
+ *          ID is given, only the histograms of that process are printed.
+ */
+int main(int argc, char **argv)
+{
+	char path[32]; /* Histograms file. */
+	
+	strcpy(path, "/proc/");
+	if (argc > 1)
+	{
+		/* Bad process ID. */
+		if (strlen(argv[1]) > 10)
+		{
+			fprintf(stderr, "schedstat: bad process ID %s\n", argv[1]);
+			return (EXIT_FAILURE);
+		}
+		
+		strcat(path, argv[1]);
+		strcat(path, "/");
+	}
+	strcat(path, "latency");
+	
+	if (readhists(path))
+	{
+		fprintf(stderr, "schedstat: cannot read %s\n", path);
+		return (EXIT_FAILURE);
+	}
+	
+	for (int i = 0; hists[i].name != NULL; i++)
+	{
+		if (hists[i].found)
+			report(&hists[i]);
+	}
+	
+	return (EXIT_SUCCESS);
+}
@@ -17,16 +17,31 @@
  * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 
 /**
  * @brief Shutdowns the system.
+ * 
+ * @details With the -z option, the system is hibernated instead, and this
+ *          program returns once it is resumed. Any other invocation,
+ *          including the conventional -h, shuts the system down.
  */
 int main(int argc, char **argv)
 {
-	((void)argc);
-	((void)argv);
+	/* Hibernate. */
+	if ((argc > 1) && (!strcmp(argv[1], "-z")))
+	{
+		if (hibernate() < 0)
+		{
+			fprintf(stderr, "shutdown: cannot hibernate\n");
+			return (EXIT_FAILURE);
+		}
+		
+		return (EXIT_SUCCESS);
+	}
 	
 	shutdown();
 	
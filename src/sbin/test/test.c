@@ -19,15 +19,27 @@
  */
 
 #include <assert.h>
+#include <errno.h>
+#include <nanvix/clock.h>
 #include <nanvix/config.h>
+#include <sys/pstat.h>
 #include <sys/times.h>
 #include <sys/wait.h>
 #include <sys/sem.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/time.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <mqueue.h>
 #include <stdio.h>
 #include <signal.h>
 #include <stdlib.h>
 #include <unistd.h>
 #include <string.h>
+#include <time.h>
 
 /* Test flags. */
 #define EXTENDED (1 << 0)
@@ -164,9 +176,1967 @@ static int io_test(void)
 	
 	/* Print timing statistics. */
 	if (flags & VERBOSE)
+	{
+		printf("  Elapsed: %d\n", t1 - t0);
+		if (t1 > t0)
+		{
+			printf("  Throughput: %d KB/s\n",
+				((MEMORY_SIZE >> 10)*CLOCK_FREQ)/(t1 - t0));
+		}
+	}
+	
+	return (0);
+}
+
+/*============================================================================*
+ *                                 fsync_test                                 *
+ *============================================================================*/
+
+/**
+ * @brief Runs a small-transaction workload.
+ * 
+ * @details Dirties a large unrelated file and then appends small records to a
+ *          log file, forcing each record to disk.
+ * 
+ * @param usefsync Use fsync() instead of sync()?
+ * 
+ * @returns The elapsed time, or a negative number upon failure.
+ */
+static clock_t fsync_work(int usefsync)
+{
+	#define FSYNC_NRECORDS 64         /* Number of records.             */
+	#define FSYNC_RECORD   64         /* Record size (in bytes).        */
+	#define FSYNC_DIRTY    (256*1024) /* Unrelated dirty data (bytes).  */
+	int fd;                           /* File descriptor.               */
+	struct tms timing;                /* Timing information.            */
+	clock_t t0, t1;                   /* Elapsed times.                 */
+	char *buffer;                     /* Buffer.                        */
+	
+	/* Allocate buffer. */
+	if ((buffer = malloc(FSYNC_DIRTY)) == NULL)
+		return (-1);
+	memset(buffer, 1, FSYNC_DIRTY);
+	
+	/* Dirty unrelated blocks. */
+	fd = open("fsync_dirty", O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+	if (fd < 0)
+		goto error0;
+	if (write(fd, buffer, FSYNC_DIRTY) != FSYNC_DIRTY)
+		goto error1;
+	close(fd);
+	
+	fd = open("fsync_log", O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+	if (fd < 0)
+		goto error0;
+	
+	t0 = times(&timing);
+	
+	/* Append records. */
+	for (int i = 0; i < FSYNC_NRECORDS; i++)
+	{
+		if (write(fd, buffer, FSYNC_RECORD) != FSYNC_RECORD)
+			goto error1;
+		
+		if (usefsync)
+		{
+			if (fsync(fd) < 0)
+				goto error1;
+		}
+		else
+			sync();
+	}
+	
+	t1 = times(&timing);
+	
+	/* House keeping. */
+	close(fd);
+	unlink("fsync_log");
+	unlink("fsync_dirty");
+	free(buffer);
+	
+	return (t1 - t0);
+
+error1:
+	close(fd);
+error0:
+	unlink("fsync_log");
+	unlink("fsync_dirty");
+	free(buffer);
+	return (-1);
+}
+
+/**
+ * @brief File synchronization testing module.
+ * 
+ * @details Runs a small-transaction workload using fsync() and then using
+ *          sync(), to compare them.
+ * 
+ * @returns Zero if passed on test, and non-zero otherwise.
+ */
+static int fsync_test(void)
+{
+	clock_t t0, t1; /* Elapsed times. */
+	
+	if ((t0 = fsync_work(1)) < 0)
+		return (-1);
+	if ((t1 = fsync_work(0)) < 0)
+		return (-1);
+	
+	/* Print timing statistics. */
+	if (flags & VERBOSE)
+	{
+		printf("  Elapsed (fsync): %d\n", t0);
+		printf("  Elapsed (sync):  %d\n", t1);
+	}
+	
+	return (0);
+}
+
+/*============================================================================*
+ *                                  rm_test                                   *
+ *============================================================================*/
+
+/**
+ * @brief File removal testing module.
+ * 
+ * @details Creates some large files and then removes them, measuring the time
+ *          spent to unlink all of them.
+ * 
+ * @returns Zero if passed on test, and non-zero otherwise.
+ */
+static int rm_test(void)
+{
+	#define RM_NFILES  8           /* Number of files.        */
+	#define RM_SIZE    (512*1024)  /* File size (in bytes).   */
+	#define RM_CHUNK   (16*1024)   /* Write size (in bytes).  */
+	int fd;                        /* File descriptor.        */
+	struct tms timing;             /* Timing information.     */
+	clock_t t0, t1;                /* Elapsed times.          */
+	char *buffer;                  /* Buffer.                 */
+	char filename[] = "rm_test0";  /* File name.              */
+	
+	/* Allocate buffer. */
+	if ((buffer = malloc(RM_CHUNK)) == NULL)
+		return (-1);
+	memset(buffer, 1, RM_CHUNK);
+	
+	/* Create files. */
+	for (int i = 0; i < RM_NFILES; i++)
+	{
+		filename[7] = '0' + i;
+		
+		fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+		if (fd < 0)
+			goto error0;
+		
+		for (int j = 0; j < RM_SIZE; j += RM_CHUNK)
+		{
+			if (write(fd, buffer, RM_CHUNK) != RM_CHUNK)
+			{
+				close(fd);
+				goto error0;
+			}
+		}
+		
+		close(fd);
+	}
+	
+	t0 = times(&timing);
+	
+	/* Remove files. */
+	for (int i = 0; i < RM_NFILES; i++)
+	{
+		filename[7] = '0' + i;
+		
+		if (unlink(filename) < 0)
+			goto error0;
+	}
+	
+	t1 = times(&timing);
+	
+	/* House keeping. */
+	free(buffer);
+	
+	/* Print timing statistics. */
+	if (flags & VERBOSE)
+		printf("  Elapsed: %d\n", t1 - t0);
+	
+	return (0);
+
+error0:
+	free(buffer);
+	return (-1);
+}
+
+/*============================================================================*
+ *                                 creat_test                                 *
+ *============================================================================*/
+
+/**
+ * @brief Builds the name of a file of the file creation test.
+ */
+static void creat_name(char *filename, int i)
+{
+	filename[2] = '0' + (i/1000)%10;
+	filename[3] = '0' + (i/100)%10;
+	filename[4] = '0' + (i/10)%10;
+	filename[5] = '0' + i%10;
+}
+
+/**
+ * @brief File creation testing module.
+ * 
+ * @details Creates many empty files in the same directory, measuring the time
+ *          spent, checks that exclusive creation of an existing file fails,
+ *          and then removes them.
+ * 
+ * @returns Zero if passed on test, and non-zero otherwise.
+ */
+static int creat_test(void)
+{
+	#define CREAT_NFILES 5000   /* Number of files.    */
+	int fd;                     /* File descriptor.    */
+	int ret;                    /* Return value.       */
+	int n;                      /* Files created.      */
+	struct tms timing;          /* Timing information. */
+	clock_t t0, t1;             /* Elapsed times.      */
+	char filename[] = "cr0000"; /* File name.          */
+	
+	ret = -1;
+	t1 = 0;
+	
+	t0 = times(&timing);
+	
+	/* Create files. */
+	for (n = 0; n < CREAT_NFILES; n++)
+	{
+		creat_name(filename, n);
+		
+		fd = open(filename, O_WRONLY | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+		if (fd < 0)
+			goto error0;
+		close(fd);
+	}
+	
+	t1 = times(&timing);
+	
+	/* File already exists. */
+	creat_name(filename, CREAT_NFILES/2);
+	fd = open(filename, O_WRONLY | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+	if ((fd >= 0) || (errno != EEXIST))
+		goto error0;
+	
+	ret = 0;
+	
+error0:
+	/* Remove files. */
+	while (n-- > 0)
+	{
+		creat_name(filename, n);
+		
+		if (unlink(filename) < 0)
+			ret = -1;
+	}
+	
+	/* Print timing statistics. */
+	if ((ret == 0) && (flags & VERBOSE))
+	{
+		printf("  Elapsed: %d\n", t1 - t0);
+		printf("  Files: %d\n", CREAT_NFILES);
+	}
+	
+	return (ret);
+}
+
+/*============================================================================*
+ *                                  cwd_test                                  *
+ *============================================================================*/
+
+/**
+ * @brief Changes the working directory and checks its path name.
+ * 
+ * @param path     Directory to change to.
+ * @param expected Expected path name of the working directory.
+ * 
+ * @returns Zero upon success, and non-zero otherwise.
+ */
+static int cwd_check(const char *path, const char *expected)
+{
+	char buf[PATH_MAX]; /* Working directory. */
+	
+	if (chdir(path) < 0)
+		return (-1);
+	if (getcwd(buf, sizeof(buf)) == NULL)
+		return (-1);
+	
+	return (strcmp(buf, expected));
+}
+
+/**
+ * @brief Working directory testing module.
+ * 
+ * @details Changes the working directory through absolute and relative path
+ *          names with dot and dot dot entries and checks the path name that
+ *          getcwd() returns, then measures the time spent to get it many
+ *          times in the deepest directory available.
+ * 
+ * @returns Zero if passed on test, and non-zero otherwise.
+ */
+static int cwd_test(void)
+{
+	#define CWD_CALLS 10000  /* Number of calls.    */
+	int ret;                 /* Return value.       */
+	struct tms timing;       /* Timing information. */
+	clock_t t0, t1;          /* Elapsed times.      */
+	char buf[8];             /* Small buffer.       */
+	char saved[PATH_MAX];    /* Saved directory.    */
+	char path[PATH_MAX];     /* Working directory.  */
+	
+	if (getcwd(saved, sizeof(saved)) == NULL)
+		return (-1);
+	
+	ret = -1;
+	t0 = t1 = 0;
+	
+	if (cwd_check("/", "/"))
+		goto out;
+	if (cwd_check("/sbin", "/sbin"))
+		goto out;
+	if (cwd_check("../etc/./", "/etc"))
+		goto out;
+	if (cwd_check("//bin/../../../dev", "/dev"))
+		goto out;
+	if (cwd_check("..", "/"))
+		goto out;
+	
+	/* Not a directory. */
+	if ((chdir("/dev/null") == 0) || (errno != ENOTDIR))
+		goto out;
+	
+	/* Buffer too small. */
+	if (cwd_check("/proc/../sbin", "/sbin"))
+		goto out;
+	if ((getcwd(buf, 5) != NULL) || (errno != ERANGE))
+		goto out;
+	
+	t0 = times(&timing);
+	
+	for (int i = 0; i < CWD_CALLS; i++)
+	{
+		if (getcwd(path, sizeof(path)) == NULL)
+			goto out;
+	}
+	
+	t1 = times(&timing);
+	
+	ret = 0;
+
+out:
+	if (chdir(saved) < 0)
+		ret = -1;
+	
+	/* Print timing statistics. */
+	if ((ret == 0) && (flags & VERBOSE))
+	{
+		printf("  Elapsed: %d\n", t1 - t0);
+		printf("  Calls: %d\n", CWD_CALLS);
+	}
+	
+	return (ret);
+}
+
+/*============================================================================*
+ *                                   rw_test                                  *
+ *============================================================================*/
+
+/**
+ * @brief Gets the number of system calls issued by a process.
+ * 
+ * @param st  Process status buffer, with room for PROC_MAX entries.
+ * @param pid Process ID.
+ * 
+ * @returns The number of system calls issued by the process, including the
+ *          one issued by this function if it is the calling process.
+ */
+static unsigned rw_nsyscalls(struct pstat *st, pid_t pid)
+{
+	int n; /* Number of processes. */
+	
+	n = pstat(st, PROC_MAX);
+	for (int i = 0; (i < n) && (i < PROC_MAX); i++)
+	{
+		if (st[i].pid == pid)
+			return (st[i].nsyscalls);
+	}
+	
+	return (0);
+}
+
+/**
+ * @brief Scatter/gather and positional I/O testing module.
+ * 
+ * @details Checks that writev(), readv(), pread() and pwrite() transfer data
+ *          in order, and that positional I/O leaves the file offset alone,
+ *          then writes many records that have a header and a payload, first
+ *          with two write() calls per record and then with a single writev()
+ *          call, measuring the time spent and the system calls issued.
+ * 
+ * @returns Zero if passed on test, and non-zero otherwise.
+ */
+static int rw_test(void)
+{
+	#define RW_NRECORDS 1024              /* Number of records.  */
+	#define RW_HEADER     16              /* Header size.        */
+	#define RW_PAYLOAD   112              /* Payload size.       */
+	int fd;                               /* File descriptor.    */
+	int ret;                              /* Return value.       */
+	int fildes[2];                        /* Pipe.               */
+	struct tms timing;                    /* Timing information. */
+	clock_t t0, t1, t2;                   /* Elapsed times.      */
+	unsigned n0, n1, n2, n3;              /* System calls.       */
+	pid_t pid;                            /* Process ID.         */
+	struct pstat *st;                     /* Process status.     */
+	struct iovec iov[2];                  /* I/O vectors.        */
+	char header[RW_HEADER];               /* Record header.      */
+	char payload[RW_PAYLOAD];             /* Record payload.     */
+	char buf[RW_HEADER + RW_PAYLOAD];     /* Working buffer.     */
+	const char *filename = "rw";          /* File name.          */
+	
+	ret = -1;
+	t0 = t1 = t2 = 0;
+	n0 = n1 = n2 = n3 = 0;
+	
+	memset(header, 'h', RW_HEADER);
+	memset(payload, 'p', RW_PAYLOAD);
+	
+	if ((st = malloc(PROC_MAX*sizeof(struct pstat))) == NULL)
+		return (-1);
+	pid = getpid();
+	
+	fd = open(filename, O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+	if (fd < 0)
+	{
+		free(st);
+		return (-1);
+	}
+	
+	/* Gather write. */
+	iov[0].iov_base = header;
+	iov[0].iov_len = RW_HEADER;
+	iov[1].iov_base = payload;
+	iov[1].iov_len = RW_PAYLOAD;
+	if (writev(fd, iov, 2) != RW_HEADER + RW_PAYLOAD)
+		goto out;
+	
+	/* Scatter read. */
+	if (lseek(fd, 0, SEEK_SET) != 0)
+		goto out;
+	iov[0].iov_base = buf;
+	iov[1].iov_base = buf + RW_HEADER;
+	if (readv(fd, iov, 2) != RW_HEADER + RW_PAYLOAD)
+		goto out;
+	if (memcmp(buf, header, RW_HEADER))
+		goto out;
+	if (memcmp(buf + RW_HEADER, payload, RW_PAYLOAD))
+		goto out;
+	
+	/* Positional I/O does not move the file offset. */
+	if (pwrite(fd, "xyz", 3, 4) != 3)
+		goto out;
+	if (pread(fd, buf, 8, 2) != 8)
+		goto out;
+	if (memcmp(buf, "hhxyzhhh", 8))
+		goto out;
+	if (lseek(fd, 0, SEEK_CUR) != RW_HEADER + RW_PAYLOAD)
+		goto out;
+	
+	/* End of file. */
+	if (pread(fd, buf, 8, RW_HEADER + RW_PAYLOAD) != 0)
+		goto out;
+	
+	/* Bad offset. */
+	if ((pread(fd, buf, 8, -1) >= 0) || (errno != EINVAL))
+		goto out;
+	
+	/* Pipes are not seekable. */
+	if (pipe(fildes) < 0)
+		goto out;
+	iov[0].iov_base = header;
+	iov[1].iov_base = payload;
+	if (writev(fildes[1], iov, 2) != RW_HEADER + RW_PAYLOAD)
+		goto out2;
+	iov[0].iov_base = buf;
+	iov[1].iov_base = buf + RW_HEADER;
+	if (readv(fildes[0], iov, 2) != RW_HEADER + RW_PAYLOAD)
+		goto out2;
+	if (memcmp(buf + RW_HEADER, payload, RW_PAYLOAD))
+		goto out2;
+	if ((pread(fildes[0], buf, 8, 0) >= 0) || (errno != ESPIPE))
+		goto out2;
+	
+	/* Records with two system calls each. */
+	close(fd);
+	fd = open(filename, O_WRONLY | O_TRUNC);
+	if (fd < 0)
+		goto out3;
+	
+	t0 = times(&timing);
+	n0 = rw_nsyscalls(st, pid);
+	
+	for (int i = 0; i < RW_NRECORDS; i++)
+	{
+		if (write(fd, header, RW_HEADER) != RW_HEADER)
+			goto out2;
+		if (write(fd, payload, RW_PAYLOAD) != RW_PAYLOAD)
+			goto out2;
+	}
+	
+	n1 = rw_nsyscalls(st, pid);
+	t1 = times(&timing);
+	
+	/* Records with a single system call each. */
+	iov[0].iov_base = header;
+	iov[1].iov_base = payload;
+	n2 = rw_nsyscalls(st, pid);
+	for (int i = 0; i < RW_NRECORDS; i++)
+	{
+		if (writev(fd, iov, 2) != RW_HEADER + RW_PAYLOAD)
+			goto out2;
+	}
+	
+	n3 = rw_nsyscalls(st, pid);
+	t2 = times(&timing);
+	
+	ret = 0;
+
+out2:
+	close(fildes[0]);
+	close(fildes[1]);
+out:
+	close(fd);
+out3:
+	if (unlink(filename) < 0)
+		ret = -1;
+	free(st);
+	
+	/* Print statistics, not counting the closing pstat() calls. */
+	if ((ret == 0) && (flags & VERBOSE))
+	{
+		printf("  Elapsed (write):  %d\n", t1 - t0);
+		printf("  Elapsed (writev): %d\n", t2 - t1);
+		printf("  System calls:     %d vs %d\n", n1 - n0 - 1, n3 - n2 - 1);
+	}
+	
+	return (ret);
+}
+
+/*============================================================================*
+ *                                sparse_test                                 *
+ *============================================================================*/
+
+/**
+ * @brief Sparse files testing module.
+ * 
+ * @details Creates a 16 MB file by writing only its first and last bytes,
+ *          checks that the hole in between reads as zeros, and then
+ *          truncates and removes the file, measuring the time spent to read
+ *          it all.
+ * 
+ * @returns Zero if passed on test, and non-zero otherwise.
+ */
+static int sparse_test(void)
+{
+	#define SPARSE_SIZE (16*1024*1024) /* File size.          */
+	int fd;                            /* File descriptor.    */
+	int ret;                           /* Return value.       */
+	ssize_t n;                         /* Bytes read.         */
+	off_t off;                         /* File offset.        */
+	struct tms timing;                 /* Timing information. */
+	clock_t t0, t1;                    /* Elapsed times.      */
+	char buf[1024];                    /* Working buffer.     */
+	const char *filename = "sparse";   /* File name.          */
+	
+	ret = -1;
+	t0 = t1 = 0;
+	
+	fd = open(filename, O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+	if (fd < 0)
+		return (-1);
+	
+	/* Write only the edges. */
+	if (write(fd, "head", 4) != 4)
+		goto out;
+	if (pwrite(fd, "tail", 4, SPARSE_SIZE - 4) != 4)
+		goto out;
+	if (lseek(fd, 0, SEEK_END) != SPARSE_SIZE)
+		goto out;
+	
+	/* Hole. */
+	if (pread(fd, buf, sizeof(buf), 64*1024) != sizeof(buf))
+		goto out;
+	for (size_t i = 0; i < sizeof(buf); i++)
+	{
+		if (buf[i] != 0)
+			goto out;
+	}
+	
+	/* Write in the middle of the hole. */
+	if (pwrite(fd, "mid", 3, SPARSE_SIZE/2) != 3)
+		goto out;
+	
+	/* Read it all back. */
+	if (lseek(fd, 0, SEEK_SET) != 0)
+		goto out;
+	
+	t0 = times(&timing);
+	
+	for (off = 0; off < SPARSE_SIZE; off += n)
+	{
+		if ((n = read(fd, buf, sizeof(buf))) != sizeof(buf))
+			goto out;
+		
+		for (ssize_t i = 0; i < n; i++)
+		{
+			char c;
+			
+			/* Expected byte. */
+			if (off + i < 4)
+				c = "head"[off + i];
+			else if (off + i >= SPARSE_SIZE - 4)
+				c = "tail"[off + i - (SPARSE_SIZE - 4)];
+			else if ((off + i >= SPARSE_SIZE/2) && (off + i < SPARSE_SIZE/2 + 3))
+				c = "mid"[off + i - SPARSE_SIZE/2];
+			else
+				c = 0;
+			
+			if (buf[i] != c)
+				goto out;
+		}
+	}
+	
+	t1 = times(&timing);
+	
+	/* End of file. */
+	if (read(fd, buf, sizeof(buf)) != 0)
+		goto out;
+	
+	/* Truncate sparse file. */
+	close(fd);
+	fd = open(filename, O_RDWR | O_TRUNC);
+	if (fd < 0)
+		goto out2;
+	if (lseek(fd, 0, SEEK_END) != 0)
+		goto out;
+	
+	ret = 0;
+
+out:
+	close(fd);
+out2:
+	if (unlink(filename) < 0)
+		ret = -1;
+	
+	/* Print timing statistics. */
+	if ((ret == 0) && (flags & VERBOSE))
+		printf("  Elapsed: %d\n", t1 - t0);
+	
+	return (ret);
+}
+
+/*============================================================================*
+ *                                 small_test                                 *
+ *============================================================================*/
+
+/**
+ * @brief Small files testing module.
+ * 
+ * @details Creates many tiny files, like the ones found in /etc, then reads
+ *          them back and removes them, measuring the time spent. Every other
+ *          file is appended to, so that it grows past inline data.
+ * 
+ * @returns Zero if passed on test, and non-zero otherwise.
+ */
+static int small_test(void)
+{
+	#define SMALL_NFILES 64                /* Number of files.      */
+	#define SMALL_SIZE   12                /* File size (in bytes). */
+	#define SMALL_GROW   40                /* Appended size.        */
+	int fd;                                /* File descriptor.      */
+	size_t size;                           /* Expected file size.   */
+	struct tms timing;                     /* Timing information.   */
+	clock_t t0, t1;                        /* Elapsed times.        */
+	char buffer[SMALL_SIZE + SMALL_GROW];  /* Buffer.               */
+	char data[SMALL_SIZE + SMALL_GROW];    /* Expected data.        */
+	char filename[] = "small00";           /* File name.            */
+	
+	for (int i = 0; i < SMALL_SIZE + SMALL_GROW; i++)
+		data[i] = 'a' + i%26;
+	
+	t0 = times(&timing);
+	
+	/* Create files. */
+	for (int i = 0; i < SMALL_NFILES; i++)
+	{
+		filename[5] = '0' + i/10;
+		filename[6] = '0' + i%10;
+		
+		fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+		if (fd < 0)
+			return (-1);
+		
+		if (write(fd, data, SMALL_SIZE) != SMALL_SIZE)
+			goto error0;
+		
+		/* Grow file. */
+		if (i & 1)
+		{
+			if (write(fd, &data[SMALL_SIZE], SMALL_GROW) != SMALL_GROW)
+				goto error0;
+		}
+		
+		close(fd);
+	}
+	
+	/* Read files back. */
+	for (int i = 0; i < SMALL_NFILES; i++)
+	{
+		filename[5] = '0' + i/10;
+		filename[6] = '0' + i%10;
+		size = (i & 1) ? SMALL_SIZE + SMALL_GROW : SMALL_SIZE;
+		
+		fd = open(filename, O_RDONLY);
+		if (fd < 0)
+			return (-1);
+		
+		if ((size_t)read(fd, buffer, sizeof(buffer)) != size)
+			goto error0;
+		if (memcmp(buffer, data, size))
+			goto error0;
+		
+		close(fd);
+	}
+	
+	/* Remove files. */
+	for (int i = 0; i < SMALL_NFILES; i++)
+	{
+		filename[5] = '0' + i/10;
+		filename[6] = '0' + i%10;
+		
+		if (unlink(filename) < 0)
+			return (-1);
+	}
+	
+	t1 = times(&timing);
+	
+	/* Print timing statistics. */
+	if (flags & VERBOSE)
+		printf("  Elapsed: %d\n", t1 - t0);
+	
+	return (0);
+
+error0:
+	close(fd);
+	return (-1);
+}
+
+/*============================================================================*
+ *                                 madv_test                                  *
+ *============================================================================*/
+
+#define MADV_PAGE     4096       /* Page size (in bytes).             */
+#define MADV_SIZE     (128*1024) /* Size of buffers (in bytes).       */
+#define MADV_FILL     (8*4096)   /* Size of demand fill buffer.       */
+#define MADV_PRESSURE 0x1000000  /* Memory pressure (in bytes).       */
+
+/**
+ * @brief Rounds up an address to the next page boundary.
+ */
+#define MADV_ALIGN(x) \
+	((char *)(((unsigned)(x) + MADV_PAGE - 1) & ~(MADV_PAGE - 1)))
+
+/**
+ * @brief Demand fill buffer.
+ * 
+ * @details The buffer is initialized, so it lives in the executable file. It
+ *          is kept small, so that the file still fits in the initrd, but it
+ *          spans enough pages for read-ahead to make a difference.
+ */
+static char madv_data[MADV_FILL + MADV_PAGE] = { 1 };
+
+/**
+ * @brief Scans a demand fill buffer.
+ * 
+ * @details Dirties and drops the pages of a buffer that is backed by the
+ *          executable file, gives some advice on them and then touches every
+ *          page, checking that it has been loaded again from the file.
+ * 
+ * @param advice Advice.
+ * 
+ * @returns The elapsed time, or a negative number upon failure.
+ */
+static clock_t madv_scan(int advice)
+{
+	char *p;           /* Buffer.             */
+	struct tms timing; /* Timing information. */
+	clock_t t0, t1;    /* Elapsed times.      */
+	
+	p = MADV_ALIGN(madv_data);
+	
+	/* Dirty all pages. */
+	for (int i = 0; i < MADV_FILL; i += MADV_PAGE)
+		p[i] = 2;
+	
+	if (madvise(p, MADV_FILL, MADV_DONTNEED) < 0)
+		return (-1);
+	
+	t0 = times(&timing);
+	
+	if (madvise(p, MADV_FILL, advice) < 0)
+		return (-1);
+	
+	/* Touch all pages. */
+	for (int i = 0; i < MADV_FILL; i += MADV_PAGE)
+	{
+		if (p[i] == 2)
+			goto error0;
+	}
+	
+	t1 = times(&timing);
+	
+	madvise(p, MADV_FILL, MADV_NORMAL);
+	
+	return (t1 - t0);
+
+error0:
+	madvise(p, MADV_FILL, MADV_NORMAL);
+	return (-1);
+}
+
+/**
+ * @brief Touches a buffer after memory pressure.
+ * 
+ * @details Fills an anonymous buffer, optionally locks it, and then fills
+ *          a larger buffer so that pages get swapped out. Finally, the
+ *          first buffer is touched again.
+ * 
+ * @param lock Lock buffer in memory?
+ * 
+ * @returns The elapsed time, or a negative number upon failure.
+ */
+static clock_t madv_pressure(int lock)
+{
+	char *p, *q;       /* Buffers.            */
+	char *buf;         /* Locked buffer.      */
+	struct tms timing; /* Timing information. */
+	clock_t t0, t1;    /* Elapsed times.      */
+	
+	if ((buf = malloc(MADV_SIZE + MADV_PAGE)) == NULL)
+		goto error0;
+	p = MADV_ALIGN(buf);
+	memset(p, 1, MADV_SIZE);
+	
+	if ((lock) && (mlock(p, MADV_SIZE) < 0))
+		goto error1;
+	
+	/* Apply memory pressure. */
+	if ((q = malloc(MADV_PRESSURE)) == NULL)
+		goto error2;
+	for (int i = 0; i < MADV_PRESSURE; i += MADV_PAGE)
+		q[i] = 1;
+	
+	t0 = times(&timing);
+	
+	/* Touch all pages. */
+	for (int i = 0; i < MADV_SIZE; i += MADV_PAGE)
+	{
+		if (p[i] != 1)
+			goto error3;
+	}
+	
+	t1 = times(&timing);
+	
+	/* House keeping. */
+	free(q);
+	if (lock)
+		munlock(p, MADV_SIZE);
+	free(buf);
+	
+	return (t1 - t0);
+
+error3:
+	free(q);
+error2:
+	if (lock)
+		munlock(p, MADV_SIZE);
+error1:
+	free(buf);
+error0:
+	return (-1);
+}
+
+/**
+ * @brief Paging hints testing module.
+ * 
+ * @details Scans a demand fill buffer with each access pattern advice, and
+ *          touches a buffer after memory pressure with and without locking
+ *          it in memory, to compare them.
+ * 
+ * @returns Zero if passed on test, and non-zero otherwise.
+ */
+static int madv_test(void)
+{
+	clock_t t[6]; /* Elapsed times. */
+	
+	if ((t[0] = madv_scan(MADV_NORMAL)) < 0)
+		return (-1);
+	if ((t[1] = madv_scan(MADV_RANDOM)) < 0)
+		return (-1);
+	if ((t[2] = madv_scan(MADV_SEQUENTIAL)) < 0)
+		return (-1);
+	if ((t[3] = madv_scan(MADV_WILLNEED)) < 0)
+		return (-1);
+	if ((t[4] = madv_pressure(0)) < 0)
+		return (-1);
+	if ((t[5] = madv_pressure(1)) < 0)
+		return (-1);
+	
+	/* Print timing statistics. */
+	if (flags & VERBOSE)
+	{
+		printf("  Elapsed (normal):     %d\n", t[0]);
+		printf("  Elapsed (random):     %d\n", t[1]);
+		printf("  Elapsed (sequential): %d\n", t[2]);
+		printf("  Elapsed (willneed):   %d\n", t[3]);
+		printf("  Elapsed (unlocked):   %d\n", t[4]);
+		printf("  Elapsed (locked):     %d\n", t[5]);
+	}
+	
+	return (0);
+}
+
+/*============================================================================*
+ *                                 heap_test                                  *
+ *============================================================================*/
+
+/**
+ * @brief Heap testing module.
+ * 
+ * @details Allocates and frees many objects of random sizes, some of them
+ *          large, checking their contents and tracking the heap breakpoint.
+ * 
+ * @returns Zero if passed on test, and non-zero otherwise.
+ */
+static int heap_test(void)
+{
+	#define HEAP_NOBJECTS 256         /* Number of objects.            */
+	#define HEAP_NROUNDS  8192        /* Number of rounds.             */
+	#define HEAP_LARGE    (64*1024)   /* Maximum large object size.    */
+	char *objs[HEAP_NOBJECTS];        /* Objects.                      */
+	size_t sizes[HEAP_NOBJECTS];      /* Object sizes.                 */
+	char *brk0, *brk1, *peak;         /* Heap breakpoints.             */
+	struct tms timing;                /* Timing information.           */
+	clock_t t0, t1;                   /* Elapsed times.                */
+	int i;                            /* Object index.                 */
+	
+	memset(objs, 0, sizeof(objs));
+	srand(1);
+	
+	brk0 = peak = sbrk(0);
+	
+	t0 = times(&timing);
+	
+	for (int k = 0; k < HEAP_NROUNDS; k++)
+	{
+		i = rand()%HEAP_NOBJECTS;
+		
+		/* Free object. */
+		if (objs[i] != NULL)
+		{
+			for (size_t j = 0; j < sizes[i]; j += 512)
+			{
+				if (objs[i][j] != (char)i)
+					goto error0;
+			}
+			free(objs[i]);
+			objs[i] = NULL;
+			continue;
+		}
+		
+		/* Allocate object. */
+		sizes[i] = (rand()%8) ? rand()%512 + 1 : rand()%HEAP_LARGE + 1;
+		if ((objs[i] = malloc(sizes[i])) == NULL)
+			goto error0;
+		for (size_t j = 0; j < sizes[i]; j += 512)
+			objs[i][j] = (char)i;
+		
+		if ((char *)sbrk(0) > peak)
+			peak = sbrk(0);
+	}
+	
+	/* House keeping. */
+	for (i = 0; i < HEAP_NOBJECTS; i++)
+		free(objs[i]);
+	
+	t1 = times(&timing);
+	
+	brk1 = sbrk(0);
+	
+	/* Print timing statistics. */
+	if (flags & VERBOSE)
+	{
+		printf("  Elapsed:   %d\n", t1 - t0);
+		printf("  Peak heap: %d KB\n", (peak - brk0) >> 10);
+		printf("  Left heap: %d KB\n", (brk1 - brk0) >> 10);
+	}
+	
+	return (0);
+
+error0:
+	for (i = 0; i < HEAP_NOBJECTS; i++)
+		free(objs[i]);
+	return (-1);
+}
+
+/*============================================================================*
+ *                                swapon_test                                 *
+ *============================================================================*/
+
+/**
+ * @brief Swap areas testing module.
+ * 
+ * @details Runs the swapping test module three times: first swapping to the
+ *          default swap area, which shares the disk with the root file system,
+ *          then swapping to a dedicated swap device with higher priority, and
+ *          finally swapping to a swap file with higher priority.
+ * 
+ * @returns Zero if passed on test, and non-zero otherwise.
+ */
+static int swapon_test(void)
+{
+	#define SWAPON_FILE_SIZE (4*1024*1024) /* Swap file size. */
+	int fd;                                /* File descriptor. */
+	int ret;                               /* Return value.    */
+	char buf[1024];                        /* Working buffer.  */
+	
+	/* Default swap area. */
+	if (flags & VERBOSE)
+		printf("  Default swap area\n");
+	if (swap_test())
+		return (-1);
+	
+	/* Dedicated swap device. */
+	if (swapon("/dev/swp", 1) < 0)
+		return (-1);
+	if (flags & VERBOSE)
+		printf("  Dedicated swap device\n");
+	ret = swap_test();
+	
+	/* House keeping. */
+	if (swapoff("/dev/swp") < 0)
+		return (-1);
+	if (ret)
+		return (ret);
+	
+	ret = -1;
+	
+	/* Swap files cannot have holes. */
+	fd = open("swapfile", O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+	if (fd < 0)
+		return (-1);
+	memset(buf, 0, sizeof(buf));
+	for (int i = 0; i < SWAPON_FILE_SIZE; i += sizeof(buf))
+	{
+		if (write(fd, buf, sizeof(buf)) != sizeof(buf))
+		{
+			close(fd);
+			goto out;
+		}
+	}
+	close(fd);
+	
+	/* Swap file. */
+	if (swapon("swapfile", 2) < 0)
+		goto out;
+	if (flags & VERBOSE)
+		printf("  Swap file\n");
+	ret = swap_test();
+	
+	/* House keeping. */
+	if (swapoff("swapfile") < 0)
+		ret = -1;
+
+out:
+	if (unlink("swapfile") < 0)
+		ret = -1;
+	
+	return (ret);
+}
+
+/*============================================================================*
+ *                                  oom_test                                  *
+ *============================================================================*/
+
+/**
+ * @brief Size of memory chunks allocated by the memory hog (in bytes).
+ */
+#define OOM_CHUNK (1024*1024)
+
+/**
+ * @brief Out of memory testing module.
+ * 
+ * @details Runs a memory hog next to an idle service process. The memory hog
+ *          touches memory until the system runs out of it. The memory hog
+ *          should then be killed, while the service process and the testing
+ *          process itself survive.
+ * 
+ * @returns Zero if passed on test, and non-zero otherwise.
+ */
+static int oom_test(void)
+{
+	int status;      /* Exit status.       */
+	char *p;         /* Memory chunk.      */
+	pid_t pid;       /* Child process ID.  */
+	pid_t hog;       /* Memory hog.        */
+	pid_t service;   /* Service process.   */
+	clock_t t0, t1;  /* Elapsed times.     */
+	struct tms timing;
+	
+	/* Service process. */
+	if ((service = fork()) < 0)
+		return (-1);
+	else if (service == 0)
+	{
+		while (1)
+			pause();
+	}
+	
+	t0 = times(&timing);
+	
+	/* Memory hog. */
+	if ((hog = fork()) < 0)
+	{
+		kill(service, SIGKILL);
+		wait(NULL);
+		return (-1);
+	}
+	else if (hog == 0)
+	{
+		while ((p = malloc(OOM_CHUNK)) != NULL)
+		{
+			for (int i = 0; i < OOM_CHUNK; i += 4096)
+				p[i] = 1;
+		}
+		
+		_exit(EXIT_FAILURE);
+	}
+	
+	/* Wait for the memory hog. */
+	while ((pid = wait(&status)) != hog)
+	{
+		/* Service process has been killed. */
+		if (pid == service)
+			service = -1;
+	}
+	
+	t1 = times(&timing);
+	
+	/* Memory hog should have been killed. */
+	if (!WIFSIGNALED(status))
+		goto error0;
+	
+	/* Service process should be alive. */
+	if (service < 0)
+		return (-1);
+	kill(service, SIGTERM);
+	wait(&status);
+	if (!WIFSIGNALED(status) || (WTERMSIG(status) != SIGTERM))
+		return (-1);
+	
+	/* Print timing statistics. */
+	if (flags & VERBOSE)
+		printf("  Elapsed: %d\n", t1 - t0);
+	
+	return (0);
+
+error0:
+	kill(service, SIGKILL);
+	wait(NULL);
+	return (-1);
+}
+
+/*============================================================================*
+ *                                 pipe_test                                  *
+ *============================================================================*/
+
+#define PIPE_CHUNK   512 /* Size of pipe writes (in bytes). */
+#define PIPE_COUNT  8192 /* Number of pipe writes.          */
+
+/**
+ * @brief Pipe testing module.
+ * 
+ * @details Streams data from a child process to its parent through a pipe,
+ *          in small chunks, and checks that it arrives intact.
+ * 
+ * @returns Zero if passed on test, and non-zero otherwise.
+ */
+static int pipe_test(void)
+{
+	int fd[2];                /* Pipe.               */
+	pid_t pid;                /* Child process ID.   */
+	int status;               /* Child exit status.  */
+	ssize_t n;                /* Bytes read.         */
+	unsigned total;           /* Total bytes read.   */
+	char buffer[PIPE_CHUNK];  /* Buffer.             */
+	struct tms timing;        /* Timing information. */
+	clock_t t0, t1;           /* Elapsed times.      */
+	
+	if (pipe(fd) < 0)
+		return (-1);
+	
+	t0 = times(&timing);
+	
+	/* Writer. */
+	if ((pid = fork()) < 0)
+	{
+		close(fd[0]);
+		close(fd[1]);
+		return (-1);
+	}
+	else if (pid == 0)
+	{
+		close(fd[0]);
+		
+		memset(buffer, 1, PIPE_CHUNK);
+		for (int i = 0; i < PIPE_COUNT; i++)
+		{
+			if (write(fd[1], buffer, PIPE_CHUNK) != PIPE_CHUNK)
+				_exit(EXIT_FAILURE);
+		}
+		
+		_exit(EXIT_SUCCESS);
+	}
+	
+	close(fd[1]);
+	
+	/* Reader. */
+	total = 0;
+	while ((n = read(fd[0], buffer, PIPE_CHUNK)) > 0)
+	{
+		/* Wrong content. */
+		if (buffer[0] != 1)
+			break;
+		
+		total += n;
+	}
+	
+	close(fd[0]);
+	wait(&status);
+	
+	t1 = times(&timing);
+	
+	if (total != PIPE_CHUNK*PIPE_COUNT)
+		return (-1);
+	if (!WIFEXITED(status) || (WEXITSTATUS(status) != EXIT_SUCCESS))
+		return (-1);
+	
+	/* Print timing statistics. */
+	if (flags & VERBOSE)
+		printf("  Elapsed: %d\n", t1 - t0);
+	
+	return (0);
+}
+
+/*============================================================================*
+ *                                 sock_test                                  *
+ *============================================================================*/
+
+#define SOCK_STREAM_NAME "sock_stream" /* Name of stream socket.     */
+#define SOCK_DGRAM_NAME  "sock_dgram"  /* Name of datagram socket.   */
+#define SOCK_MSG                   64  /* Size of messages.          */
+#define SOCK_ROUNDS              4096  /* Number of request/replies. */
+
+/**
+ * @brief Fills a UNIX domain socket address.
+ * 
+ * @param addr Socket address.
+ * @param name Name of the socket.
+ */
+static void sock_addr(struct sockaddr_un *addr, const char *name)
+{
+	memset(addr, 0, sizeof(struct sockaddr_un));
+	addr->sun_family = AF_UNIX;
+	strncpy(addr->sun_path, name, UNIX_PATH_MAX - 1);
+}
+
+/**
+ * @brief Client side of the sockets test.
+ * 
+ * @details Connects to the server, issues request/reply rounds, sends the
+ *          read end of a pipe along with a message, and finally sends a
+ *          datagram to the server.
+ */
+static void sock_client(void)
+{
+	int fd;                     /* Socket.             */
+	int p[2];                   /* Passed pipe.        */
+	char buffer[SOCK_MSG];      /* Buffer.             */
+	struct sockaddr_un addr;    /* Server address.     */
+	struct iovec iov;           /* I/O vector.         */
+	struct msghdr msg;          /* Message.            */
+	struct cmsghdr *cmsg;       /* Control message.    */
+	int control[(CMSG_SPACE(sizeof(int)) + sizeof(int) - 1)/sizeof(int)];
+	
+	if ((fd = socket(AF_UNIX, SOCK_STREAM, 0)) < 0)
+		_exit(EXIT_FAILURE);
+	
+	sock_addr(&addr, SOCK_STREAM_NAME);
+	if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+		_exit(EXIT_FAILURE);
+	
+	/* Request/reply rounds. */
+	for (int i = 0; i < SOCK_ROUNDS; i++)
+	{
+		memset(buffer, i & 0xff, SOCK_MSG);
+		if (send(fd, buffer, SOCK_MSG, 0) != SOCK_MSG)
+			_exit(EXIT_FAILURE);
+		if (recv(fd, buffer, SOCK_MSG, 0) != SOCK_MSG)
+			_exit(EXIT_FAILURE);
+		if (buffer[SOCK_MSG - 1] != (char)((i + 1) & 0xff))
+			_exit(EXIT_FAILURE);
+	}
+	
+	/* Pass the read end of a pipe. */
+	if (pipe(p) < 0)
+		_exit(EXIT_FAILURE);
+	if (write(p[1], "x", 1) != 1)
+		_exit(EXIT_FAILURE);
+	
+	iov.iov_base = buffer;
+	iov.iov_len = 1;
+	msg.msg_name = NULL;
+	msg.msg_namelen = 0;
+	msg.msg_iov = &iov;
+	msg.msg_iovlen = 1;
+	msg.msg_control = control;
+	msg.msg_controllen = CMSG_SPACE(sizeof(int));
+	msg.msg_flags = 0;
+	cmsg = CMSG_FIRSTHDR(&msg);
+	cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+	cmsg->cmsg_level = SOL_SOCKET;
+	cmsg->cmsg_type = SCM_RIGHTS;
+	memcpy(CMSG_DATA(cmsg), &p[0], sizeof(int));
+	
+	if (sendmsg(fd, &msg, 0) != 1)
+		_exit(EXIT_FAILURE);
+	
+	close(p[0]);
+	close(p[1]);
+	close(fd);
+	
+	/* Datagram. */
+	if ((fd = socket(AF_UNIX, SOCK_DGRAM, 0)) < 0)
+		_exit(EXIT_FAILURE);
+	sock_addr(&addr, SOCK_DGRAM_NAME);
+	memset(buffer, 'd', SOCK_MSG);
+	if (sendto(fd, buffer, SOCK_MSG, 0, (struct sockaddr *)&addr,
+		sizeof(addr)) != SOCK_MSG)
+		_exit(EXIT_FAILURE);
+	close(fd);
+	
+	_exit(EXIT_SUCCESS);
+}
+
+/**
+ * @brief Server side of the sockets test.
+ * 
+ * @param listener Listening stream socket.
+ * @param dgram    Bound datagram socket.
+ * 
+ * @returns Zero if the client was served correctly, and non-zero otherwise.
+ */
+static int sock_server(int listener, int dgram)
+{
+	int fd;                     /* Connection.         */
+	int passed;                 /* Passed descriptor.  */
+	char buffer[SOCK_MSG];      /* Buffer.             */
+	struct iovec iov;           /* I/O vector.         */
+	struct msghdr msg;          /* Message.            */
+	struct cmsghdr *cmsg;       /* Control message.    */
+	int control[(CMSG_SPACE(sizeof(int)) + sizeof(int) - 1)/sizeof(int)];
+	
+	if ((fd = accept(listener, NULL, NULL)) < 0)
+		return (-1);
+	
+	/* Reply to requests. */
+	for (int i = 0; i < SOCK_ROUNDS; i++)
+	{
+		if (recv(fd, buffer, SOCK_MSG, 0) != SOCK_MSG)
+			goto error;
+		if (buffer[0] != (char)(i & 0xff))
+			goto error;
+		memset(buffer, (i + 1) & 0xff, SOCK_MSG);
+		if (send(fd, buffer, SOCK_MSG, 0) != SOCK_MSG)
+			goto error;
+	}
+	
+	/* Receive a descriptor. */
+	iov.iov_base = buffer;
+	iov.iov_len = 1;
+	msg.msg_name = NULL;
+	msg.msg_namelen = 0;
+	msg.msg_iov = &iov;
+	msg.msg_iovlen = 1;
+	msg.msg_control = control;
+	msg.msg_controllen = sizeof(control);
+	msg.msg_flags = 0;
+	
+	if (recvmsg(fd, &msg, 0) != 1)
+		goto error;
+	if ((cmsg = CMSG_FIRSTHDR(&msg)) == NULL)
+		goto error;
+	if ((cmsg->cmsg_level != SOL_SOCKET) || (cmsg->cmsg_type != SCM_RIGHTS))
+		goto error;
+	memcpy(&passed, CMSG_DATA(cmsg), sizeof(int));
+	if (read(passed, buffer, 1) != 1)
+		goto error;
+	close(passed);
+	if (buffer[0] != 'x')
+		goto error;
+	
+	/* Peer is gone. */
+	if (recv(fd, buffer, SOCK_MSG, 0) != 0)
+		goto error;
+	close(fd);
+	
+	/* Receive a datagram. */
+	if (recv(dgram, buffer, SOCK_MSG, 0) != SOCK_MSG)
+		return (-1);
+	if (buffer[SOCK_MSG - 1] != 'd')
+		return (-1);
+	
+	return (0);
+
+error:
+	close(fd);
+	return (-1);
+}
+
+/**
+ * @brief Sockets testing module.
+ * 
+ * @details Serves a child process through UNIX domain sockets: measures the
+ *          request/reply latency over a stream connection, then checks
+ *          descriptor passing and datagram delivery.
+ * 
+ * @returns Zero if passed on test, and non-zero otherwise.
+ */
+static int sock_test(void)
+{
+	int ret;                 /* Return value.       */
+	int listener;            /* Listening socket.   */
+	int dgram;               /* Datagram socket.    */
+	pid_t pid;               /* Child process ID.   */
+	int status;              /* Child exit status.  */
+	struct sockaddr_un addr; /* Socket address.     */
+	struct tms timing;       /* Timing information. */
+	clock_t t0, t1;          /* Elapsed times.      */
+	
+	ret = -1;
+	
+	unlink(SOCK_STREAM_NAME);
+	unlink(SOCK_DGRAM_NAME);
+	
+	if ((listener = socket(AF_UNIX, SOCK_STREAM, 0)) < 0)
+		return (-1);
+	if ((dgram = socket(AF_UNIX, SOCK_DGRAM, 0)) < 0)
+		goto error0;
+	
+	sock_addr(&addr, SOCK_STREAM_NAME);
+	if (bind(listener, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+		goto error1;
+	if (listen(listener, 1) < 0)
+		goto error2;
+	sock_addr(&addr, SOCK_DGRAM_NAME);
+	if (bind(dgram, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+		goto error2;
+	
+	t0 = times(&timing);
+	
+	if ((pid = fork()) < 0)
+		goto error3;
+	else if (pid == 0)
+		sock_client();
+	
+	ret = sock_server(listener, dgram);
+	
+	wait(&status);
+	
+	t1 = times(&timing);
+	
+	if (!WIFEXITED(status) || (WEXITSTATUS(status) != EXIT_SUCCESS))
+		ret = -1;
+	
+	/* Print timing statistics. */
+	if ((ret == 0) && (flags & VERBOSE))
+	{
+		printf("  Elapsed: %d\n", t1 - t0);
+		printf("  Round trips: %d\n", SOCK_ROUNDS);
+	}
+
+error3:
+	unlink(SOCK_DGRAM_NAME);
+error2:
+	unlink(SOCK_STREAM_NAME);
+error1:
+	close(dgram);
+error0:
+	close(listener);
+	return (ret);
+}
+
+/*============================================================================*
+ *                                  udp_test                                  *
+ *============================================================================*/
+
+#define UDP_PORT   7777 /* Server port.               */
+#define UDP_ROUNDS 2048 /* Number of round trips.     */
+#define UDP_SMALL  64   /* Size of small datagrams.   */
+#define UDP_LARGE  1472 /* Size of largest datagrams. */
+
+/**
+ * @brief Fills in a loopback address.
+ */
+static void udp_addr(struct sockaddr_in *addr, in_port_t port)
+{
+	memset(addr, 0, sizeof(struct sockaddr_in));
+	addr->sin_family = AF_INET;
+	addr->sin_port = htons(port);
+	addr->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+}
+
+/**
+ * @brief Echoes datagrams back until an empty one arrives.
+ */
+static void udp_server(int fd)
+{
+	ssize_t n;                     /* Datagram length. */
+	socklen_t len;                 /* Address length.  */
+	struct sockaddr_in addr;       /* Peer address.    */
+	static char buffer[UDP_LARGE]; /* Buffer.          */
+	
+	while (1)
+	{
+		len = sizeof(addr);
+		n = recvfrom(fd, buffer, UDP_LARGE, 0, (struct sockaddr *)&addr, &len);
+		
+		if (n < 0)
+			_exit(EXIT_FAILURE);
+		if (n == 0)
+			break;
+		
+		if (sendto(fd, buffer, n, 0, (struct sockaddr *)&addr, len) != n)
+			_exit(EXIT_FAILURE);
+	}
+	
+	_exit(EXIT_SUCCESS);
+}
+
+/**
+ * @brief Performs request/reply rounds.
+ * 
+ * @param fd   Connected socket.
+ * @param size Size of datagrams.
+ * 
+ * @returns Zero upon success, and non-zero otherwise.
+ */
+static int udp_rounds(int fd, size_t size)
+{
+	socklen_t len;                 /* Address length. */
+	struct sockaddr_in addr;       /* Peer address.   */
+	static char buffer[UDP_LARGE]; /* Buffer.         */
+	
+	for (int i = 0; i < UDP_ROUNDS; i++)
+	{
+		memset(buffer, i & 0xff, size);
+		if (send(fd, buffer, size, 0) != (ssize_t)size)
+			return (-1);
+		
+		memset(buffer, 0, size);
+		len = sizeof(addr);
+		if (recvfrom(fd, buffer, size, 0, (struct sockaddr *)&addr, &len)
+			!= (ssize_t)size)
+			return (-1);
+		
+		/* Wrong content. */
+		if ((buffer[0] != (char)(i & 0xff)) ||
+			(buffer[size - 1] != (char)(i & 0xff)))
+			return (-1);
+		
+		/* Wrong source. */
+		if ((addr.sin_port != htons(UDP_PORT)) ||
+			(addr.sin_addr.s_addr != htonl(INADDR_LOOPBACK)))
+			return (-1);
+	}
+	
+	return (0);
+}
+
+/**
+ * @brief UDP sockets testing module.
+ * 
+ * @details Exchanges datagrams with a child process over the loopback
+ *          interface: measures the request/reply latency with small and
+ *          largest datagrams, and checks that oversized ones are refused.
+ * 
+ * @returns Zero if passed on test, and non-zero otherwise.
+ */
+static int udp_test(void)
+{
+	int ret;                           /* Return value.      */
+	int server;                        /* Server socket.     */
+	int client;                        /* Client socket.     */
+	pid_t pid;                         /* Child process ID.  */
+	int status;                        /* Child exit status. */
+	struct sockaddr_in addr;           /* Socket address.    */
+	clock_t t0, t1;                    /* Elapsed times.     */
+	struct tms timing;                 /* Timing info.       */
+	static char buffer[UDP_LARGE + 1]; /* Buffer.            */
+	
+	ret = -1;
+	t0 = t1 = 0;
+	
+	if ((server = socket(AF_INET, SOCK_DGRAM, 0)) < 0)
+		return (-1);
+	udp_addr(&addr, UDP_PORT);
+	if (bind(server, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+		goto error0;
+	
+	if ((pid = fork()) < 0)
+		goto error0;
+	else if (pid == 0)
+		udp_server(server);
+	
+	if ((client = socket(AF_INET, SOCK_DGRAM, 0)) < 0)
+		goto error1;
+	if (connect(client, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+		goto error2;
+	
+	t0 = times(&timing);
+	
+	if (udp_rounds(client, UDP_SMALL))
+		goto error2;
+	if (udp_rounds(client, UDP_LARGE))
+		goto error2;
+	
+	t1 = times(&timing);
+	
+	/* Datagram does not fit in a frame. */
+	if ((send(client, buffer, UDP_LARGE + 1, 0) >= 0) || (errno != EMSGSIZE))
+		goto error2;
+	
+	ret = 0;
+
+error2:
+	close(client);
+error1:
+	/* Stop server. */
+	if ((client = socket(AF_INET, SOCK_DGRAM, 0)) >= 0)
+	{
+		sendto(client, buffer, 0, 0, (struct sockaddr *)&addr, sizeof(addr));
+		close(client);
+	}
+	wait(&status);
+	if (!WIFEXITED(status) || (WEXITSTATUS(status) != EXIT_SUCCESS))
+		ret = -1;
+error0:
+	close(server);
+	
+	/* Print timing statistics. */
+	if ((ret == 0) && (flags & VERBOSE))
+	{
 		printf("  Elapsed: %d\n", t1 - t0);
+		printf("  Round trips: %d\n", 2*UDP_ROUNDS);
+	}
+	
+	return (ret);
+}
+
+/*============================================================================*
+ *                                 time_test                                  *
+ *============================================================================*/
+
+#define TIME_READS 1000000 /* Number of time reads. */
+
+/**
+ * @brief Time reading testing module.
+ * 
+ * @details Reads the time many times through the gticks() system call and
+ *          through the shared time page, and checks that the latter never
+ *          goes backwards and agrees with the former.
+ * 
+ * @returns Zero if passed on test, and non-zero otherwise.
+ */
+static int time_test(void)
+{
+	int ticks;               /* Ticks from the kernel. */
+	long long ns, last;      /* Nanoseconds.           */
+	struct timespec ts;      /* Time from time page.   */
+	struct timeval tv;       /* Time of day.           */
+	struct tms timing;       /* Timing information.    */
+	clock_t t0, t1, t2;      /* Elapsed times.         */
+	
+	t0 = times(&timing);
+	
+	/* Through system call. */
+	for (int i = 0; i < TIME_READS; i++)
+		ticks = gticks();
+	
+	t1 = times(&timing);
+	
+	/* Through time page. */
+	last = 0;
+	for (int i = 0; i < TIME_READS; i++)
+	{
+		if (clock_gettime(CLOCK_MONOTONIC, &ts) < 0)
+			return (-1);
+		
+		ns = ts.tv_sec*1000000000LL + ts.tv_nsec;
+		
+		/* Time went backwards. */
+		if (ns < last)
+			return (-1);
+		
+		last = ns;
+	}
+	
+	t2 = times(&timing);
+	
+	/* Clocks disagree. */
+	ticks = gticks();
+	if (clock_gettime(CLOCK_MONOTONIC, &ts) < 0)
+		return (-1);
+	if ((ts.tv_sec*CLOCK_FREQ + ts.tv_nsec/(1000000000/CLOCK_FREQ)) < ticks)
+		return (-1);
+	if (gettimeofday(&tv, NULL) < 0)
+		return (-1);
+	if ((tv.tv_usec < 0) || (tv.tv_usec >= 1000000))
+		return (-1);
+	
+	/* Print timing statistics. */
+	if (flags & VERBOSE)
+	{
+		printf("  Elapsed (syscall):   %d\n", t1 - t0);
+		printf("  Elapsed (time page): %d\n", t2 - t1);
+	}
+	
+	return (0);
+}
+
+/*============================================================================*
+ *                                  mq_test                                   *
+ *============================================================================*/
+
+#define MQ_PAGE        4096 /* Page size (in bytes).       */
+#define MQ_BIGMSG     65536 /* Size of large messages.     */
+#define MQ_NBIG         256 /* Number of large messages.   */
+#define MQ_SMALLMSG      64 /* Size of small messages.     */
+#define MQ_NSMALL      4096 /* Number of small messages.   */
+#define MQ_NAME     "/test" /* Name of the message queue.  */
+
+/**
+ * @brief Rounds up an address to the next page boundary.
+ */
+#define MQ_ALIGN(x) \
+	((char *)(((unsigned)(x) + MQ_PAGE - 1) & ~(MQ_PAGE - 1)))
+
+/**
+ * @brief Transfers messages between two processes.
+ * 
+ * @details Sends @p n messages of @p size bytes to a child process through a
+ *          message queue. Messages are sent from and received at @p off bytes
+ *          past a page boundary, so that whole pages are handed over when
+ *          @p off is zero, and copied otherwise.
+ * 
+ * @param data Page aligned message buffer.
+ * @param size Message size.
+ * @param n    Number of messages.
+ * @param off  Offset of message buffers.
+ * 
+ * @returns The elapsed time, or a negative number upon failure.
+ */
+static clock_t mq_xfer(char *data, int size, int n, int off)
+{
+	mqd_t mq;            /* Message queue.      */
+	char *buf;           /* Message buffer.     */
+	pid_t pid;           /* Child process ID.   */
+	int status;          /* Child exit status.  */
+	unsigned prio;       /* Message priority.   */
+	struct mq_attr attr; /* Queue attributes.   */
+	struct tms timing;   /* Timing information. */
+	clock_t t0, t1;      /* Elapsed times.      */
+	
+	attr.mq_flags = 0;
+	attr.mq_maxmsg = 8;
+	attr.mq_msgsize = size;
+	attr.mq_curmsgs = 0;
+	
+	if ((mq = mq_open(MQ_NAME, O_RDWR | O_CREAT | O_EXCL, 0600, &attr)) < 0)
+		return (-1);
+	mq_unlink(MQ_NAME);
+	
+	buf = data + off;
+	for (int i = 0; i < size; i += MQ_PAGE)
+		buf[i] = 1;
+	
+	t0 = times(&timing);
+	
+	/* Receiver. */
+	if ((pid = fork()) < 0)
+		goto error0;
+	else if (pid == 0)
+	{
+		for (int i = 0; i < n; i++)
+		{
+			buf[0] = 0;
+			
+			if (mq_receive(mq, buf, MQ_BIGMSG + MQ_PAGE, &prio) != size)
+				_exit(EXIT_FAILURE);
+			
+			/* Wrong content. */
+			if (buf[0] != 1)
+				_exit(EXIT_FAILURE);
+		}
+		
+		_exit(EXIT_SUCCESS);
+	}
+	
+	/* Sender. */
+	for (int i = 0; i < n; i++)
+	{
+		if (mq_send(mq, buf, size, 0) < 0)
+		{
+			kill(pid, SIGKILL);
+			wait(NULL);
+			goto error0;
+		}
+	}
+	
+	wait(&status);
+	
+	t1 = times(&timing);
+	
+	mq_close(mq);
+	
+	if (!WIFEXITED(status) || (WEXITSTATUS(status) != EXIT_SUCCESS))
+		return (-1);
+	
+	return (t1 - t0);
+
+error0:
+	mq_close(mq);
+	return (-1);
+}
+
+/**
+ * @brief Checks message priorities.
+ * 
+ * @param data Message buffer.
+ * 
+ * @returns Zero if messages are received in priority order, and non-zero
+ *          otherwise.
+ */
+static int mq_order(char *data)
+{
+	mqd_t mq;       /* Message queue.    */
+	char msg;       /* Message.          */
+	unsigned prio;  /* Message priority. */
+	const char *sent = "abcd";
+	const char *expected = "bdca";
+	const unsigned prios[4] = { 1, 3, 2, 3 };
+	
+	mq = mq_open(MQ_NAME, O_RDWR | O_CREAT | O_EXCL | O_NONBLOCK, 0600, NULL);
+	if (mq < 0)
+		return (-1);
+	mq_unlink(MQ_NAME);
+	
+	for (int i = 0; i < 4; i++)
+	{
+		if (mq_send(mq, &sent[i], 1, prios[i]) < 0)
+			goto error0;
+	}
+	
+	for (int i = 0; i < 4; i++)
+	{
+		if (mq_receive(mq, data, MQ_BIGMSG, &prio) != 1)
+			goto error0;
+		
+		msg = data[0];
+		
+		/* Wrong order. */
+		if ((msg != expected[i]) || (prio != prios[msg - 'a']))
+			goto error0;
+	}
+	
+	/* Queue should be empty. */
+	if (mq_receive(mq, data, MQ_BIGMSG, &prio) >= 0)
+		goto error0;
+	
+	mq_close(mq);
+	
+	return (0);
+
+error0:
+	mq_close(mq);
+	return (-1);
+}
+
+/**
+ * @brief Message queues testing module.
+ * 
+ * @details Checks that messages are received in priority order, then measures
+ *          the rate of small messages and the bandwidth of large messages that
+ *          are either handed over as whole pages or copied.
+ * 
+ * @returns Zero if passed on test, and non-zero otherwise.
+ */
+static int mq_test(void)
+{
+	clock_t t;  /* Elapsed time.   */
+	char *data; /* Message buffer. */
+	char *buf;  /* Aligned buffer. */
+	
+	if ((data = malloc(MQ_BIGMSG + 2*MQ_PAGE)) == NULL)
+		return (-1);
+	buf = MQ_ALIGN(data);
+	
+	if (mq_order(buf))
+		goto error0;
+	
+	/* Small messages. */
+	if ((t = mq_xfer(buf, MQ_SMALLMSG, MQ_NSMALL, 0)) < 0)
+		goto error0;
+	if (flags & VERBOSE)
+		printf("  Small messages:  %d\n", t);
+	
+	/* Large messages, handed over. */
+	if ((t = mq_xfer(buf, MQ_BIGMSG, MQ_NBIG, 0)) < 0)
+		goto error0;
+	if (flags & VERBOSE)
+		printf("  Zero-copy:       %d\n", t);
+	
+	/* Large messages, copied. */
+	if ((t = mq_xfer(buf, MQ_BIGMSG, MQ_NBIG, 1)) < 0)
+		goto error0;
+	if (flags & VERBOSE)
+		printf("  Copied:          %d\n", t);
+	
+	free(data);
 	
 	return (0);
+
+error0:
+	free(data);
+	return (-1);
 }
 
 /*============================================================================*
@@ -571,10 +2541,26 @@ static void usage(void)
 	printf("Usage: test [options]\n\n");
 	printf("Brief: Performs regression tests on Nanvix.\n\n");
 	printf("Options:\n");
+	printf("  creat File Creation Test\n");
+	printf("  cwd   Working Directory Test\n");
 	printf("  fpu   Floating Point Unit Test\n");
+	printf("  fsync File Synchronization Test\n");
+	printf("  hole  Sparse Files Test\n");
+	printf("  heap  Heap Test\n");
 	printf("  io    I/O Test\n");
 	printf("  ipc   Interprocess Communication Test\n");
+	printf("  madv  Paging Hints Test\n");
+	printf("  mq    Message Queues Test\n");
+	printf("  oom   Out of Memory Test\n");
+	printf("  pipe  Pipe Test\n");
+	printf("  rm    File Removal Test\n");
+	printf("  rw    Scatter/Gather I/O Test\n");
+	printf("  sock  Sockets Test\n");
+	printf("  udp   UDP Sockets Test\n");
+	printf("  small Small Files Test\n");
 	printf("  swp   Swapping Test\n");
+	printf("  swpon Swap Areas Test\n");
+	printf("  time  Time Reading Test\n");
 	printf("  sched Scheduling Test\n");
 	
 	exit(EXIT_SUCCESS);
@@ -599,6 +2585,118 @@ int main(int argc, char **argv)
 				(!io_test()) ? "PASSED" : "FAILED");
 		}
 		
+		/* File synchronization test. */
+		else if (!strcmp(argv[i], "fsync"))
+		{
+			printf("File Synchronization Test\n");
+			printf("  Result:             [%s]\n",
+				(!fsync_test()) ? "PASSED" : "FAILED");
+		}
+		
+		/* File removal test. */
+		else if (!strcmp(argv[i], "rm"))
+		{
+			printf("File Removal Test\n");
+			printf("  Result:             [%s]\n",
+				(!rm_test()) ? "PASSED" : "FAILED");
+		}
+		
+		/* File creation test. */
+		else if (!strcmp(argv[i], "creat"))
+		{
+			printf("File Creation Test\n");
+			printf("  Result:             [%s]\n",
+				(!creat_test()) ? "PASSED" : "FAILED");
+		}
+		
+		/* Working directory test. */
+		else if (!strcmp(argv[i], "cwd"))
+		{
+			printf("Working Directory Test\n");
+			printf("  Result:             [%s]\n",
+				(!cwd_test()) ? "PASSED" : "FAILED");
+		}
+		
+		/* Scatter/gather I/O test. */
+		else if (!strcmp(argv[i], "rw"))
+		{
+			printf("Scatter/Gather I/O Test\n");
+			printf("  Result:             [%s]\n",
+				(!rw_test()) ? "PASSED" : "FAILED");
+		}
+		
+		/* Small files test. */
+		else if (!strcmp(argv[i], "small"))
+		{
+			printf("Small Files Test\n");
+			printf("  Result:             [%s]\n",
+				(!small_test()) ? "PASSED" : "FAILED");
+		}
+		
+		/* Sparse files test. */
+		else if (!strcmp(argv[i], "hole"))
+		{
+			printf("Sparse Files Test\n");
+			printf("  Result:             [%s]\n",
+				(!sparse_test()) ? "PASSED" : "FAILED");
+		}
+		
+		/* Heap test. */
+		else if (!strcmp(argv[i], "heap"))
+		{
+			printf("Heap Test\n");
+			printf("  Result:             [%s]\n",
+				(!heap_test()) ? "PASSED" : "FAILED");
+		}
+		
+		/* Paging hints test. */
+		else if (!strcmp(argv[i], "madv"))
+		{
+			printf("Paging Hints Test\n");
+			printf("  Result:             [%s]\n",
+				(!madv_test()) ? "PASSED" : "FAILED");
+		}
+		
+		/* Message queues test. */
+		else if (!strcmp(argv[i], "mq"))
+		{
+			printf("Message Queues Test\n");
+			printf("  Result:             [%s]\n",
+				(!mq_test()) ? "PASSED" : "FAILED");
+		}
+		
+		/* Out of memory test. */
+		else if (!strcmp(argv[i], "oom"))
+		{
+			printf("Out of Memory Test\n");
+			printf("  Result:             [%s]\n",
+				(!oom_test()) ? "PASSED" : "FAILED");
+		}
+		
+		/* Pipe test. */
+		else if (!strcmp(argv[i], "pipe"))
+		{
+			printf("Pipe Test\n");
+			printf("  Result:             [%s]\n",
+				(!pipe_test()) ? "PASSED" : "FAILED");
+		}
+		
+		/* Sockets test. */
+		else if (!strcmp(argv[i], "sock"))
+		{
+			printf("Sockets Test\n");
+			printf("  Result:             [%s]\n",
+				(!sock_test()) ? "PASSED" : "FAILED");
+		}
+		
+		/* UDP sockets test. */
+		else if (!strcmp(argv[i], "udp"))
+		{
+			printf("UDP Sockets Test\n");
+			printf("  Result:             [%s]\n",
+				(!udp_test()) ? "PASSED" : "FAILED");
+		}
+		
 		/* Swapping test. */
 		else if (!strcmp(argv[i], "swp"))
 		{
@@ -607,6 +2705,22 @@ int main(int argc, char **argv)
 				(!swap_test()) ? "PASSED" : "FAILED");
 		}
 		
+		/* Swap areas test. */
+		else if (!strcmp(argv[i], "swpon"))
+		{
+			printf("Swap Areas Test\n");
+			printf("  Result:             [%s]\n",
+				(!swapon_test()) ? "PASSED" : "FAILED");
+		}
+		
+		/* Time reading test. */
+		else if (!strcmp(argv[i], "time"))
+		{
+			printf("Time Reading Test\n");
+			printf("  Result:             [%s]\n",
+				(!time_test()) ? "PASSED" : "FAILED");
+		}
+		
 		/* Scheduling test. */
 		else if (!strcmp(argv[i], "sched"))
 		{
@@ -17,13 +17,170 @@
  * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include <unistd.h>
+#include <dirent.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Field length. */
+#define FIELD_MAX 32
+
+/* Process information. */
+struct pinfo
+{
+	char name[FIELD_MAX];     /* Name.        */
+	char pid[FIELD_MAX];      /* PID.         */
+	char uid[FIELD_MAX];      /* User ID.     */
+	char priority[FIELD_MAX]; /* Priority.    */
+	char nice[FIELD_MAX];     /* Nice.        */
+	char state[FIELD_MAX];    /* State.       */
+	char utime[FIELD_MAX];    /* User time.   */
+	char ktime[FIELD_MAX];    /* Kernel time. */
+};
+
+/*
+ * Process file field.
+ */
+struct field
+{
+	const char *key; /* Key.   */
+	char *value;     /* Value. */
+};
+
+/*
+ * Reads fields from a process file.
+ */
+static int readfile(const char *pid, const char *file, struct field *fields)
+{
+	FILE *fp;                  /* Process file.  */
+	char *value;               /* Working value. */
+	char line[2*FIELD_MAX];    /* Working line.  */
+	char path[3*FIELD_MAX];    /* File path.     */
+	
+	strcpy(path, "/proc/");
+	strcat(path, pid);
+	strcat(path, "/");
+	strcat(path, file);
+	
+	/* Process is gone. */
+	if ((fp = fopen(path, "r")) == NULL)
+		return (-1);
+	
+	while (fgets(line, sizeof(line), fp) != NULL)
+	{
+		/* Bad line. */
+		if ((value = strchr(line, ':')) == NULL)
+			continue;
+		*value++ = '\0';
+		
+		/* Skip blanks. */
+		while ((*value == '\t') || (*value == ' '))
+			value++;
+		value[strcspn(value, "\n")] = '\0';
+		
+		for (int i = 0; fields[i].key != NULL; i++)
+		{
+			if (!strcmp(line, fields[i].key))
+			{
+				strncpy(fields[i].value, value, FIELD_MAX - 1);
+				fields[i].value[FIELD_MAX - 1] = '\0';
+			}
+		}
+	}
+	
+	fclose(fp);
+	
+	return (0);
+}
+
+/*
+ * Reads information about a process.
+ */
+static int readproc(const char *pid, struct pinfo *p)
+{
+	struct field status[] = {
+		{ "name",     p->name     },
+		{ "pid",      p->pid      },
+		{ "uid",      p->uid      },
+		{ "priority", p->priority },
+		{ "nice",     p->nice     },
+		{ "state",    p->state    },
+		{ NULL,       NULL        }
+	};
+	struct field times[] = {
+		{ "utime", p->utime },
+		{ "ktime", p->ktime },
+		{ NULL,    NULL     }
+	};
+	
+	memset(p, 0, sizeof(struct pinfo));
+	
+	if (readfile(pid, "status", status))
+		return (-1);
+	if (readfile(pid, "times", times))
+		return (-1);
+	
+	return (0);
+}
+
+/*
+ * Prints a left aligned column.
+ */
+static void column(const char *s, int width)
+{
+	fputs(s, stdout);
+	for (int i = strlen(s); i < width; i++)
+		putchar(' ');
+}
 
 /*
  * Gets and prints process information
  */
 int main()
 {
-	ps();
-	return 0;
+	DIR *dirp;               /* Process directory.       */
+	char *end;               /* End of process ID.       */
+	struct dirent *dp;       /* Working directory entry. */
+	struct pinfo p;          /* Process information.     */
+	char name[NAME_MAX + 1]; /* Working entry name.      */
+	
+	/* Open process directory. */
+	if ((dirp = opendir("/proc")) == NULL)
+	{
+		fprintf(stderr, "ps: cannot open /proc\n");
+		return (errno);
+	}
+	
+	printf("NAME               PID   UID       PRIORITY   NICE"
+	       "   UTIME   KTIME     STATUS\n");
+	
+	name[NAME_MAX] = '\0';
+	while ((dp = readdir(dirp)) != NULL)
+	{
+		strncpy(name, dp->d_name, NAME_MAX);
+		
+		/* Not a process. */
+		strtol(name, &end, 10);
+		if ((end == name) || (*end != '\0'))
+			continue;
+		
+		/* Process is gone. */
+		if (readproc(name, &p))
+			continue;
+		
+		column(p.name, 19);
+		column(p.pid, 6);
+		column(p.uid, 10);
+		column(p.priority, 11);
+		column(p.nice, 7);
+		column(p.utime, 8);
+		column(p.ktime, 10);
+		printf("%s\n", p.state);
+	}
+	
+	closedir(dirp);
+	
+	return (EXIT_SUCCESS);
 }
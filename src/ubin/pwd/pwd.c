@@ -38,10 +38,8 @@ int main(int argc, char *const argv[])
 	((void)argv);
 	
 	/* 
-	 * Get current working directory name. getcwd() will
-	 * do all the dirty job. It will contruct the current
-	 * working directory name from bottom to up, that is,
-	 * towards the root directory.
+	 * Get current working directory name. The
+	 * kernel keeps it, so getcwd() is cheap.
 	 */
 	if (getcwd(pathname, PATH_MAX) == NULL)
 	{
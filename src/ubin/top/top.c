@@ -0,0 +1,337 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of Nanvix.
+ * 
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nanvix/clock.h>
+#include <nanvix/config.h>
+#include <dev/tty.h>
+#include <sys/pstat.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stropts.h>
+#include <unistd.h>
+
+/**
+ * @name Sort Keys
+ */
+/**@{*/
+#define SORT_CPU    0 /**< Sort by CPU usage.   */
+#define SORT_MEM    1 /**< Sort by memory size. */
+#define SORT_FAULTS 2 /**< Sort by page faults. */
+/**@}*/
+
+/**
+ * @brief Process entry.
+ */
+struct entry
+{
+	struct pstat st; /**< Process status.                */
+	unsigned cpu;    /**< CPU usage (tenths of percent). */
+	unsigned faults; /**< Page faults in the interval.   */
+};
+
+/**
+ * @brief Process states.
+ */
+static const char *states[] = {
+	"DEAD", "ZOMBIE", "RUNNING", "READY", "WAITING", "SLEEPING", "STOPPED"
+};
+
+/**
+ * @brief Current and previous snapshots.
+ */
+static struct pstat snaps[2][PROC_MAX];
+
+/**
+ * @brief Number of processes in each snapshot.
+ */
+static int nsnaps[2] = { 0, 0 };
+
+/**
+ * @brief Processes shown.
+ */
+static struct entry entries[PROC_MAX];
+
+/**
+ * @brief Sort key.
+ */
+static int sortkey = SORT_CPU;
+
+/**
+ * @brief Prints program usage and exits.
+ */
+static void usage(void)
+{
+	printf("Usage: top [-d seconds] [-n iterations] [-s cpu|mem|faults]\n\n");
+	printf("Brief: Displays processes that use the most resources.\n\n");
+	printf("Options:\n");
+	printf("  -d Refresh interval (default 2 seconds)\n");
+	printf("  -n Number of refreshes (default forever)\n");
+	printf("  -s Sort key (default cpu)\n");
+	
+	exit(EXIT_SUCCESS);
+}
+
+/**
+ * @brief Alarm handler.
+ */
+static void wake(int sig)
+{
+	((void)sig);
+}
+
+/**
+ * @brief Prints a left aligned column.
+ */
+static void column(const char *s, int width)
+{
+	fputs(s, stdout);
+	for (int i = strlen(s); i < width; i++)
+		putchar(' ');
+}
+
+/**
+ * @brief Prints a right aligned number.
+ */
+static void number(unsigned n, int width)
+{
+	int len;
+	char buf[16];
+	
+	len = 0;
+	do
+	{
+		buf[len++] = '0' + n%10;
+		n /= 10;
+	} while (n > 0);
+	
+	for (int i = len; i < width; i++)
+		putchar(' ');
+	while (len > 0)
+		putchar(buf[--len]);
+}
+
+/**
+ * @brief Compares two entries according to the sort key.
+ */
+static int compare(const void *a, const void *b)
+{
+	unsigned ka, kb;
+	const struct entry *ea = a;
+	const struct entry *eb = b;
+	
+	switch (sortkey)
+	{
+		case SORT_MEM:
+			ka = ea->st.size;
+			kb = eb->st.size;
+			break;
+		
+		case SORT_FAULTS:
+			ka = ea->faults;
+			kb = eb->faults;
+			break;
+		
+		default:
+			ka = ea->cpu;
+			kb = eb->cpu;
+			break;
+	}
+	
+	/* Break ties by total CPU time. */
+	if (ka == kb)
+	{
+		ka = ea->st.utime + ea->st.ktime;
+		kb = eb->st.utime + eb->st.ktime;
+	}
+	
+	return ((ka < kb) ? 1 : (ka > kb) ? -1 : 0);
+}
+
+/**
+ * @brief Builds process entries from the last two snapshots.
+ * 
+ * @param curr    Current snapshot.
+ * @param elapsed Ticks elapsed since the previous snapshot.
+ * 
+ * @returns The number of entries.
+ */
+static int build(int curr, unsigned elapsed)
+{
+	int prev;          /* Previous snapshot. */
+	struct pstat *st;  /* Current status.    */
+	struct pstat *old; /* Previous status.   */
+	struct entry *e;   /* Working entry.     */
+	unsigned used;     /* Ticks used.        */
+	
+	prev = !curr;
+	
+	for (int i = 0; i < nsnaps[curr]; i++)
+	{
+		st = &snaps[curr][i];
+		e = &entries[i];
+		e->st = *st;
+		
+		/* Find process in the previous snapshot. */
+		old = NULL;
+		for (int j = 0; j < nsnaps[prev]; j++)
+		{
+			if (snaps[prev][j].pid == st->pid)
+			{
+				old = &snaps[prev][j];
+				break;
+			}
+		}
+		
+		used = st->utime + st->ktime;
+		e->faults = st->faults;
+		if (old != NULL)
+		{
+			used -= old->utime + old->ktime;
+			e->faults -= old->faults;
+		}
+		
+		e->cpu = (elapsed > 0) ? (1000*used)/elapsed : 0;
+	}
+	
+	return (nsnaps[curr]);
+}
+
+/**
+ * @brief Displays process entries.
+ */
+static void display(int n, int total, unsigned elapsed)
+{
+	unsigned time;     /* CPU time (seconds).  */
+	unsigned count[7]; /* Processes per state. */
+	
+	/* Clear screen. */
+	if (ioctl(fileno(stdout), TTY_CLEAR) < 0)
+		putchar('\n');
+	
+	memset(count, 0, sizeof(count));
+	for (int i = 0; i < n; i++)
+	{
+		if (entries[i].st.state < 7)
+			count[entries[i].st.state]++;
+	}
+	
+	printf("top - %d processes: %d running, %d ready, %d waiting, "
+	       "%d sleeping, %d stopped, %d zombie\n", total,
+	       count[2], count[3], count[4], count[5], count[6], count[1]);
+	printf("interval: %d ticks\n\n", elapsed);
+	
+	printf("  PID  UID  NI  CPU%%    TIME  SIZE(KB)  FAULTS  STATE     NAME\n");
+	for (int i = 0; i < n; i++)
+	{
+		time = (entries[i].st.utime + entries[i].st.ktime)/CLOCK_FREQ;
+		
+		number(entries[i].st.pid, 5);
+		number(entries[i].st.uid, 5);
+		number(entries[i].st.nice, 4);
+		number(entries[i].cpu/10, 4);
+		putchar('.');
+		number(entries[i].cpu%10, 1);
+		number(time/60, 5);
+		putchar(':');
+		putchar('0' + (time%60)/10);
+		putchar('0' + time%10);
+		number(entries[i].st.size >> 10, 10);
+		number(entries[i].faults, 8);
+		fputs("  ", stdout);
+		column((entries[i].st.state < 7) ? states[entries[i].st.state] : "?", 10);
+		printf("%s\n", entries[i].st.name);
+	}
+}
+
+/**
+ * @brief Displays processes that use the most resources.
+ */
+int main(int argc, char **argv)
+{
+	int n;          /* Number of entries.   */
+	int curr;       /* Current snapshot.    */
+	int total;      /* Existing processes.  */
+	int delay;      /* Refresh interval.    */
+	int iterations; /* Number of refreshes. */
+	unsigned now;   /* Current time.        */
+	unsigned then;  /* Last time.           */
+	
+	delay = 2;
+	iterations = -1;
+	
+	/* Get program arguments. */
+	for (int i = 1; i < argc; i++)
+	{
+		if ((!strcmp(argv[i], "-d")) && (i + 1 < argc))
+			delay = atoi(argv[++i]);
+		else if ((!strcmp(argv[i], "-n")) && (i + 1 < argc))
+			iterations = atoi(argv[++i]);
+		else if ((!strcmp(argv[i], "-s")) && (i + 1 < argc))
+		{
+			i++;
+			if (!strcmp(argv[i], "cpu"))
+				sortkey = SORT_CPU;
+			else if (!strcmp(argv[i], "mem"))
+				sortkey = SORT_MEM;
+			else if (!strcmp(argv[i], "faults"))
+				sortkey = SORT_FAULTS;
+			else
+				usage();
+		}
+		else
+			usage();
+	}
+	
+	if (delay < 1)
+		delay = 1;
+	
+	signal(SIGALRM, wake);
+	
+	curr = 0;
+	then = gticks();
+	nsnaps[!curr] = pstat(snaps[!curr], PROC_MAX);
+	
+	while (iterations != 0)
+	{
+		alarm(delay);
+		pause();
+		
+		/* Take snapshot. */
+		if ((total = pstat(snaps[curr], PROC_MAX)) < 0)
+		{
+			fprintf(stderr, "top: cannot get process status\n");
+			return (EXIT_FAILURE);
+		}
+		now = gticks();
+		nsnaps[curr] = (total < PROC_MAX) ? total : PROC_MAX;
+		
+		n = build(curr, now - then);
+		qsort(entries, n, sizeof(struct entry), compare);
+		display(n, total, now - then);
+		
+		then = now;
+		curr = !curr;
+		if (iterations > 0)
+			iterations--;
+	}
+	
+	return (EXIT_SUCCESS);
+}
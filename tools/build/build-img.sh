@@ -78,17 +78,19 @@ function passwords
 #   $3 Number of inodes.
 #
 function format {
-	bin/mkfs.minix $1 $2 $3 $ROOTUID $ROOTGID
+	bin/mkfs.minix $1 $2 $3 $ROOTUID $ROOTGID -i
 	bin/mkdir.minix $1 /etc $ROOTUID $ROOTGID
 	bin/mkdir.minix $1 /sbin $ROOTUID $ROOTGID
 	bin/mkdir.minix $1 /bin $ROOTUID $ROOTGID
 	bin/mkdir.minix $1 /home $ROOTUID $ROOTGID
 	bin/mkdir.minix $1 /dev $ROOTUID $ROOTGID
+	bin/mkdir.minix $1 /proc $ROOTUID $ROOTGID
 	bin/mknod.minix $1 /dev/null 666 c 0 0 $ROOTUID $ROOTGID
 	bin/mknod.minix $1 /dev/tty 666 c 0 1 $ROOTUID $ROOTGID
 	bin/mknod.minix $1 /dev/klog 666 c 0 2 $ROOTUID $ROOTGID
 	bin/mknod.minix $1 /dev/ramdisk 666 b 0 0 $ROOTUID $ROOTGID
 	bin/mknod.minix $1 /dev/hdd 666 b 0 1 $ROOTUID $ROOTGID
+	bin/mknod.minix $1 /dev/swp 666 b 2 1 $ROOTUID $ROOTGID
 }
 
 #
@@ -122,11 +124,18 @@ function copy_files
 dd if=/dev/zero of=hdd.img bs=512 count=131072
 format hdd.img 32708 16384
 copy_files hdd.img
+bin/layout.minix hdd.img tools/img/bootlist
+bin/fsck.minix hdd.img
+
+# Build swap image.
+dd if=/dev/zero of=swap.img bs=512 count=32256
 
 # Build initrd image.
-dd if=/dev/zero of=initrd.img bs=512K count=1
-format initrd.img 128 512
+dd if=/dev/zero of=initrd.img bs=1M count=1
+format initrd.img 128 1024
 copy_files initrd.img
+bin/layout.minix initrd.img tools/img/bootlist
+bin/fsck.minix initrd.img
 
 # Build nanvix image.
 cp -f tools/img/blank.img nanvix.img
@@ -0,0 +1,801 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of Nanvix.
+ * 
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <sys/types.h>
+#include <fcntl.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "bitmap.h"
+#include "minix.h"
+#include "stat.h"
+#include "util.h"
+
+/**
+ * @file
+ * 
+ * @brief Minix file system checker.
+ * 
+ * @details The image is read front to back: superblock, bitmaps and inode
+ *          table are loaded at once, and then only data blocks that hold
+ *          metadata (indirect blocks and directories) are visited, in
+ *          increasing block order. Blocks that are discovered behind the
+ *          current position are left for another sweep. All bookkeeping is
+ *          done in in-memory maps indexed by block and inode number.
+ */
+
+/**
+ * @brief Number of block numbers.
+ */
+#define NR_BLOCKS (1 << 16)
+
+/**
+ * @brief Number of directory entries per block.
+ */
+#define DIRENTS_PER_BLOCK (BLOCK_SIZE/sizeof(struct d_dirent))
+
+/**
+ * @name Block Roles
+ */
+/**@{*/
+#define ROLE_NONE   0 /**< Not used.                */
+#define ROLE_DATA   1 /**< File data.               */
+#define ROLE_DIR    2 /**< Directory entries.       */
+#define ROLE_SINGLE 3 /**< Single indirect block.   */
+#define ROLE_DOUBLE 4 /**< Double indirect block.   */
+/**@}*/
+
+/**
+ * @name Directory Flags
+ */
+/**@{*/
+#define HAS_DOT    (1 << 0) /**< Has "." entry?  */
+#define HAS_DOTDOT (1 << 1) /**< Has ".." entry? */
+/**@}*/
+
+/**
+ * @brief Image file.
+ */
+static int fd = -1;
+
+/**
+ * @brief Repair file system?
+ */
+static bool repair = false;
+
+/**
+ * @brief Number of problems found.
+ */
+static unsigned nerrors = 0;
+
+/**
+ * @brief Number of problems fixed.
+ */
+static unsigned nfixed = 0;
+
+/**
+ * @brief Superblock.
+ */
+static struct d_superblock super;
+
+/**
+ * @brief Inode map.
+ */
+static struct
+{
+	size_t size;      /**< Size of bitmap (in bytes). */
+	uint32_t *bitmap; /**< Bitmap.                    */
+	bool dirty;       /**< Modified?                  */
+} imap;
+
+/**
+ * @brief Zone map.
+ */
+static struct
+{
+	size_t size;      /**< Size of bitmap (in bytes). */
+	uint32_t *bitmap; /**< Bitmap.                    */
+	bool dirty;       /**< Modified?                  */
+} zmap;
+
+/**
+ * @brief Inode table.
+ */
+static struct
+{
+	size_t size;           /**< Size of table (in bytes). */
+	struct d_inode *table; /**< Disk inodes.              */
+	bool dirty;            /**< Modified?                 */
+} inodes;
+
+/**
+ * @brief Block information.
+ */
+static struct
+{
+	uint16_t owner[NR_BLOCKS];   /**< Owner inode.           */
+	uint8_t role[NR_BLOCKS];     /**< Role.                  */
+	uint32_t logic[NR_BLOCKS];   /**< Logical block number.  */
+	uint32_t todo[NR_BLOCKS/32]; /**< Blocks to be visited.  */
+	unsigned ntodo;              /**< Number of such blocks. */
+} blocks;
+
+/**
+ * @brief Directory information.
+ */
+static struct
+{
+	uint16_t *refs;   /**< References to inodes.        */
+	uint16_t *parent; /**< Directory that refers to it. */
+	uint16_t *dotdot; /**< Contents of "..".            */
+	uint8_t *flags;   /**< Directory flags.             */
+} dirs;
+
+/**
+ * @brief Reports a problem.
+ * 
+ * @param fmt Formatted message.
+ */
+static void problem(const char *fmt, ...)
+{
+	va_list args;
+
+	nerrors++;
+
+	va_start(args, fmt);
+	vfprintf(stderr, fmt, args);
+	va_end(args);
+	fputc('\n', stderr);
+}
+
+/**
+ * @brief Asserts if the last problem should be fixed.
+ * 
+ * @returns True if the file system is being repaired, and false otherwise.
+ */
+static bool fix(void)
+{
+	if (!repair)
+		return (false);
+
+	nfixed++;
+
+	return (true);
+}
+
+/**
+ * @brief Returns a disk inode.
+ * 
+ * @param num Inode number.
+ * 
+ * @returns The disk inode with number @p num.
+ */
+static inline struct d_inode *inode(uint16_t num)
+{
+	return (&inodes.table[num - 1]);
+}
+
+/**
+ * @brief Asserts if a file holds inline data.
+ * 
+ * @param ip File to be inspected.
+ * 
+ * @returns True if the file pointed to by @p ip holds inline data, and false
+ *          otherwise.
+ */
+static bool is_inline(const struct d_inode *ip)
+{
+	return ((super.s_features & MINIX_FEATURE_INLINE) &&
+			S_ISREG(ip->i_mode) && (ip->i_size <= MINIX_INLINE_MAX));
+}
+
+/**
+ * @brief Claims a zone.
+ * 
+ * @details Records that the zone @p blk is used by the inode @p num. Zones
+ *          that hold metadata are scheduled for a visit.
+ * 
+ * @param num  Inode number.
+ * @param blk  Zone number.
+ * @param role Role of the zone.
+ * @param lg   Logical number of the zone in the file.
+ * 
+ * @returns True if the reference is valid, and false otherwise.
+ */
+static bool zone_claim(uint16_t num, block_t blk, uint8_t role, uint32_t lg)
+{
+	/* Nothing to be done. */
+	if (blk == BLOCK_NULL)
+		return (true);
+
+	/* Out of range. */
+	if ((blk < super.s_first_data_block) ||
+		((uint32_t)blk >= (uint32_t)super.s_first_data_block + super.s_nblocks))
+	{
+		problem("inode %u: bad zone %u", num, blk);
+		return (false);
+	}
+
+	/* Multiply claimed. */
+	if (blocks.owner[blk] != INODE_NULL)
+	{
+		problem("inode %u: zone %u is also used by inode %u",
+			num, blk, blocks.owner[blk]);
+		return (false);
+	}
+
+	blocks.owner[blk] = num;
+	blocks.role[blk] = role;
+	blocks.logic[blk] = lg;
+
+	/* Visit it later. */
+	if (role != ROLE_DATA)
+	{
+		bitmap_set(blocks.todo, blk);
+		blocks.ntodo++;
+	}
+
+	return (true);
+}
+
+/**
+ * @brief Checks the zones of an inode.
+ * 
+ * @param num Inode number.
+ */
+static void inode_zones_check(uint16_t num)
+{
+	uint8_t role;       /* Role of data zones. */
+	struct d_inode *ip; /* Inode.              */
+
+	ip = inode(num);
+
+	/* Device files and inline data have no zones. */
+	if (!(S_ISREG(ip->i_mode) || S_ISDIR(ip->i_mode)) || is_inline(ip))
+		return;
+
+	/* File too big. */
+	if (ip->i_size > super.s_max_size)
+		problem("inode %u: bad size %u", num, ip->i_size);
+
+	role = (S_ISDIR(ip->i_mode)) ? ROLE_DIR : ROLE_DATA;
+
+	for (unsigned i = 0; i < NR_ZONES; i++)
+	{
+		bool ok;
+
+		if (i < ZONE_SINGLE)
+			ok = zone_claim(num, ip->i_zones[i], role, i);
+		else if (i < ZONE_DOUBLE)
+			ok = zone_claim(num, ip->i_zones[i], ROLE_SINGLE, NR_ZONES_DIRECT);
+		else
+		{
+			ok = zone_claim(num, ip->i_zones[i], ROLE_DOUBLE,
+				NR_ZONES_DIRECT + NR_SINGLE);
+		}
+
+		/* Drop bad reference. */
+		if (!ok && fix())
+		{
+			ip->i_zones[i] = BLOCK_NULL;
+			inodes.dirty = true;
+		}
+	}
+}
+
+/**
+ * @brief Checks a block of directory entries.
+ * 
+ * @param num Inode number of the directory.
+ * @param d   Directory entries.
+ * @param lg  Logical number of the block in the directory.
+ * 
+ * @returns True if the block has been modified, and false otherwise.
+ */
+static bool dir_check(uint16_t num, struct d_dirent *d, uint32_t lg)
+{
+	bool dirty;         /* Block modified?           */
+	uint32_t nentries;  /* Number of entries.        */
+	uint32_t first;     /* First entry in the block. */
+
+	dirty = false;
+	nentries = inode(num)->i_size/sizeof(struct d_dirent);
+	first = lg*DIRENTS_PER_BLOCK;
+
+	for (uint32_t i = 0; (i < DIRENTS_PER_BLOCK) && (first + i < nentries); i++)
+	{
+		uint16_t ino = d[i].d_ino;
+
+		/* Free entry. */
+		if (ino == INODE_NULL)
+			continue;
+
+		/* Dangling entry. */
+		if ((ino > super.s_ninodes) || (inode(ino)->i_nlinks == 0))
+		{
+			problem("directory %u: entry \"%.14s\" refers to free inode %u",
+				num, d[i].d_name, ino);
+			if (fix())
+			{
+				d[i].d_ino = INODE_NULL;
+				dirty = true;
+			}
+			continue;
+		}
+
+		dirs.refs[ino]++;
+
+		/* Self entry. */
+		if (!strncmp(d[i].d_name, ".", MINIX_NAME_MAX))
+		{
+			if (ino != num)
+				problem("directory %u: \".\" refers to inode %u", num, ino);
+			dirs.flags[num] |= HAS_DOT;
+		}
+
+		/* Parent entry. */
+		else if (!strncmp(d[i].d_name, "..", MINIX_NAME_MAX))
+		{
+			dirs.dotdot[num] = ino;
+			dirs.flags[num] |= HAS_DOTDOT;
+		}
+
+		/* Subdirectory. */
+		else if (S_ISDIR(inode(ino)->i_mode))
+		{
+			if (dirs.parent[ino] != INODE_NULL)
+				problem("directory %u: linked more than once", ino);
+			dirs.parent[ino] = num;
+		}
+	}
+
+	return (dirty);
+}
+
+/**
+ * @brief Checks a metadata block.
+ * 
+ * @param blk Block number.
+ * @param buf Block contents.
+ * 
+ * @returns True if the block has been modified, and false otherwise.
+ */
+static bool block_check(block_t blk, block_t *buf)
+{
+	bool dirty;    /* Block modified?    */
+	uint16_t num;  /* Owner inode.       */
+	uint8_t role;  /* Role of children.  */
+	uint32_t lg;   /* Logical number.    */
+
+	dirty = false;
+	num = blocks.owner[blk];
+	lg = blocks.logic[blk];
+
+	switch (blocks.role[blk])
+	{
+		/* Single indirect block. */
+		case ROLE_SINGLE:
+			role = (S_ISDIR(inode(num)->i_mode)) ? ROLE_DIR : ROLE_DATA;
+			for (unsigned i = 0; i < NR_SINGLE; i++)
+			{
+				if (!zone_claim(num, buf[i], role, lg + i) && fix())
+				{
+					buf[i] = BLOCK_NULL;
+					dirty = true;
+				}
+			}
+			break;
+
+		/* Double indirect block. */
+		case ROLE_DOUBLE:
+			for (unsigned i = 0; i < NR_SINGLE; i++)
+			{
+				if (!zone_claim(num, buf[i], ROLE_SINGLE, lg + i*NR_SINGLE) && fix())
+				{
+					buf[i] = BLOCK_NULL;
+					dirty = true;
+				}
+			}
+			break;
+
+		/* Directory entries. */
+		case ROLE_DIR:
+			dirty = dir_check(num, (struct d_dirent *)buf, lg);
+			break;
+	}
+
+	return (dirty);
+}
+
+/**
+ * @brief Visits all scheduled metadata blocks.
+ * 
+ * @details Sweeps the data area in increasing block order, until no block is
+ *          left to be visited.
+ */
+static void data_sweep(void)
+{
+	block_t buf[NR_SINGLE]; /* Working buffer. */
+	uint32_t end;           /* End of data.    */
+
+	end = (uint32_t)super.s_first_data_block + super.s_nblocks;
+
+	while (blocks.ntodo > 0)
+	{
+		for (uint32_t blk = super.s_first_data_block; blk < end; blk++)
+		{
+			/* Skip chunk of blocks. */
+			if (blocks.todo[IDX(blk)] == 0)
+			{
+				blk |= 0x1f;
+				continue;
+			}
+
+			if (!bitmap_test(blocks.todo, blk))
+				continue;
+
+			bitmap_clear(blocks.todo, blk);
+			blocks.ntodo--;
+
+			slseek(fd, (off_t)blk*BLOCK_SIZE, SEEK_SET);
+			sread(fd, buf, BLOCK_SIZE);
+
+			/* Write back. */
+			if (block_check(blk, buf))
+			{
+				slseek(fd, (off_t)blk*BLOCK_SIZE, SEEK_SET);
+				swrite(fd, buf, BLOCK_SIZE);
+			}
+		}
+	}
+}
+
+/**
+ * @brief Releases all zones of an inode.
+ * 
+ * @param num Inode number.
+ */
+static void inode_release(uint16_t num)
+{
+	for (uint32_t blk = 0; blk < NR_BLOCKS; blk++)
+	{
+		if (blocks.owner[blk] == num)
+		{
+			blocks.owner[blk] = INODE_NULL;
+			blocks.role[blk] = ROLE_NONE;
+		}
+	}
+
+	memset(inode(num), 0, sizeof(struct d_inode));
+	inodes.dirty = true;
+}
+
+/**
+ * @brief Checks link counts, directory structure and the inode map.
+ * 
+ * @returns The number of inodes in use.
+ */
+static unsigned inodes_check(void)
+{
+	unsigned nused; /* Inodes in use. */
+
+	nused = 0;
+
+	for (uint32_t num = 1; num <= super.s_ninodes; num++)
+	{
+		bool used;
+		struct d_inode *ip = inode(num);
+
+		used = (ip->i_nlinks != 0);
+
+		if (used)
+		{
+			/* Lost inode. */
+			if (dirs.refs[num] == 0)
+			{
+				problem("inode %u: not referenced", num);
+				if (fix())
+				{
+					inode_release(num);
+					used = false;
+				}
+			}
+
+			/* Bad link count. */
+			else if (ip->i_nlinks != dirs.refs[num])
+			{
+				problem("inode %u: link count is %u, should be %u",
+					num, ip->i_nlinks, dirs.refs[num]);
+				if (fix())
+				{
+					ip->i_nlinks = dirs.refs[num];
+					inodes.dirty = true;
+				}
+			}
+		}
+
+		/* Broken directory. */
+		if (used && S_ISDIR(ip->i_mode))
+		{
+			uint16_t parent;
+
+			parent = (num == INODE_ROOT) ? INODE_ROOT : dirs.parent[num];
+
+			if (!(dirs.flags[num] & HAS_DOT))
+				problem("directory %u: missing \".\"", num);
+			if (!(dirs.flags[num] & HAS_DOTDOT))
+				problem("directory %u: missing \"..\"", num);
+			else if (dirs.dotdot[num] != parent)
+			{
+				problem("directory %u: \"..\" is %u, should be %u",
+					num, dirs.dotdot[num], parent);
+			}
+		}
+
+		/* Inode map mismatch. */
+		if ((bitmap_test(imap.bitmap, num - 1) != 0) != used)
+		{
+			problem("inode %u: marked %s in the inode map",
+				num, (used) ? "free" : "used");
+			if (fix())
+			{
+				if (used)
+					bitmap_set(imap.bitmap, num - 1);
+				else
+					bitmap_clear(imap.bitmap, num - 1);
+				imap.dirty = true;
+			}
+		}
+
+		if (used)
+			nused++;
+	}
+
+	return (nused);
+}
+
+/**
+ * @brief Checks the zone map.
+ * 
+ * @returns The number of zones in use.
+ */
+static unsigned zones_check(void)
+{
+	unsigned nused;   /* Zones in use.            */
+	unsigned nleaked; /* Zones marked used, free. */
+
+	nused = 0;
+	nleaked = 0;
+
+	for (uint32_t i = 0; i < super.s_nblocks; i++)
+	{
+		bool used;
+
+		used = (blocks.owner[super.s_first_data_block + i] != INODE_NULL);
+
+		/* Zone map mismatch. */
+		if ((bitmap_test(zmap.bitmap, i) != 0) != used)
+		{
+			if (used)
+			{
+				problem("zone %u: marked free in the zone map",
+					super.s_first_data_block + i);
+				if (fix())
+				{
+					bitmap_set(zmap.bitmap, i);
+					zmap.dirty = true;
+				}
+			}
+			
+			/* Reported below. */
+			else
+			{
+				nleaked++;
+				if (repair)
+				{
+					bitmap_clear(zmap.bitmap, i);
+					zmap.dirty = true;
+				}
+			}
+		}
+
+		if (used)
+			nused++;
+	}
+
+	/* Leaked zones. */
+	if (nleaked > 0)
+	{
+		problem("%u zones marked used in the zone map, but not referenced",
+			nleaked);
+		fix();
+	}
+
+	return (nused);
+}
+
+/**
+ * @brief Reads file system metadata.
+ * 
+ * @details Reads the superblock, the inode and zone maps, and the inode table,
+ *          which are laid out in sequence at the beginning of the image.
+ */
+static void metadata_read(void)
+{
+	off_t size;             /* Image size (in bytes). */
+	uint32_t inode_nblocks; /* Inode table blocks.    */
+
+	size = lseek(fd, 0, SEEK_END);
+
+	slseek(fd, 1*BLOCK_SIZE, SEEK_SET);
+	sread(fd, &super, sizeof(struct d_superblock));
+
+	/* Bad superblock. */
+	if (super.s_magic != SUPER_MAGIC)
+		error("bad magic number");
+	if (super.s_features & ~MINIX_FEATURES)
+		error("unsupported file system features");
+	if ((uint32_t)super.s_imap_nblocks*BLOCK_SIZE*8 < super.s_ninodes)
+		error("inode map too small");
+	if ((uint32_t)super.s_bmap_nblocks*BLOCK_SIZE*8 < super.s_nblocks)
+		error("zone map too small");
+	if (super.s_first_data_block < 2 + super.s_imap_nblocks + super.s_bmap_nblocks)
+		error("bad first data block");
+
+	inode_nblocks = super.s_first_data_block - 2;
+	inode_nblocks -= super.s_imap_nblocks + super.s_bmap_nblocks;
+
+	/* Bad geometry. */
+	if (inode_nblocks*BLOCK_SIZE < super.s_ninodes*sizeof(struct d_inode))
+		error("inode table too small");
+	if ((off_t)(super.s_first_data_block + super.s_nblocks)*BLOCK_SIZE > size)
+		error("file system larger than image");
+
+	/* Read inode map. */
+	slseek(fd, 2*BLOCK_SIZE, SEEK_SET);
+	imap.size = super.s_imap_nblocks*BLOCK_SIZE;
+	imap.bitmap = smalloc(imap.size);
+	sread(fd, imap.bitmap, imap.size);
+
+	/* Read zone map. */
+	zmap.size = super.s_bmap_nblocks*BLOCK_SIZE;
+	zmap.bitmap = smalloc(zmap.size);
+	sread(fd, zmap.bitmap, zmap.size);
+
+	/* Read inode table. */
+	inodes.size = super.s_ninodes*sizeof(struct d_inode);
+	inodes.table = smalloc(inodes.size);
+	sread(fd, inodes.table, inodes.size);
+
+	/* Bad root directory. */
+	if ((super.s_ninodes < INODE_ROOT) ||
+		(inode(INODE_ROOT)->i_nlinks == 0) ||
+		(!S_ISDIR(inode(INODE_ROOT)->i_mode)))
+		error("bad root directory");
+}
+
+/**
+ * @brief Writes back file system metadata that has been repaired.
+ */
+static void metadata_write(void)
+{
+	/* Write inode map. */
+	if (imap.dirty)
+	{
+		slseek(fd, 2*BLOCK_SIZE, SEEK_SET);
+		swrite(fd, imap.bitmap, imap.size);
+	}
+
+	/* Write zone map. */
+	if (zmap.dirty)
+	{
+		slseek(fd, (2 + super.s_imap_nblocks)*BLOCK_SIZE, SEEK_SET);
+		swrite(fd, zmap.bitmap, zmap.size);
+	}
+
+	/* Write inode table. */
+	if (inodes.dirty)
+	{
+		slseek(fd, (2 + super.s_imap_nblocks + super.s_bmap_nblocks)*BLOCK_SIZE, SEEK_SET);
+		swrite(fd, inodes.table, inodes.size);
+	}
+}
+
+/**
+ * @brief Prints program usage and exits.
+ */
+static void usage(void)
+{
+	printf("usage: fsck.minix [-r] <input file>\n");
+	printf("  -r  repair file system\n");
+	exit(EXIT_SUCCESS);
+}
+
+/**
+ * @brief Checks a Minix file system.
+ */
+int main(int argc, char **argv)
+{
+	const char *diskfile; /* Disk file name.  */
+	unsigned ninodes;     /* Inodes in use.   */
+	unsigned nzones;      /* Zones in use.    */
+
+	diskfile = NULL;
+
+	/* Parse arguments. */
+	for (int i = 1; i < argc; i++)
+	{
+		if (!strcmp(argv[i], "-r"))
+			repair = true;
+		else if (diskfile == NULL)
+			diskfile = argv[i];
+		else
+			usage();
+	}
+
+	/* Missing arguments. */
+	if (diskfile == NULL)
+		usage();
+
+	fd = sopen(diskfile, (repair) ? O_RDWR : O_RDONLY);
+
+	metadata_read();
+
+	dirs.refs = scalloc(super.s_ninodes + 1, sizeof(uint16_t));
+	dirs.parent = scalloc(super.s_ninodes + 1, sizeof(uint16_t));
+	dirs.dotdot = scalloc(super.s_ninodes + 1, sizeof(uint16_t));
+	dirs.flags = scalloc(super.s_ninodes + 1, sizeof(uint8_t));
+
+	/* Check zones. */
+	for (uint32_t num = 1; num <= super.s_ninodes; num++)
+	{
+		if (inode(num)->i_nlinks != 0)
+			inode_zones_check(num);
+	}
+	data_sweep();
+
+	ninodes = inodes_check();
+	nzones = zones_check();
+
+	if (repair)
+		metadata_write();
+
+	sclose(fd);
+
+	printf("%s: %u/%u inodes, %u/%u zones\n",
+		diskfile, ninodes, super.s_ninodes, nzones, super.s_nblocks);
+	if (nerrors > 0)
+		printf("%s: %u errors, %u fixed\n", diskfile, nerrors, nfixed);
+
+	/* House keeping. */
+	free(dirs.flags);
+	free(dirs.dotdot);
+	free(dirs.parent);
+	free(dirs.refs);
+	free(inodes.table);
+	free(zmap.bitmap);
+	free(imap.bitmap);
+
+	return ((nerrors == nfixed) ? EXIT_SUCCESS : EXIT_FAILURE);
+}
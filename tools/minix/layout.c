@@ -0,0 +1,625 @@
+/*
+ * Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of Nanvix.
+ * 
+ * Nanvix is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Nanvix is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Nanvix. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <sys/types.h>
+#include <ctype.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "bitmap.h"
+#include "minix.h"
+#include "stat.h"
+#include "util.h"
+
+/**
+ * @file
+ * 
+ * @brief Minix image layout optimiser.
+ * 
+ * @details Rewrites a Minix image so that the files that are accessed early
+ *          at boot come first, in access order. Files are given by a list
+ *          that has one entry per line: either an absolute path name, or a
+ *          block number taken from a block access trace, in which case the
+ *          file that owns that block is moved. Inodes are renumbered in the
+ *          same order, so that they share inode table blocks. All other files
+ *          follow, each one laid out contiguously.
+ */
+
+/**
+ * @brief Number of block numbers.
+ */
+#define NR_BLOCKS (1 << 16)
+
+/**
+ * @brief Number of directory entries per block.
+ */
+#define DIRENTS_PER_BLOCK (BLOCK_SIZE/sizeof(struct d_dirent))
+
+/**
+ * @brief Image contents.
+ */
+static char *image = NULL;
+
+/**
+ * @brief Superblock.
+ */
+static struct d_superblock *super = NULL;
+
+/**
+ * @brief New inode numbers.
+ */
+static uint16_t *newino = NULL;
+
+/**
+ * @brief Old inode numbers, in new order.
+ */
+static uint16_t *oldino = NULL;
+
+/**
+ * @brief Number of inodes placed.
+ */
+static unsigned ninodes = 0;
+
+/**
+ * @brief New block numbers.
+ */
+static block_t newblk[NR_BLOCKS];
+
+/**
+ * @brief Number of blocks placed.
+ */
+static unsigned nblocks = 0;
+
+/**
+ * @brief Owner of blocks.
+ */
+static uint16_t owner[NR_BLOCKS];
+
+/**
+ * @brief Returns a block of the image.
+ * 
+ * @param num Block number.
+ * 
+ * @returns A pointer to the contents of block @p num.
+ */
+static inline void *block(block_t num)
+{
+	return (&image[(size_t)num*BLOCK_SIZE]);
+}
+
+/**
+ * @brief Returns a disk inode of the image.
+ * 
+ * @param num Inode number.
+ * 
+ * @returns A pointer to the disk inode @p num.
+ */
+static inline struct d_inode *inode(uint16_t num)
+{
+	block_t blk;
+
+	blk = 2 + super->s_imap_nblocks + super->s_bmap_nblocks;
+
+	return (&((struct d_inode *)block(blk))[num - 1]);
+}
+
+/**
+ * @brief Asserts if an inode has zones.
+ * 
+ * @param ip Inode to be inspected.
+ * 
+ * @returns True if the inode pointed to by @p ip has zones, and false
+ *          otherwise.
+ */
+static bool has_zones(const struct d_inode *ip)
+{
+	/* Device files. */
+	if (!(S_ISREG(ip->i_mode) || S_ISDIR(ip->i_mode)))
+		return (false);
+
+	/* Inline data. */
+	if ((super->s_features & MINIX_FEATURE_INLINE) &&
+		S_ISREG(ip->i_mode) && (ip->i_size <= MINIX_INLINE_MAX))
+		return (false);
+
+	return (true);
+}
+
+/**
+ * @brief Asserts if a block number is valid.
+ * 
+ * @param num Block number.
+ * 
+ * @returns True if @p num refers to a data block, and false otherwise.
+ */
+static bool valid_block(block_t num)
+{
+	return ((num >= super->s_first_data_block) &&
+		((uint32_t)num < (uint32_t)super->s_first_data_block + super->s_nblocks));
+}
+
+/**
+ * @brief Reads an entry of an indirect block.
+ */
+static inline block_t indirect(block_t num, unsigned i)
+{
+	return (((block_t *)block(num))[i]);
+}
+
+/**
+ * @brief Maps a logical block of a file.
+ * 
+ * @param ip    File.
+ * @param logic Logical block number.
+ * 
+ * @returns The block number of logical block @p logic of the file pointed to
+ *          by @p ip, or #BLOCK_NULL if there is no such block.
+ */
+static block_t block_map(const struct d_inode *ip, uint32_t logic)
+{
+	block_t num;
+
+	/* Direct block. */
+	if (logic < NR_ZONES_DIRECT)
+		return (ip->i_zones[logic]);
+	logic -= NR_ZONES_DIRECT;
+
+	/* Single indirect block. */
+	if (logic < NR_SINGLE)
+	{
+		if ((num = ip->i_zones[ZONE_SINGLE]) == BLOCK_NULL)
+			return (BLOCK_NULL);
+		return (indirect(num, logic));
+	}
+	logic -= NR_SINGLE;
+
+	/* Double indirect block. */
+	if ((num = ip->i_zones[ZONE_DOUBLE]) == BLOCK_NULL)
+		return (BLOCK_NULL);
+	if ((num = indirect(num, logic/NR_SINGLE)) == BLOCK_NULL)
+		return (BLOCK_NULL);
+	return (indirect(num, logic%NR_SINGLE));
+}
+
+/**
+ * @brief Searches for a file in a directory.
+ * 
+ * @param dnum     Inode number of the directory.
+ * @param filename Name of the file.
+ * 
+ * @returns The inode number of the file, or #INODE_NULL if it does not exist.
+ */
+static uint16_t lookup(uint16_t dnum, const char *filename)
+{
+	uint32_t nentries;   /* Number of entries. */
+	struct d_inode *dip; /* Directory.         */
+
+	dip = inode(dnum);
+
+	/* Not a directory. */
+	if (!S_ISDIR(dip->i_mode))
+		return (INODE_NULL);
+
+	nentries = dip->i_size/sizeof(struct d_dirent);
+
+	for (uint32_t i = 0; i < nentries; i++)
+	{
+		block_t blk;
+		struct d_dirent *d;
+
+		blk = block_map(dip, i/DIRENTS_PER_BLOCK);
+
+		/* Hole. */
+		if (!valid_block(blk))
+		{
+			i |= DIRENTS_PER_BLOCK - 1;
+			continue;
+		}
+
+		d = &((struct d_dirent *)block(blk))[i%DIRENTS_PER_BLOCK];
+
+		if ((d->d_ino != INODE_NULL) &&
+			(!strncmp(d->d_name, filename, MINIX_NAME_MAX)))
+			return (d->d_ino);
+	}
+
+	return (INODE_NULL);
+}
+
+/**
+ * @brief Places a block.
+ * 
+ * @param num Block number.
+ */
+static void block_place(block_t num)
+{
+	/* Nothing to be done. */
+	if (!valid_block(num) || (newblk[num] != BLOCK_NULL))
+		return;
+
+	newblk[num] = super->s_first_data_block + nblocks++;
+}
+
+/**
+ * @brief Places a file.
+ * 
+ * @details Assigns the next inode number to the file @p num, and the next
+ *          data blocks to its blocks in logical order. Indirect blocks come
+ *          right before the blocks they map.
+ * 
+ * @param num Inode number.
+ */
+static void file_place(uint16_t num)
+{
+	struct d_inode *ip;
+
+	/* Already placed. */
+	if (newino[num] != INODE_NULL)
+		return;
+
+	newino[num] = ++ninodes;
+	oldino[ninodes] = num;
+
+	ip = inode(num);
+
+	/* No zones. */
+	if (!has_zones(ip))
+		return;
+
+	for (unsigned i = 0; i < NR_ZONES_DIRECT; i++)
+		block_place(ip->i_zones[i]);
+
+	/* Single indirect block. */
+	if (valid_block(ip->i_zones[ZONE_SINGLE]))
+	{
+		block_place(ip->i_zones[ZONE_SINGLE]);
+		for (unsigned i = 0; i < NR_SINGLE; i++)
+			block_place(indirect(ip->i_zones[ZONE_SINGLE], i));
+	}
+
+	/* Double indirect block. */
+	if (valid_block(ip->i_zones[ZONE_DOUBLE]))
+	{
+		block_place(ip->i_zones[ZONE_DOUBLE]);
+		for (unsigned i = 0; i < NR_SINGLE; i++)
+		{
+			block_t blk = indirect(ip->i_zones[ZONE_DOUBLE], i);
+
+			if (!valid_block(blk))
+				continue;
+
+			block_place(blk);
+			for (unsigned j = 0; j < NR_SINGLE; j++)
+				block_place(indirect(blk, j));
+		}
+	}
+}
+
+/**
+ * @brief Places a file and all directories in its path.
+ * 
+ * @param pathname Path name of the file.
+ * 
+ * @returns True if the file exists, and false otherwise.
+ */
+static bool path_place(const char *pathname)
+{
+	uint16_t num;                      /* Working inode number. */
+	char filename[MINIX_NAME_MAX + 1]; /* Working file name.    */
+
+	num = INODE_ROOT;
+	while (*pathname != '\0')
+	{
+		pathname = break_path(pathname, filename);
+
+		/* Trailing slash. */
+		if (filename[0] == '\0')
+			break;
+
+		file_place(num);
+
+		if ((num = lookup(num, filename)) == INODE_NULL)
+			return (false);
+	}
+
+	file_place(num);
+
+	return (true);
+}
+
+/**
+ * @brief Records the owner of all blocks.
+ */
+static void owners_read(void)
+{
+	for (uint32_t num = 1; num <= super->s_ninodes; num++)
+	{
+		struct d_inode *ip = inode(num);
+
+		if ((ip->i_nlinks == 0) || !has_zones(ip))
+			continue;
+
+		for (uint32_t logic = 0; /* noop */; logic++)
+		{
+			block_t blk;
+
+			if (logic*BLOCK_SIZE >= ip->i_size)
+				break;
+
+			blk = block_map(ip, logic);
+			if (valid_block(blk))
+				owner[blk] = num;
+		}
+	}
+}
+
+/**
+ * @brief Reads the list of boot files.
+ * 
+ * @param listfile Name of the list file.
+ */
+static void list_read(const char *listfile)
+{
+	FILE *fp;        /* List file.    */
+	char line[1024]; /* Working line. */
+
+	if ((fp = fopen(listfile, "r")) == NULL)
+		error("cannot open list file");
+
+	while (fgets(line, sizeof(line), fp) != NULL)
+	{
+		line[strcspn(line, "\r\n")] = '\0';
+
+		/* Path name. */
+		if (line[0] == '/')
+		{
+			if (!path_place(line))
+				fprintf(stderr, "layout.minix: %s: not found\n", line);
+		}
+
+		/* Block number. */
+		else if (isdigit((unsigned char)line[0]))
+		{
+			unsigned long num = strtoul(line, NULL, 0);
+
+			if ((num < NR_BLOCKS) && (owner[num] != INODE_NULL))
+				file_place(owner[num]);
+		}
+	}
+
+	fclose(fp);
+}
+
+/**
+ * @brief Relocates the pointers of a file.
+ * 
+ * @param ip File whose zones shall be relocated.
+ */
+static void file_relocate(struct d_inode *ip)
+{
+	/* Remap directory entries. */
+	if (S_ISDIR(ip->i_mode))
+	{
+		uint32_t nentries = ip->i_size/sizeof(struct d_dirent);
+
+		for (uint32_t i = 0; i < nentries; i++)
+		{
+			block_t blk;
+			struct d_dirent *d;
+
+			blk = block_map(ip, i/DIRENTS_PER_BLOCK);
+			if (!valid_block(blk))
+			{
+				i |= DIRENTS_PER_BLOCK - 1;
+				continue;
+			}
+
+			d = &((struct d_dirent *)block(blk))[i%DIRENTS_PER_BLOCK];
+			if (d->d_ino <= super->s_ninodes)
+				d->d_ino = newino[d->d_ino];
+			else
+				d->d_ino = INODE_NULL;
+		}
+	}
+
+	/* Remap zones. */
+	if (!has_zones(ip))
+		return;
+
+	for (unsigned i = 0; i < NR_ZONES; i++)
+	{
+		block_t blk = ip->i_zones[i];
+
+		if (!valid_block(blk))
+			continue;
+
+		/* Single indirect block. */
+		if (i == ZONE_SINGLE)
+		{
+			for (unsigned j = 0; j < NR_SINGLE; j++)
+			{
+				block_t *p = &((block_t *)block(blk))[j];
+				*p = (valid_block(*p)) ? newblk[*p] : BLOCK_NULL;
+			}
+		}
+
+		/* Double indirect block. */
+		else if (i == ZONE_DOUBLE)
+		{
+			for (unsigned j = 0; j < NR_SINGLE; j++)
+			{
+				block_t *p = &((block_t *)block(blk))[j];
+
+				if (!valid_block(*p))
+				{
+					*p = BLOCK_NULL;
+					continue;
+				}
+
+				for (unsigned k = 0; k < NR_SINGLE; k++)
+				{
+					block_t *q = &((block_t *)block(*p))[k];
+					*q = (valid_block(*q)) ? newblk[*q] : BLOCK_NULL;
+				}
+
+				*p = newblk[*p];
+			}
+		}
+
+		ip->i_zones[i] = newblk[blk];
+	}
+}
+
+/**
+ * @brief Rewrites the image.
+ * 
+ * @details Remaps all pointers in the image to the new inode and block
+ *          numbers, and then moves inodes and blocks to their new places.
+ * 
+ * @param size Image size (in bytes).
+ * 
+ * @returns The new image.
+ */
+static char *image_rewrite(size_t size)
+{
+	char *out;             /* New image.            */
+	size_t end;            /* End of file system.   */
+	block_t itable;        /* Inode table block.    */
+	uint32_t *imap, *zmap; /* New inode/zone maps.  */
+
+	/* Remap pointers in place. */
+	for (unsigned i = 1; i <= ninodes; i++)
+		file_relocate(inode(oldino[i]));
+
+	out = scalloc(size, 1);
+	itable = 2 + super->s_imap_nblocks + super->s_bmap_nblocks;
+
+	/* Boot block and superblock. */
+	memcpy(out, image, 2*BLOCK_SIZE);
+
+	/* Inode map. */
+	imap = (uint32_t *)&out[2*BLOCK_SIZE];
+	for (unsigned i = 0; i < ninodes; i++)
+		bitmap_set(imap, i);
+
+	/* Zone map. */
+	zmap = (uint32_t *)&out[(2 + super->s_imap_nblocks)*BLOCK_SIZE];
+	for (unsigned i = 0; i < nblocks; i++)
+		bitmap_set(zmap, i);
+
+	/* Inode table. */
+	for (unsigned i = 1; i <= ninodes; i++)
+	{
+		memcpy(&out[(size_t)itable*BLOCK_SIZE + (i - 1)*sizeof(struct d_inode)],
+			inode(oldino[i]), sizeof(struct d_inode));
+	}
+
+	/* Data blocks. */
+	for (uint32_t num = 0; num < NR_BLOCKS; num++)
+	{
+		if (newblk[num] != BLOCK_NULL)
+			memcpy(&out[(size_t)newblk[num]*BLOCK_SIZE], block(num), BLOCK_SIZE);
+	}
+
+	/* Anything past the file system. */
+	end = ((size_t)super->s_first_data_block + super->s_nblocks)*BLOCK_SIZE;
+	if (end < size)
+		memcpy(&out[end], &image[end], size - end);
+
+	return (out);
+}
+
+/**
+ * @brief Prints program usage and exits.
+ */
+static void usage(void)
+{
+	printf("usage: layout.minix <input file> <list file>\n");
+	exit(EXIT_SUCCESS);
+}
+
+/**
+ * @brief Lays out a Minix file system in boot order.
+ */
+int main(int argc, char **argv)
+{
+	int fd;         /* Image file.            */
+	off_t size;     /* Image size (in bytes). */
+	char *out;      /* New image.             */
+	unsigned nboot; /* Number of boot blocks. */
+
+	/* Wrong usage. */
+	if (argc != 3)
+		usage();
+
+	/* Read image. */
+	fd = sopen(argv[1], O_RDWR);
+	size = lseek(fd, 0, SEEK_END);
+	if (size < 2*BLOCK_SIZE)
+		error("image too small");
+	image = smalloc(size);
+	slseek(fd, 0, SEEK_SET);
+	sread(fd, image, size);
+
+	super = (struct d_superblock *)&image[BLOCK_SIZE];
+	if (super->s_magic != SUPER_MAGIC)
+		error("bad magic number");
+	if ((off_t)(super->s_first_data_block + super->s_nblocks)*BLOCK_SIZE > size)
+		error("file system larger than image");
+
+	newino = scalloc(super->s_ninodes + 1, sizeof(uint16_t));
+	oldino = scalloc(super->s_ninodes + 1, sizeof(uint16_t));
+
+	owners_read();
+
+	/* Boot files first. */
+	file_place(INODE_ROOT);
+	list_read(argv[2]);
+	nboot = nblocks;
+
+	/* Then everything else. */
+	for (uint32_t num = 1; num <= super->s_ninodes; num++)
+	{
+		if (inode(num)->i_nlinks != 0)
+			file_place(num);
+	}
+
+	out = image_rewrite(size);
+
+	/* Write image. */
+	slseek(fd, 0, SEEK_SET);
+	swrite(fd, out, size);
+	sclose(fd);
+
+	printf("%s: %u boot blocks, %u/%u inodes, %u/%u zones\n",
+		argv[1], nboot, ninodes, super->s_ninodes, nblocks, super->s_nblocks);
+
+	/* House keeping. */
+	free(out);
+	free(oldino);
+	free(newino);
+	free(image);
+
+	return (EXIT_SUCCESS);
+}
@@ -509,7 +509,6 @@ static void minix_dirent_add
 	slseek(fd, off, SEEK_SET);
 	swrite(fd, &d, sizeof(struct d_dirent));
 	
-	dip->i_nlinks++;
 	dip->i_time = 0;
 }
 
@@ -593,7 +592,8 @@ uint16_t minix_mkdir
 	ip = minix_inode_read(num);
 	minix_dirent_add(ip, ".", num);
 	minix_dirent_add(ip, "..", dnum);
-	ip->i_nlinks--;
+	ip->i_nlinks++;
+	dip->i_nlinks++;
 	minix_inode_write(num, ip);
 	
 	return (num);
@@ -669,26 +669,40 @@ uint16_t minix_create
 }
 
 /**
- * @brief Writes data to a file.
+ * @brief Asserts if a file holds inline data.
  * 
- * @param num Inode number of the file.
+ * @param ip File to be inspected.
+ * 
+ * @returns True if the file pointed to by @p ip holds inline data, and false
+ *          otherwise.
+ * 
+ * @note @p ip must point to a valid inode.
+ * @note The Minix file system must be mounted.
+ */
+static bool minix_inline(const struct d_inode *ip)
+{
+	return ((super.s_features & MINIX_FEATURE_INLINE) &&
+			S_ISREG(ip->i_mode) && (ip->i_size <= MINIX_INLINE_MAX));
+}
+
+/**
+ * @brief Appends data to the blocks of a file.
+ * 
+ * @param ip  File.
  * @param buf Buffer to be written.
  * @param n   Number of bytes to be written.
  * 
- * @note num must refer  to a valid inode.
- * @note buf must point to a valid buffer.
+ * @note @p ip must point to a valid inode.
+ * @note @p buf must point to a valid buffer.
  * @note The Minix file system must be mounted.
  */
-void minix_write(uint16_t num, const void *buf, size_t n)
+static void minix_write_blocks(struct d_inode *ip, const void *buf, size_t n)
 {
-	const char *p;      /* Writing pointer.     */
-	off_t off;          /* Current file offset. */
-	struct d_inode *ip; /* File.                */
+	const char *p; /* Writing pointer.     */
+	off_t off;     /* Current file offset. */
 	
 	p = buf;
 	
-	ip = minix_inode_read(num);
-	
 	off = ip->i_size;
 	
 	/* Write data. */
@@ -711,7 +725,55 @@ void minix_write(uint16_t num, const void *buf, size_t n)
 		p += chunk;
 		i += chunk;
 	}
+}
+
+/**
+ * @brief Writes data to a file.
+ * 
+ * @details Appends @p n bytes from @p buf to the file whose inode number is
+ *          @p num. Tiny files keep their data inline if the file system
+ *          supports it, and data is moved to a block once it does not fit.
+ * 
+ * @param num Inode number of the file.
+ * @param buf Buffer to be written.
+ * @param n   Number of bytes to be written.
+ * 
+ * @note num must refer  to a valid inode.
+ * @note buf must point to a valid buffer.
+ * @note The Minix file system must be mounted.
+ */
+void minix_write(uint16_t num, const void *buf, size_t n)
+{
+	struct d_inode *ip;          /* File.        */
+	char data[MINIX_INLINE_MAX]; /* Inline data. */
+	size_t size;                 /* Inline size. */
 	
+	ip = minix_inode_read(num);
+	
+	if (minix_inline(ip))
+	{
+		size = ip->i_size;
+		memcpy(data, ip->i_zones, size);
+		
+		/* Write inline data. */
+		if (size + n <= MINIX_INLINE_MAX)
+		{
+			memcpy(&data[size], buf, n);
+			memcpy(ip->i_zones, data, size + n);
+			ip->i_size = size + n;
+			
+			goto out;
+		}
+		
+		/* Move inline data to blocks. */
+		memset(ip->i_zones, 0, MINIX_INLINE_MAX);
+		ip->i_size = 0;
+		minix_write_blocks(ip, data, size);
+	}
+	
+	minix_write_blocks(ip, buf, n);
+	
+out:
 	minix_inode_write(num, ip);
 }
 
@@ -721,15 +783,16 @@ void minix_write(uint16_t num, const void *buf, size_t n)
  * @param diskfile File where the minix file system shall be created.
  * @param ninodes  Number of inodes.
  * @param nblocks  Number of blocks.
- * @param uid  User ID.
- * @param gid  User group ID.
+ * @param uid      User ID.
+ * @param gid      User group ID.
+ * @param features Feature flags.
  * 
  * @note @p diskfile must refer to a valid file.
  * @note @p ninodes must be valid.
  * @note @p nblocks must be valid.
  */
 void minix_mkfs
-(const char *diskfile, uint16_t ninodes, uint16_t nblocks, uint16_t uid, uint16_t gid)
+(const char *diskfile, uint16_t ninodes, uint16_t nblocks, uint16_t uid, uint16_t gid, uint16_t features)
 {
 	size_t size;            /* Size of file system.            */
 	char buf[BLOCK_SIZE];   /* Writing buffer.                 */
@@ -742,12 +805,12 @@ void minix_mkfs
 	
 	fd = sopen(diskfile, O_RDWR | O_CREAT);
 	
-	#define ROUND(x) (((x) == 0) ? 1 : (x))
+	#define ROUND(x, y) (((x) + (y) - 1)/(y))
 	
 	/* Compute dimensions of file sytem. */
-	imap_nblocks = ROUND(ninodes/(8*BLOCK_SIZE));
-	bmap_nblocks = ROUND(nblocks/(8*BLOCK_SIZE));
-	inode_nblocks = ROUND( (ninodes*sizeof(struct d_inode))/BLOCK_SIZE);
+	imap_nblocks = ROUND(ninodes + 1, 8*BLOCK_SIZE);
+	bmap_nblocks = ROUND(nblocks, 8*BLOCK_SIZE);
+	inode_nblocks = ROUND(ninodes*sizeof(struct d_inode), BLOCK_SIZE);
 	
 	/* Compute size of file system. */
 	size  = 1;             /* boot block   */
@@ -769,7 +832,8 @@ void minix_mkfs
 	super.s_imap_nblocks = imap_nblocks;
 	super.s_bmap_nblocks = bmap_nblocks;
 	super.s_first_data_block = 2 + imap_nblocks + bmap_nblocks + inode_nblocks;
-	super.s_max_size = 532480;
+	super.s_features = features;
+	super.s_max_size = (NR_ZONES_DIRECT + NR_SINGLE + NR_DOUBLE)*BLOCK_SIZE;
 	super.s_magic = SUPER_MAGIC;
 	
 	/* Create inode map. */
@@ -789,7 +853,7 @@ void minix_mkfs
 	root = minix_inode_read(num);
 	minix_dirent_add(root, ".", num);
 	minix_dirent_add(root, "..", num);
-	root->i_nlinks--;
+	root->i_nlinks++;
 	minix_inode_write(num, root);
 	
 	minix_umount();
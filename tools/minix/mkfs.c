@@ -19,6 +19,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "minix.h"
 
@@ -27,7 +28,8 @@
  */
 static void usage(void)
 {
-	printf("usage: mkfs.minix <input file> <ninodes> <nblocks> <uid> <gid>\n");
+	printf("usage: mkfs.minix <input file> <ninodes> <nblocks> <uid> <gid> [-i]\n");
+	printf("  -i  store tiny files inline\n");
 	exit(EXIT_SUCCESS);
 }
 
@@ -39,17 +41,29 @@ int main(int argc, char **argv)
 	unsigned ninodes;     /* # inodes in the file system.      */
 	unsigned nblocks; 	  /* # data blocks in the file system. */
 	const char *diskfile; /* Disk file name.                   */
+	uint16_t features;    /* File system features.             */
 	
 	/* Missing arguments. */
 	if (argc < 6)
 		usage();
 	
+	features = 0;
+	
+	/* Optional features. */
+	for (int i = 6; i < argc; i++)
+	{
+		if (!strcmp(argv[i], "-i"))
+			features |= MINIX_FEATURE_INLINE;
+		else
+			usage();
+	}
+	
 	/* Extract arguments. */
 	diskfile = argv[1];
 	sscanf(argv[2], "%u", &ninodes);
 	sscanf(argv[3], "%u", &nblocks);
 	
-	minix_mkfs(diskfile, ninodes, nblocks, atoi(argv[4]), atoi(argv[5]));
+	minix_mkfs(diskfile, ninodes, nblocks, atoi(argv[4]), atoi(argv[5]), features);
 	
 	return (EXIT_SUCCESS);
 }
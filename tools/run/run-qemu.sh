@@ -0,0 +1,69 @@
+# 
+# Copyright(C) 2011-2016 Pedro H. Penna <pedrohenriquepenna@gmail.com> 
+#
+# This file is part of Nanvix.
+#
+# Nanvix is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# Nanvix is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with Nanvix.  If not, see <http://www.gnu.org/licenses/>.
+#
+
+
+# NOTES:
+#   - This script should work in any Linux distribution.
+#   - Boots Nanvix in QEMU with a legacy virtio-net card, so that the
+#     network stack can be exercised. Usage:
+#
+#       run-qemu.sh [user|listen|connect]
+#
+#   - user (default): user mode networking. Nanvix is 10.0.2.15 and the
+#     host is reachable at 10.0.2.2, so a host UDP echo server on port 7777
+#     stands in for "netperf -s", e.g.:
+#
+#       socat UDP4-LISTEN:7777,fork PIPE
+#       netperf 10.0.2.2 7777 64 1000
+#
+#   - listen/connect: two instances on a socket backed segment. Start the
+#     first with "listen" and the second with "connect", then give the
+#     second one another address, e.g.:
+#
+#       ifconfig 10.0.2.16
+#       netperf -s                        (first instance)
+#       netperf 10.0.2.15 7777 1472 1000  (second instance)
+#
+
+MODE=${1:-user}
+MAC=52:54:00:12:34:56
+
+case $MODE in
+	user)
+		NETDEV="user,id=n0"
+		;;
+	listen)
+		NETDEV="socket,id=n0,listen=:1234"
+		;;
+	connect)
+		NETDEV="socket,id=n0,connect=127.0.0.1:1234"
+		MAC=52:54:00:12:34:57
+		;;
+	*)
+		echo "usage: $0 [user|listen|connect]"
+		exit 1
+		;;
+esac
+
+qemu-system-i386 -m 16                                    \
+	-fda nanvix.img -boot a                               \
+	-drive file=hdd.img,index=0,media=disk,format=raw     \
+	-drive file=swap.img,index=2,media=disk,format=raw    \
+	-netdev $NETDEV                                       \
+	-device virtio-net-pci,netdev=n0,mac=$MAC,disable-modern=on